@@ -0,0 +1,87 @@
+#include <benchmark/benchmark.h>
+#include <audio_mixer.h>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+// One SDL audio callback worth of stereo frames
+constexpr int frames = 2048;
+constexpr int num_se = 32;
+
+namespace {
+
+struct Channel {
+	AudioMixer::Format format;
+	int channels;
+	std::vector<uint8_t> data;
+};
+
+std::vector<Channel> MakeChannels() {
+	std::mt19937 rng(12345);
+	std::vector<Channel> result;
+
+	auto make = [&](AudioMixer::Format format, int channels, int sample_size) {
+		Channel chan { format, channels, std::vector<uint8_t>(frames * channels * sample_size) };
+		if (format == AudioMixer::Format::F32) {
+			std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+			auto* samples = reinterpret_cast<float*>(chan.data.data());
+			for (int i = 0; i < frames * channels; ++i) {
+				samples[i] = dist(rng);
+			}
+		} else {
+			for (auto& b: chan.data) {
+				b = static_cast<uint8_t>(rng());
+			}
+		}
+		result.push_back(std::move(chan));
+	};
+
+	// BGM
+	make(AudioMixer::Format::S16, 2, 2);
+
+	// SE: mix of the formats produced by the decoders and the resampler
+	for (int i = 0; i < num_se; ++i) {
+		switch (i % 4) {
+			case 0: make(AudioMixer::Format::S16, 1, 2); break;
+			case 1: make(AudioMixer::Format::S16, 2, 2); break;
+			case 2: make(AudioMixer::Format::F32, 2, 4); break;
+			case 3: make(AudioMixer::Format::F32, 1, 4); break;
+		}
+	}
+
+	return result;
+}
+
+template <typename Mix, typename Pack>
+void MixChannels(benchmark::State& state, Mix mix, Pack pack) {
+	auto channels = MakeChannels();
+	std::vector<float> mixer(frames * 2);
+	std::vector<int16_t> output(frames * 2);
+
+	for (auto _: state) {
+		std::fill(mixer.begin(), mixer.end(), 0.0f);
+		float total_volume = 0.0f;
+		for (auto& chan: channels) {
+			mix(mixer.data(), chan.data.data(), chan.format, chan.channels, frames, 0.5f, 0.4f);
+			total_volume += 0.5f;
+		}
+		pack(output.data(), mixer.data(), frames * 2, total_volume);
+		benchmark::DoNotOptimize(output.data());
+	}
+}
+
+}
+
+static void BM_MixBgmAnd32Se(benchmark::State& state) {
+	MixChannels(state, AudioMixer::Mix, AudioMixer::ClipAndPack);
+}
+
+BENCHMARK(BM_MixBgmAnd32Se);
+
+static void BM_MixBgmAnd32SeScalar(benchmark::State& state) {
+	MixChannels(state, AudioMixer::Scalar::Mix, AudioMixer::Scalar::ClipAndPack);
+}
+
+BENCHMARK(BM_MixBgmAnd32SeScalar);
+
+BENCHMARK_MAIN();
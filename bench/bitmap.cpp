@@ -1,9 +1,12 @@
 #include <cmath>
+#include <sstream>
 #include <benchmark/benchmark.h>
 #include <rect.h>
 #include <bitmap.h>
 #include <pixel_format.h>
 #include <transform.h>
+#include <pixel_kernels.h>
+#include <cache.h>
 
 constexpr auto opacity_100 = Opacity::Opaque();
 constexpr auto opacity_0 = Opacity(0);
@@ -82,6 +85,20 @@ static void BM_Create(benchmark::State& state) {
 
 BENCHMARK(BM_Create);
 
+static void BM_CreatePNG(benchmark::State& state) {
+	Bitmap::SetFormat(format);
+	auto src = Bitmap::Create(480, 256);
+	std::ostringstream os;
+	src->WritePNG(os);
+	const auto png = os.str();
+	for (auto _: state) {
+		auto bm = Bitmap::Create(reinterpret_cast<const uint8_t*>(png.data()), png.size(), true, Bitmap::Flag_Chipset | Bitmap::Flag_ReadOnly);
+		(void)bm;
+	}
+}
+
+BENCHMARK(BM_CreatePNG);
+
 static void BM_Blit(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
@@ -251,31 +268,56 @@ static void BM_ClearRect(benchmark::State& state) {
 
 BENCHMARK(BM_ClearRect);
 
-static void BM_HueChangeBlit(benchmark::State& state) {
+static void BM_HueChangeBlit(benchmark::State& state, PixelKernels::Variant variant) {
+	auto prev_variant = PixelKernels::GetVariant();
+	if (!PixelKernels::SetVariant(variant)) {
+		state.SkipWithError("Variant not supported");
+		return;
+	}
+
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
 	auto src = Bitmap::Create(320, 240);
+	src->Fill(Color(200, 100, 50, 255));
 	auto rect = src->GetRect();
 	double hue = 1.0;
 	for (auto _: state) {
 		dest->HueChangeBlit(0, 0, *src, rect, hue);
 	}
+
+	PixelKernels::SetVariant(prev_variant);
 }
 
-BENCHMARK(BM_HueChangeBlit);
+BENCHMARK_CAPTURE(BM_HueChangeBlit, scalar, PixelKernels::Variant::Scalar);
+BENCHMARK_CAPTURE(BM_HueChangeBlit, sse41, PixelKernels::Variant::Sse41);
+BENCHMARK_CAPTURE(BM_HueChangeBlit, avx2, PixelKernels::Variant::Avx2);
+BENCHMARK_CAPTURE(BM_HueChangeBlit, neon, PixelKernels::Variant::Neon);
+
+static void BM_ToneBlit(benchmark::State& state, PixelKernels::Variant variant) {
+	auto prev_variant = PixelKernels::GetVariant();
+	if (!PixelKernels::SetVariant(variant)) {
+		state.SkipWithError("Variant not supported");
+		return;
+	}
 
-static void BM_ToneBlit(benchmark::State& state) {
 	Bitmap::SetFormat(format);
 	auto dest = Bitmap::Create(320, 240);
 	auto src = Bitmap::Create(320, 240);
+	src->Fill(Color(200, 100, 50, 192));
 	auto rect = src->GetRect();
-	auto tone = Tone(255,255,255,128);
+	// Color and saturation change
+	auto tone = Tone(255, 100, 160, 64);
 	for (auto _: state) {
 		dest->ToneBlit(0, 0, *src, rect, tone, opacity);
 	}
+
+	PixelKernels::SetVariant(prev_variant);
 }
 
-BENCHMARK(BM_ToneBlit);
+BENCHMARK_CAPTURE(BM_ToneBlit, scalar, PixelKernels::Variant::Scalar);
+BENCHMARK_CAPTURE(BM_ToneBlit, sse41, PixelKernels::Variant::Sse41);
+BENCHMARK_CAPTURE(BM_ToneBlit, avx2, PixelKernels::Variant::Avx2);
+BENCHMARK_CAPTURE(BM_ToneBlit, neon, PixelKernels::Variant::Neon);
 
 static void BM_BlendBlit(benchmark::State& state) {
 	Bitmap::SetFormat(format);
@@ -374,6 +416,35 @@ static void BM_EffectsBlit(benchmark::State& state) {
 
 BENCHMARK(BM_EffectsBlit);
 
+// 100 charsets drawn under a screen tone that changes every frame
+static void BM_CharsetsToneChange(benchmark::State& state, bool fused) {
+	Bitmap::SetFormat(format);
+	auto dest = Bitmap::Create(320, 240);
+	auto charset = Bitmap::Create(288, 256);
+	charset->Fill(Color(200, 100, 50, 192));
+	charset->SetId("Bench/Charset");
+	int frame = 0;
+	for (auto _: state) {
+		auto tone = Tone(128 + frame % 128, 128, 128 - frame % 128, 128);
+		for (int i = 0; i < 100; ++i) {
+			auto rect = Rect((i % 12) * 24, (i / 12 % 8) * 32, 24, 32);
+			int x = (i * 37) % 296;
+			int y = (i * 53) % 208;
+			if (fused) {
+				dest->EffectsBlit(x, y, 0, 0, *charset, rect, opacity, tone, Color(), i % 2 == 0, false);
+			} else {
+				auto effect = Cache::SpriteEffect(charset, rect, i % 2 == 0, false, tone, Color());
+				dest->Blit(x, y, *effect, effect->GetRect(), opacity);
+			}
+		}
+		++frame;
+	}
+	Cache::Clear();
+}
+
+BENCHMARK_CAPTURE(BM_CharsetsToneChange, effect_bitmap, false);
+BENCHMARK_CAPTURE(BM_CharsetsToneChange, fused, true);
+
 
 
 BENCHMARK_MAIN();
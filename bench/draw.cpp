@@ -45,4 +45,108 @@ static void BM_DrawSortLocality(benchmark::State& state) {
 
 BENCHMARK(BM_DrawSortLocality);
 
+class TestPicture : public Drawable {
+	public:
+		TestPicture(Drawable::Z_t z) : Drawable(z) { DrawableMgr::Register(this); }
+		void Draw(Bitmap&) override {}
+};
+
+static void BM_DrawAddRemove(benchmark::State& state) {
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+	list.Sort();
+
+	std::vector<std::unique_ptr<TestPicture>> pictures(state.range(0));
+
+	for (auto _: state) {
+		// Show pictures ordered by id, then erase all of them
+		for (size_t i = 0; i < pictures.size(); ++i) {
+			pictures[i] = std::make_unique<TestPicture>(Priority_PictureNew + i);
+		}
+		for (auto& picture: pictures) {
+			picture.reset();
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_DrawAddRemove)->Arg(1000)->Arg(10000);
+
+static void BM_DrawRemoveRandom(benchmark::State& state) {
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+	list.Sort();
+
+	std::vector<std::unique_ptr<TestPicture>> pictures(state.range(0));
+	std::vector<size_t> order(pictures.size());
+	uint32_t seed = 1;
+	for (size_t i = 0; i < order.size(); ++i) {
+		seed = seed * 1103515245u + 12345u;
+		order[i] = i;
+		std::swap(order[i], order[(seed >> 8) % (i + 1)]);
+	}
+
+	for (auto _: state) {
+		for (size_t i = 0; i < pictures.size(); ++i) {
+			pictures[i] = std::make_unique<TestPicture>(Priority_PictureNew + i);
+		}
+		for (auto i: order) {
+			pictures[i].reset();
+		}
+		// Compact the remaining holes like a draw would
+		benchmark::DoNotOptimize(list.begin());
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_DrawRemoveRandom)->Arg(1000)->Arg(10000);
+
+static void BM_DrawReZ(benchmark::State& state) {
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	std::vector<std::unique_ptr<TestPicture>> pictures;
+	for (int i = 0; i < state.range(0); ++i) {
+		pictures.push_back(std::make_unique<TestPicture>(Priority_PictureNew + i));
+	}
+	list.Sort();
+
+	// One picture changes its layer per frame, a draw sorts the list if needed
+	uint32_t seed = 1;
+	for (auto _: state) {
+		seed = seed * 1103515245u + 12345u;
+		auto& picture = pictures[(seed >> 8) % pictures.size()];
+		picture->SetZ(picture->GetZ() < Priority_Window ? picture->GetZ() + Priority_Window : picture->GetZ() - Priority_Window);
+		if (list.IsDirty()) {
+			list.Sort();
+		}
+	}
+}
+
+BENCHMARK(BM_DrawReZ)->Arg(1000)->Arg(10000);
+
+static void BM_DrawReZLocal(benchmark::State& state) {
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	std::vector<std::unique_ptr<TestPicture>> pictures;
+	for (int i = 0; i < state.range(0); ++i) {
+		pictures.push_back(std::make_unique<TestPicture>(Priority_EventsBelow + i * 16));
+	}
+	list.Sort();
+
+	// Event sprites moving by one tile change their Z slightly
+	uint32_t seed = 1;
+	for (auto _: state) {
+		seed = seed * 1103515245u + 12345u;
+		auto& picture = pictures[(seed >> 8) % pictures.size()];
+		picture->SetZ(picture->GetZ() + ((seed >> 20) & 1 ? 40 : -40));
+		if (list.IsDirty()) {
+			list.Sort();
+		}
+	}
+}
+
+BENCHMARK(BM_DrawReZLocal)->Arg(1000)->Arg(10000);
+
 BENCHMARK_MAIN();
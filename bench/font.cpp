@@ -53,4 +53,46 @@ static void BM_Render(benchmark::State& state) {
 
 BENCHMARK(BM_Render);
 
+static void RenderStrWrap(benchmark::State& state, std::u32string_view str, bool warm) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SystemOrBlack();
+
+	auto font = Font::Default();
+	font->ClearGlyphCache();
+	for (auto _: state) {
+		if (!warm) {
+			font->ClearGlyphCache();
+		}
+		int x = 0;
+		for (auto ch: str) {
+			x += font->Render(*surface, x % width, 0, *system, 0, ch).x;
+		}
+	}
+}
+
+static void BM_RenderStrCold(benchmark::State& state) {
+	RenderStrWrap(state, U"Alex landed a critical hit on Slime!", false);
+}
+
+BENCHMARK(BM_RenderStrCold);
+
+static void BM_RenderStrWarm(benchmark::State& state) {
+	RenderStrWrap(state, U"Alex landed a critical hit on Slime!", true);
+}
+
+BENCHMARK(BM_RenderStrWarm);
+
+static void BM_RenderStrCJKCold(benchmark::State& state) {
+	RenderStrWrap(state, U"アレックスの攻撃！スライムに痛恨の一撃！", false);
+}
+
+BENCHMARK(BM_RenderStrCJKCold);
+
+static void BM_RenderStrCJKWarm(benchmark::State& state) {
+	RenderStrWrap(state, U"アレックスの攻撃！スライムに痛恨の一撃！", true);
+}
+
+BENCHMARK(BM_RenderStrCJKWarm);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,32 @@
+#include <benchmark/benchmark.h>
+#include "game_pictures.h"
+
+// A picture HUD: many static pictures and a few moving ones
+static void BM_PicturesUpdate(benchmark::State& state) {
+	Game_Pictures pictures;
+	const int num_pictures = state.range(0);
+	for (int i = 1; i <= num_pictures; ++i) {
+		Game_Pictures::ShowParams params;
+		params.position_x = i;
+		pictures.Show(i, params);
+	}
+	pictures.Update(false);
+
+	int frame = 0;
+	for (auto _: state) {
+		if (frame % 60 == 0) {
+			for (int i = 1; i <= num_pictures; i += 100) {
+				Game_Pictures::MoveParams params;
+				params.position_x = frame % 320;
+				params.duration = 10;
+				pictures.Move(i, params);
+			}
+		}
+		pictures.Update(false);
+		++frame;
+	}
+}
+
+BENCHMARK(BM_PicturesUpdate)->Arg(50)->Arg(1000);
+
+BENCHMARK_MAIN();
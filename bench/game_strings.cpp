@@ -0,0 +1,83 @@
+#include <benchmark/benchmark.h>
+#include <regex>
+#include <string>
+#include <vector>
+#include "game_map.h"
+#include "game_strings.h"
+#include "game_variables.h"
+#include "regex_cache.h"
+#include <lcf/data.h>
+
+// Lines like the ones parsed by Maniac Patch games (inventories, dialog, save info)
+static const std::vector<std::string> lines = {
+	"Potion x12",
+	"Hi-Potion x3",
+	"Name: Alex Level: 12 HP: 120/150",
+	"The quick brown fox jumps over the lazy dog",
+	"[color=red]Warning[/color] low HP",
+	"Item_0042;Weapon;Sword of Light;250",
+	"Gold: 1234567",
+	"Quest 7: Find the lost ring (0/1)"
+};
+
+static const std::vector<std::pair<std::string, std::string>> replacements = {
+	{ "x(\\d+)", "($1)" },
+	{ "\\[/?color(=\\w+)?\\]", "" },
+	{ "\\s+", " " },
+	{ ";", "\t" }
+};
+
+static void BM_RegExReplace(benchmark::State& state) {
+	RegexCache::Global().Clear();
+	for (auto _: state) {
+		for (auto& line: lines) {
+			for (auto& r: replacements) {
+				benchmark::DoNotOptimize(Game_Strings::RegExReplace(line, r.first, r.second));
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * lines.size() * replacements.size());
+}
+
+BENCHMARK(BM_RegExReplace);
+
+// Same loop, compiling every expression like before the cache existed
+static void BM_RegExReplaceUncached(benchmark::State& state) {
+	for (auto _: state) {
+		for (auto& line: lines) {
+			for (auto& r: replacements) {
+				std::wregex rexp(Utils::ToWideString(r.first));
+				auto result = std::regex_replace(Utils::ToWideString(line), rexp, Utils::ToWideString(r.second));
+				benchmark::DoNotOptimize(Utils::FromWideString(result));
+			}
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * lines.size() * replacements.size());
+}
+
+BENCHMARK(BM_RegExReplaceUncached);
+
+static void BM_ExMatch(benchmark::State& state) {
+	lcf::Data::variables.resize(16);
+	Game_Variables variables(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Game_Strings strings;
+	// No map is loaded, skip the event refresh tracking
+	Game_Map::SetNeedRefresh(true);
+
+	for (size_t i = 0; i < lines.size(); ++i) {
+		strings.Set(static_cast<int>(i) + 1, lines[i]);
+	}
+
+	RegexCache::Global().Clear();
+	for (auto _: state) {
+		// Extract all numbers of every string
+		for (size_t i = 0; i < lines.size(); ++i) {
+			benchmark::DoNotOptimize(strings.ExMatch(static_cast<int>(i) + 1, "\\d+", 1, 0, 10, variables));
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * lines.size());
+}
+
+BENCHMARK(BM_ExMatch);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,78 @@
+#include <benchmark/benchmark.h>
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <vector>
+#include "game_interpreter.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "maniac_patch.h"
+#include "span.h"
+#include <lcf/data.h>
+
+static std::vector<int32_t> pack(std::initializer_list<int> bytes) {
+	std::vector<int32_t> params((bytes.size() + 3) / 4);
+	int i = 0;
+	for (int b: bytes) {
+		params[i / 4] |= static_cast<int32_t>(static_cast<uint32_t>(b) << (8 * (i % 4)));
+		++i;
+	}
+	return params;
+}
+
+// v[1] * 3 + max(v[2], 10) - v[v[3]] % 7
+static const std::vector<int32_t> expression = pack({ 49, 48, 50, 8, 1, 1, 1, 3, 78, 13, 2, 8, 1, 2, 1, 10, 52, 13, 1, 3, 1, 7 });
+
+// (1 + 2) * 3, 4, v[1] + v[2]
+static const std::vector<int32_t> expressions = pack({ 50, 48, 1, 1, 1, 2, 1, 3, 1, 4, 48, 8, 1, 1, 8, 1, 2 });
+
+static void setup() {
+	lcf::Data::variables.resize(16);
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	for (int i = 1; i <= 16; ++i) {
+		Main_Data::game_variables->Set(i, i);
+	}
+}
+
+static void BM_ManiacCompileExpression(benchmark::State& state) {
+	for (auto _: state) {
+		auto expr = ManiacPatch::CompileExpression(MakeSpan(expression));
+		benchmark::DoNotOptimize(expr.code.data());
+	}
+}
+
+BENCHMARK(BM_ManiacCompileExpression);
+
+static void BM_ManiacEvaluateExpression(benchmark::State& state) {
+	setup();
+	Game_Interpreter interpreter;
+	auto expr = ManiacPatch::CompileExpression(MakeSpan(expression));
+	for (auto _: state) {
+		benchmark::DoNotOptimize(ManiacPatch::EvaluateExpression(expr, interpreter));
+	}
+}
+
+BENCHMARK(BM_ManiacEvaluateExpression);
+
+static void BM_ManiacParseExpression(benchmark::State& state) {
+	setup();
+	Game_Interpreter interpreter;
+	for (auto _: state) {
+		benchmark::DoNotOptimize(ManiacPatch::ParseExpression(MakeSpan(expression), interpreter));
+	}
+}
+
+BENCHMARK(BM_ManiacParseExpression);
+
+static void BM_ManiacParseExpressions(benchmark::State& state) {
+	setup();
+	Game_Interpreter interpreter;
+	for (auto _: state) {
+		auto values = ManiacPatch::ParseExpressions(MakeSpan(expressions), interpreter);
+		benchmark::DoNotOptimize(values.data());
+	}
+}
+
+BENCHMARK(BM_ManiacParseExpressions);
+
+BENCHMARK_MAIN();
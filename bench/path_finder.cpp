@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <path_finder.h>
+#include <random>
+#include <vector>
+
+constexpr int grid_w = 500;
+constexpr int grid_h = 500;
+
+static std::vector<uint8_t> MakeGrid(int blocked_percent) {
+	std::mt19937 rng(12345);
+	std::uniform_int_distribution<int> dist(0, 99);
+
+	std::vector<uint8_t> grid(grid_w * grid_h);
+	for (auto& cell: grid) {
+		cell = dist(rng) < blocked_percent;
+	}
+	grid[0] = 0;
+	grid[grid_w * grid_h - 1] = 0;
+	return grid;
+}
+
+static void BM_PathFinderSearch(benchmark::State& state, bool allow_diagonal) {
+	auto grid = MakeGrid(static_cast<int>(state.range(0)));
+
+	auto check_way = [&](int, int, int to_x, int to_y, bool) {
+		return grid[to_y * grid_w + to_x] == 0;
+	};
+
+	PathFinder::Args args;
+	args.start_x = 0;
+	args.start_y = 0;
+	args.dest_x = grid_w - 1;
+	args.dest_y = grid_h - 1;
+	args.width = grid_w;
+	args.height = grid_h;
+	args.allow_diagonal = allow_diagonal;
+
+	PathFinder pf;
+	std::vector<int> route;
+	for (auto _: state) {
+		pf.Search(args, check_way, route);
+		benchmark::DoNotOptimize(route.data());
+	}
+	state.counters["nodes"] = pf.GetExpandedNodes();
+}
+
+BENCHMARK_CAPTURE(BM_PathFinderSearch, orthogonal, false)->Arg(0)->Arg(20)->Arg(35);
+BENCHMARK_CAPTURE(BM_PathFinderSearch, diagonal, true)->Arg(0)->Arg(20)->Arg(35);
+
+BENCHMARK_MAIN();
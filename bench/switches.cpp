@@ -44,25 +44,41 @@ BENCHMARK(BM_SwitchFlip);
 
 template <typename F>
 static void BM_SwitchRangeOp(benchmark::State& state, F&& op) {
-	auto s = make();
+	const int size = state.range(0);
+	auto s = make(size);
 	int i = 0;
 	for (auto _: state) {
-		op(s, i + 1, i);
-		i = (i + 1) % max_sws;
+		op(s, size, i & 1);
+		// The interpreter consumes the changes after every command
+		s.ClearChanges();
+		++i;
 	}
+	state.SetItemsProcessed(state.iterations() * size);
 }
 
 static void BM_SwitchSetRange(benchmark::State& state) {
-	BM_SwitchOp(state, [](auto& s, auto, bool val) { s.SetRange(1, max_sws, val); });
+	BM_SwitchRangeOp(state, [](auto& s, int size, bool val) { s.SetRange(1, size, val); });
 }
 
-BENCHMARK(BM_SwitchSetRange);
+BENCHMARK(BM_SwitchSetRange)->Arg(1024)->Arg(16384)->Arg(131072);
+
+static void BM_SwitchSetRangeUnaligned(benchmark::State& state) {
+	BM_SwitchRangeOp(state, [](auto& s, int size, bool val) { s.SetRange(3, size - 5, val); });
+}
+
+BENCHMARK(BM_SwitchSetRangeUnaligned)->Arg(1024)->Arg(16384)->Arg(131072);
 
 static void BM_SwitchFlipRange(benchmark::State& state) {
-	BM_SwitchOp(state, [](auto& s, auto, bool) { s.FlipRange(1, max_sws); });
+	BM_SwitchRangeOp(state, [](auto& s, int size, bool) { s.FlipRange(1, size); });
 }
 
-BENCHMARK(BM_SwitchFlipRange);
+BENCHMARK(BM_SwitchFlipRange)->Arg(1024)->Arg(16384)->Arg(131072);
+
+static void BM_SwitchCountRange(benchmark::State& state) {
+	volatile int x = 0;
+	BM_SwitchRangeOp(state, [&x](auto& s, int size, bool) { x = s.CountRange(1, size); });
+}
 
+BENCHMARK(BM_SwitchCountRange)->Arg(1024)->Arg(16384)->Arg(131072);
 
 BENCHMARK_MAIN();
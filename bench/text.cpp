@@ -7,6 +7,7 @@
 #include <cache.h>
 
 const std::string text = "Alex $A landed a critical hit on Slime $B!";
+const std::string text_cjk = "アレックスの攻撃！スライムに痛恨の一撃！";
 char32_t symbol = '\\';
 constexpr int width = 240;
 constexpr int height = 80;
@@ -36,6 +37,45 @@ static void BM_TextDrawStrColor(benchmark::State& state) {
 
 BENCHMARK(BM_TextDrawStrColor);
 
+void DrawStrSystemCacheWrap(benchmark::State& state, std::string_view str, bool warm) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto font = Font::Default();
+	auto surface = Bitmap::Create(width, height);
+	auto system = Cache::SysBlack();
+
+	font->ClearGlyphCache();
+	for (auto _: state) {
+		if (!warm) {
+			font->ClearGlyphCache();
+		}
+		Text::Draw(*surface, 0, 0, *font, *system, 0, str, Text::AlignLeft);
+	}
+}
+
+static void BM_TextDrawStrSystemCold(benchmark::State& state) {
+	DrawStrSystemCacheWrap(state, text, false);
+}
+
+BENCHMARK(BM_TextDrawStrSystemCold);
+
+static void BM_TextDrawStrSystemWarm(benchmark::State& state) {
+	DrawStrSystemCacheWrap(state, text, true);
+}
+
+BENCHMARK(BM_TextDrawStrSystemWarm);
+
+static void BM_TextDrawStrSystemCJKCold(benchmark::State& state) {
+	DrawStrSystemCacheWrap(state, text_cjk, false);
+}
+
+BENCHMARK(BM_TextDrawStrSystemCJKCold);
+
+static void BM_TextDrawStrSystemCJKWarm(benchmark::State& state) {
+	DrawStrSystemCacheWrap(state, text_cjk, true);
+}
+
+BENCHMARK(BM_TextDrawStrSystemCJKWarm);
+
 void DrawCharSystemWrap(benchmark::State& state, char32_t ch, bool is_exfont) {
 	Bitmap::SetFormat(format_R8G8B8A8_a().format());
 	auto font = Font::Default();
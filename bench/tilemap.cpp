@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+#include <bitmap.h>
+#include <pixel_format.h>
+#include <tilemap.h>
+#include <drawable_list.h>
+#include <drawable_mgr.h>
+#include <game_map.h>
+#include <game_actors.h>
+#include <game_party.h>
+#include <game_player.h>
+#include <game_system.h>
+#include <game_switches.h>
+#include <game_variables.h>
+#include <game_screen.h>
+#include <game_pictures.h>
+#include <main_data.h>
+#include <map_data.h>
+#include <player.h>
+#include <lcf/data.h>
+
+constexpr int map_w = 100;
+constexpr int map_h = 100;
+
+static void SetupMap() {
+	static bool initialized = false;
+	if (initialized) {
+		return;
+	}
+	initialized = true;
+
+	lcf::Data::chipsets.push_back({});
+	lcf::Data::chipsets.back().passable_data_lower.resize(162, 0xF);
+	lcf::Data::chipsets.back().passable_data_upper.resize(162, 0xF);
+
+	auto& treemap = lcf::Data::treemap;
+	treemap.maps.push_back(lcf::rpg::MapInfo());
+	treemap.maps.back().type = lcf::rpg::TreeMap::MapType_root;
+	treemap.maps.push_back(lcf::rpg::MapInfo());
+	treemap.maps.back().ID = 1;
+	treemap.maps.back().type = lcf::rpg::TreeMap::MapType_map;
+
+	Main_Data::game_actors = std::make_unique<Game_Actors>();
+	Main_Data::game_party = std::make_unique<Game_Party>();
+	Game_Map::Init();
+	Main_Data::game_system = std::make_unique<Game_System>();
+	Main_Data::game_switches = std::make_unique<Game_Switches>();
+	Main_Data::game_variables = std::make_unique<Game_Variables>(Game_Variables::min_2k3, Game_Variables::max_2k3);
+	Main_Data::game_pictures = std::make_unique<Game_Pictures>();
+	Main_Data::game_screen = std::make_unique<Game_Screen>();
+	Main_Data::game_player = std::make_unique<Game_Player>();
+	Main_Data::game_player->SetMapId(1);
+
+	auto map = std::make_unique<lcf::rpg::Map>();
+	map->width = map_w;
+	map->height = map_h;
+	map->lower_layer.resize(map_w * map_h);
+	map->upper_layer.resize(map_w * map_h, BLOCK_F);
+
+	// Mix of static and animated tiles
+	for (int i = 0; i < map_w * map_h; ++i) {
+		switch (i % 4) {
+			case 0: map->lower_layer[i] = BLOCK_A + 46; break;
+			case 1: map->lower_layer[i] = BLOCK_C; break;
+			case 2: map->lower_layer[i] = BLOCK_D + 46; break;
+			default: map->lower_layer[i] = BLOCK_E + (i % 96); break;
+		}
+		if (i % 3 == 0) {
+			map->upper_layer[i] = BLOCK_F + 1 + (i % 47);
+		}
+	}
+
+	Game_Map::Setup(std::move(map));
+}
+
+static void BM_TilemapDraw(benchmark::State& state, bool layer_cache, bool scroll) {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	SetupMap();
+
+	Player::screen_width = static_cast<int>(state.range(0));
+	Player::screen_height = static_cast<int>(state.range(1));
+
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	auto chipset = Bitmap::Create(480, 256);
+	chipset->Fill(Color(255, 0, 0, 255));
+	chipset->CheckPixels(Bitmap::Flag_Chipset | Bitmap::Flag_ReadOnly);
+
+	Tilemap tilemap;
+	tilemap.SetWidth(map_w);
+	tilemap.SetHeight(map_h);
+	tilemap.SetChipset(chipset);
+	tilemap.SetMapDataDown(Game_Map::GetMapDataDown());
+	tilemap.SetMapDataUp(Game_Map::GetMapDataUp());
+	tilemap.SetPassableDown(Game_Map::GetPassagesDown());
+	tilemap.SetPassableUp(Game_Map::GetPassagesUp());
+	tilemap.SetLayerCache(layer_cache);
+
+	auto surface = Bitmap::Create(Player::screen_width, Player::screen_height);
+
+	int ox = 0;
+	for (auto _: state) {
+		if (scroll) {
+			ox = (ox + 1) % (map_w * TILE_SIZE);
+			tilemap.SetOx(ox);
+			tilemap.SetOy(ox);
+		}
+		for (auto* drawable: list) {
+			drawable->Draw(*surface);
+		}
+	}
+}
+
+BENCHMARK_CAPTURE(BM_TilemapDraw, per_tile, false, false)->Args({320, 240})->Args({640, 480})->Args({1280, 960});
+BENCHMARK_CAPTURE(BM_TilemapDraw, layer_cache, true, false)->Args({320, 240})->Args({640, 480})->Args({1280, 960});
+BENCHMARK_CAPTURE(BM_TilemapDraw, per_tile_scroll, false, true)->Args({320, 240})->Args({640, 480})->Args({1280, 960});
+BENCHMARK_CAPTURE(BM_TilemapDraw, layer_cache_scroll, true, true)->Args({320, 240})->Args({640, 480})->Args({1280, 960});
+
+BENCHMARK_MAIN();
@@ -1,5 +1,6 @@
 #include <benchmark/benchmark.h>
 #include "game_variables.h"
+#include "variable_kernels.h"
 #include <lcf/data.h>
 
 constexpr int max_vars = 1024; // Keep this a power of 2 so no expensive modulus instructions
@@ -70,41 +71,93 @@ static void BM_VariableMod(benchmark::State& state) {
 
 BENCHMARK(BM_VariableMod);
 
+template <typename F>
+static void BM_VariableRangeOp(benchmark::State& state, F&& op) {
+	const int size = state.range(0);
+	auto v = make(size);
+	int i = 0;
+	for (auto _: state) {
+		op(v, size, i + 1);
+		i = (i + 1) % max_vars;
+	}
+	state.SetItemsProcessed(state.iterations() * size);
+}
+
 static void BM_VariableSetRange(benchmark::State& state) {
-	BM_VariableOp(state, [](auto& v, auto, auto val) { v.SetRange(1, max_vars, val); });
+	BM_VariableRangeOp(state, [](auto& v, int size, auto val) { v.SetRange(1, size, val); });
 }
 
-BENCHMARK(BM_VariableSetRange);
+BENCHMARK(BM_VariableSetRange)->Arg(1000)->Arg(100000);
 
 static void BM_VariableAddRange(benchmark::State& state) {
-	BM_VariableOp(state, [](auto& v, auto, auto val) { v.AddRange(1, max_vars, val); });
+	BM_VariableRangeOp(state, [](auto& v, int size, auto val) { v.AddRange(1, size, val); });
 }
 
-BENCHMARK(BM_VariableAddRange);
+BENCHMARK(BM_VariableAddRange)->Arg(1000)->Arg(100000);
 
 static void BM_VariableSubRange(benchmark::State& state) {
-	BM_VariableOp(state, [](auto& v, auto, auto val) { v.SubRange(1, max_vars, val); });
+	BM_VariableRangeOp(state, [](auto& v, int size, auto val) { v.SubRange(1, size, val); });
 }
 
-BENCHMARK(BM_VariableSubRange);
+BENCHMARK(BM_VariableSubRange)->Arg(1000)->Arg(100000);
 
 static void BM_VariableMultRange(benchmark::State& state) {
-	BM_VariableOp(state, [](auto& v, auto, auto val) { v.MultRange(1, max_vars, val); });
+	BM_VariableRangeOp(state, [](auto& v, int size, auto val) { v.MultRange(1, size, val); });
 }
 
-BENCHMARK(BM_VariableMultRange);
+BENCHMARK(BM_VariableMultRange)->Arg(1000)->Arg(100000);
 
 static void BM_VariableDivRange(benchmark::State& state) {
-	BM_VariableOp(state, [](auto& v, auto, auto val) { v.DivRange(1, max_vars, val); });
+	BM_VariableRangeOp(state, [](auto& v, int size, auto val) { v.DivRange(1, size, val); });
 }
 
-BENCHMARK(BM_VariableDivRange);
+BENCHMARK(BM_VariableDivRange)->Arg(1000)->Arg(100000);
 
 static void BM_VariableModRange(benchmark::State& state) {
-	BM_VariableOp(state, [](auto& v, auto, auto val) { v.ModRange(1, max_vars, val); });
+	BM_VariableRangeOp(state, [](auto& v, int size, auto val) { v.ModRange(1, size, val); });
 }
 
-BENCHMARK(BM_VariableModRange);
+BENCHMARK(BM_VariableModRange)->Arg(1000)->Arg(100000);
+
+static void BM_VariableBitXorRange(benchmark::State& state) {
+	BM_VariableRangeOp(state, [](auto& v, int size, auto val) { v.BitXorRange(1, size, val); });
+}
+
+BENCHMARK(BM_VariableBitXorRange)->Arg(1000)->Arg(100000);
+
+static void BM_VariableKernelsRange(benchmark::State& state, VariableKernels::Variant variant, VariableKernels::Op op) {
+	auto prev_variant = VariableKernels::GetVariant();
+	if (!VariableKernels::SetVariant(variant)) {
+		state.SkipWithError("Variant not supported");
+		return;
+	}
+
+	BM_VariableRangeOp(state, [op](auto& v, int size, auto val) {
+		switch (op) {
+			case VariableKernels::Op::Mult:
+				v.MultRange(1, size, val);
+				break;
+			case VariableKernels::Op::Div:
+				v.DivRange(1, size, val);
+				break;
+			default:
+				v.AddRange(1, size, val);
+				break;
+		}
+	});
+
+	VariableKernels::SetVariant(prev_variant);
+}
+
+BENCHMARK_CAPTURE(BM_VariableKernelsRange, add_scalar, VariableKernels::Variant::Scalar, VariableKernels::Op::Add)->Arg(100000);
+BENCHMARK_CAPTURE(BM_VariableKernelsRange, add_sse41, VariableKernels::Variant::Sse41, VariableKernels::Op::Add)->Arg(100000);
+BENCHMARK_CAPTURE(BM_VariableKernelsRange, add_avx2, VariableKernels::Variant::Avx2, VariableKernels::Op::Add)->Arg(100000);
+BENCHMARK_CAPTURE(BM_VariableKernelsRange, mult_scalar, VariableKernels::Variant::Scalar, VariableKernels::Op::Mult)->Arg(100000);
+BENCHMARK_CAPTURE(BM_VariableKernelsRange, mult_sse41, VariableKernels::Variant::Sse41, VariableKernels::Op::Mult)->Arg(100000);
+BENCHMARK_CAPTURE(BM_VariableKernelsRange, mult_avx2, VariableKernels::Variant::Avx2, VariableKernels::Op::Mult)->Arg(100000);
+BENCHMARK_CAPTURE(BM_VariableKernelsRange, div_scalar, VariableKernels::Variant::Scalar, VariableKernels::Op::Div)->Arg(100000);
+BENCHMARK_CAPTURE(BM_VariableKernelsRange, div_sse41, VariableKernels::Variant::Sse41, VariableKernels::Op::Div)->Arg(100000);
+BENCHMARK_CAPTURE(BM_VariableKernelsRange, div_avx2, VariableKernels::Variant::Avx2, VariableKernels::Op::Div)->Arg(100000);
 
 static void BM_VariableSetRangeVariable(benchmark::State& state) {
 	BM_VariableOp(state, [](auto& v, auto, auto val) { v.SetRangeVariable(1, max_vars, val); });
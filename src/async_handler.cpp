@@ -27,14 +27,17 @@
 #endif
 
 #include "async_handler.h"
+#include "audio_secache.h"
 #include "cache.h"
 #include "filefinder.h"
+#include "game_clock.h"
 #include "memory_management.h"
 #include "output.h"
 #include "player.h"
 #include "main_data.h"
 #include "utils.h"
 #include "transition.h"
+#include "thread_pool.h"
 #include "rand.h"
 
 // When this option is enabled async requests are randomly delayed.
@@ -44,6 +47,8 @@
 namespace {
 	std::unordered_map<std::string, FileRequestAsync> async_requests;
 	std::unordered_map<std::string, std::string> file_mapping;
+	// Requests waiting for a background job
+	std::vector<FileRequestAsync*> worker_requests;
 	int next_id = 0;
 #ifdef EMSCRIPTEN
 	int index_version = 1;
@@ -69,6 +74,29 @@ namespace {
 		return std::make_shared<int>(next_id++);
 	}
 
+#ifndef EMSCRIPTEN
+	bool IsAudioDirectory(std::string_view directory) {
+		return directory == "Music" || directory == "Sound";
+	}
+
+	void UpdateWorkerRequests() {
+		if (worker_requests.empty()) {
+			return;
+		}
+
+		// The listeners can start new requests
+		auto requests = std::move(worker_requests);
+		worker_requests.clear();
+
+		for (auto* request: requests) {
+			request->UpdateProgress();
+			if (!request->IsReady()) {
+				worker_requests.push_back(request);
+			}
+		}
+	}
+#endif
+
 #ifdef EMSCRIPTEN
 	constexpr size_t ASYNC_MAX_RETRY_COUNT{ 16 };
 
@@ -223,6 +251,7 @@ void AsyncHandler::ClearRequests() {
 		}
 	}
 	async_requests.clear();
+	worker_requests.clear();
 }
 
 FileRequestAsync* AsyncHandler::RequestFile(std::string_view folder_name, std::string_view file_name) {
@@ -243,7 +272,51 @@ FileRequestAsync* AsyncHandler::RequestFile(std::string_view file_name) {
 	return RequestFile(".", file_name);
 }
 
+std::shared_future<void> AsyncHandler::Prefetch(std::string_view folder_name, std::string_view file_name) {
+	if (file_name.empty()) {
+		return {};
+	}
+
+#ifdef EMSCRIPTEN
+	// Downloading is already asynchronous
+	RequestFile(folder_name, file_name)->Start();
+	return {};
+#else
+	if (ThreadPool::Global().GetThreadCount() == 0) {
+		// Loading synchronously here is not faster than loading on demand
+		return {};
+	}
+
+	if (!IsAudioDirectory(folder_name)) {
+		return Cache::Prefetch(folder_name, file_name);
+	}
+
+	auto is = (folder_name == "Music") ? FileFinder::OpenMusic(file_name) : FileFinder::OpenSound(file_name);
+	if (!is) {
+		return {};
+	}
+
+	if (folder_name == "Sound" && !EndsWith(file_name, ".link") && !EndsWith(file_name, ".script")) {
+		// Sound effects are decoded completely, this avoids decoding them on the main thread.
+		// Ineluki link and script files are handled by Game_System.
+		return AudioSeCache::Prefetch(std::move(is), file_name);
+	}
+
+	// The audio decoders open the file again, reading it once is enough to avoid disk IO on the main thread
+	auto stream = std::make_shared<Filesystem_Stream::InputStream>(std::move(is));
+	return ThreadPool::Global().Submit([stream]() {
+		std::vector<char> buf(64 * 1024);
+		while (stream->read(buf.data(), buf.size())) {
+		}
+	});
+#endif
+}
+
 bool AsyncHandler::IsFilePending(bool important, bool graphic) {
+#if !defined(EMSCRIPTEN) && !defined(EP_DEBUG_SIMULATE_ASYNC)
+	UpdateWorkerRequests();
+#endif
+
 	for (auto& ap: async_requests) {
 		FileRequestAsync& request = ap.second;
 
@@ -382,6 +455,17 @@ void FileRequestAsync::Start() {
 #  endif
 
 #  ifndef EP_DEBUG_SIMULATE_ASYNC
+	// Graphics requested while the screen is erased and audio are loaded in
+	// the background. Everything else is expected to be available immediately.
+	// In max speed mode the amount of frames spent waiting must be reproducible.
+	if (!Game_Clock::IsMaxSpeed() && ((graphic && important) || IsAudioDirectory(directory))) {
+		worker_job = AsyncHandler::Prefetch(directory, file);
+		if (worker_job.valid()) {
+			worker_requests.push_back(this);
+			return;
+		}
+	}
+
 	DownloadDone(true);
 #  endif
 #endif
@@ -389,11 +473,18 @@ void FileRequestAsync::Start() {
 
 void FileRequestAsync::UpdateProgress() {
 #ifndef EMSCRIPTEN
+#  ifdef EP_DEBUG_SIMULATE_ASYNC
 	// Fake download for testing event handlers
 
 	if (!IsReady() && Rand::ChanceOf(1, 100)) {
 		DownloadDone(true);
 	}
+#  else
+	if (!IsReady() && worker_job.valid() && worker_job.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+		worker_job = {};
+		DownloadDone(true);
+	}
+#  endif
 #endif
 }
 
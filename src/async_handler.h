@@ -19,6 +19,7 @@
 #define EP_ASYNC_HANDLER_H
 
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -69,6 +70,20 @@ namespace AsyncHandler {
 	 */
 	FileRequestAsync* RequestFile(std::string_view file_name);
 
+	/**
+	 * Starts loading a file in the background before it is requested.
+	 * Images are decoded into the Cache, music and sound files are read once
+	 * to warm the file cache of the operating system.
+	 * On Emscripten the download of the file is started.
+	 * Does nothing when the Player is built without background workers.
+	 *
+	 * @param folder_name folder where the file is stored
+	 * @param file_name Name of the file
+	 * @return future that becomes ready when the file was loaded or an
+	 *         invalid future when nothing is loaded in the background.
+	 */
+	std::shared_future<void> Prefetch(std::string_view folder_name, std::string_view file_name);
+
 	/**
 	 * Checks if any file with important-flag hasn't finished downloading yet.
 	 *
@@ -218,6 +233,8 @@ private:
 	std::string directory;
 	std::string file;
 	std::string path;
+	/** Background job that must finish before the request is done (native only) */
+	std::shared_future<void> worker_job;
 	int state = State_DoneFailure;
 	bool important = false;
 	bool graphic = false;
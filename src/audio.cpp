@@ -18,6 +18,7 @@
 // Headers
 #include "audio.h"
 #include "audio_midi.h"
+#include "audio_secache.h"
 #include "system.h"
 #include "baseui.h"
 #include "player.h"
@@ -65,7 +66,7 @@ EmptyAudio::EmptyAudio(const Game_ConfigAudio& cfg) : AudioInterface(cfg) {
 }
 
 AudioInterface::AudioInterface(const Game_ConfigAudio& cfg) : cfg(cfg) {
-
+	AudioSeCache::SetMemoryLimit(static_cast<size_t>(cfg.sound_cache_size.Get()) * 1024 * 1024);
 }
 
 Game_ConfigAudio AudioInterface::GetConfig() const {
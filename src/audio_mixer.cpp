@@ -0,0 +1,441 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "audio_mixer.h"
+#include "cpu_features.h"
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#ifdef EP_SIMD_SSE2
+#  include <emmintrin.h>
+#endif
+#ifdef EP_SIMD_AVX2
+#  include <immintrin.h>
+#endif
+#ifdef EP_SIMD_NEON
+#  include <arm_neon.h>
+#endif
+
+using Format = AudioMixer::Format;
+
+namespace {
+
+/** Dynamic range compression starts above this sample value */
+constexpr float compress_threshold = 0.8f;
+
+constexpr float s8_scale = 1.0f / 128.0f;
+constexpr float s16_scale = 1.0f / 32768.0f;
+constexpr float s32_scale = 1.0f / 2147483648.0f;
+
+/*
+ * Unsigned samples are converted to signed ones by flipping the sign bit.
+ * This way all integer formats share the same code path.
+ */
+constexpr int16_t u16_flip = static_cast<int16_t>(0x8000);
+constexpr int32_t u32_flip = static_cast<int32_t>(0x80000000u);
+
+int SampleSize(Format format) {
+	switch (format) {
+		case Format::S8:
+		case Format::U8:
+			return 1;
+		case Format::S16:
+		case Format::U16:
+			return 2;
+		case Format::S32:
+		case Format::U32:
+		case Format::F32:
+			return 4;
+	}
+	return 1;
+}
+
+template <typename T>
+inline float ToFloat(T sample, T flip) {
+	return static_cast<std::make_signed_t<T>>(static_cast<T>(sample ^ flip));
+}
+
+inline float ToFloat(float sample, float) {
+	return sample;
+}
+
+template <typename T>
+void MixScalar(float* dst, const T* src, int channels, int frames, float vleft, float vright, T flip) {
+	if (channels == 1) {
+		for (int i = 0; i < frames; ++i) {
+			float sample = ToFloat(src[i], flip);
+			dst[i * 2] += sample * vleft;
+			dst[i * 2 + 1] += sample * vright;
+		}
+	} else {
+		for (int i = 0; i < frames; ++i) {
+			const T* frame = src + i * channels;
+			dst[i * 2] += ToFloat(frame[0], flip) * vleft;
+			dst[i * 2 + 1] += ToFloat(frame[1], flip) * vright;
+		}
+	}
+}
+
+inline int16_t ClipSample(float sample, bool compress, float factor) {
+	float value = std::fabs(sample);
+	if (compress && value > compress_threshold) {
+		value = compress_threshold + (value - compress_threshold) * factor;
+	}
+	value = std::min(value * 32768.0f, 32767.0f);
+
+	auto result = static_cast<int16_t>(value);
+	return sample < 0 ? static_cast<int16_t>(-result) : result;
+}
+
+float CompressFactor(float total_volume) {
+	if (total_volume <= 1.0f) {
+		return 1.0f;
+	}
+	return (1.0f - compress_threshold) / (total_volume - compress_threshold);
+}
+
+#ifdef EP_SIMD_SSE2
+namespace Sse2 {
+	inline __m128 Load(const int16_t* src, int16_t flip) {
+		__m128i x = _mm_xor_si128(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src)), _mm_set1_epi16(flip));
+		// Sign extend to 32 bit
+		return _mm_cvtepi32_ps(_mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16));
+	}
+
+	inline __m128 Load(const int32_t* src, int32_t flip) {
+		__m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), _mm_set1_epi32(flip));
+		return _mm_cvtepi32_ps(x);
+	}
+
+	inline __m128 Load(const float* src, float) {
+		return _mm_loadu_ps(src);
+	}
+
+	template <typename T>
+	int Mix(float* dst, const T* src, int channels, int frames, float vleft, float vright, T flip) {
+		int i = 0;
+		if (channels == 2) {
+			const __m128 vol = _mm_setr_ps(vleft, vright, vleft, vright);
+			for (; i + 2 <= frames; i += 2) {
+				float* out = dst + i * 2;
+				__m128 sample = Load(src + i * 2, flip);
+				_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_mul_ps(sample, vol)));
+			}
+		} else {
+			const __m128 vol_l = _mm_set1_ps(vleft);
+			const __m128 vol_r = _mm_set1_ps(vright);
+			for (; i + 4 <= frames; i += 4) {
+				float* out = dst + i * 2;
+				__m128 sample = Load(src + i, flip);
+				__m128 l = _mm_mul_ps(sample, vol_l);
+				__m128 r = _mm_mul_ps(sample, vol_r);
+				_mm_storeu_ps(out, _mm_add_ps(_mm_loadu_ps(out), _mm_unpacklo_ps(l, r)));
+				_mm_storeu_ps(out + 4, _mm_add_ps(_mm_loadu_ps(out + 4), _mm_unpackhi_ps(l, r)));
+			}
+		}
+		return i;
+	}
+
+	inline __m128i Clip(__m128 sample, bool compress, __m128 factor) {
+		const __m128 sign_mask = _mm_set1_ps(-0.0f);
+		const __m128 threshold = _mm_set1_ps(compress_threshold);
+
+		__m128 sign = _mm_and_ps(sample, sign_mask);
+		__m128 value = _mm_andnot_ps(sign_mask, sample);
+		if (compress) {
+			__m128 over = _mm_cmpgt_ps(value, threshold);
+			__m128 compressed = _mm_add_ps(threshold, _mm_mul_ps(_mm_sub_ps(value, threshold), factor));
+			value = _mm_or_ps(_mm_and_ps(over, compressed), _mm_andnot_ps(over, value));
+		}
+		value = _mm_min_ps(_mm_mul_ps(value, _mm_set1_ps(32768.0f)), _mm_set1_ps(32767.0f));
+		return _mm_cvttps_epi32(_mm_or_ps(value, sign));
+	}
+
+	int ClipAndPack(int16_t* dst, const float* src, int samples, bool compress, float factor) {
+		const __m128 vfactor = _mm_set1_ps(factor);
+		int i = 0;
+		for (; i + 8 <= samples; i += 8) {
+			__m128i lo = Clip(_mm_loadu_ps(src + i), compress, vfactor);
+			__m128i hi = Clip(_mm_loadu_ps(src + i + 4), compress, vfactor);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packs_epi32(lo, hi));
+		}
+		return i;
+	}
+}
+#endif
+
+#ifdef EP_SIMD_AVX2
+namespace Avx2 {
+	EP_TARGET_AVX2 inline __m256 Load(const int16_t* src, int16_t flip) {
+		__m128i x = _mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src)), _mm_set1_epi16(flip));
+		return _mm256_cvtepi32_ps(_mm256_cvtepi16_epi32(x));
+	}
+
+	EP_TARGET_AVX2 inline __m256 Load(const int32_t* src, int32_t flip) {
+		__m256i x = _mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(src)), _mm256_set1_epi32(flip));
+		return _mm256_cvtepi32_ps(x);
+	}
+
+	EP_TARGET_AVX2 inline __m256 Load(const float* src, float) {
+		return _mm256_loadu_ps(src);
+	}
+
+	template <typename T>
+	EP_TARGET_AVX2 int Mix(float* dst, const T* src, int channels, int frames, float vleft, float vright, T flip) {
+		int i = 0;
+		if (channels == 2) {
+			const __m256 vol = _mm256_setr_ps(vleft, vright, vleft, vright, vleft, vright, vleft, vright);
+			for (; i + 4 <= frames; i += 4) {
+				float* out = dst + i * 2;
+				__m256 sample = Load(src + i * 2, flip);
+				_mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out), _mm256_mul_ps(sample, vol)));
+			}
+		} else {
+			const __m256 vol_l = _mm256_set1_ps(vleft);
+			const __m256 vol_r = _mm256_set1_ps(vright);
+			for (; i + 8 <= frames; i += 8) {
+				float* out = dst + i * 2;
+				__m256 sample = Load(src + i, flip);
+				__m256 l = _mm256_mul_ps(sample, vol_l);
+				__m256 r = _mm256_mul_ps(sample, vol_r);
+				// unpack works per 128 bit lane, restore the order afterwards
+				__m256 lo = _mm256_unpacklo_ps(l, r);
+				__m256 hi = _mm256_unpackhi_ps(l, r);
+				_mm256_storeu_ps(out, _mm256_add_ps(_mm256_loadu_ps(out), _mm256_permute2f128_ps(lo, hi, 0x20)));
+				_mm256_storeu_ps(out + 8, _mm256_add_ps(_mm256_loadu_ps(out + 8), _mm256_permute2f128_ps(lo, hi, 0x31)));
+			}
+		}
+		return i;
+	}
+
+	EP_TARGET_AVX2 inline __m256i Clip(__m256 sample, bool compress, __m256 factor) {
+		const __m256 sign_mask = _mm256_set1_ps(-0.0f);
+		const __m256 threshold = _mm256_set1_ps(compress_threshold);
+
+		__m256 sign = _mm256_and_ps(sample, sign_mask);
+		__m256 value = _mm256_andnot_ps(sign_mask, sample);
+		if (compress) {
+			__m256 over = _mm256_cmp_ps(value, threshold, _CMP_GT_OQ);
+			__m256 compressed = _mm256_add_ps(threshold, _mm256_mul_ps(_mm256_sub_ps(value, threshold), factor));
+			value = _mm256_blendv_ps(value, compressed, over);
+		}
+		value = _mm256_min_ps(_mm256_mul_ps(value, _mm256_set1_ps(32768.0f)), _mm256_set1_ps(32767.0f));
+		return _mm256_cvttps_epi32(_mm256_or_ps(value, sign));
+	}
+
+	EP_TARGET_AVX2 int ClipAndPack(int16_t* dst, const float* src, int samples, bool compress, float factor) {
+		const __m256 vfactor = _mm256_set1_ps(factor);
+		int i = 0;
+		for (; i + 16 <= samples; i += 16) {
+			__m256i lo = Clip(_mm256_loadu_ps(src + i), compress, vfactor);
+			__m256i hi = Clip(_mm256_loadu_ps(src + i + 8), compress, vfactor);
+			// pack works per 128 bit lane, restore the order afterwards
+			__m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+		}
+		return i;
+	}
+
+	EP_TARGET_AVX2 int Mix(float* dst, const void* src, Format format, int channels, int frames, float vleft, float vright) {
+		switch (format) {
+			case Format::S16:
+			case Format::U16:
+				return Mix(dst, static_cast<const int16_t*>(src), channels, frames, vleft * s16_scale, vright * s16_scale,
+					format == Format::U16 ? u16_flip : int16_t(0));
+			case Format::S32:
+			case Format::U32:
+				return Mix(dst, static_cast<const int32_t*>(src), channels, frames, vleft * s32_scale, vright * s32_scale,
+					format == Format::U32 ? u32_flip : int32_t(0));
+			case Format::F32:
+				return Mix(dst, static_cast<const float*>(src), channels, frames, vleft, vright, 0.0f);
+			default:
+				return 0;
+		}
+	}
+}
+#endif
+
+#ifdef EP_SIMD_NEON
+namespace Neon {
+	inline float32x4_t Load(const int16_t* src, int16_t flip) {
+		int16x4_t x = veor_s16(vld1_s16(src), vdup_n_s16(flip));
+		return vcvtq_f32_s32(vmovl_s16(x));
+	}
+
+	inline float32x4_t Load(const int32_t* src, int32_t flip) {
+		return vcvtq_f32_s32(veorq_s32(vld1q_s32(src), vdupq_n_s32(flip)));
+	}
+
+	inline float32x4_t Load(const float* src, float) {
+		return vld1q_f32(src);
+	}
+
+	template <typename T>
+	int Mix(float* dst, const T* src, int channels, int frames, float vleft, float vright, T flip) {
+		int i = 0;
+		if (channels == 2) {
+			const float vol_lr[4] = { vleft, vright, vleft, vright };
+			const float32x4_t vol = vld1q_f32(vol_lr);
+			for (; i + 2 <= frames; i += 2) {
+				float* out = dst + i * 2;
+				float32x4_t sample = Load(src + i * 2, flip);
+				vst1q_f32(out, vaddq_f32(vld1q_f32(out), vmulq_f32(sample, vol)));
+			}
+		} else {
+			for (; i + 4 <= frames; i += 4) {
+				float* out = dst + i * 2;
+				float32x4_t sample = Load(src + i, flip);
+				float32x4x2_t lr = vzipq_f32(vmulq_n_f32(sample, vleft), vmulq_n_f32(sample, vright));
+				vst1q_f32(out, vaddq_f32(vld1q_f32(out), lr.val[0]));
+				vst1q_f32(out + 4, vaddq_f32(vld1q_f32(out + 4), lr.val[1]));
+			}
+		}
+		return i;
+	}
+
+	inline int32x4_t Clip(float32x4_t sample, bool compress, float32x4_t factor) {
+		const float32x4_t threshold = vdupq_n_f32(compress_threshold);
+
+		uint32x4_t negative = vcltq_f32(sample, vdupq_n_f32(0.0f));
+		float32x4_t value = vabsq_f32(sample);
+		if (compress) {
+			uint32x4_t over = vcgtq_f32(value, threshold);
+			float32x4_t compressed = vaddq_f32(threshold, vmulq_f32(vsubq_f32(value, threshold), factor));
+			value = vbslq_f32(over, compressed, value);
+		}
+		value = vminq_f32(vmulq_n_f32(value, 32768.0f), vdupq_n_f32(32767.0f));
+		int32x4_t result = vcvtq_s32_f32(value);
+		return vbslq_s32(negative, vnegq_s32(result), result);
+	}
+
+	int ClipAndPack(int16_t* dst, const float* src, int samples, bool compress, float factor) {
+		const float32x4_t vfactor = vdupq_n_f32(factor);
+		int i = 0;
+		for (; i + 8 <= samples; i += 8) {
+			int32x4_t lo = Clip(vld1q_f32(src + i), compress, vfactor);
+			int32x4_t hi = Clip(vld1q_f32(src + i + 4), compress, vfactor);
+			vst1q_s16(dst + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+		}
+		return i;
+	}
+}
+#endif
+
+#if defined(EP_SIMD_SSE2) || defined(EP_SIMD_NEON)
+#  ifdef EP_SIMD_SSE2
+namespace Simd = Sse2;
+#  else
+namespace Simd = Neon;
+#  endif
+
+int MixSimd(float* dst, const void* src, Format format, int channels, int frames, float vleft, float vright) {
+	switch (format) {
+		case Format::S16:
+		case Format::U16:
+			return Simd::Mix(dst, static_cast<const int16_t*>(src), channels, frames, vleft * s16_scale, vright * s16_scale,
+				format == Format::U16 ? u16_flip : int16_t(0));
+		case Format::S32:
+		case Format::U32:
+			return Simd::Mix(dst, static_cast<const int32_t*>(src), channels, frames, vleft * s32_scale, vright * s32_scale,
+				format == Format::U32 ? u32_flip : int32_t(0));
+		case Format::F32:
+			return Simd::Mix(dst, static_cast<const float*>(src), channels, frames, vleft, vright, 0.0f);
+		default:
+			// 8 bit samples are rare, the scalar code is good enough
+			return 0;
+	}
+}
+#endif
+
+} // anonymous namespace
+
+void AudioMixer::Mix(float* dst, const void* src, Format format, int channels, int frames, float vleft, float vright) {
+	int done = 0;
+
+	if (channels == 1 || channels == 2) {
+#if defined(EP_SIMD_AVX2)
+		if (CpuFeatures::HasAvx2()) {
+			done = Avx2::Mix(dst, src, format, channels, frames, vleft, vright);
+		} else {
+			done = MixSimd(dst, src, format, channels, frames, vleft, vright);
+		}
+#elif defined(EP_SIMD_SSE2) || defined(EP_SIMD_NEON)
+		done = MixSimd(dst, src, format, channels, frames, vleft, vright);
+#endif
+	}
+
+	if (done < frames) {
+		// Remaining frames that do not fill a whole vector
+		const auto* rest = static_cast<const uint8_t*>(src) + done * channels * SampleSize(format);
+		Scalar::Mix(dst + done * 2, rest, format, channels, frames - done, vleft, vright);
+	}
+}
+
+void AudioMixer::ClipAndPack(int16_t* dst, const float* src, int samples, float total_volume) {
+	int done = 0;
+
+#if defined(EP_SIMD_AVX2)
+	if (CpuFeatures::HasAvx2()) {
+		done = Avx2::ClipAndPack(dst, src, samples, total_volume > 1.0f, CompressFactor(total_volume));
+	} else {
+		done = Sse2::ClipAndPack(dst, src, samples, total_volume > 1.0f, CompressFactor(total_volume));
+	}
+#elif defined(EP_SIMD_SSE2) || defined(EP_SIMD_NEON)
+	done = Simd::ClipAndPack(dst, src, samples, total_volume > 1.0f, CompressFactor(total_volume));
+#endif
+
+	if (done < samples) {
+		Scalar::ClipAndPack(dst + done, src + done, samples - done, total_volume);
+	}
+}
+
+void AudioMixer::Scalar::Mix(float* dst, const void* src, Format format, int channels, int frames, float vleft, float vright) {
+	switch (format) {
+		case Format::S8:
+			MixScalar(dst, static_cast<const int8_t*>(src), channels, frames, vleft * s8_scale, vright * s8_scale, int8_t(0));
+			break;
+		case Format::U8:
+			MixScalar(dst, static_cast<const uint8_t*>(src), channels, frames, vleft * s8_scale, vright * s8_scale, uint8_t(0x80));
+			break;
+		case Format::S16:
+			MixScalar(dst, static_cast<const int16_t*>(src), channels, frames, vleft * s16_scale, vright * s16_scale, int16_t(0));
+			break;
+		case Format::U16:
+			MixScalar(dst, static_cast<const uint16_t*>(src), channels, frames, vleft * s16_scale, vright * s16_scale, uint16_t(0x8000));
+			break;
+		case Format::S32:
+			MixScalar(dst, static_cast<const int32_t*>(src), channels, frames, vleft * s32_scale, vright * s32_scale, int32_t(0));
+			break;
+		case Format::U32:
+			MixScalar(dst, static_cast<const uint32_t*>(src), channels, frames, vleft * s32_scale, vright * s32_scale, uint32_t(0x80000000u));
+			break;
+		case Format::F32:
+			MixScalar(dst, static_cast<const float*>(src), channels, frames, vleft, vright, 0.0f);
+			break;
+	}
+}
+
+void AudioMixer::Scalar::ClipAndPack(int16_t* dst, const float* src, int samples, float total_volume) {
+	const bool compress = total_volume > 1.0f;
+	const float factor = CompressFactor(total_volume);
+
+	for (int i = 0; i < samples; ++i) {
+		dst[i] = ClipSample(src[i], compress, factor);
+	}
+}
@@ -0,0 +1,70 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_AUDIO_MIXER_H
+#define EP_AUDIO_MIXER_H
+
+// Headers
+#include <cstdint>
+#include "audio_decoder_base.h"
+
+/**
+ * Sample conversion and mixing kernels used by GenericAudio.
+ *
+ * The functions use SSE2, AVX2 or NEON when available and fall back to the
+ * scalar implementation otherwise.
+ */
+namespace AudioMixer {
+	using Format = AudioDecoderBase::Format;
+
+	/**
+	 * Converts interleaved samples to float, applies the volume and adds
+	 * them to an interleaved stereo buffer.
+	 * Mono samples are added to both sides.
+	 *
+	 * @param dst stereo buffer, must hold 2 * frames floats
+	 * @param src samples
+	 * @param format sample format of src
+	 * @param channels channels per frame of src, only the first two are mixed
+	 * @param frames number of frames in src
+	 * @param vleft volume of the left side (1.0 = unchanged)
+	 * @param vright volume of the right side (1.0 = unchanged)
+	 */
+	void Mix(float* dst, const void* src, Format format, int channels, int frames, float vleft, float vright);
+
+	/**
+	 * Converts mixed float samples to signed 16 bit.
+	 * When the sum of the channel volumes exceeds 1.0 samples above a threshold
+	 * are compressed to reduce clipping. The result is saturated.
+	 *
+	 * @param dst output buffer
+	 * @param src mixed samples
+	 * @param samples number of samples
+	 * @param total_volume sum of the volumes of all mixed channels
+	 */
+	void ClipAndPack(int16_t* dst, const float* src, int samples, float total_volume);
+
+	/**
+	 * Reference implementations without SIMD.
+	 */
+	namespace Scalar {
+		void Mix(float* dst, const void* src, Format format, int channels, int frames, float vleft, float vright);
+		void ClipAndPack(int16_t* dst, const float* src, int samples, float total_volume);
+	}
+}
+
+#endif
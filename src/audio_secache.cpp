@@ -18,61 +18,121 @@
 // Headers
 #include <cassert>
 #include <cstring>
+#include <list>
 #include <map>
 #include <memory>
-#include <set>
 #include "audio_resampler.h"
 #include "audio_secache.h"
-#include "game_clock.h"
 #include "filefinder.h"
 #include "output.h"
-
-using namespace std::chrono_literals;
+#include "thread_pool.h"
 
 namespace {
-	typedef std::map<std::string, AudioSeRef> cache_type;
+	struct CacheItem {
+		AudioSeRef se;
+		std::list<std::string>::iterator lru;
+	};
+
+	typedef std::map<std::string, CacheItem, std::less<>> cache_type;
 
 	cache_type cache;
 
-	constexpr int cache_limit = 3 * 1024 * 1024;
-	int cache_size = 0;
+	// Names of the cached samples, most recently used first
+	std::list<std::string> lru;
+
+	size_t cache_limit = 3 * 1024 * 1024;
+	size_t cache_size = 0;
+
+	struct PrefetchItem {
+		std::shared_future<void> done;
+		std::shared_ptr<AudioSeRef> se;
+	};
+
+	std::map<std::string, PrefetchItem, std::less<>> prefetch_items;
+
+	AudioSeRef DecodeSe(AudioDecoderBase& decoder) {
+		auto se = std::make_shared<AudioSeData>();
+		decoder.GetFormat(se->frequency, se->format, se->channels);
+		se->buffer = decoder.DecodeAll();
+		return se;
+	}
+
+	void Touch(CacheItem& item) {
+		lru.splice(lru.begin(), lru, item.lru);
+	}
 
 	void FreeCacheMemory() {
-		auto cur_time = Game_Clock::GetFrameTime();
+		for (auto it = lru.end(); it != lru.begin() && cache_size > cache_limit; ) {
+			--it;
 
-		for (auto it = cache.begin(); it != cache.end(); ) {
-			if (it->second.use_count() > 1) {
-				// SE is currently playing
-				++it;
-				continue;
-			}
+			auto cit = cache.find(*it);
+			assert(cit != cache.end());
 
-			if (cache_size <= cache_limit && cur_time - it->second->last_access < 3s) {
-				// Below memory limit and last access < 3s
-				++it;
+			if (cit->second.se.use_count() > 1) {
+				// SE is currently playing
 				continue;
 			}
 
 #ifdef CACHE_DEBUG
-			Output::Debug("SE: Freeing memory of {}", it->first);
+			Output::Debug("SE: Freeing memory of {}", cit->first);
 #endif
 
-			cache_size -= it->second->buffer.size();
-
-			it = cache.erase(it);
+			cache_size -= cit->second.se->buffer.size();
+			cache.erase(cit);
+			it = lru.erase(it);
 		}
 
 #ifdef CACHE_DEBUG
 		Output::Debug("SE cache size: {}", cache_size / 1024.0 / 1024);
 #endif
 	}
+
+	void AddToCache(std::string_view name, AudioSeRef se) {
+		if (cache.find(name) != cache.end()) {
+			return;
+		}
+
+		lru.emplace_front(name);
+		cache.emplace(std::string(name), CacheItem{ se, lru.begin() });
+		cache_size += se->buffer.size();
+
+#ifdef CACHE_DEBUG
+		Output::Debug("SE cache size (Add): {}", cache_size / 1024.0 / 1024.0);
+#endif
+
+		FreeCacheMemory();
+	}
+
+	/**
+	 * Moves the samples decoded by the worker into the cache.
+	 *
+	 * @param wait_for SE to wait for when it is still decoding
+	 */
+	void CollectPrefetched(std::string_view wait_for = {}) {
+		for (auto it = prefetch_items.begin(); it != prefetch_items.end(); ) {
+			auto& item = it->second;
+			if (it->first == wait_for) {
+				item.done.wait();
+			} else if (item.done.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+				++it;
+				continue;
+			}
+
+			if (*item.se) {
+				AddToCache(it->first, std::move(*item.se));
+			}
+			it = prefetch_items.erase(it);
+		}
+	}
 }
 
 std::unique_ptr<AudioSeCache> AudioSeCache::Create(Filesystem_Stream::InputStream stream, std::string_view name) {
 	auto se = std::make_unique<AudioSeCache>();
 	se->name = ToString(name);
 
-	auto const it = cache.find(ToString(name));
+	CollectPrefetched(name);
+
+	auto const it = cache.find(name);
 	if (it == cache.end()) {
 		// Not in cache
 		if (!stream) {
@@ -108,14 +168,15 @@ void AudioSeCache::GetFormat(int& frequency, AudioDecoder::Format& format, int&
 }
 
 std::unique_ptr<AudioSeCache> AudioSeCache::GetCachedSe(std::string_view name) {
-	auto se = std::make_unique<AudioSeCache>();
-	se->name = ToString(name);
+	CollectPrefetched(name);
 
-	auto const it = cache.find(se->name);
+	auto const it = cache.find(name);
 	if (it == cache.end()) {
 		return {};
 	}
 
+	auto se = std::make_unique<AudioSeCache>();
+	se->name = ToString(name);
 	return se;
 }
 
@@ -123,9 +184,9 @@ bool AudioSeCache::GetCachedFormat(int& frequency, AudioDecoder::Format& format,
 	cache_type::const_iterator it = cache.find(name);
 
 	if (it != cache.end()) {
-		frequency = (*it).second->frequency;
-		format = (*it).second->format;
-		channels = (*it).second->channels;
+		frequency = it->second.se->frequency;
+		format = it->second.se->format;
+		channels = it->second.se->channels;
 
 		return true;
 	}
@@ -138,58 +199,92 @@ std::unique_ptr<AudioDecoderBase> AudioSeCache::CreateSeDecoder() {
 
 	auto it = cache.find(name);
 	if (it != cache.end()) {
-		se = it->second;
-		se->last_access = Game_Clock::GetFrameTime();
+		se = it->second.se;
+		Touch(it->second);
+	} else {
+		// Not cached yet: Decode the sample without any resampling
+		assert(audio_decoder);
+
+		se = DecodeSe(*audio_decoder);
+		AddToCache(name, se);
+	}
 
-		std::unique_ptr<AudioDecoderBase> dec = std::make_unique<AudioSeDecoder>(se);
+	std::unique_ptr<AudioDecoderBase> dec = std::make_unique<AudioSeDecoder>(se);
 #ifdef USE_AUDIO_RESAMPLER
-		dec = std::make_unique<AudioResampler>(std::move(dec));
+	dec = std::make_unique<AudioResampler>(std::move(dec));
 #endif
-		Filesystem_Stream::InputStream is;
-		dec->Open(std::move(is));
-		return dec;
+	Filesystem_Stream::InputStream is;
+	dec->Open(std::move(is));
+	return dec;
+}
+
+AudioSeRef AudioSeCache::GetSeData() const {
+	auto it = cache.find(name);
+	assert(it != cache.end());
+
+	return it->second.se;
+};
+
+std::shared_future<void> AudioSeCache::Prefetch(Filesystem_Stream::InputStream stream, std::string_view name) {
+	CollectPrefetched();
+
+	if (!stream || cache.find(name) != cache.end()) {
+		return {};
 	}
 
-	// Not cached yet: Decode the sample without any resampling
+	auto it = prefetch_items.find(name);
+	if (it != prefetch_items.end()) {
+		return it->second.done;
+	}
 
-	if (!se) {
-		se.reset(new AudioSeData());
+	char magic[4] = { 0 };
+	if (!stream.ReadIntoObj(magic)) {
+		return {};
 	}
+	stream.seekg(0, std::ios::beg);
 
-	assert(audio_decoder);
+	if (!strncmp(magic, "MThd", 4)) {
+		// Decoded on demand by the game thread
+		return {};
+	}
 
-	audio_decoder->GetFormat(se->frequency, se->format, se->channels);
-	se->buffer = audio_decoder->DecodeAll();
+	// Some decoder libraries are initialized by the constructor, this is not thread-safe
+	std::shared_ptr<AudioDecoderBase> decoder = AudioDecoder::Create(stream, false);
+	if (!decoder) {
+		return {};
+	}
 
-	cache.insert(std::make_pair(name, se));
+	auto is = std::make_shared<Filesystem_Stream::InputStream>(std::move(stream));
+	auto se = std::make_shared<AudioSeRef>();
 
-	cache_size += se->buffer.size();
+	auto done = ThreadPool::Global().Submit([decoder, is, se]() {
+		if (decoder->Open(std::move(*is))) {
+			*se = DecodeSe(*decoder);
+		}
+	});
 
-#ifdef CACHE_DEBUG
-	Output::Debug("SE cache size (Add): {}", cache_size / 1024.0 / 1024.0);
-#endif
+	prefetch_items.emplace(ToString(name), PrefetchItem{ done, se });
+	return done;
+}
 
+void AudioSeCache::SetMemoryLimit(size_t limit) {
+	cache_limit = limit;
 	FreeCacheMemory();
-
-	std::unique_ptr<AudioDecoderBase> dec = std::unique_ptr<AudioDecoderBase>(new AudioSeDecoder(se));
-#ifdef USE_AUDIO_RESAMPLER
-	dec = std::unique_ptr<AudioDecoderBase>(new AudioResampler(std::move(dec)));
-#endif
-	Filesystem_Stream::InputStream is;
-	dec->Open(std::move(is));
-	return dec;
 }
 
-AudioSeRef AudioSeCache::GetSeData() const {
-	auto it = cache.find(name);
-	assert(it != cache.end());
+size_t AudioSeCache::GetMemoryLimit() {
+	return cache_limit;
+}
 
-	return it->second;
-};
+size_t AudioSeCache::GetMemoryUsage() {
+	return cache_size;
+}
 
 void AudioSeCache::Clear() {
 	cache_size = 0;
 	cache.clear();
+	lru.clear();
+	prefetch_items.clear();
 }
 
 std::string_view AudioSeCache::GetName() const {
@@ -198,7 +293,6 @@ std::string_view AudioSeCache::GetName() const {
 
 AudioSeDecoder::AudioSeDecoder(const AudioSeRef& se) :
 	se(se) {
-	se->last_access = Game_Clock::GetFrameTime();
 }
 
 bool AudioSeDecoder::IsFinished() const {
@@ -20,13 +20,12 @@
 
 // Headers
 #include <cstdio>
+#include <future>
 #include <string>
 #include <vector>
 #include <memory>
-#include <map>
 
 #include "audio_decoder.h"
-#include "game_clock.h"
 
 class AudioSeCache;
 
@@ -36,7 +35,6 @@ class AudioSeCache;
 class AudioSeData {
 public:
 	std::vector<uint8_t> buffer;
-	Game_Clock::time_point last_access;
 	int frequency;
 	AudioDecoder::Format format;
 	int channels;
@@ -70,8 +68,10 @@ private:
  * AudioSeCache provides an interface for accessing sound effects.
  * It also provides an automatic cache management, any SE is only decoded
  * once, otherwise returned from the cache.
- * The cache is flushed from recently (>10 seconds by default) unused
- * samples when it reaches the memory limit (5 MB by default).
+ * When the decoded samples exceed the memory limit (3 MB by default) the
+ * least recently used samples that are not playing are freed.
+ * Sound effects can be decoded in advance by a worker thread to avoid
+ * decoding them on the game thread when they are played the first time.
  * Uses an internal AudioDecoder for handling the decoding.
  */
 class AudioSeCache {
@@ -137,6 +137,31 @@ public:
 	 */
 	std::string_view GetName() const;
 
+	/**
+	 * Decodes a sound effect in a worker thread and adds it to the cache.
+	 * Does nothing when the SE is already cached or being decoded.
+	 * MIDI files are skipped, the MIDI decoders are not thread-safe.
+	 *
+	 * @param stream Stream to the audio file
+	 * @param name Name for the cache entry
+	 * @return future that becomes ready when decoding finished, invalid when nothing is decoded
+	 */
+	static std::shared_future<void> Prefetch(Filesystem_Stream::InputStream stream, std::string_view name);
+
+	/**
+	 * Sets the maximum amount of memory used by decoded samples.
+	 * Samples that are currently playing are never freed.
+	 *
+	 * @param limit memory limit in bytes
+	 */
+	static void SetMemoryLimit(size_t limit);
+
+	/** @return memory limit in bytes */
+	static size_t GetMemoryLimit();
+
+	/** @return memory used by decoded samples in bytes */
+	static size_t GetMemoryUsage();
+
 	static void Clear();
 private:
 	std::unique_ptr<AudioDecoderBase> audio_decoder;
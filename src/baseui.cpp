@@ -18,6 +18,7 @@
 // Headers
 #include "baseui.h"
 #include "bitmap.h"
+#include "headless_ui.h"
 #include "player.h"
 
 #if USE_SDL==3
@@ -39,6 +40,10 @@
 std::shared_ptr<BaseUi> DisplayUi;
 
 std::shared_ptr<BaseUi> BaseUi::CreateUi(long width, long height, const Game_Config& cfg) {
+	if (Player::headless_flag) {
+		return std::make_shared<HeadlessUi>(width, height, cfg, Player::hash_surface_interval);
+	}
+
 #if USE_SDL==3
 	return std::make_shared<Sdl3Ui>(width, height, cfg);
 #elif USE_SDL==2
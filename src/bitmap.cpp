@@ -37,9 +37,12 @@
 #include "font.h"
 #include "output.h"
 #include "util_macro.h"
-#include "bitmap_hslrgb.h"
+#include "pixel_kernels.h"
 #include <iostream>
 
+/** Working area of the tone and flash EffectsBlit, recreated when the pixel format changes */
+static BitmapRef effects_scratch;
+
 BitmapRef Bitmap::Create(int width, int height, const Color& color) {
 	BitmapRef surface = Bitmap::Create(width, height, true);
 	surface->Fill(color);
@@ -90,6 +93,164 @@ Bitmap::Bitmap(void *pixels, int width, int height, int pitch, const DynamicForm
 	Init(width, height, pixels, pitch, false);
 }
 
+class Bitmap::RowWriter final : public ImageRowOut {
+public:
+	RowWriter(Bitmap& bitmap, bool transparent, uint32_t flags) :
+		bitmap(bitmap), img_format(transparent ? image_format : opaque_image_format), flags(flags) {}
+
+	bool Begin(int width, int height, int bpp) override;
+	void WriteRow(int y, uint8_t* pixels) override;
+
+	/**
+	 * Writes a completely decoded image and frees its pixels.
+	 *
+	 * @param image decoded image.
+	 */
+	void Write(ImageOut& image);
+
+	/**
+	 * Stores the opacity calculated while writing the rows.
+	 *
+	 * @return flags which must still be handled by CheckPixels.
+	 */
+	uint32_t Finish();
+
+	/** Bpp of the source image */
+	int bpp = 0;
+
+private:
+	/** Opacity of a range of pixels as a bit set, combined with & */
+	enum OpacityBits : uint8_t {
+		Op_Transparent = 1,
+		Op_Opaque = 2,
+		Op_1Bit = 4,
+		Op_All = 7
+	};
+
+	static ImageOpacity ToImageOpacity(uint8_t op) {
+		return
+			(op & Op_Transparent) ? ImageOpacity::Transparent :
+			(op & Op_Opaque) ? ImageOpacity::Opaque :
+			(op & Op_1Bit) ? ImageOpacity::Alpha_1Bit :
+			ImageOpacity::Alpha_8Bit;
+	}
+
+	Bitmap& bitmap;
+	const DynamicFormat& img_format;
+	uint32_t flags;
+
+	/** Pixels are packed by us instead of pixman */
+	bool direct = false;
+	int rows = 0;
+	int tile_rows = 0;
+	uint8_t image_op = Op_All;
+	std::vector<uint8_t> tile_op;
+};
+
+bool Bitmap::RowWriter::Begin(int width, int height, int bpp) {
+	this->bpp = bpp;
+	bitmap.Init(width, height, nullptr);
+
+	// The common 32 bit formats are packed directly and the opacity is
+	// calculated on the way. Other formats are converted by pixman and
+	// CheckPixels calculates the opacity afterwards.
+	const auto& format = bitmap.format;
+	direct = format.bits == 32 && format.alpha_type == PF::Alpha &&
+		format.r.bits == 8 && format.g.bits == 8 && format.b.bits == 8 && format.a.bits == 8;
+
+	if (direct && (flags & Flag_Chipset)) {
+		tile_rows = height / TILE_SIZE;
+		bitmap.tile_opacity = TileOpacity(width / TILE_SIZE, tile_rows);
+		tile_op.assign(width / TILE_SIZE, Op_All);
+	}
+
+	return true;
+}
+
+void Bitmap::RowWriter::WriteRow(int y, uint8_t* pixels) {
+	const int width = bitmap.width();
+	++rows;
+
+	// Skip alpha calculation for 32x32 system background graphic
+	const int preserve = ((flags & Flag_SystemBgPreserveColor) && y < 32) ? std::min(width, 32) : 0;
+
+	if (!direct) {
+		uint8_t* p = pixels + preserve * 4;
+		for (int x = preserve; x < width; ++x, p += 4) {
+			MultiplyAlpha(p[0], p[1], p[2], p[3]);
+		}
+
+		Bitmap src(pixels, width, 1, 0, img_format);
+		bitmap.BlitFast(0, y, src, src.GetRect(), Opacity::Opaque());
+		return;
+	}
+
+	const auto& format = bitmap.format;
+	auto* dst = reinterpret_cast<uint32_t*>(reinterpret_cast<uint8_t*>(bitmap.pixels()) + y * bitmap.pitch());
+	const bool in_tile = y < tile_rows * TILE_SIZE;
+
+	for (int x0 = 0, tx = 0; x0 < width; x0 += TILE_SIZE, ++tx) {
+		const int x1 = std::min(x0 + TILE_SIZE, width);
+		uint8_t op = Op_All;
+
+		for (int x = x0; x < x1; ++x) {
+			const uint8_t* p = pixels + x * 4;
+			uint8_t r = p[0];
+			uint8_t g = p[1];
+			uint8_t b = p[2];
+			const uint8_t a = p[3];
+			if (x >= preserve) {
+				MultiplyAlpha(r, g, b, a);
+			}
+
+			dst[x] = (uint32_t)r << format.r.shift | (uint32_t)g << format.g.shift |
+				(uint32_t)b << format.b.shift | (uint32_t)a << format.a.shift;
+			op &= (a == 0) ? (Op_Transparent | Op_1Bit) : (a == 255) ? (Op_Opaque | Op_1Bit) : 0;
+		}
+
+		image_op &= op;
+		if (in_tile && tx < static_cast<int>(tile_op.size())) {
+			tile_op[tx] &= op;
+		}
+	}
+
+	if (in_tile && (y + 1) % TILE_SIZE == 0) {
+		const int ty = y / TILE_SIZE;
+		for (int tx = 0; tx < static_cast<int>(tile_op.size()); ++tx) {
+			bitmap.tile_opacity.Set(tx, ty, ToImageOpacity(tile_op[tx]));
+			tile_op[tx] = Op_All;
+		}
+	}
+}
+
+void Bitmap::RowWriter::Write(ImageOut& image) {
+	if (Begin(image.width, image.height, image.bpp)) {
+		for (int y = 0; y < image.height; ++y) {
+			WriteRow(y, static_cast<uint8_t*>(image.pixels) + y * image.width * 4);
+		}
+	}
+
+	free(image.pixels);
+	image.pixels = nullptr;
+}
+
+uint32_t Bitmap::RowWriter::Finish() {
+	// The decoder stopped early: Calculate the opacity from the bitmap
+	if (!direct || rows != bitmap.height()) {
+		return flags;
+	}
+
+	uint32_t remaining = flags & ~Flag_Chipset;
+
+	if (flags & Flag_ReadOnly) {
+		bitmap.read_only = true;
+		bitmap.image_opacity = ToImageOpacity(image_op);
+		remaining &= ~Flag_ReadOnly;
+	}
+
+	return remaining;
+}
+
 Bitmap::Bitmap(Filesystem_Stream::InputStream stream, bool transparent, uint32_t flags) {
 	format = (transparent ? pixel_format : opaque_pixel_format);
 	pixman_format = find_format(format);
@@ -100,6 +261,7 @@ Bitmap::Bitmap(Filesystem_Stream::InputStream stream, bool transparent, uint32_t
 	}
 
 	ImageOut image_out;
+	RowWriter writer(*this, transparent, flags);
 
 	uint8_t data[4] = {};
 	size_t bytes = stream.read(reinterpret_cast<char*>(data),  4).gcount();
@@ -112,22 +274,27 @@ Bitmap::Bitmap(Filesystem_Stream::InputStream stream, bool transparent, uint32_t
 	} else if (bytes > 2 && strncmp((char*)data, "BM", 2) == 0) {
 		img_okay = ImageBMP::Read(stream, transparent, image_out);
 	} else if (bytes >= 4 && strncmp((char*)(data + 1), "PNG", 3) == 0) {
-		img_okay = ImagePNG::Read(stream, transparent, image_out);
+		img_okay = ImagePNG::Read(stream, transparent, writer);
 	} else
 		Output::Warning("Unsupported image file {} (Magic: {:02X})", stream.GetName(), *reinterpret_cast<uint32_t*>(data));
 
 	if (!img_okay) {
 		free(image_out.pixels);
+		bitmap.reset();
 		return;
 	}
 
-	Init(image_out.width, image_out.height, nullptr);
+	if (image_out.pixels) {
+		writer.Write(image_out);
+	}
 
-	ConvertImage(image_out.width, image_out.height, image_out.pixels, transparent, flags);
+	if (!bitmap) {
+		return;
+	}
 
-	CheckPixels(flags);
+	CheckPixels(writer.Finish());
 
-	original_bpp = image_out.bpp;
+	original_bpp = writer.bpp;
 
 	id = ToString(stream.GetName());
 }
@@ -137,6 +304,7 @@ Bitmap::Bitmap(const uint8_t* data, unsigned bytes, bool transparent, uint32_t f
 	pixman_format = find_format(format);
 
 	ImageOut image_out;
+	RowWriter writer(*this, transparent, flags);
 
 	bool img_okay = false;
 
@@ -145,22 +313,27 @@ Bitmap::Bitmap(const uint8_t* data, unsigned bytes, bool transparent, uint32_t f
 	else if (bytes > 2 && strncmp((char*) data, "BM", 2) == 0)
 		img_okay = ImageBMP::Read(data, bytes, transparent, image_out);
 	else if (bytes > 4 && strncmp((char*)(data + 1), "PNG", 3) == 0)
-		img_okay = ImagePNG::Read((const void*) data, transparent, image_out);
+		img_okay = ImagePNG::Read((const void*) data, transparent, writer);
 	else
 		Output::Warning("Unsupported image (Magic: {:02X})", bytes >= 4 ? *reinterpret_cast<const uint32_t*>(data) : 0);
 
 	if (!img_okay) {
 		free(image_out.pixels);
+		bitmap.reset();
 		return;
 	}
 
-	Init(image_out.width, image_out.height, nullptr);
+	if (image_out.pixels) {
+		writer.Write(image_out);
+	}
 
-	ConvertImage(image_out.width, image_out.height, image_out.pixels, transparent, flags);
+	if (!bitmap) {
+		return;
+	}
 
-	original_bpp = image_out.bpp;
+	original_bpp = writer.bpp;
 
-	CheckPixels(flags);
+	CheckPixels(writer.Finish());
 }
 
 Bitmap::Bitmap(Bitmap const& source, Rect const& src_rect, bool transparent) {
@@ -332,16 +505,7 @@ void Bitmap::HueChangeBlit(int x, int y, Bitmap const& src, Rect const& src_rect
 	Bitmap bmp(reinterpret_cast<void*>(&pixels.front()), src_rect.width, src_rect.height, src_rect.width * 4, format);
 	bmp.Blit(0, 0, src, src_rect, Opacity::Opaque());
 
-	for (std::vector<uint32_t>::iterator p = pixels.begin(); p != pixels.end(); ++p) {
-		uint32_t pixel = *p;
-		uint8_t r = (pixel>>24) & 0xFF;
-		uint8_t g = (pixel>>16) & 0xFF;
-		uint8_t b = (pixel>> 8) & 0xFF;
-		uint8_t a = pixel & 0xFF;
-		if (a > 0)
-			RGB_adjust_HSL(r, g, b, hue);
-		*p = ((uint32_t) r << 24) | ((uint32_t) g << 16) | ((uint32_t) b << 8) | (uint32_t) a;
-	}
+	PixelKernels::ApplyHueChange(pixels.data(), static_cast<int>(pixels.size()), hue, { 24, 16, 8, 0 });
 
 	Blit(dst_rect.x, dst_rect.y, bmp, bmp.GetRect(), Opacity::Opaque());
 }
@@ -477,6 +641,7 @@ DynamicFormat Bitmap::image_format;
 DynamicFormat Bitmap::opaque_image_format;
 
 void Bitmap::SetFormat(const DynamicFormat& format) {
+	effects_scratch.reset();
 	pixel_format = format;
 	opaque_pixel_format = format;
 	opaque_pixel_format.alpha_type = PF::NoAlpha;
@@ -543,46 +708,6 @@ void Bitmap::Init(int width, int height, void* data, int pitch, bool destroy) {
 		pixman_image_set_destroy_function(bitmap.get(), destroy_func, data);
 }
 
-void Bitmap::ConvertImage(int& width, int& height, void*& pixels, bool transparent, uint32_t flags) {
-	const DynamicFormat& img_format = transparent ? image_format : opaque_image_format;
-
-	// premultiply alpha
-	if ((flags & Flag_SystemBgPreserveColor) == 0) {
-		for (int y = 0; y < height; y++) {
-			uint8_t* dst = (uint8_t*) pixels + y * width * 4;
-			for (int x = 0; x < width; x++) {
-				uint8_t &r = *dst++;
-				uint8_t &g = *dst++;
-				uint8_t &b = *dst++;
-				uint8_t &a = *dst++;
-				MultiplyAlpha(r, g, b, a);
-			}
-		}
-	} else {
-		for (int y = 0; y < height; y++) {
-			uint8_t* dst = (uint8_t*) pixels + y * width * 4;
-			for (int x = 0; x < width; x++) {
-				uint8_t &r = *dst++;
-				uint8_t &g = *dst++;
-				uint8_t &b = *dst++;
-				uint8_t &a = *dst++;
-
-				// Skip alpha calculation for 32x32 system background graphic
-				if (x < 32 && y < 32) {
-					continue;
-				}
-
-				MultiplyAlpha(r, g, b, a);
-			}
-		}
-	}
-
-	Bitmap src(pixels, width, height, 0, img_format);
-	Clear();
-	BlitFast(0, 0, src, src.GetRect(), Opacity::Opaque());
-	free(pixels);
-}
-
 void* Bitmap::pixels() {
 	if (!bitmap) {
 		return nullptr;
@@ -636,6 +761,28 @@ namespace {
 
 		return mask;
 	}
+
+	/** Applies a tone to a rectangle of pixels in Bitmap::pixel_format */
+	void ApplyToneRect(Bitmap& dst, int x, int y, int width, int height, const Tone& tone, ImageOpacity src_opacity) {
+		int next_row = dst.pitch() / sizeof(uint32_t);
+		uint32_t* pixels = (uint32_t*)dst.pixels();
+		pixels = pixels + (y - 1) * next_row + x;
+
+		PixelKernels::ToneParams params;
+		const auto& format = Bitmap::pixel_format;
+		params.layout = { format.r.shift, format.g.shift, format.b.shift, format.a.shift };
+		params.saturation = tone.gray != 128;
+		params.sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+		params.color = (tone.red != 128 || tone.green != 128 || tone.blue != 128);
+		params.tone = tone;
+		params.skip_transparent = src_opacity != ImageOpacity::Opaque;
+		params.premultiply = src_opacity == ImageOpacity::Alpha_8Bit;
+
+		for (int i = 0; i < height; ++i) {
+			pixels += next_row;
+			PixelKernels::ApplyTone(pixels, width, params);
+		}
+	}
 } // anonymous namespace
 
 void Bitmap::Blit(int x, int y, Bitmap const& src, Rect const& src_rect, Opacity const& opacity, Bitmap::BlendMode blend_mode) {
@@ -820,69 +967,6 @@ void Bitmap::ClearRect(Rect const& dst_rect) {
 	pixman_image_fill_boxes(PIXMAN_OP_CLEAR, bitmap.get(), &pcolor, 1, &box);
 }
 
-// Hard light lookup table mapping source color to destination color
-// FIXME: Replace this with std::array<std::array<uint8_t,256>,256> when we have C++17
-struct HardLightTable {
-	uint8_t table[256][256] = {};
-};
-
-static constexpr HardLightTable make_hard_light_lookup() {
-	HardLightTable hl;
-	for (int i = 0; i < 256; ++i) {
-		for (int j = 0; j < 256; ++j) {
-			int res = 0;
-			if (i <= 128)
-				res = (2 * i * j) / 255;
-			else
-				res = 255 - 2 * (255 - i) * (255 - j) / 255;
-			hl.table[i][j] = res > 255 ? 255 : res < 0 ? 0 : res;
-		}
-	}
-	return hl;
-}
-
-constexpr auto hard_light = make_hard_light_lookup();
-
-
-// Saturation Tone Inline: Changes a pixel saturation
-static inline void saturation_tone(uint32_t &src_pixel, const int saturation, const int rs, const int gs, const int bs, const int as) {
-	// Algorithm from OpenPDN (MIT license)
-	// Transformation in Y'CbCr color space
-	uint8_t r = (src_pixel >> rs) & 0xFF;
-	uint8_t g = (src_pixel >> gs) & 0xFF;
-	uint8_t b = (src_pixel >> bs) & 0xFF;
-	uint8_t a = (src_pixel >> as) & 0xFF;
-
-	// Y' = 0.299 R' + 0.587 G' + 0.114 B'
-	uint8_t lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
-
-	// Scale Cb/Cr by scale factor "sat"
-	int red = ((lum * 1024 + (r - lum) * saturation) >> 10);
-	red = red > 255 ? 255 : red < 0 ? 0 : red;
-	int green = ((lum * 1024 + (g - lum) * saturation) >> 10);
-	green = green > 255 ? 255 : green < 0 ? 0 : green;
-	int blue = ((lum * 1024 + (b - lum) * saturation) >> 10);
-	blue = blue > 255 ? 255 : blue < 0 ? 0 : blue;
-
-	src_pixel = ((uint32_t)red << rs) | ((uint32_t)green << gs) | ((uint32_t)blue << bs) | ((uint32_t)a << as);
-}
-
-// Color Tone Inline: Changes color of a pixel by hard light table
-static inline void color_tone(uint32_t &src_pixel, const Tone& tone, const int rs, const int gs, const int bs, const int as) {
-	src_pixel = ((uint32_t)hard_light.table[tone.red][(src_pixel >> rs) & 0xFF] << rs)
-		| ((uint32_t)hard_light.table[tone.green][(src_pixel >> gs) & 0xFF] << gs)
-		| ((uint32_t)hard_light.table[tone.blue][(src_pixel >> bs) & 0xFF] << bs)
-		| ((uint32_t)((src_pixel >> as) & 0xFF) << as);
-}
-
-static inline void color_tone_alpha(uint32_t &src_pixel, const Tone& tone, const int rs, const int gs, const int bs, const int as) {
-	uint8_t a = (src_pixel >> as) & 0xFF;
-	uint8_t r = ((uint32_t)hard_light.table[tone.red][(src_pixel >> rs) & 0xFF]) * a / 255;
-	uint8_t g = ((uint32_t)hard_light.table[tone.green][(src_pixel >> gs) & 0xFF]) * a / 255;
-	uint8_t b = ((uint32_t)hard_light.table[tone.blue][(src_pixel >> bs) & 0xFF]) * a / 255;
-	src_pixel = ((uint32_t)r << rs) | ((uint32_t)g << gs) | ((uint32_t)b << bs) | ((uint32_t)a << as);
-}
-
 void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Tone &tone, Opacity const& opacity) {
 	if (opacity.IsTransparent()) {
 		return;
@@ -921,121 +1005,10 @@ void Bitmap::ToneBlit(int x, int y, Bitmap const& src, Rect const& src_rect, con
 		src_rect.width, src_rect.height);
 	}
 
-	const int as = pixel_format.a.shift;
-	const int rs = pixel_format.r.shift;
-	const int gs = pixel_format.g.shift;
-	const int bs = pixel_format.b.shift;
-	int next_row = pitch() / sizeof(uint32_t);
-	uint32_t* pixels = (uint32_t*)this->pixels();
-	pixels = pixels + (y - 1) * next_row + x;
-
 	const uint16_t limit_height = std::min<uint16_t>(src_rect.height, height());
 	const uint16_t limit_width = std::min<uint16_t>(src_rect.width, width());
 
-	const bool apply_sat = tone.gray != 128;
-	const bool apply_tone = (tone.red != 128 || tone.green != 128 || tone.blue != 128);
-
-	// If Saturation + Color:
-	if (apply_sat && apply_tone) {
-		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
-
-		if (src_opacity == ImageOpacity::Opaque) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		} else if (src_opacity == ImageOpacity::Alpha_1Bit) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					uint8_t a = (uint8_t)((pixels[j] >> as) & 0xFF);
-					if (a == 0)
-						continue;
-
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		} else { // 8 Bit Alpha
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					uint8_t a = (uint8_t)((pixels[j] >> as) & 0xFF);
-					if (a == 0) {
-						continue;
-					}
-
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-					color_tone_alpha(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		}
-	}
-
-	// If Only Saturation:
-	else if (apply_sat) {
-		int sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
-
-		if (src_opacity == ImageOpacity::Opaque) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-				}
-			}
-		} else { // Any kind of alpha
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					uint8_t a = (uint8_t)((pixels[j] >> as) & 0xFF);
-					if (a == 0)
-						continue;
-
-					saturation_tone(pixels[j], sat, rs, gs, bs, as);
-				}
-			}
-		}
-	}
-
-	// If Only Color:
-	else if (apply_tone) {
-		if (src_opacity == ImageOpacity::Opaque) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		} else if (src_opacity == ImageOpacity::Alpha_1Bit) {
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					uint8_t a = (uint8_t)((pixels[j] >> as) & 0xFF);
-					if (a == 0)
-						continue;
-
-					color_tone(pixels[j], tone, rs, gs, bs, as);
-				}
-			}
-		} else { // 8 Bit Alpha
-			for (uint16_t i = 0; i < limit_height; ++i) {
-				pixels += next_row;
-				for (uint16_t j = 0; j < limit_width; ++j) {
-					uint8_t a = (uint8_t)((pixels[j] >> as) & 0xFF);
-					if (a == 0)
-						continue;
-					else if (a == 255) {
-						color_tone(pixels[j], tone, rs, gs, bs, as);
-					} else {
-						color_tone_alpha(pixels[j], tone, rs, gs, bs, as);
-					}
-				}
-			}
-		}
-	}
+	ApplyToneRect(*this, x, y, limit_width, limit_height, tone, src_opacity);
 }
 
 void Bitmap::BlendBlit(int x, int y, Bitmap const& src, Rect const& src_rect, const Color& color, Opacity const& opacity) {
@@ -1189,6 +1162,71 @@ void Bitmap::EffectsBlit(int x, int y, int ox, int oy,
 	}
 }
 
+void Bitmap::EffectsBlit(int x, int y, int ox, int oy,
+						 Bitmap const& src, Rect const& src_rect,
+						 Opacity const& opacity,
+						 const Tone& tone, const Color& blend, bool flip_x, bool flip_y,
+						 Bitmap::BlendMode blend_mode) {
+	if (opacity.IsTransparent() || src_rect.width <= 0 || src_rect.height <= 0) {
+		return;
+	}
+
+	const int w = src_rect.width;
+	const int h = src_rect.height;
+
+	if (!effects_scratch || effects_scratch->width() < w || effects_scratch->height() < h) {
+		const int scratch_w = effects_scratch ? std::max(w, effects_scratch->width()) : w;
+		const int scratch_h = effects_scratch ? std::max(h, effects_scratch->height()) : h;
+		effects_scratch = Bitmap::Create(scratch_w, scratch_h, true);
+	}
+	auto& scratch = *effects_scratch;
+
+	// Copy of the source, flipped in the same pass
+	auto* src_img = src.bitmap.get();
+	int src_x = src_rect.x;
+	int src_y = src_rect.y;
+	if (flip_x || flip_y) {
+		const auto img_w = src.GetWidth();
+		const auto img_h = src.GetHeight();
+
+		Transform xform = Transform::Scale(flip_x ? -1 : 1, flip_y ? -1 : 1);
+		xform *= Transform::Translation(flip_x ? -img_w : 0, flip_y ? -img_h : 0);
+		pixman_image_set_transform(src_img, &xform.matrix);
+
+		src_x = flip_x ? img_w - src_rect.x - w : src_rect.x;
+		src_y = flip_y ? img_h - src_rect.y - h : src_rect.y;
+	}
+
+	pixman_image_composite32(PIXMAN_OP_SRC,
+							 src_img, nullptr, scratch.bitmap.get(),
+							 src_x, src_y,
+							 0, 0,
+							 0, 0,
+							 w, h);
+
+	if (flip_x || flip_y) {
+		pixman_image_set_transform(src_img, nullptr);
+	}
+
+	if (tone != Tone()) {
+		ApplyToneRect(scratch, 0, 0, w, h, tone, src.GetImageOpacity());
+	}
+
+	if (blend.alpha != 0) {
+		pixman_color_t tcolor = PixmanColor(blend);
+		auto timage = PixmanImagePtr{ pixman_image_create_solid_fill(&tcolor) };
+
+		pixman_image_composite32(PIXMAN_OP_OVER,
+								 timage.get(), scratch.bitmap.get(), scratch.bitmap.get(),
+								 0, 0,
+								 0, 0,
+								 0, 0,
+								 w, h);
+	}
+
+	Blit(x - ox, y - oy, scratch, Rect(0, 0, w, h), opacity, blend_mode);
+}
+
 void Bitmap::RotateZoomOpacityBlit(int x, int y, int ox, int oy,
 		Bitmap const& src, Rect const& src_rect,
 		double angle, double zoom_x, double zoom_y, Opacity const& opacity, Bitmap::BlendMode blend_mode)
@@ -592,6 +592,31 @@ public:
 		int waver_depth, double waver_phase,
 		BlendMode blend_mode = BlendMode::Default);
 
+	/**
+	 * Blits source bitmap with tone, flash and flip effects.
+	 * The result equals blitting a copy of the source rect that had the
+	 * effects applied by ToneBlit, BlendBlit and Flip, but no bitmap is
+	 * created for it.
+	 *
+	 * @param x destination x position.
+	 * @param y destination y position.
+	 * @param ox source origin x.
+	 * @param oy source origin y.
+	 * @param src source bitmap.
+	 * @param src_rect source bitmap rectangle.
+	 * @param opacity opacity to apply.
+	 * @param tone tone to apply.
+	 * @param blend flash color to blend with.
+	 * @param flip_x mirror horizontally.
+	 * @param flip_y mirror vertically.
+	 * @param blend_mode Blend mode to use.
+	 */
+	void EffectsBlit(int x, int y, int ox, int oy,
+		Bitmap const& src, Rect const& src_rect,
+		Opacity const& opacity,
+		const Tone& tone, const Color& blend, bool flip_x, bool flip_y,
+		BlendMode blend_mode = BlendMode::Default);
+
 	static DynamicFormat ChooseFormat(const DynamicFormat& format);
 	static void SetFormat(const DynamicFormat& format);
 
@@ -631,7 +656,9 @@ protected:
 	pixman_format_code_t pixman_format;
 
 	void Init(int width, int height, void* data, int pitch = 0, bool destroy = true);
-	void ConvertImage(int& width, int& height, void*& pixels, bool transparent, uint32_t flags);
+
+	/** Converts decoded image rows into the bitmap format */
+	class RowWriter;
 
 	static PixmanImagePtr GetSubimage(Bitmap const& src, const Rect& src_rect);
 	static inline void MultiplyAlpha(uint8_t &r, uint8_t &g, uint8_t &b, const uint8_t &a) {
@@ -670,6 +697,33 @@ struct ImageOut {
 	int bpp = 0;
 };
 
+/**
+ * Receives an image row by row while it is decoded.
+ * Avoids keeping a copy of the whole image in R8G8B8A8.
+ */
+class ImageRowOut {
+public:
+	virtual ~ImageRowOut() = default;
+
+	/**
+	 * Called once before the first row is written.
+	 *
+	 * @param width image width.
+	 * @param height image height.
+	 * @param bpp bits per pixel of the source image.
+	 * @return false to abort decoding.
+	 */
+	virtual bool Begin(int width, int height, int bpp) = 0;
+
+	/**
+	 * Called for every row of the image from top to bottom.
+	 *
+	 * @param y row index.
+	 * @param pixels width pixels in R8G8B8A8 (not premultiplied), may be modified.
+	 */
+	virtual void WriteRow(int y, uint8_t* pixels) = 0;
+};
+
 inline ImageOpacity Bitmap::GetImageOpacity() const {
 	return image_opacity;
 }
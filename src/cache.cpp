@@ -20,10 +20,10 @@
 #  pragma warning(disable: 4003)
 #endif
 
-#include <map>
-#include <tuple>
 #include <chrono>
 #include <cassert>
+#include <deque>
+#include <unordered_map>
 
 #include "async_handler.h"
 #include "cache.h"
@@ -35,6 +35,7 @@
 #include "player.h"
 #include <lcf/data.h>
 #include "game_clock.h"
+#include "thread_pool.h"
 #include "translation.h"
 
 using namespace std::chrono_literals;
@@ -78,12 +79,100 @@ namespace {
 	using key_type = std::string;
 	std::unordered_map<key_type, CacheItem> cache;
 
+	struct PrefetchItem {
+		std::shared_future<void> done;
+		std::shared_ptr<BitmapRef> bitmap;
+		Game_Clock::time_point time;
+	};
+
+	// Images decoded by a worker thread that were not requested yet
+	std::unordered_map<key_type, PrefetchItem> prefetch_items;
+
 	using tile_key_type = std::string;
 	std::unordered_map<tile_key_type, std::weak_ptr<Bitmap>> cache_tiles;
 
-	// rect, flip_x, flip_y, tone, blend
-	using effect_key_type = std::tuple<std::string, bool, Rect, bool, bool, Tone, Color>;
-	std::map<effect_key_type, std::weak_ptr<Bitmap>> cache_effects;
+	struct EffectKey {
+		/** Interned bitmap ID or the address of a bitmap without ID */
+		uintptr_t bitmap;
+		bool transparent;
+		Rect rect;
+		bool flip_x;
+		bool flip_y;
+		Tone tone;
+		Color blend;
+
+		bool operator==(const EffectKey& o) const {
+			return bitmap == o.bitmap && transparent == o.transparent && rect == o.rect
+				&& flip_x == o.flip_x && flip_y == o.flip_y && tone == o.tone && blend == o.blend;
+		}
+	};
+
+	struct EffectKeyHash {
+		size_t operator()(const EffectKey& k) const {
+			uint64_t h = 0xcbf29ce484222325ULL;
+			auto mix = [&h](uint64_t v) {
+				h = (h ^ v) * 0x100000001b3ULL;
+			};
+			mix(k.bitmap);
+			mix(static_cast<uint64_t>(static_cast<uint32_t>(k.rect.x)) << 32 | static_cast<uint32_t>(k.rect.y));
+			mix(static_cast<uint64_t>(static_cast<uint32_t>(k.rect.width)) << 32 | static_cast<uint32_t>(k.rect.height));
+			mix(static_cast<uint64_t>(static_cast<uint32_t>(k.tone.red)) << 32 | static_cast<uint32_t>(k.tone.green));
+			mix(static_cast<uint64_t>(static_cast<uint32_t>(k.tone.blue)) << 32 | static_cast<uint32_t>(k.tone.gray));
+			mix(static_cast<uint64_t>(k.blend.red) | k.blend.green << 8 | k.blend.blue << 16 | static_cast<uint64_t>(k.blend.alpha) << 24
+				| static_cast<uint64_t>(k.transparent) << 32 | static_cast<uint64_t>(k.flip_x) << 33 | static_cast<uint64_t>(k.flip_y) << 34);
+			return static_cast<size_t>(h ^ (h >> 32));
+		}
+	};
+
+	std::unordered_map<EffectKey, std::weak_ptr<Bitmap>, EffectKeyHash> cache_effects;
+
+	// Bitmap IDs used in cache_effects, the views point into effect_id_names
+	std::unordered_map<std::string_view, uintptr_t> effect_ids;
+	std::deque<std::string> effect_id_names;
+
+	// Expired effects are removed when the cache grows beyond this size
+	constexpr size_t effect_cache_limit = 1024;
+	size_t effect_prune_size = effect_cache_limit;
+
+	size_t effect_hits = 0;
+	size_t effect_misses = 0;
+
+	uintptr_t InternEffectBitmap(const Bitmap& bitmap) {
+		const auto id = bitmap.GetId();
+		if (id.empty()) {
+			// Aligned addresses are even and never collide with the odd interned IDs
+			return reinterpret_cast<uintptr_t>(&bitmap);
+		}
+
+		auto it = effect_ids.find(id);
+		if (it != effect_ids.end()) {
+			return it->second;
+		}
+
+		effect_id_names.emplace_back(id);
+		const uintptr_t interned = 2 * effect_id_names.size() - 1;
+		effect_ids.emplace(effect_id_names.back(), interned);
+		return interned;
+	}
+
+	void PruneEffects() {
+		for (auto it = cache_effects.begin(); it != cache_effects.end();) {
+			if (it->second.expired()) {
+				it = cache_effects.erase(it);
+			} else {
+				++it;
+			}
+		}
+
+		if (cache_effects.empty()) {
+			// No key refers to an interned ID anymore
+			effect_ids.clear();
+			effect_id_names.clear();
+		}
+
+		// Effects in use by sprites stay cached, prune again when the amount doubled
+		effect_prune_size = std::max(effect_cache_limit, 2 * cache_effects.size());
+	}
 
 	std::string system_name;
 
@@ -95,6 +184,15 @@ namespace {
 	void FreeBitmapMemory() {
 		auto cur_ticks = Game_Clock::GetFrameTime();
 
+		for (auto it = prefetch_items.begin(); it != prefetch_items.end();) {
+			// Prefetched images that are not used soon were prefetched for nothing
+			if (cur_ticks - it->second.time > 3s && it->second.done.wait_for(0s) == std::future_status::ready) {
+				it = prefetch_items.erase(it);
+			} else {
+				++it;
+			}
+		}
+
 		for (auto it = cache.begin(); it != cache.end();) {
 			if (it->second.bitmap.use_count() != 1) {
 				// Bitmap is referenced
@@ -235,6 +333,71 @@ namespace {
 		return s.dummy_renderer();
 	}
 
+	uint32_t GetBitmapFlags(Material::Type type, uint32_t extra_flags) {
+		uint32_t flags = Bitmap::Flag_ReadOnly | (
+				type == Material::Chipset ? Bitmap::Flag_Chipset :
+				type == Material::System ? Bitmap::Flag_System : 0);
+		return flags | extra_flags;
+	}
+
+	std::shared_future<void> PrefetchBitmap(Material::Type type, std::string_view filename, bool transparent, uint32_t extra_flags = 0) {
+		const Spec& s = spec[type];
+
+		if (filename.empty() || filename == CACHE_DEFAULT_BITMAP) {
+			return {};
+		}
+
+		const auto key = MakeHashKey(s.directory, filename, transparent, extra_flags);
+		if (cache.find(key) != cache.end()) {
+			return {};
+		}
+
+		auto it = prefetch_items.find(key);
+		if (it != prefetch_items.end()) {
+			return it->second.done;
+		}
+
+		// The file lookup is not thread-safe, only decoding happens in the worker
+		auto is = FileFinder::OpenImage(s.directory, filename);
+		if (!is) {
+			// Reported when the image is actually loaded
+			return {};
+		}
+
+		auto stream = std::make_shared<Filesystem_Stream::InputStream>(std::move(is));
+		auto bitmap = std::make_shared<BitmapRef>();
+		auto flags = GetBitmapFlags(type, extra_flags);
+
+		auto done = ThreadPool::Global().Submit([stream, bitmap, transparent, flags]() {
+			*bitmap = Bitmap::Create(std::move(*stream), transparent, flags);
+		});
+
+		prefetch_items[key] = { done, bitmap, Game_Clock::GetFrameTime() };
+		return done;
+	}
+
+	/**
+	 * Takes a prefetched bitmap out of the prefetch list.
+	 * Waits until the worker finished decoding it.
+	 *
+	 * @param key cache key
+	 * @param bmp set to the decoded bitmap, nullptr when decoding failed
+	 * @return whether the bitmap was prefetched
+	 */
+	bool TakePrefetchedBitmap(const std::string& key, BitmapRef& bmp) {
+		auto it = prefetch_items.find(key);
+		if (it == prefetch_items.end()) {
+			return false;
+		}
+
+		auto item = std::move(it->second);
+		prefetch_items.erase(it);
+
+		item.done.wait();
+		bmp = std::move(*item.bitmap);
+		return true;
+	}
+
 	template<Material::Type T>
 	BitmapRef LoadBitmap(std::string_view filename, bool transparent, uint32_t extra_flags = 0) {
 		static_assert(Material::REND < T && T < Material::END, "Invalid material.");
@@ -255,11 +418,16 @@ namespace {
 			}
 
 			if (!bmp) {
-				auto is = FileFinder::OpenImage(s.directory, filename);
+				Filesystem_Stream::InputStream is;
+				bool found = TakePrefetchedBitmap(key, bmp);
+				if (!found) {
+					is = FileFinder::OpenImage(s.directory, filename);
+					found = static_cast<bool>(is);
+				}
 
 				FreeBitmapMemory();
 
-				if (!is) {
+				if (!found) {
 					if (s.warn_missing) {
 						Output::Warning("Image not found: {}/{}", s.directory, filename);
 					} else {
@@ -267,12 +435,9 @@ namespace {
 						bmp = CreateEmpty<T>();
 					}
 				} else {
-					auto flags = Bitmap::Flag_ReadOnly | (
-							T == Material::Chipset ? Bitmap::Flag_Chipset :
-							T == Material::System ? Bitmap::Flag_System : 0);
-					flags |= extra_flags;
-
-					bmp = Bitmap::Create(std::move(is), transparent, flags);
+					if (is) {
+						bmp = Bitmap::Create(std::move(is), transparent, GetBitmapFlags(T, extra_flags));
+					}
 					if (!bmp) {
 						Output::Warning("Invalid image: {}/{}", s.directory, filename);
 					} else {
@@ -470,17 +635,12 @@ BitmapRef Cache::Tile(std::string_view filename, int tile_id) {
 }
 
 BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend) {
-	std::string id = ToString(src_bitmap->GetId());
-
-	if (id.empty()) {
-		// Log causes false positives when empty bitmaps or placeholder (checkerboard)
-		// bitmaps are used.
-		//Output::Debug("Bitmap has no ID. Please report a bug!");
-		id = fmt::format("{}", (void*)(src_bitmap.get()));
+	if (cache_effects.size() >= effect_prune_size) {
+		PruneEffects();
 	}
 
-	const effect_key_type key {
-		id,
+	const EffectKey key {
+		InternEffectBitmap(*src_bitmap),
 		src_bitmap->GetTransparent(),
 		rect,
 		flip_x,
@@ -489,48 +649,87 @@ BitmapRef Cache::SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, boo
 		blend
 	};
 
-	const auto it = cache_effects.find(key);
+	auto& cached = cache_effects[key];
+	if (auto bitmap = cached.lock()) {
+		++effect_hits;
+		return bitmap;
+	}
 
-	if (it == cache_effects.end() || it->second.expired()) {
-		BitmapRef bitmap_effects;
+	++effect_misses;
 
-		auto create = [&rect] () -> BitmapRef {
-			return Bitmap::Create(rect.width, rect.height, true);
-		};
+	BitmapRef bitmap_effects;
+
+	auto create = [&rect] () -> BitmapRef {
+		return Bitmap::Create(rect.width, rect.height, true);
+	};
+
+	if (tone != Tone()) {
+		bitmap_effects = create();
+		bitmap_effects->ToneBlit(0, 0, *src_bitmap, rect, tone, Opacity::Opaque());
+	}
+
+	if (blend != Color()) {
+		if (bitmap_effects) {
+			// Tone blit was applied
+			bitmap_effects->BlendBlit(0, 0, *bitmap_effects, bitmap_effects->GetRect(), blend, Opacity::Opaque());
+		} else {
+			bitmap_effects = create();
+			bitmap_effects->BlendBlit(0, 0, *src_bitmap, rect, blend, Opacity::Opaque());
+		}
+	}
 
-		if (tone != Tone()) {
+	if (flip_x || flip_y) {
+		if (bitmap_effects) {
+			// Tone or blend blit was applied
+			bitmap_effects->Flip(flip_x, flip_y);
+		} else {
 			bitmap_effects = create();
-			bitmap_effects->ToneBlit(0, 0, *src_bitmap, rect, tone, Opacity::Opaque());
+			bitmap_effects->FlipBlit(0, 0, *src_bitmap, rect, flip_x, flip_y, Opacity::Opaque());
 		}
+	}
 
-		if (blend != Color()) {
-			if (bitmap_effects) {
-				// Tone blit was applied
-				bitmap_effects->BlendBlit(0, 0, *bitmap_effects, bitmap_effects->GetRect(), blend, Opacity::Opaque());
-			} else {
-				bitmap_effects = create();
-				bitmap_effects->BlendBlit(0, 0, *src_bitmap, rect, blend, Opacity::Opaque());
-			}
+	assert(bitmap_effects && "Effect cache used but no effect applied!");
+
+	cached = bitmap_effects;
+	return bitmap_effects;
+}
+
+size_t Cache::GetSpriteEffectHits() {
+	return effect_hits;
+}
+
+size_t Cache::GetSpriteEffectMisses() {
+	return effect_misses;
+}
+
+size_t Cache::GetSpriteEffectCacheSize() {
+	return cache_effects.size();
+}
+
+std::shared_future<void> Cache::Prefetch(std::string_view folder_name, std::string_view filename) {
+	for (int i = 0; i < Material::END; ++i) {
+		auto type = static_cast<Material::Type>(i);
+		if (folder_name != spec[type].directory) {
+			continue;
 		}
 
-		if (flip_x || flip_y) {
-			if (bitmap_effects) {
-				// Tone or blend blit was applied
-				bitmap_effects->Flip(flip_x, flip_y);
-			} else {
-				bitmap_effects = create();
-				bitmap_effects->FlipBlit(0, 0, *src_bitmap, rect, flip_x, flip_y, Opacity::Opaque());
-			}
+		if (type == Material::System) {
+			// Flags depend on the engine, loaded once anyway
+			return {};
 		}
 
-		assert(bitmap_effects && "Effect cache used but no effect applied!");
+		return PrefetchBitmap(type, filename, spec[type].transparent);
+	}
 
-		return(cache_effects[key] = bitmap_effects).lock();
-	} else { return it->second.lock(); }
+	return {};
 }
 
 void Cache::Clear() {
+	prefetch_items.clear();
 	cache_effects.clear();
+	effect_ids.clear();
+	effect_id_names.clear();
+	effect_prune_size = effect_cache_limit;
 	cache.clear();
 	cache_size = 0;
 
@@ -20,6 +20,7 @@
 
 // Headers
 #include <cstdint>
+#include <future>
 #include <string>
 #include <vector>
 
@@ -58,6 +59,28 @@ namespace Cache {
 	BitmapRef Tile(std::string_view filename, int tile_id);
 	BitmapRef SpriteEffect(const BitmapRef& src_bitmap, const Rect& rect, bool flip_x, bool flip_y, const Tone& tone, const Color& blend);
 
+	/** @return Number of SpriteEffect calls that reused a cached bitmap */
+	size_t GetSpriteEffectHits();
+
+	/** @return Number of SpriteEffect calls that created a new bitmap */
+	size_t GetSpriteEffectMisses();
+
+	/** @return Number of entries in the sprite effect cache, including expired ones */
+	size_t GetSpriteEffectCacheSize();
+
+	/**
+	 * Starts decoding an image in a background thread.
+	 * The next load of the image through the functions above uses the
+	 * decoded bitmap instead of reading the file again.
+	 * Only the default transparency of the folder is prefetched.
+	 *
+	 * @param folder_name folder of the image (e.g. "CharSet")
+	 * @param filename name of the image
+	 * @return future that becomes ready when decoding finished or an invalid
+	 *         future when the image is already cached or does not exist.
+	 */
+	std::shared_future<void> Prefetch(std::string_view folder_name, std::string_view filename);
+
 	void Clear();
 	void ClearAll();
 
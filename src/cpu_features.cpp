@@ -0,0 +1,79 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "cpu_features.h"
+
+#if defined(EP_SIMD_SSE41) && defined(_MSC_VER) && !defined(__clang__)
+#  include <intrin.h>
+#  include <immintrin.h>
+#endif
+
+namespace {
+	bool DetectSse41() {
+#if !defined(EP_SIMD_SSE41)
+		return false;
+#elif defined(__GNUC__)
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse4.1");
+#else
+		int info[4];
+		__cpuid(info, 1);
+		return (info[2] & (1 << 19)) != 0;
+#endif
+	}
+
+	bool DetectAvx2() {
+#if !defined(EP_SIMD_AVX2)
+		return false;
+#elif defined(__GNUC__)
+		// Also checks whether the OS saves the AVX registers
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#else
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] < 7) {
+			return false;
+		}
+
+		// OSXSAVE and AVX
+		__cpuid(info, 1);
+		if ((info[2] & (1 << 27)) == 0 || (info[2] & (1 << 28)) == 0) {
+			return false;
+		}
+
+		// XMM and YMM state enabled by the OS
+		if ((_xgetbv(0) & 0x6) != 0x6) {
+			return false;
+		}
+
+		__cpuidex(info, 7, 0);
+		return (info[1] & (1 << 5)) != 0;
+#endif
+	}
+}
+
+bool CpuFeatures::HasSse41() {
+	static const bool has_sse41 = DetectSse41();
+	return has_sse41;
+}
+
+bool CpuFeatures::HasAvx2() {
+	static const bool has_avx2 = DetectAvx2();
+	return has_avx2;
+}
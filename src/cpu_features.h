@@ -0,0 +1,67 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_CPU_FEATURES_H
+#define EP_CPU_FEATURES_H
+
+/*
+ * Compile time detection of the SIMD instruction sets that are always
+ * available for the target, and whether SSE4.1 and AVX2 code can be
+ * compiled in and selected at runtime.
+ */
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define EP_SIMD_SSE2
+#endif
+
+#if defined(EP_SIMD_SSE2) && (defined(__GNUC__) || (defined(_MSC_VER) && !defined(__clang__)))
+#  define EP_SIMD_SSE41
+#  define EP_SIMD_AVX2
+#  if defined(__GNUC__)
+#    define EP_TARGET_SSE41 __attribute__((target("sse4.1")))
+#    define EP_TARGET_AVX2 __attribute__((target("avx2")))
+#  else
+#    define EP_TARGET_SSE41
+#    define EP_TARGET_AVX2
+#  endif
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define EP_SIMD_NEON
+#endif
+
+/**
+ * Runtime detection of CPU features.
+ */
+namespace CpuFeatures {
+	/**
+	 * Functions marked with EP_TARGET_SSE41 must only be called when this
+	 * returns true.
+	 *
+	 * @return Whether the CPU supports SSE4.1
+	 */
+	bool HasSse41();
+
+	/**
+	 * Functions marked with EP_TARGET_AVX2 must only be called when this
+	 * returns true.
+	 *
+	 * @return Whether the CPU and the operating system support AVX2
+	 */
+	bool HasAvx2();
+}
+
+#endif
@@ -24,8 +24,11 @@ Drawable::~Drawable() {
 }
 
 void Drawable::SetZ(Z_t nz) {
-	if (_z != nz) DrawableMgr::OnUpdateZ(this);
-	_z = nz;
+	if (_z != nz) {
+		const Z_t old_z = _z;
+		_z = nz;
+		DrawableMgr::OnUpdateZ(this, old_z);
+	}
 }
 
 Drawable::Z_t Drawable::GetPriorityForMapLayer(int which) {
@@ -94,3 +97,49 @@ Drawable::Z_t Drawable::GetPriorityForBattleLayer(int which) {
 
 	return layer + (1ULL << z_offset);
 }
+
+const char* Drawable::GetPriorityName(Z_t z) {
+	const Z_t layer = z >> z_offset;
+	if (layer % 10 != 0) {
+		// Pictures placed on top of a layer
+		return "Drawable::Picture";
+	}
+
+	switch (layer << z_offset) {
+		case Priority_Background:
+			return "Drawable::Background";
+		case Priority_TilesetBelow:
+			return "Drawable::TilesetBelow";
+		case Priority_EventsBelow:
+			return "Drawable::EventsBelow";
+		case Priority_Player:
+			return "Drawable::Player";
+		case Priority_TilesetAbove:
+			return "Drawable::TilesetAbove";
+		case Priority_EventsAbove:
+			return "Drawable::EventsAbove";
+		case Priority_EventsFlying:
+			return "Drawable::EventsFlying";
+		case Priority_Weather:
+			return "Drawable::Weather";
+		case Priority_Screen:
+			return "Drawable::Screen";
+		case Priority_PictureNew:
+		case Priority_PictureOld:
+			return "Drawable::Picture";
+		case Priority_BattleAnimation:
+			return "Drawable::BattleAnimation";
+		case Priority_Window:
+			return "Drawable::Window";
+		case Priority_Timer:
+			return "Drawable::Timer";
+		case Priority_Frame:
+			return "Drawable::Frame";
+		case Priority_Transition:
+			return "Drawable::Transition";
+		case Priority_Overlay:
+			return "Drawable::Overlay";
+		default:
+			return "Drawable::Other";
+	}
+}
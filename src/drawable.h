@@ -18,6 +18,7 @@
 #ifndef EP_DRAWABLE_H
 #define EP_DRAWABLE_H
 
+#include <cstddef>
 #include <cstdint>
 #include <memory>
 
@@ -113,11 +114,24 @@ public:
 	 * @return Priority or 0 when not found
 	 */
 	static Z_t GetPriorityForBattleLayer(int which);
+
+	/**
+	 * Returns a name describing the priority layer of a z value.
+	 * Used for profiling.
+	 *
+	 * @param z z value
+	 * @return name of the layer
+	 */
+	static const char* GetPriorityName(Z_t z);
 private:
+	friend class DrawableList;
+
 	Z_t _z = 0;
 	Flags _flags = Flags::Default;
 	int render_ox = 0;
 	int render_oy = 0;
+	/** Position in the DrawableList containing the drawable, maintained by the list */
+	size_t _list_index = 0;
 };
 
 inline Drawable::Flags operator|(Drawable::Flags l, Drawable::Flags r) {
@@ -18,6 +18,7 @@
 // Headers
 #include "drawable_list.h"
 #include "drawable_mgr.h"
+#include "instrumentation.h"
 #include <algorithm>
 #include <cassert>
 
@@ -33,26 +34,32 @@ DrawableList::~DrawableList() {
 
 void DrawableList::Clear() {
 	_list.clear();
+	_holes = 0;
 	SetClean();
 }
 
 bool DrawableList::IsSorted() const {
+	Compact();
 	return std::is_sorted(_list.begin(), _list.end(), DrawCmp);
 }
 
 void DrawableList::Sort() {
+	Compact();
 	// stable sort to work around a flickering event sprite issue when
 	// the map is scrolling (have same Z value)
 	std::stable_sort(_list.begin(), _list.end(), DrawCmp);
+	Reindex(0, _list.size());
 	SetClean();
 }
 
 void DrawableList::Append(Drawable* ptr) {
 	assert(ptr != nullptr);
-	assert(_list.end() == std::find(_list.begin(), _list.end(), ptr));
+	assert(!Contains(ptr));
 
+	Compact();
 	const bool ordered = _list.empty() || !DrawCmp(ptr, _list.back());
 
+	ptr->_list_index = _list.size();
 	_list.push_back(ptr);
 
 	if (!ordered) {
@@ -61,42 +68,99 @@ void DrawableList::Append(Drawable* ptr) {
 }
 
 Drawable* DrawableList::Take(Drawable* ptr) {
-	auto iter = std::find(_list.begin(), _list.end(), ptr);
-	if (iter == _list.end()) {
+	if (!Contains(ptr)) {
 		return nullptr;
 	}
-
-	auto ret = *iter;
-	// FIXME: Can we remove this O(N) operation here?
-	_list.erase(iter);
-	return ret;
+	const size_t index = ptr->_list_index;
 
 	// Removing doesn't change sorted order, so not dirty flag.
+	if (index + 1 < _list.size()) {
+		_list[index] = nullptr;
+		++_holes;
+		return ptr;
+	}
+
+	_list.pop_back();
+	while (!_list.empty() && _list.back() == nullptr) {
+		_list.pop_back();
+		--_holes;
+	}
+	return ptr;
+}
+
+void DrawableList::UpdateZ(Drawable* ptr, Drawable::Z_t old_z) {
+	if (IsDirty()) {
+		return;
+	}
+
+	if (!Contains(ptr)) {
+		return;
+	}
+
+	// Binary search does not work with holes
+	Compact();
+
+	// Place it like std::stable_sort does: The drawable was in front of all
+	// drawables with the new Z when the Z increased and behind them otherwise.
+	const auto z = ptr->GetZ();
+	const auto iter = _list.begin() + ptr->_list_index;
+	if (z > old_z) {
+		auto pos = std::lower_bound(iter + 1, _list.end(), z, [](Drawable* d, Drawable::Z_t v) { return d->GetZ() < v; });
+		std::rotate(iter, iter + 1, pos);
+		Reindex(iter - _list.begin(), pos - _list.begin());
+	} else {
+		auto pos = std::upper_bound(_list.begin(), iter, z, [](Drawable::Z_t v, Drawable* d) { return v < d->GetZ(); });
+		std::rotate(pos, iter, iter + 1);
+		Reindex(pos - _list.begin(), iter + 1 - _list.begin());
+	}
 }
 
 void DrawableList::TakeFrom(DrawableList& other) noexcept {
 	if (&other == this) { return; }
 
+	other.Compact();
 	auto& olist = other._list;
 
 	if (olist.empty()) {
 		return;
 	}
 
+	Compact();
+	const size_t old_size = _list.size();
 	_list.insert(_list.end(), olist.begin(), olist.end());
 	olist.clear();
+	Reindex(old_size, _list.size());
 
 	SetDirty();
 	other.SetClean();
 }
 
+void DrawableList::CompactHoles() const {
+	auto first = std::find(_list.begin(), _list.end(), nullptr);
+	const size_t first_index = first - _list.begin();
+	_list.erase(std::remove(first, _list.end(), nullptr), _list.end());
+	_holes = 0;
+	Reindex(first_index, _list.size());
+}
+
+void DrawableList::Reindex(size_t first, size_t last) const {
+	for (size_t i = first; i < last; ++i) {
+		_list[i]->_list_index = i;
+	}
+}
+
 void DrawableList::Draw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z) {
 	if (IsDirty()) {
 		Sort();
 	} else {
+		Compact();
 		assert(IsSorted());
 	}
 
+	// Drawables of the same priority layer are profiled together
+	Instrumentation::Scope iscope;
+	const char* layer_name = nullptr;
+
 	for (auto* drawable : _list) {
 		auto z = drawable->GetZ();
 		if (z < min_z) {
@@ -106,6 +170,13 @@ void DrawableList::Draw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z) {
 			break;
 		}
 		if (drawable->IsVisible()) {
+			if (Instrumentation::IsTraceEnabled()) {
+				const char* name = Drawable::GetPriorityName(z);
+				if (name != layer_name) {
+					layer_name = name;
+					iscope.Begin(name);
+				}
+			}
 			drawable->Draw(dst);
 		}
 	}
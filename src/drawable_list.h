@@ -25,6 +25,11 @@
 
 /** A list of Drawable objects. These are used by the graphics engine store and
  * to render all drawable objects.
+ *
+ * Every drawable knows its position in the list, removing it only leaves a
+ * hole which is compacted the next time the list is accessed in order.
+ * A drawable whose Z changed is moved to its new position instead of
+ * sorting the whole list.
  */
 class DrawableList {
 	public:
@@ -70,6 +75,16 @@ class DrawableList {
 		template <typename T>
 		T* Take(std::enable_if_t<IsDrawable<T>,T*> drawable);
 
+		/**
+		 * Moves a drawable whose Z value changed to the position a stable sort
+		 * would put it. Does nothing when the drawable is not in the list.
+		 * When the list is dirty the move is deferred to the next Sort.
+		 *
+		 * @param drawable the Drawable which changed
+		 * @param old_z Z value before the change
+		 */
+		void UpdateZ(Drawable* drawable, Drawable::Z_t old_z);
+
 		/**
 		 * Remove all drawables from other and append them to this.
 		 *
@@ -93,10 +108,10 @@ class DrawableList {
 		void SetDirty();
 
 		/** @return an iterator to the beginning */
-		iterator begin() const { return _list.begin(); }
+		iterator begin() const { Compact(); return _list.begin(); }
 
 		/** @return an iterator to the end */
-		iterator end() const { return _list.end(); }
+		iterator end() const { Compact(); return _list.end(); }
 
 		/**
 		 * Return drawable at i'th index
@@ -106,14 +121,15 @@ class DrawableList {
 		 * @return the drawable at i
 		 */
 		Drawable* operator[](size_t i) const {
+			Compact();
 			return _list[i];
 		}
 
 		/** @return the number of drawables in the list */
-		size_t size() const { return _list.size(); }
+		size_t size() const { return _list.size() - _holes; }
 
 		/** @return if the list is empty */
-		bool empty() const { return _list.empty(); }
+		bool empty() const { return size() == 0; }
 
 		/**
 		 * Sort the list if it's dirty, then call Draw() on every drawable in order.
@@ -132,10 +148,27 @@ class DrawableList {
 		void Draw(Bitmap& dst, Drawable::Z_t min_z, Drawable::Z_t max_z);
 
 	private:
-		std::vector<Drawable*> _list;
+		/** Contains nullptr for removed drawables when _holes is not 0 */
+		mutable std::vector<Drawable*> _list;
+		mutable size_t _holes = 0;
 		bool _dirty = false;
 
 		void SetClean();
+
+		/** @return Whether the drawable is in the list, O(1) */
+		bool Contains(const Drawable* drawable) const;
+
+		/** Removes the holes left by Take. Does not change the order. */
+		void Compact() const;
+		void CompactHoles() const;
+
+		/**
+		 * Updates the stored position of the drawables.
+		 *
+		 * @param first index of the first drawable to update
+		 * @param last index after the last drawable to update
+		 */
+		void Reindex(size_t first, size_t last) const;
 };
 
 template <typename T>
@@ -148,7 +181,10 @@ template <typename F>
 void DrawableList::TakeFrom(DrawableList& other, F&& cond) noexcept {
 	if (&other == this) { return; }
 
+	Compact();
+	other.Compact();
 	auto& olist = other._list;
+	const size_t old_size = _list.size();
 
 	int shift = 0;
 	const auto end = olist.end();
@@ -169,6 +205,9 @@ void DrawableList::TakeFrom(DrawableList& other, F&& cond) noexcept {
 	}
 	olist.resize(olist.size() - shift);
 
+	other.Reindex(0, olist.size());
+	Reindex(old_size, _list.size());
+
 	SetDirty();
 	if (olist.empty()) {
 		other.SetClean();
@@ -187,6 +226,17 @@ inline void DrawableList::SetClean() {
 	_dirty = false;
 }
 
+inline bool DrawableList::Contains(const Drawable* drawable) const {
+	const size_t index = drawable->_list_index;
+	return index < _list.size() && _list[index] == drawable;
+}
+
+inline void DrawableList::Compact() const {
+	if (_holes > 0) {
+		CompactHoles();
+	}
+}
+
 inline void DrawableList::Draw(Bitmap& dst) {
 	Draw(dst, std::numeric_limits<Drawable::Z_t>::min(), std::numeric_limits<Drawable::Z_t>::max());
 }
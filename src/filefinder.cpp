@@ -610,7 +610,7 @@ std::vector<FileFinder::FsEntry> FileFinder::FindGames(FilesystemView fs, int re
 			if (entry.type == DirectoryTree::FileType::Directory) {
 				find_recursive(subfs.Subtree(entry.name), rec_limit - 1);
 			} else if (entry.type == DirectoryTree::FileType::Regular && IsSupportedArchiveExtension(entry.name)) {
-				find_recursive(fs.Create(entry.name), rec_limit - 1);
+				find_recursive(subfs.Create(entry.name), rec_limit - 1);
 			}
 		}
 	};
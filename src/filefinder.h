@@ -86,6 +86,8 @@ namespace FileFinder {
 	struct GameEntry {
 		std::string dir_name;
 		ProjectType type;
+		/** GameTitle of the RPG_RT.ini, empty when unknown */
+		std::string title;
 	};
 
 	/**
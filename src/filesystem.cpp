@@ -175,6 +175,10 @@ FilesystemView Filesystem::Subtree(std::string sub_path) const {
 	return FilesystemView(shared_from_this(), sub_path);
 }
 
+int64_t Filesystem::GetModificationTime(std::string_view) const {
+	return -1;
+}
+
 bool Filesystem::MakeDirectory(std::string_view, bool) const {
 	return false;
 }
@@ -317,6 +321,11 @@ int64_t FilesystemView::GetFilesize(std::string_view path) const {
 	return fs->GetFilesize(MakePath(path));
 }
 
+int64_t FilesystemView::GetModificationTime(std::string_view path) const {
+	assert(fs);
+	return fs->GetModificationTime(MakePath(path));
+}
+
 DirectoryTree::DirectoryListType* FilesystemView::ListDirectory(std::string_view path) const {
 	assert(fs);
 	return fs->ListDirectory(MakePath(path));
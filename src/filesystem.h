@@ -219,6 +219,7 @@ public:
 	virtual bool IsDirectory(std::string_view path, bool follow_symlinks) const = 0;
 	virtual bool Exists(std::string_view path) const = 0;
 	virtual int64_t GetFilesize(std::string_view path) const = 0;
+	virtual int64_t GetModificationTime(std::string_view path) const;
 	virtual bool MakeDirectory(std::string_view dir, bool follow_symlinks) const;
 	virtual bool IsFeatureSupported(Feature f) const;
 	virtual std::string Describe() const = 0;
@@ -381,6 +382,15 @@ public:
 	 */
 	int64_t GetFilesize(std::string_view path) const;
 
+	/**
+	 * The unit of the value depends on the filesystem, it is only meaningful
+	 * for comparing it with other modification times.
+	 *
+	 * @param path Path to check
+	 * @return Time of the last modification or -1 when not supported or on error.
+	 */
+	int64_t GetModificationTime(std::string_view path) const;
+
 	/**
 	 * Enumerates a directory.
 	 *
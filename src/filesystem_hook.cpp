@@ -102,6 +102,10 @@ int64_t HookFilesystem::GetFilesize(std::string_view path) const {
 	return GetParent().GetFilesize(path);
 }
 
+int64_t HookFilesystem::GetModificationTime(std::string_view path) const {
+	return GetParent().GetModificationTime(path);
+}
+
 bool HookFilesystem::MakeDirectory(std::string_view dir, bool follow_symlinks) const {
 	return GetParent().MakeDirectory(dir, follow_symlinks);
 }
@@ -73,6 +73,10 @@ int64_t RootFilesystem::GetFilesize(std::string_view  path) const {
 	return FilesystemForPath(path).GetFilesize(path);
 }
 
+int64_t RootFilesystem::GetModificationTime(std::string_view path) const {
+	return FilesystemForPath(path).GetModificationTime(path);
+}
+
 std::streambuf* RootFilesystem::CreateInputStreambuffer(std::string_view path, std::ios_base::openmode mode) const {
 	return FilesystemForPath(path).CreateInputStreambuffer(path, mode);
 }
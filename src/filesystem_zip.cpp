@@ -28,6 +28,7 @@
 #include <sstream>
 #include <cassert>
 #include <algorithm>
+#include <array>
 #include <fmt/format.h>
 
 constexpr char end_of_central_directory[] = "\x50\x4b\x05\x06";
@@ -52,9 +53,280 @@ static std::string normalize_path(std::string_view path) {
 	return inner_path;
 }
 
+namespace {
+	/** Reads a Stored entry directly from the archive */
+	class ZipStoredStreamBuf : public std::streambuf {
+	public:
+		ZipStoredStreamBuf(Filesystem_Stream::InputStream is, uint32_t offset, uint32_t size);
+		ZipStoredStreamBuf(ZipStoredStreamBuf const& other) = delete;
+		ZipStoredStreamBuf const& operator=(ZipStoredStreamBuf const& other) = delete;
+
+	protected:
+		int_type underflow() override;
+		std::streamsize xsgetn(char* s, std::streamsize n) override;
+		std::streambuf::pos_type seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+		std::streambuf::pos_type seekpos(std::streambuf::pos_type pos, std::ios_base::openmode mode) override;
+
+	private:
+		std::streamsize GetPosition() const;
+
+		Filesystem_Stream::InputStream is;
+		/** Offset of the entry data in the archive */
+		uint32_t offset;
+		uint32_t size;
+		/** Position in the entry of the first byte in the buffer */
+		std::streamsize buffer_pos = 0;
+		std::array<char, 16 * 1024> buffer;
+	};
+
+	/**
+	 * Inflates a Deflate entry on demand.
+	 * Only the most recently inflated window is kept in memory. Seeking
+	 * backwards out of the window restarts inflating at the beginning.
+	 */
+	class ZipInflateStreamBuf : public std::streambuf {
+	public:
+		static constexpr size_t window_size = 64 * 1024;
+		static constexpr size_t in_buffer_size = 16 * 1024;
+
+		ZipInflateStreamBuf(Filesystem_Stream::InputStream is, std::string name,
+			uint32_t offset, uint32_t compressed_size, uint32_t uncompressed_size);
+		ZipInflateStreamBuf(ZipInflateStreamBuf const& other) = delete;
+		ZipInflateStreamBuf const& operator=(ZipInflateStreamBuf const& other) = delete;
+		~ZipInflateStreamBuf() override;
+
+	protected:
+		int_type underflow() override;
+		std::streambuf::pos_type seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) override;
+		std::streambuf::pos_type seekpos(std::streambuf::pos_type pos, std::ios_base::openmode mode) override;
+
+	private:
+		std::streamsize GetPosition() const;
+		void Restart();
+		std::streamsize InflateWindow();
+
+		Filesystem_Stream::InputStream is;
+		std::string name;
+		/** Offset of the entry data in the archive */
+		uint32_t offset;
+		uint32_t compressed_size;
+		uint32_t size;
+
+		z_stream zlib_stream = {};
+		std::vector<uint8_t> in_buffer;
+		uint32_t compressed_read = 0;
+		bool stream_end = false;
+
+		/** Inflated data, always ends at the current inflate position */
+		std::vector<char> window;
+		/** Position in the entry of the first byte in the window */
+		std::streamsize window_pos = 0;
+
+		bool seek_pending = false;
+		std::streamsize seek_target = 0;
+	};
+} // anonymous namespace
+
+ZipStoredStreamBuf::ZipStoredStreamBuf(Filesystem_Stream::InputStream is, uint32_t offset, uint32_t size)
+	: is(std::move(is)), offset(offset), size(size) {
+	setg(buffer.data(), buffer.data(), buffer.data());
+}
+
+std::streamsize ZipStoredStreamBuf::GetPosition() const {
+	return buffer_pos + (gptr() - eback());
+}
+
+ZipStoredStreamBuf::int_type ZipStoredStreamBuf::underflow() {
+	assert(gptr() == egptr());
+
+	buffer_pos = GetPosition();
+	auto len = std::min<std::streamsize>(buffer.size(), size - buffer_pos);
+	if (len <= 0) {
+		setg(buffer.data(), buffer.data(), buffer.data());
+		return traits_type::eof();
+	}
+
+	is.clear();
+	is.seekg(offset + buffer_pos);
+	len = is.read(buffer.data(), len).gcount();
+	setg(buffer.data(), buffer.data(), buffer.data() + len);
+
+	if (len <= 0) {
+		return traits_type::eof();
+	}
+	return traits_type::to_int_type(*gptr());
+}
+
+std::streamsize ZipStoredStreamBuf::xsgetn(char* s, std::streamsize n) {
+	// Serve what is buffered, then read the remainder directly into the target
+	std::streamsize buffered = std::min<std::streamsize>(n, egptr() - gptr());
+	std::copy(gptr(), gptr() + buffered, s);
+	gbump(static_cast<int>(buffered));
+
+	std::streamsize remaining = std::min<std::streamsize>(n - buffered, size - GetPosition());
+	if (remaining <= 0) {
+		return buffered;
+	}
+
+	const auto pos = GetPosition();
+	is.clear();
+	is.seekg(offset + pos);
+	auto len = is.read(s + buffered, remaining).gcount();
+
+	buffer_pos = pos + len;
+	setg(buffer.data(), buffer.data(), buffer.data());
+
+	return buffered + len;
+}
+
+std::streambuf::pos_type ZipStoredStreamBuf::seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
+	if (dir == std::ios_base::beg) {
+		return seekpos(offset, mode);
+	} else if (dir == std::ios_base::cur) {
+		return seekpos(GetPosition() + offset, mode);
+	} else {
+		return seekpos(static_cast<std::streamoff>(size) + offset, mode);
+	}
+}
+
+std::streambuf::pos_type ZipStoredStreamBuf::seekpos(std::streambuf::pos_type pos, std::ios_base::openmode) {
+	std::streamoff off = Utils::Clamp<std::streamoff>(pos, 0, size);
+
+	const std::streamoff buffered = egptr() - eback();
+	if (off >= buffer_pos && off <= buffer_pos + buffered) {
+		setg(eback(), eback() + (off - buffer_pos), egptr());
+	} else {
+		buffer_pos = off;
+		setg(buffer.data(), buffer.data(), buffer.data());
+	}
+	return off;
+}
+
+ZipInflateStreamBuf::ZipInflateStreamBuf(Filesystem_Stream::InputStream is, std::string name,
+		uint32_t offset, uint32_t compressed_size, uint32_t uncompressed_size)
+	: is(std::move(is)), name(std::move(name)), offset(offset), compressed_size(compressed_size), size(uncompressed_size) {
+	in_buffer.resize(in_buffer_size);
+	window.resize(window_size);
+	setg(window.data(), window.data(), window.data());
+
+	inflateInit2(&zlib_stream, -MAX_WBITS);
+}
+
+ZipInflateStreamBuf::~ZipInflateStreamBuf() {
+	inflateEnd(&zlib_stream);
+}
+
+std::streamsize ZipInflateStreamBuf::GetPosition() const {
+	return seek_pending ? seek_target : window_pos + (gptr() - eback());
+}
+
+void ZipInflateStreamBuf::Restart() {
+	inflateReset(&zlib_stream);
+	zlib_stream.next_in = nullptr;
+	zlib_stream.avail_in = 0;
+	compressed_read = 0;
+	window_pos = 0;
+	stream_end = false;
+	setg(window.data(), window.data(), window.data());
+}
+
+std::streamsize ZipInflateStreamBuf::InflateWindow() {
+	zlib_stream.next_out = reinterpret_cast<Bytef*>(window.data());
+	zlib_stream.avail_out = static_cast<uInt>(window.size());
+
+	while (zlib_stream.avail_out > 0 && !stream_end) {
+		if (zlib_stream.avail_in == 0) {
+			auto len = std::min<std::streamsize>(in_buffer.size(), compressed_size - compressed_read);
+			if (len > 0) {
+				is.clear();
+				is.seekg(offset + compressed_read);
+				len = is.read(reinterpret_cast<char*>(in_buffer.data()), len).gcount();
+			}
+			if (len <= 0) {
+				Output::Warning("ZipFS: zlib failed for {}: Unexpected end of data (Archive corrupted?)", name);
+				stream_end = true;
+				break;
+			}
+			compressed_read += len;
+			zlib_stream.next_in = in_buffer.data();
+			zlib_stream.avail_in = static_cast<uInt>(len);
+		}
+
+		int zlib_error = inflate(&zlib_stream, Z_NO_FLUSH);
+		if (zlib_error == Z_STREAM_END) {
+			stream_end = true;
+		} else if (zlib_error != Z_OK) {
+			Output::Warning("ZipFS: zlib failed for {}: {} ({})", name, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
+			stream_end = true;
+		}
+	}
+
+	return static_cast<std::streamsize>(window.size() - zlib_stream.avail_out);
+}
+
+ZipInflateStreamBuf::int_type ZipInflateStreamBuf::underflow() {
+	const std::streamsize target = GetPosition();
+	seek_pending = false;
+
+	if (target >= size) {
+		seek_pending = true;
+		seek_target = target;
+		return traits_type::eof();
+	}
+
+	if (target < window_pos) {
+		// Deflate streams can only be read forward
+		Restart();
+	} else {
+		window_pos += egptr() - eback();
+	}
+
+	// Inflate until the window contains the target, skipped windows are discarded
+	while (true) {
+		auto len = InflateWindow();
+		if (len == 0) {
+			setg(window.data(), window.data(), window.data());
+			return traits_type::eof();
+		}
+
+		if (target < window_pos + len) {
+			setg(window.data(), window.data() + (target - window_pos), window.data() + len);
+			return traits_type::to_int_type(*gptr());
+		}
+		window_pos += len;
+	}
+}
+
+std::streambuf::pos_type ZipInflateStreamBuf::seekoff(std::streambuf::off_type offset, std::ios_base::seekdir dir, std::ios_base::openmode mode) {
+	if (dir == std::ios_base::beg) {
+		return seekpos(offset, mode);
+	} else if (dir == std::ios_base::cur) {
+		return seekpos(GetPosition() + offset, mode);
+	} else {
+		return seekpos(static_cast<std::streamoff>(size) + offset, mode);
+	}
+}
+
+std::streambuf::pos_type ZipInflateStreamBuf::seekpos(std::streambuf::pos_type pos, std::ios_base::openmode) {
+	std::streamoff off = Utils::Clamp<std::streamoff>(pos, 0, size);
+
+	const std::streamoff buffered = egptr() - eback();
+	if (off >= window_pos && off < window_pos + buffered) {
+		// Still in the window
+		seek_pending = false;
+		setg(eback(), eback() + (off - window_pos), egptr());
+	} else {
+		// Inflating is deferred to the next read, this keeps size queries cheap
+		seek_pending = true;
+		seek_target = off;
+		setg(eback(), egptr(), egptr());
+	}
+	return off;
+}
+
 ZipFilesystem::ZipFilesystem(std::string base_path, FilesystemView parent_fs, std::string_view enc) :
 	Filesystem(base_path, parent_fs) {
-	zip_is = parent_fs.OpenInputStream(GetPath());
+	auto zip_is = parent_fs.OpenInputStream(GetPath());
 	if (!zip_is) {
 		return;
 	}
@@ -365,72 +637,87 @@ int64_t ZipFilesystem::GetFilesize(std::string_view path) const {
 std::streambuf* ZipFilesystem::CreateInputStreambuffer(std::string_view path, std::ios_base::openmode) const {
 	std::string path_normalized = normalize_path(path);
 	auto central_entry = Find(path);
-	if (central_entry && !central_entry->is_directory) {
-		zip_is.clear();
-		zip_is.seekg(central_entry->fileoffset);
-		StorageMethod method;
-		ZipEntry local_entry = {};
-		if (ReadLocalHeader(zip_is, method, local_entry)) {
-			if (central_entry->compressed_size != local_entry.compressed_size) {
-				if (local_entry.compressed_size == 0) {
-					local_entry.compressed_size = central_entry->compressed_size;
-				} else {
-					Output::Warning("ZipFS: Compressed size mismatch {}: {} != {}", path_normalized, central_entry->compressed_size, local_entry.compressed_size);
-					return nullptr;
-				}
-			}
+	if (!central_entry || central_entry->is_directory) {
+		return nullptr;
+	}
 
-			if (central_entry->uncompressed_size != local_entry.uncompressed_size) {
-				if (local_entry.uncompressed_size == 0) {
-					local_entry.uncompressed_size = central_entry->uncompressed_size;
-				} else {
-					Output::Warning("ZipFS: Uncompressed size mismatch {}: {} != {}", path_normalized, central_entry->uncompressed_size, local_entry.uncompressed_size);
-					return nullptr;
-				}
-			}
+	// Every stream uses an own handle on the archive to allow reading
+	// multiple files at the same time
+	auto zip_is = GetParent().OpenInputStream(GetPath());
+	if (!zip_is) {
+		return nullptr;
+	}
 
-			if (local_entry.compressed_size == 0xffffffff || local_entry.uncompressed_size == 0xffffffff) {
-				Output::Warning("ZipFS: Zip64 is not supported {}", path_normalized);
-				return nullptr;
-			}
+	zip_is.seekg(central_entry->fileoffset);
+	StorageMethod method;
+	ZipEntry local_entry = {};
+	if (!ReadLocalHeader(zip_is, method, local_entry)) {
+		return nullptr;
+	}
 
-			zip_is.seekg(central_entry->fileoffset + local_entry.fileoffset);
-			if (method == StorageMethod::Plain) {
-				auto data = std::vector<uint8_t>(local_entry.uncompressed_size);
-				zip_is.read(reinterpret_cast<char*>(data.data()), data.size());
-				return new Filesystem_Stream::InputMemoryStreamBuf(std::move(data));
-			} else if (method == StorageMethod::Deflate) {
-				std::vector<uint8_t> comp_buf;
-				comp_buf.resize(local_entry.compressed_size);
-				zip_is.read(reinterpret_cast<char*>(comp_buf.data()), comp_buf.size());
-				auto dec_buf = std::vector<uint8_t>(local_entry.uncompressed_size);
-				z_stream zlib_stream = {};
-				zlib_stream.next_in = reinterpret_cast<Bytef*>(comp_buf.data());
-				zlib_stream.avail_in = static_cast<uInt>(comp_buf.size());
-				zlib_stream.next_out = reinterpret_cast<Bytef*>(dec_buf.data());
-				zlib_stream.avail_out = static_cast<uInt>(dec_buf.size());
-				inflateInit2(&zlib_stream, -MAX_WBITS);
-				auto inflate_sg = lcf::makeScopeGuard([&]() {
-					inflateEnd(&zlib_stream);
-				});
-
-				int zlib_error = inflate(&zlib_stream, Z_NO_FLUSH);
-				if (zlib_error == Z_OK) {
-					Output::Warning("ZipFS: zlib failed for {}: More data available (Archive corrupted?)", path_normalized);
-					return nullptr;
-				}
-				else if (zlib_error != Z_STREAM_END) {
-					Output::Warning("ZipFS: zlib failed for {}: {} ({})", path_normalized, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
-					return nullptr;
-				}
-				return new Filesystem_Stream::InputMemoryStreamBuf(std::move(dec_buf));
-			} else {
-				Output::Warning("ZipFS: {} has unsupported compression format. Only Deflate is supported", path_normalized);
-				return nullptr;
-			}
+	if (central_entry->compressed_size != local_entry.compressed_size) {
+		if (local_entry.compressed_size == 0) {
+			local_entry.compressed_size = central_entry->compressed_size;
+		} else {
+			Output::Warning("ZipFS: Compressed size mismatch {}: {} != {}", path_normalized, central_entry->compressed_size, local_entry.compressed_size);
+			return nullptr;
 		}
 	}
-	return nullptr;
+
+	if (central_entry->uncompressed_size != local_entry.uncompressed_size) {
+		if (local_entry.uncompressed_size == 0) {
+			local_entry.uncompressed_size = central_entry->uncompressed_size;
+		} else {
+			Output::Warning("ZipFS: Uncompressed size mismatch {}: {} != {}", path_normalized, central_entry->uncompressed_size, local_entry.uncompressed_size);
+			return nullptr;
+		}
+	}
+
+	if (local_entry.compressed_size == 0xffffffff || local_entry.uncompressed_size == 0xffffffff) {
+		Output::Warning("ZipFS: Zip64 is not supported {}", path_normalized);
+		return nullptr;
+	}
+
+	const uint32_t data_offset = central_entry->fileoffset + local_entry.fileoffset;
+
+	if (method == StorageMethod::Plain) {
+		return new ZipStoredStreamBuf(std::move(zip_is), data_offset, local_entry.uncompressed_size);
+	} else if (method == StorageMethod::Deflate) {
+		if (local_entry.uncompressed_size > ZipInflateStreamBuf::window_size) {
+			return new ZipInflateStreamBuf(std::move(zip_is), std::move(path_normalized), data_offset,
+				local_entry.compressed_size, local_entry.uncompressed_size);
+		}
+
+		// Small files are inflated at once, this allows cheap random access
+		zip_is.seekg(data_offset);
+		std::vector<uint8_t> comp_buf;
+		comp_buf.resize(local_entry.compressed_size);
+		zip_is.read(reinterpret_cast<char*>(comp_buf.data()), comp_buf.size());
+		auto dec_buf = std::vector<uint8_t>(local_entry.uncompressed_size);
+		z_stream zlib_stream = {};
+		zlib_stream.next_in = reinterpret_cast<Bytef*>(comp_buf.data());
+		zlib_stream.avail_in = static_cast<uInt>(comp_buf.size());
+		zlib_stream.next_out = reinterpret_cast<Bytef*>(dec_buf.data());
+		zlib_stream.avail_out = static_cast<uInt>(dec_buf.size());
+		inflateInit2(&zlib_stream, -MAX_WBITS);
+		auto inflate_sg = lcf::makeScopeGuard([&]() {
+			inflateEnd(&zlib_stream);
+		});
+
+		int zlib_error = inflate(&zlib_stream, Z_NO_FLUSH);
+		if (zlib_error == Z_OK) {
+			Output::Warning("ZipFS: zlib failed for {}: More data available (Archive corrupted?)", path_normalized);
+			return nullptr;
+		}
+		else if (zlib_error != Z_STREAM_END) {
+			Output::Warning("ZipFS: zlib failed for {}: {} ({})", path_normalized, zlib_error, zlib_stream.msg ? zlib_stream.msg : "No error message");
+			return nullptr;
+		}
+		return new Filesystem_Stream::InputMemoryStreamBuf(std::move(dec_buf));
+	} else {
+		Output::Warning("ZipFS: {} has unsupported compression format. Only Deflate is supported", path_normalized);
+		return nullptr;
+	}
 }
 
 bool ZipFilesystem::GetDirectoryContent(std::string_view path, std::vector<DirectoryTree::Entry>& entries) const {
@@ -45,6 +45,7 @@
 #include "filefinder.h"
 #include "output.h"
 #include "font.h"
+#include "glyph_cache.h"
 #include "bitmap.h"
 #include "utils.h"
 #include "cache.h"
@@ -250,7 +251,9 @@ namespace {
 
 BitmapFont::BitmapFont(std::string_view name, function_type func)
 	: Font(name, HEIGHT, false, false), func(func)
-{}
+{
+	glyph_cache = std::make_unique<GlyphCache>(true);
+}
 
 Rect BitmapFont::vGetSize(char32_t glyph) const {
 	auto bm_glyph = func(glyph);
@@ -312,6 +315,8 @@ FTFont::FTFont(Filesystem_Stream::InputStream is, int size, bool bold, bool ital
 		// Workaround for bad kerning in RM2000 and RMG2000 fonts
 		rm2000_workaround = true;
 	}
+
+	glyph_cache = std::make_unique<GlyphCache>(false);
 }
 
 FTFont::~FTFont() {
@@ -672,6 +677,11 @@ void Font::ResetDefault() {
 	SetDefault(nullptr, true);
 	SetDefault(nullptr, false);
 
+	// The glyph lookup of the builtin fonts depends on the game encoding
+	for (auto& font: { gothic, mincho, rmg2000, ttyp0 }) {
+		font->ClearGlyphCache();
+	}
+
 #ifdef HAVE_FREETYPE
 	auto& cfg = Player::player_config;
 	if (!cfg.font1.Get().empty()) {
@@ -711,6 +721,8 @@ Font::Font(std::string_view name, int size, bool bold, bool italic)
 	current_style = original_style;
 }
 
+Font::~Font() = default;
+
 std::string_view Font::GetName() const {
 	return name;
 }
@@ -742,7 +754,7 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 		return {};
 	}
 
-	auto gret = vRender(glyph);
+	auto gret = GetGlyph(glyph, false);
 
 	if (EP_UNLIKELY(!RenderImpl(dest, x, y, sys, color, gret))) {
 		return {};
@@ -758,7 +770,7 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 		return Render(dest, x, y, sys, color, shape.code);
 	}
 
-	auto gret = vRenderShaped(shape.code);
+	auto gret = GetGlyph(shape.code, true);
 
 	if (EP_UNLIKELY(!RenderImpl(dest, x, y, sys, color, gret))) {
 		return {};
@@ -768,12 +780,32 @@ Point Font::Render(Bitmap& dest, int const x, int const y, const Bitmap& sys, in
 	return advance;
 }
 
+Font::GlyphRet Font::GetGlyph(char32_t glyph, bool shaped) const {
+	if (glyph_cache) {
+		auto* cached = glyph_cache->Find(glyph, current_style.size, shaped);
+		if (cached) {
+			return *cached;
+		}
+	}
+
+	auto gret = shaped ? vRenderShaped(glyph) : vRender(glyph);
+	if (gret.bitmap && gret.rect == Rect()) {
+		gret.rect = gret.bitmap->GetRect();
+	}
+
+	if (glyph_cache) {
+		return glyph_cache->Insert(glyph, current_style.size, shaped, gret);
+	}
+	return gret;
+}
+
 bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys, int color, const GlyphRet& gret) const {
 	if (EP_UNLIKELY(gret.bitmap == nullptr)) {
 		return false;
 	}
 
-	auto rect = Rect(x, y, gret.bitmap->width(), gret.bitmap->height());
+	const auto& glyph_rect = gret.rect;
+	auto rect = Rect(x, y, glyph_rect.width, glyph_rect.height);
 	if (EP_UNLIKELY(rect.width == 0)) {
 		return false;
 	}
@@ -785,7 +817,7 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 	unsigned src_x = 0;
 	unsigned src_y = 0;
 
-	int glyph_height = gret.bitmap->height() - gret.offset.y;
+	int glyph_height = glyph_rect.height - gret.offset.y;
 
 	// Adjust how the mask is applied depending on the glyph size to prevent that
 	// pixels from outside of the mask color are read
@@ -811,7 +843,7 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 			// First draw the shadow, offset by one
 			if (!gret.has_color && current_style.draw_shadow) {
 				auto shadow_rect = Rect(rect.x + 1, rect.y + 1, rect.width, rect.height);
-				dest.MaskedBlit(shadow_rect, *gret.bitmap, 0, 0, *sys_large, 0, 0);
+				dest.MaskedBlit(shadow_rect, *gret.bitmap, glyph_rect.x, glyph_rect.y, *sys_large, 0, 0);
 			}
 
 			src_x = current_style.size;
@@ -820,15 +852,15 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 
 		if (!gret.has_color) {
 			if (current_style.draw_gradient) {
-				dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *sys_large, src_x, src_y);
+				dest.MaskedBlit(rect, *gret.bitmap, glyph_rect.x, glyph_rect.y, *sys_large, src_x, src_y);
 			} else {
 				auto col = sys.GetColorAt(current_style.color_offset.x + src_x, current_style.color_offset.y + src_y);
-				auto col_bm = Bitmap::Create(gret.bitmap->width(), gret.bitmap->height(), col);
-				dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *col_bm, 0, 0);
+				auto col_bm = Bitmap::Create(glyph_rect.width, glyph_rect.height, col);
+				dest.MaskedBlit(rect, *gret.bitmap, glyph_rect.x, glyph_rect.y, *col_bm, 0, 0);
 			}
 		} else {
 			// Color glyphs, emojis etc.
-			dest.Blit(rect.x, rect.y, *gret.bitmap, gret.bitmap->GetRect(), Opacity::Opaque());
+			dest.Blit(rect.x, rect.y, *gret.bitmap, glyph_rect, Opacity::Opaque());
 		}
 
 		return true;
@@ -839,7 +871,7 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 		// First draw the shadow, offset by one
 		if (!gret.has_color && current_style.draw_shadow) {
 			auto shadow_rect = Rect(rect.x + 1, rect.y + 1, rect.width, rect.height);
-			dest.MaskedBlit(shadow_rect, *gret.bitmap, 0, 0, sys, 16, 32);
+			dest.MaskedBlit(shadow_rect, *gret.bitmap, glyph_rect.x, glyph_rect.y, sys, 16, 32);
 		}
 
 		src_x = color % 10 * 16 + 2;
@@ -859,15 +891,15 @@ bool Font::RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys,
 				src_y -= glyph_height - 12;
 			}
 
-			dest.MaskedBlit(rect, *gret.bitmap, 0, 0, sys, src_x, src_y);
+			dest.MaskedBlit(rect, *gret.bitmap, glyph_rect.x, glyph_rect.y, sys, src_x, src_y);
 		} else {
 			auto col = sys.GetColorAt(current_style.color_offset.x + src_x, current_style.color_offset.y + src_y);
-			auto col_bm = Bitmap::Create(gret.bitmap->width(), gret.bitmap->height(), col);
-			dest.MaskedBlit(rect, *gret.bitmap, 0, 0, *col_bm, 0, 0);
+			auto col_bm = Bitmap::Create(glyph_rect.width, glyph_rect.height, col);
+			dest.MaskedBlit(rect, *gret.bitmap, glyph_rect.x, glyph_rect.y, *col_bm, 0, 0);
 		}
 	} else {
 		// Color glyphs, emojis etc.
-		dest.Blit(rect.x, rect.y, *gret.bitmap, gret.bitmap->GetRect(), Opacity::Opaque());
+		dest.Blit(rect.x, rect.y, *gret.bitmap, glyph_rect, Opacity::Opaque());
 	}
 
 	return true;
@@ -878,13 +910,13 @@ Point Font::Render(Bitmap& dest, int x, int y, Color const& color, char32_t glyp
 		return {};
 	}
 
-	auto gret = vRender(glyph);
+	auto gret = GetGlyph(glyph, false);
 	if (EP_UNLIKELY(gret.bitmap == nullptr)) {
 		return {};
 	}
 
-	auto rect = Rect(x, y, gret.bitmap->width(), gret.bitmap->height());
-	dest.MaskedBlit(rect, *gret.bitmap, 0, 0, color);
+	auto rect = Rect(x, y, gret.rect.width, gret.rect.height);
+	dest.MaskedBlit(rect, *gret.bitmap, gret.rect.x, gret.rect.y, color);
 
 	gret.advance.x += current_style.letter_spacing;
 
@@ -903,6 +935,14 @@ std::vector<Font::ShapeRet> Font::Shape(std::u32string_view text) const {
 
 void Font::SetFallbackFont(FontRef fallback_font) {
 	this->fallback_font = fallback_font;
+	// Glyphs missing in this font were rendered by the old fallback
+	ClearGlyphCache();
+}
+
+void Font::ClearGlyphCache() {
+	if (glyph_cache) {
+		glyph_cache->Clear();
+	}
 }
 
 bool Font::IsStyleApplied() const {
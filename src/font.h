@@ -29,7 +29,7 @@
 #include <lcf/scope_guard.h>
 
 class Color;
-class Rect;
+class GlyphCache;
 
 /**
  * Font class.
@@ -55,6 +55,11 @@ class Font {
 		Point offset;
 		/** When enabled the glyph is colored and not masked with the system graphic */
 		bool has_color = false;
+		/**
+		 * Area of bitmap containing the glyph.
+		 * vRender implementations can leave this empty, the whole bitmap is used then.
+		 */
+		Rect rect;
 	};
 
 	/** Contains metrics of a glyph shaped by Harfbuzz */
@@ -96,7 +101,7 @@ class Font {
 		int letter_spacing = 0;
 	};
 
-	virtual ~Font() = default;
+	virtual ~Font();
 
 	/**
 	 * @return Name of the font
@@ -195,6 +200,11 @@ class Font {
 	 */
 	void SetFallbackFont(FontRef fallback_font);
 
+	/**
+	 * Removes all rendered glyphs from the glyph cache of this font.
+	 */
+	void ClearGlyphCache();
+
 	using StyleScopeGuard = lcf::ScopeGuard<std::function<void()>>;
 
 	/**
@@ -262,8 +272,19 @@ class Font {
 	Style original_style;
 	Style current_style;
 	FontRef fallback_font;
+	/** Rendered glyphs, only used by fonts whose glyphs never change */
+	std::unique_ptr<GlyphCache> glyph_cache;
 
 private:
+	/**
+	 * Renders a glyph or fetches it from the glyph cache.
+	 *
+	 * @param glyph codepoint or glyph index
+	 * @param shaped when true glyph is a glyph index and vRenderShaped is used
+	 * @return rendered glyph with a valid rect
+	 */
+	GlyphRet GetGlyph(char32_t glyph, bool shaped) const;
+
 	bool RenderImpl(Bitmap& dest, int const x, int const y, const Bitmap& sys, int color, const GlyphRet& gret) const;
 };
 
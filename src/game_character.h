@@ -947,6 +947,8 @@ protected:
 	lcf::rpg::SaveMapEventBase* data();
 	const lcf::rpg::SaveMapEventBase* data() const;
 
+	void OnPositionChanged(int old_x, int old_y);
+
 	int original_move_frequency = 2;
 	// contains if any movement (<= step_forward) of a forced move route was successful
 
@@ -999,7 +1001,11 @@ inline int Game_Character::GetX() const {
 }
 
 inline void Game_Character::SetX(int new_x) {
+	const int old_x = data()->position_x;
 	data()->position_x = new_x;
+	if (old_x != new_x) {
+		OnPositionChanged(old_x, GetY());
+	}
 }
 
 inline int Game_Character::GetY() const {
@@ -1007,7 +1013,11 @@ inline int Game_Character::GetY() const {
 }
 
 inline void Game_Character::SetY(int new_y) {
+	const int old_y = data()->position_y;
 	data()->position_y = new_y;
+	if (old_y != new_y) {
+		OnPositionChanged(GetX(), old_y);
+	}
 }
 
 inline int Game_Character::GetMapId() const {
@@ -76,6 +76,16 @@ public:
 	/** @return the speed up or slowdown factor we'll use to run the game. */
 	static float GetGameSpeedFactor();
 
+	/**
+	 * Enable or disable the max speed mode. In this mode every frame runs exactly
+	 * one simulation step, independent of the elapsed real time, and the main loop
+	 * does not wait for the frame limit. Used for running input replays headless.
+	 */
+	static void SetMaxSpeed(bool enabled);
+
+	/** @return Whether the max speed mode is enabled */
+	static bool IsMaxSpeed();
+
 	/** Get the time of the current frame */
 	static time_point GetFrameTime();
 
@@ -117,6 +127,7 @@ private:
 		float speed = 1.0;
 		float fps = 0.0;
 		int frame = 0;
+		bool max_speed = false;
 	};
 	static Data data;
 };
@@ -180,4 +191,12 @@ inline float Game_Clock::GetGameSpeedFactor() {
 	return data.speed;
 }
 
+inline void Game_Clock::SetMaxSpeed(bool enabled) {
+	data.max_speed = enabled;
+}
+
+inline bool Game_Clock::IsMaxSpeed() {
+	return data.max_speed;
+}
+
 #endif
@@ -527,6 +527,12 @@ void Game_Config::LoadFromArgs(CmdlineParser& cp) {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--sound-cache-size")) {
+			if (arg.ParseValue(0, li_value)) {
+				audio.sound_cache_size.Set(li_value);
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--soundfont")) {
 			if (arg.NumValues() > 0) {
 				audio.soundfont.Set(arg.Value(0));
@@ -575,6 +581,10 @@ void Game_Config::LoadFromArgs(CmdlineParser& cp) {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 0, {"--preload-maps", "--no-preload-maps"})) {
+			player.preload_maps.Set(arg.ArgIsOn());
+			continue;
+		}
 
 		cp.SkipNext();
 	}
@@ -611,6 +621,7 @@ void Game_Config::LoadFromStream(Filesystem_Stream::InputStream& is) {
 	/** AUDIO SECTION */
 	audio.music_volume.FromIni(ini);
 	audio.sound_volume.FromIni(ini);
+	audio.sound_cache_size.FromIni(ini);
 	audio.fluidsynth_midi.FromIni(ini);
 	audio.wildmidi_midi.FromIni(ini);
 	audio.native_midi.FromIni(ini);
@@ -681,6 +692,7 @@ void Game_Config::LoadFromStream(Filesystem_Stream::InputStream& is) {
 	player.screenshot_timestamp.FromIni(ini);
 	player.automatic_screenshots.FromIni(ini);
 	player.automatic_screenshots_interval.FromIni(ini);
+	player.preload_maps.FromIni(ini);
 }
 
 void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
@@ -713,6 +725,7 @@ void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
 
 	audio.music_volume.ToIni(os);
 	audio.sound_volume.ToIni(os);
+	audio.sound_cache_size.ToIni(os);
 	audio.fluidsynth_midi.ToIni(os);
 	audio.wildmidi_midi.ToIni(os);
 	audio.native_midi.ToIni(os);
@@ -774,6 +787,7 @@ void Game_Config::WriteToStream(Filesystem_Stream::OutputStream& os) const {
 	player.screenshot_timestamp.ToIni(os);
 	player.automatic_screenshots.ToIni(os);
 	player.automatic_screenshots_interval.ToIni(os);
+	player.preload_maps.ToIni(os);
 
 	os << "\n";
 }
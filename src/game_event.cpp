@@ -60,6 +60,7 @@ void Game_Event::SetSaveData(lcf::rpg::SaveMapEvent save)
 	// 2k Savegames have 0 for the mapid for compatibility with RPG_RT.
 	auto map_id = GetMapId();
 	*data() = std::move(save);
+	Game_Map::InvalidateEventIndex();
 
 	data()->ID = event->ID;
 	SetMapId(map_id);
@@ -0,0 +1,242 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "game_index.h"
+#include <algorithm>
+#include <istream>
+#include <locale>
+#include <ostream>
+#include <sstream>
+#include <fmt/format.h>
+#include "output.h"
+#include "utils.h"
+
+namespace {
+	constexpr const char* header = "EasyRPG GameIndex 1";
+
+	// directory, name, size, mtime, project type, title
+	constexpr int num_fields = 6;
+
+	std::string Escape(std::string_view s) {
+		std::string out;
+		out.reserve(s.size());
+		for (char c: s) {
+			switch (c) {
+				case '\\': out += "\\\\"; break;
+				case '\t': out += "\\t"; break;
+				case '\n': out += "\\n"; break;
+				case '\r': out += "\\r"; break;
+				default: out += c;
+			}
+		}
+		return out;
+	}
+
+	std::string Unescape(std::string_view s) {
+		std::string out;
+		out.reserve(s.size());
+		for (size_t i = 0; i < s.size(); ++i) {
+			if (s[i] != '\\' || i + 1 == s.size()) {
+				out += s[i];
+				continue;
+			}
+			switch (s[++i]) {
+				case 't': out += '\t'; break;
+				case 'n': out += '\n'; break;
+				case 'r': out += '\r'; break;
+				default: out += s[i];
+			}
+		}
+		return out;
+	}
+
+	std::vector<std::string_view> SplitFields(std::string_view line) {
+		std::vector<std::string_view> fields;
+		size_t start = 0;
+		for (;;) {
+			size_t end = line.find('\t', start);
+			if (end == std::string_view::npos) {
+				fields.push_back(line.substr(start));
+				return fields;
+			}
+			fields.push_back(line.substr(start, end - start));
+			start = end + 1;
+		}
+	}
+
+	template <typename T>
+	bool ParseNumber(std::string_view s, T& out) {
+		std::istringstream iss{std::string(s)};
+		iss.imbue(std::locale::classic());
+		iss >> out;
+		return !iss.fail() && iss.peek() == std::char_traits<char>::eof();
+	}
+}
+
+GameIndex GameIndex::Load(const FilesystemView& fs) {
+	GameIndex index;
+
+	auto file = fs.FindFile(filename);
+	if (file.empty()) {
+		return index;
+	}
+
+	auto is = fs.OpenInputStream(file);
+	if (!is || !index.Read(is)) {
+		Output::Debug("GameIndex: {} is invalid, ignoring it", file);
+	}
+	return index;
+}
+
+bool GameIndex::Save(const FilesystemView& fs) {
+	auto file = fs.FindFile(filename);
+	if (file.empty()) {
+		file = filename;
+	}
+
+	auto os = fs.OpenOutputStream(file);
+	if (!os) {
+		Output::Debug("GameIndex: Cannot write {}", file);
+		return false;
+	}
+
+	Write(os);
+	modified = false;
+	return true;
+}
+
+bool GameIndex::Read(std::istream& is) {
+	directories.clear();
+	modified = false;
+
+	std::string line;
+	if (!Utils::ReadLine(is, line) || line != header) {
+		return false;
+	}
+
+	while (Utils::ReadLine(is, line)) {
+		if (line.empty()) {
+			continue;
+		}
+
+		auto fields = SplitFields(line);
+		if (fields.size() != num_fields) {
+			directories.clear();
+			return false;
+		}
+
+		Entry entry;
+		int type = 0;
+		bool ok = ParseNumber(fields[2], entry.size)
+			&& ParseNumber(fields[3], entry.mtime)
+			&& ParseNumber(fields[4], type);
+
+		if (!ok || fields[1].empty() || type < 0 || type >= static_cast<int>(FileFinder::ProjectType::LAST)) {
+			directories.clear();
+			return false;
+		}
+		entry.type = static_cast<FileFinder::ProjectType>(type);
+		entry.title = Unescape(fields[5]);
+
+		directories[Unescape(fields[0])][Unescape(fields[1])] = std::move(entry);
+	}
+
+	return true;
+}
+
+void GameIndex::Write(std::ostream& os) const {
+	os << header << "\n";
+
+	for (const auto& dir: directories) {
+		const auto dir_name = Escape(dir.first);
+		for (const auto& it: dir.second) {
+			const auto& e = it.second;
+			os << fmt::format("{}\t{}\t{}\t{}\t{}\t{}\n",
+				dir_name, Escape(it.first), e.size, e.mtime,
+				static_cast<int>(e.type), Escape(e.title));
+		}
+	}
+}
+
+const GameIndex::Entry* GameIndex::Find(std::string_view dir, std::string_view name, int64_t size, int64_t mtime) const {
+	if (size < 0 || mtime < 0) {
+		return nullptr;
+	}
+
+	auto dir_it = directories.find(dir);
+	if (dir_it == directories.end()) {
+		return nullptr;
+	}
+
+	auto it = dir_it->second.find(name);
+	if (it == dir_it->second.end() || it->second.size != size || it->second.mtime != mtime) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+void GameIndex::Update(std::string_view dir, std::string_view name, Entry entry) {
+	auto dir_it = directories.find(dir);
+
+	if (entry.size < 0 || entry.mtime < 0) {
+		if (dir_it != directories.end()) {
+			auto it = dir_it->second.find(name);
+			if (it != dir_it->second.end()) {
+				dir_it->second.erase(it);
+				modified = true;
+			}
+		}
+		return;
+	}
+
+	if (dir_it == directories.end()) {
+		dir_it = directories.emplace(ToString(dir), DirectoryEntries()).first;
+	}
+
+	auto it = dir_it->second.find(name);
+	if (it == dir_it->second.end()) {
+		dir_it->second.emplace(ToString(name), std::move(entry));
+	} else {
+		it->second = std::move(entry);
+	}
+	modified = true;
+}
+
+void GameIndex::Retain(std::string_view dir, const std::vector<std::string>& names) {
+	auto dir_it = directories.find(dir);
+	if (dir_it == directories.end()) {
+		return;
+	}
+
+	std::vector<std::string_view> sorted_names(names.begin(), names.end());
+	std::sort(sorted_names.begin(), sorted_names.end());
+
+	auto& games = dir_it->second;
+	for (auto it = games.begin(); it != games.end();) {
+		if (!std::binary_search(sorted_names.begin(), sorted_names.end(), std::string_view(it->first))) {
+			it = games.erase(it);
+			modified = true;
+		} else {
+			++it;
+		}
+	}
+
+	if (games.empty()) {
+		directories.erase(dir_it);
+	}
+}
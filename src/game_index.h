@@ -0,0 +1,142 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_INDEX_H
+#define EP_GAME_INDEX_H
+
+// Headers
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+#include "filefinder.h"
+#include "filesystem.h"
+#include "string_view.h"
+
+/**
+ * Persistent index of the games found by the game browser.
+ *
+ * Determining the project type of a game requires opening the game
+ * directory or archive. For archives this means parsing the whole
+ * central directory. The index remembers the result for every entry of a
+ * browsed directory. An entry is only used when size and modification
+ * time of the game directory or archive still match, otherwise the game
+ * must be probed again.
+ */
+class GameIndex {
+public:
+	/** Name of the index file in the config directory */
+	static constexpr const char* filename = "easyrpg_gameindex.txt";
+
+	struct Entry {
+		int64_t size = -1;
+		int64_t mtime = -1;
+		FileFinder::ProjectType type = FileFinder::ProjectType::Unknown;
+		/** GameTitle of the RPG_RT.ini, empty when unknown */
+		std::string title;
+	};
+
+	/**
+	 * Reads the index from a directory.
+	 * A missing or broken index file results in an empty index.
+	 *
+	 * @param fs directory containing the index
+	 * @return index
+	 */
+	static GameIndex Load(const FilesystemView& fs);
+
+	/**
+	 * Writes the index to a directory.
+	 *
+	 * @param fs directory containing the index
+	 * @return Whether writing was successful
+	 */
+	bool Save(const FilesystemView& fs);
+
+	/**
+	 * Reads the index from a stream, replacing all entries.
+	 *
+	 * @param is stream to read
+	 * @return false when the stream does not contain a valid index
+	 */
+	bool Read(std::istream& is);
+
+	/**
+	 * Writes the index to a stream.
+	 *
+	 * @param os stream to write
+	 */
+	void Write(std::ostream& os) const;
+
+	/**
+	 * Looks up a game.
+	 *
+	 * @param dir full path of the browsed directory
+	 * @param name name of the game directory or archive
+	 * @param size current size of the game directory or archive
+	 * @param mtime current modification time of the game directory or archive
+	 * @return entry or nullptr when the game is not indexed or the entry is stale
+	 */
+	const Entry* Find(std::string_view dir, std::string_view name, int64_t size, int64_t mtime) const;
+
+	/**
+	 * Stores the probing result of a game.
+	 * Nothing is stored when size or modification time are unknown.
+	 *
+	 * @param dir full path of the browsed directory
+	 * @param name name of the game directory or archive
+	 * @param entry size, modification time, project type and title of the game
+	 */
+	void Update(std::string_view dir, std::string_view name, Entry entry);
+
+	/**
+	 * Removes the entries of a directory that are not in the list.
+	 * Used to forget games that were deleted or renamed.
+	 *
+	 * @param dir full path of the browsed directory
+	 * @param names names of all games in the directory
+	 */
+	void Retain(std::string_view dir, const std::vector<std::string>& names);
+
+	/** @return Amount of indexed games */
+	size_t GetSize() const;
+
+	/** @return Whether entries changed since the last Load, Read or Save */
+	bool IsModified() const;
+
+private:
+	using DirectoryEntries = std::map<std::string, Entry, std::less<>>;
+
+	/** Games by name for every browsed directory */
+	std::map<std::string, DirectoryEntries, std::less<>> directories;
+	bool modified = false;
+};
+
+inline size_t GameIndex::GetSize() const {
+	size_t size = 0;
+	for (const auto& it: directories) {
+		size += it.second.size();
+	}
+	return size;
+}
+
+inline bool GameIndex::IsModified() const {
+	return modified;
+}
+
+#endif
@@ -44,6 +44,7 @@
 #include "game_runtime_patches.h"
 #include "game_screen.h"
 #include "game_interpreter_control_variables.h"
+#include "instrumentation.h"
 #include "game_windows.h"
 #include "json_helper.h"
 #include "maniac_patch.h"
@@ -90,6 +91,7 @@ void Game_Interpreter::Clear() {
 	_state = {};
 	_keyinput = {};
 	_async_op = {};
+	_jump_tables.clear();
 }
 
 // Is interpreter running.
@@ -141,6 +143,10 @@ void Game_Interpreter::PushInternal(
 	}
 
 	_state.stack.push_back(std::move(frame));
+
+	// A new frame can reuse the slot of a popped frame
+	_jump_tables.resize(_state.stack.size());
+	_jump_tables.back() = {};
 }
 
 
@@ -371,6 +377,8 @@ int Game_Interpreter::GetSubcommandIndex(int indent) const {
 
 // Update
 void Game_Interpreter::Update(bool reset_loop_count) {
+	Instrumentation::Scope iscope("Game_Interpreter::Update");
+
 	if (reset_loop_count) {
 		loop_count = 0;
 	}
@@ -585,15 +593,18 @@ void Game_Interpreter::SkipToNextConditional(std::initializer_list<Cmd> codes, i
 		return;
 	}
 
-	for (++index; index < static_cast<int>(list.size()); ++index) {
-		const auto& com = list[index];
-		if (com.indent > indent) {
-			continue;
-		}
-		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
-			break;
-		}
+	index = GetJumpTable().FindNext(index, indent, codes);
+}
+
+const InterpreterJumpTable& Game_Interpreter::GetJumpTable() {
+	const auto& list = GetFrame().commands;
+
+	_jump_tables.resize(_state.stack.size());
+	auto& table = _jump_tables.back();
+	if (!table.IsFor(list)) {
+		table = InterpreterJumpTable(list);
 	}
+	return table;
 }
 
 // Execute Command.
@@ -1077,15 +1088,15 @@ bool Game_Interpreter::CommandControlSwitches(lcf::rpg::EventCommand const& com)
 			} else {
 				Main_Data::game_switches->Flip(start);
 			}
-			Game_Map::SetNeedRefreshForSwitchChange(start);
 		} else {
 			if (val < 2) {
 				Main_Data::game_switches->SetRange(start, end, val == 0);
 			} else {
 				Main_Data::game_switches->FlipRange(start, end);
 			}
-			Game_Map::SetNeedRefresh(true);
 		}
+		// Only switches whose value changed affect the event pages
+		Game_Map::SetNeedRefreshForSwitchChanges(*Main_Data::game_switches);
 	}
 	return true;
 }
@@ -1366,7 +1377,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRangeVariable(start, end, var_id);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRangeChange(start, end);
 		} else if (com.parameters[4] == 2) {
 			// Multiple variables - Indirect variable lookup
 			int var_id = com.parameters[5];
@@ -1405,7 +1416,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRangeVariableIndirect(start, end, var_id);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRangeChange(start, end);
 		} else if (com.parameters[4] == 3) {
 			// Multiple variables - random
 			int rmax = max(com.parameters[5], com.parameters[6]);
@@ -1445,7 +1456,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRangeRandom(start, end, rmin, rmax);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRangeChange(start, end);
 		} else {
 			// Multiple variables - constant
 			switch (operation) {
@@ -1483,7 +1494,7 @@ bool Game_Interpreter::CommandControlVariables(lcf::rpg::EventCommand const& com
 					Main_Data::game_variables->BitShiftRightRange(start, end, value);
 					break;
 			}
-			Game_Map::SetNeedRefresh(true);
+			Game_Map::SetNeedRefreshForVarRangeChange(start, end);
 		}
 	}
 
@@ -3755,18 +3766,13 @@ bool Game_Interpreter::CommandEndBranch(lcf::rpg::EventCommand const& /* com */)
 
 bool Game_Interpreter::CommandJumpToLabel(lcf::rpg::EventCommand const& com) { // code 12120
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
 	auto& index = frame.current_command;
 
 	int label_id = com.parameters[0];
 
-	for (int idx = 0; (size_t)idx < list.size(); idx++) {
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Label)
-			continue;
-		if (list[idx].parameters.empty() || list[idx].parameters[0] != label_id)
-			continue;
+	int idx = GetJumpTable().FindLabel(label_id);
+	if (idx >= 0) {
 		index = idx;
-		break;
 	}
 
 	return true;
@@ -3850,20 +3856,13 @@ bool Game_Interpreter::CommandBreakLoop(lcf::rpg::EventCommand const& /* com */)
 
 	// This emulates an RPG_RT bug where break loop ignores scopes and
 	// unconditionally jumps to the next EndLoop command.
-	auto pcode = static_cast<Cmd>(list[index].code);
-	for (++index; index < (int)list.size(); ++index) {
-		if (pcode == Cmd::EndLoop) {
-			break;
-		}
-		pcode = static_cast<Cmd>(list[index].code);
-	}
+	index = std::min(GetJumpTable().FindNextEndLoop(index) + 1, static_cast<int>(list.size()));
 
 	return true;
 }
 
 bool Game_Interpreter::CommandEndLoop(lcf::rpg::EventCommand const& com) { // code 22210
 	auto& frame = GetFrame();
-	const auto& list = frame.commands;
 	auto& index = frame.current_command;
 
 	int indent = com.indent;
@@ -3920,15 +3919,12 @@ bool Game_Interpreter::CommandEndLoop(lcf::rpg::EventCommand const& com) { // co
 	}
 
 	// Restart the loop
-	for (int idx = index; idx >= 0; idx--) {
-		if (list[idx].indent > indent)
-			continue;
-		if (list[idx].indent < indent)
-			return false;
-		if (static_cast<Cmd>(list[idx].code) != Cmd::Loop)
-			continue;
+	int idx = GetJumpTable().FindPrevious(index, indent, Cmd::Loop);
+	if (idx == -1) {
+		return false;
+	}
+	if (idx >= 0) {
 		index = idx;
-		break;
 	}
 
 	// Jump past the Cmd::Loop to the first command.
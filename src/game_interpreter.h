@@ -26,6 +26,7 @@
 #include "game_character.h"
 #include "game_actor.h"
 #include "game_interpreter_shared.h"
+#include "game_interpreter_jump_table.h"
 #include <lcf/dbarray.h>
 #include <lcf/rpg/fwd.h>
 #include <lcf/rpg/eventcommand.h>
@@ -174,6 +175,14 @@ protected:
 	 */
 	void SkipToNextConditional(std::initializer_list<Cmd> codes, int indent);
 
+	/**
+	 * Returns the control flow analysis of the current frame.
+	 * The analysis is built on first use and kept until the frame is popped.
+	 *
+	 * @return jump table of the current frame
+	 */
+	const InterpreterJumpTable& GetJumpTable();
+
 	/**
 	 * Sets up a wait (and closes the message box)
 	 */
@@ -360,6 +369,9 @@ protected:
 	KeyInputState _keyinput;
 	AsyncOp _async_op = {};
 
+	/** Jump tables of the stack frames, indexed like _state.stack */
+	std::vector<InterpreterJumpTable> _jump_tables;
+
 	private:
 		void PushInternal(
 			InterpreterPush push_info,
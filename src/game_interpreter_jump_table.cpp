@@ -0,0 +1,131 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "game_interpreter_jump_table.h"
+#include <algorithm>
+
+InterpreterJumpTable::InterpreterJumpTable(const std::vector<lcf::rpg::EventCommand>& list)
+	: data(list.data()), size(list.size())
+{
+	const int num = static_cast<int>(list.size());
+
+	entries.resize(num);
+	next_end_loop.resize(num);
+
+	for (int i = 0; i < num; ++i) {
+		const auto& com = list[i];
+		entries[i].code = com.code;
+		entries[i].indent = com.indent;
+
+		if (static_cast<Cmd>(com.code) == Cmd::Label && !com.parameters.empty()) {
+			// Only the first label with an id is reachable
+			labels.emplace(com.parameters[0], i);
+		}
+	}
+
+	// Monotonic stacks: commands that are still waiting for a
+	// neighbour with an indentation <= their own.
+	std::vector<int32_t> pending;
+	pending.reserve(16);
+
+	for (int i = 0; i < num; ++i) {
+		while (!pending.empty() && entries[pending.back()].indent >= entries[i].indent) {
+			entries[pending.back()].next = i;
+			pending.pop_back();
+		}
+		pending.push_back(i);
+	}
+	for (auto idx: pending) {
+		entries[idx].next = num;
+	}
+
+	pending.clear();
+	for (int i = num - 1; i >= 0; --i) {
+		while (!pending.empty() && entries[pending.back()].indent >= entries[i].indent) {
+			entries[pending.back()].prev = i;
+			pending.pop_back();
+		}
+		pending.push_back(i);
+	}
+	for (auto idx: pending) {
+		entries[idx].prev = -1;
+	}
+
+	int32_t end_loop = num;
+	for (int i = num - 1; i >= 0; --i) {
+		next_end_loop[i] = end_loop;
+		if (static_cast<Cmd>(entries[i].code) == Cmd::EndLoop) {
+			end_loop = i;
+		}
+	}
+}
+
+bool InterpreterJumpTable::IsFor(const std::vector<lcf::rpg::EventCommand>& list) const {
+	return data == list.data() && size == list.size();
+}
+
+int InterpreterJumpTable::FindLabel(int label_id) const {
+	auto it = labels.find(label_id);
+	return it != labels.end() ? it->second : -1;
+}
+
+int InterpreterJumpTable::FindNext(int index, int indent, std::initializer_list<Cmd> codes) const {
+	const int num = static_cast<int>(entries.size());
+
+	int idx = index + 1;
+	while (idx < num) {
+		const auto& entry = entries[idx];
+		if (entry.indent > indent) {
+			// Everything up to entry.next is indented even deeper
+			idx = entry.next;
+			continue;
+		}
+		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(entry.code)) != codes.end()) {
+			break;
+		}
+		++idx;
+	}
+	return std::min(idx, num);
+}
+
+int InterpreterJumpTable::FindNextEndLoop(int index) const {
+	if (index < 0 || index >= static_cast<int>(next_end_loop.size())) {
+		return static_cast<int>(next_end_loop.size());
+	}
+	return next_end_loop[index];
+}
+
+int InterpreterJumpTable::FindPrevious(int index, int indent, Cmd code) const {
+	int idx = std::min(index, static_cast<int>(entries.size()) - 1);
+	while (idx >= 0) {
+		const auto& entry = entries[idx];
+		if (entry.indent > indent) {
+			// Everything back to entry.prev is indented even deeper
+			idx = entry.prev;
+			continue;
+		}
+		if (entry.indent < indent) {
+			return -1;
+		}
+		if (static_cast<Cmd>(entry.code) == code) {
+			return idx;
+		}
+		--idx;
+	}
+	return -2;
+}
@@ -0,0 +1,114 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GAME_INTERPRETER_JUMP_TABLE_H
+#define EP_GAME_INTERPRETER_JUMP_TABLE_H
+
+// Headers
+#include <cstdint>
+#include <initializer_list>
+#include <unordered_map>
+#include <vector>
+#include <lcf/rpg/eventcommand.h>
+
+/**
+ * Control flow analysis of an event command list.
+ *
+ * Built once per command list and used by the interpreter to resolve
+ * labels, branches and loops without scanning the whole list on every
+ * jump. All lookups return exactly the same targets as a linear scan.
+ */
+class InterpreterJumpTable {
+public:
+	using Cmd = lcf::rpg::EventCommand::Code;
+
+	InterpreterJumpTable() = default;
+
+	/**
+	 * Analyzes a command list.
+	 *
+	 * @param list command list
+	 */
+	explicit InterpreterJumpTable(const std::vector<lcf::rpg::EventCommand>& list);
+
+	/**
+	 * Checks whether this table was built for the given list.
+	 *
+	 * @param list command list
+	 * @return true when the table can be used for list
+	 */
+	bool IsFor(const std::vector<lcf::rpg::EventCommand>& list) const;
+
+	/**
+	 * Finds the first Label command with the given id.
+	 *
+	 * @param label_id label id
+	 * @return index of the label or -1 when not found
+	 */
+	int FindLabel(int label_id) const;
+
+	/**
+	 * Finds the next command after index whose indentation is <= indent
+	 * and whose code is in codes.
+	 *
+	 * @param index index to start searching after
+	 * @param indent maximum indentation
+	 * @param codes which codes to check
+	 * @return index of the command or the list size when not found
+	 */
+	int FindNext(int index, int indent, std::initializer_list<Cmd> codes) const;
+
+	/**
+	 * Finds the next EndLoop command after index, ignoring the indentation.
+	 *
+	 * @param index index to start searching after
+	 * @return index of the command or the list size when not found
+	 */
+	int FindNextEndLoop(int index) const;
+
+	/**
+	 * Searches backwards starting at index for a command with the same
+	 * indentation and the given code. Commands with a higher indentation
+	 * are skipped, a command with a lower indentation ends the search.
+	 *
+	 * @param index index to start searching at (inclusive)
+	 * @param indent indentation to match
+	 * @param code code to search for
+	 * @return index of the command, -1 when a command with a lower
+	 *         indentation was found first or -2 when the start of the
+	 *         list was reached.
+	 */
+	int FindPrevious(int index, int indent, Cmd code) const;
+
+private:
+	struct Entry {
+		int32_t code = 0;
+		int32_t indent = 0;
+		/** Next command with an indentation <= this one */
+		int32_t next = 0;
+		/** Previous command with an indentation <= this one */
+		int32_t prev = -1;
+	};
+
+	const lcf::rpg::EventCommand* data = nullptr;
+	size_t size = 0;
+	std::vector<Entry> entries;
+	std::vector<int32_t> next_end_loop;
+	std::unordered_map<int32_t, int32_t> labels;
+};
+
+#endif
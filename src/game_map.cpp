@@ -22,7 +22,9 @@
 #include <sstream>
 #include <algorithm>
 #include <climits>
+#include <functional>
 #include <numeric>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "async_handler.h"
@@ -32,6 +34,8 @@
 #include "game_battler.h"
 #include "game_map.h"
 #include "game_interpreter_map.h"
+#include "instrumentation.h"
+#include "map_file_cache.h"
 #include "game_switches.h"
 #include "game_player.h"
 #include "game_party.h"
@@ -67,12 +71,17 @@ namespace {
 	lcf::rpg::SavePanorama panorama;
 
 	bool need_refresh;
+	// Events observing changed switches or variables, refreshed when need_refresh is not set
+	std::vector<int> refresh_event_ids;
 
 	int animation_type;
 	bool animation_fast;
 	std::vector<unsigned char> passages_down;
 	std::vector<unsigned char> passages_up;
 	std::vector<Game_Event> events;
+	// Indices into events by tile, each list is in the order of events
+	std::unordered_map<uint64_t, std::vector<int>> events_by_tile;
+	bool events_by_tile_valid = false;
 	std::vector<Game_CommonEvent> common_events;
 	std::unique_ptr<Game_Map::Caching::MapCache> map_cache;
 
@@ -98,12 +107,161 @@ namespace Game_Map {
 void SetupCommon();
 }
 
+static uint64_t EventTileKey(int x, int y) {
+	return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+static void RebuildEventIndex() {
+	for (auto& tile: events_by_tile) {
+		tile.second.clear();
+	}
+	for (int i = 0; i < static_cast<int>(events.size()); ++i) {
+		events_by_tile[EventTileKey(events[i].GetX(), events[i].GetY())].push_back(i);
+	}
+	events_by_tile_valid = true;
+}
+
+/** @return indices of the events at (x, y) in event order or nullptr when there are none */
+static const std::vector<int>* GetEventIndicesAt(int x, int y) {
+	if (!events_by_tile_valid) {
+		RebuildEventIndex();
+	}
+	auto it = events_by_tile.find(EventTileKey(x, y));
+	if (it == events_by_tile.end() || it->second.empty()) {
+		return nullptr;
+	}
+	return &it->second;
+}
+
+/**
+ * @return index of the first event at (x, y) which comes after the event at index after, -1 if none.
+ * Looked up again for every step because updating an event can change the index.
+ */
+static int GetNextEventIndexAt(int x, int y, int after) {
+	const auto* indices = GetEventIndicesAt(x, y);
+	if (!indices) {
+		return -1;
+	}
+	auto it = std::upper_bound(indices->begin(), indices->end(), after);
+	return it != indices->end() ? *it : -1;
+}
+
 void Game_Map::OnContinueFromBattle() {
 	Main_Data::game_system->BgmPlay(Main_Data::game_system->GetBeforeBattleMusic());
 }
 
 static Game_Map::Parallax::Params GetParallaxParams();
 
+/**
+ * Starts loading the graphics and sounds used by the events of the map in
+ * the background, before the sprites of the events request them.
+ */
+static void PrefetchMapAssets() {
+	if (!FileFinder::Game()) {
+		return;
+	}
+
+	AsyncHandler::Prefetch("ChipSet", Game_Map::GetChipsetName());
+
+	if (map->parallax_flag) {
+		AsyncHandler::Prefetch("Panorama", map->parallax_name);
+	}
+
+	std::unordered_set<std::string_view> sounds;
+
+	for (const auto& ev: map->events) {
+		for (const auto& page: ev.pages) {
+			if (!page.character_name.empty()) {
+				AsyncHandler::Prefetch("CharSet", page.character_name);
+			}
+
+			for (const auto& move_command: page.move_route.move_commands) {
+				if (static_cast<lcf::rpg::MoveCommand::Code>(move_command.command_id) == lcf::rpg::MoveCommand::Code::play_sound_effect
+						&& sounds.insert(move_command.parameter_string).second) {
+					AsyncHandler::Prefetch("Sound", move_command.parameter_string);
+				}
+			}
+
+			for (const auto& com: page.event_commands) {
+				switch (static_cast<lcf::rpg::EventCommand::Code>(com.code)) {
+					case lcf::rpg::EventCommand::Code::ShowPicture:
+						AsyncHandler::Prefetch("Picture", com.string);
+						break;
+					case lcf::rpg::EventCommand::Code::PlaySound:
+						if (sounds.insert(com.string).second) {
+							AsyncHandler::Prefetch("Sound", com.string);
+						}
+						break;
+					default:
+						break;
+				}
+			}
+		}
+	}
+}
+
+/**
+ * Starts parsing the maps reachable by teleport commands and the source
+ * maps of cloned events in the background, when enabled in the config.
+ */
+static void PrefetchNeighbourMaps() {
+	if (!Player::player_config.preload_maps.Get() || !FileFinder::Game() || Input::IsRecording()) {
+		return;
+	}
+
+	// Parsing more maps costs more than it saves
+	constexpr size_t max_maps = 8;
+
+	std::vector<int> map_ids;
+	auto add_map = [&](int map_id) {
+		if (map_id > 0 && map_id != Game_Map::GetMapId() && map_ids.size() < max_maps
+				&& std::find(map_ids.begin(), map_ids.end(), map_id) == map_ids.end()) {
+			map_ids.push_back(map_id);
+		}
+	};
+
+	for (const auto& ev: map->events) {
+		for (const auto& page: ev.pages) {
+			for (const auto& com: page.event_commands) {
+				switch (static_cast<lcf::rpg::EventCommand::Code>(com.code)) {
+					case lcf::rpg::EventCommand::Code::Teleport:
+						if (com.parameters.size() > 0) {
+							add_map(com.parameters[0]);
+						}
+						break;
+					case lcf::rpg::EventCommand::Code::EasyRpg_CloneMapEvent:
+						// Only source maps that are not taken from a variable
+						if (com.parameters.size() > 1 && com.parameters[0] == 0) {
+							add_map(com.parameters[1]);
+						}
+						break;
+					default:
+						break;
+				}
+			}
+		}
+	}
+
+	for (int map_id: map_ids) {
+		if (MapFileCache::IsCachedOrPending(map_id)) {
+			continue;
+		}
+
+		// Same lookup as ParseMapFile: EasyRPG map files first
+		bool xml = true;
+		std::string map_file = FileFinder::Game().FindFile(Game_Map::ConstructMapName(map_id, true));
+		if (map_file.empty()) {
+			xml = false;
+			map_file = FileFinder::Game().FindFile(Game_Map::ConstructMapName(map_id, false));
+			if (map_file.empty()) {
+				continue;
+			}
+		}
+
+		MapFileCache::Prefetch(map_id, FileFinder::Game().OpenInputStream(map_file), xml, Player::encoding);
+	}
+}
+
 void Game_Map::Init() {
 	Dispose();
 
@@ -133,6 +291,8 @@ void Game_Map::InitCommonEvents() {
 
 void Game_Map::Dispose() {
 	events.clear();
+	events_by_tile.clear();
+	events_by_tile_valid = false;
 	map.reset();
 	map_info = {};
 	panorama = {};
@@ -211,6 +371,9 @@ void Game_Map::Setup(std::unique_ptr<lcf::rpg::Map> map_in) {
 	// Update the save counts so that if the player saves the game
 	// events will properly resume upon loading.
 	Main_Data::game_player->UpdateSaveCounts(lcf::Data::system.save_count, GetMapSaveCount());
+
+	PrefetchMapAssets();
+	PrefetchNeighbourMaps();
 }
 
 void Game_Map::SetupFromSave(
@@ -320,9 +483,12 @@ void Game_Map::SetupFromSave(
 	// FIXME: RPG_RT compatibility bug: On async platforms, panorama async loading can
 	// cause panorama chunks to be out of sync.
 	Game_Map::Parallax::ChangeBG(GetParallaxParams());
+
+	PrefetchMapAssets();
+	PrefetchNeighbourMaps();
 }
 
-std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id) {
+static std::unique_ptr<lcf::rpg::Map> ParseMapFile(int map_id) {
 	std::unique_ptr<lcf::rpg::Map> map;
 
 	// Try loading EasyRPG map files first, then fallback to normal RPG Maker
@@ -370,13 +536,54 @@ std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id) {
 	return map;
 }
 
+/**
+ * Returns the parsed and translated map from the map file cache.
+ * When not cached the map file is parsed and added to the cache.
+ * While input is recorded the cache is bypassed because every map load
+ * adds a hash of the map file to the recording.
+ */
+static MapFileCache::MapRef LoadCachedMapFile(int map_id) {
+	const bool use_cache = !Input::IsRecording();
+
+	if (use_cache) {
+		if (auto map = MapFileCache::Get(map_id)) {
+			return map;
+		}
+	}
+
+	auto map = use_cache ? MapFileCache::TakePrefetched(map_id) : nullptr;
+	if (!map) {
+		map = ParseMapFile(map_id);
+		if (!map) {
+			return {};
+		}
+	}
+
+	if (!Tr::GetCurrentTranslationId().empty()) {
+		Game_Map::TranslateMapMessages(map_id, *map);
+	}
+
+	MapFileCache::MapRef map_ref = std::move(map);
+	if (use_cache) {
+		MapFileCache::Add(map_id, map_ref);
+	}
+	return map_ref;
+}
+
+std::unique_ptr<lcf::rpg::Map> Game_Map::LoadMapFile(int map_id) {
+	auto map = LoadCachedMapFile(map_id);
+	if (!map) {
+		return nullptr;
+	}
+
+	// The current map is modified by the game, the cached map stays untouched
+	return std::make_unique<lcf::rpg::Map>(*map);
+}
+
 void Game_Map::SetupCommon() {
 	screen_width = (Player::screen_width / 16.0) * SCREEN_TILE_SIZE;
 	screen_height = (Player::screen_height / 16.0) * SCREEN_TILE_SIZE;
 
-	if (!Tr::GetCurrentTranslationId().empty()) {
-		TranslateMapMessages(GetMapId(), *map);
-	}
 	SetNeedRefresh(true);
 
 	PrintPathToMap();
@@ -386,6 +593,7 @@ void Game_Map::SetupCommon() {
 	}
 
 	map_cache->Clear();
+	refresh_event_ids.clear();
 
 	CreateMapEvents();
 }
@@ -396,6 +604,7 @@ void Game_Map::CreateMapEvents() {
 		events.emplace_back(GetMapId(), &ev);
 		AddEventToCache(ev);
 	}
+	InvalidateEventIndex();
 }
 
 void Game_Map::AddEventToCache(const lcf::rpg::Event& ev) {
@@ -411,6 +620,9 @@ void Game_Map::AddEventToCache(const lcf::rpg::Event& ev) {
 		if (pg.condition.flags.variable) {
 			map_cache->AddEventAsRefreshTarget<Op::VarSet>(pg.condition.variable_id, ev);
 		}
+		if (pg.condition.flags.item || pg.condition.flags.actor || pg.condition.flags.timer || pg.condition.flags.timer2) {
+			map_cache->AddUntrackedRefreshTarget(ev);
+		}
 	}
 }
 
@@ -427,33 +639,45 @@ void Game_Map::RemoveEventFromCache(const lcf::rpg::Event& ev) {
 		if (pg.condition.flags.variable) {
 			map_cache->RemoveEventAsRefreshTarget<Op::VarSet>(pg.condition.variable_id, ev);
 		}
+		if (pg.condition.flags.item || pg.condition.flags.actor || pg.condition.flags.timer || pg.condition.flags.timer2) {
+			map_cache->RemoveUntrackedRefreshTarget(ev);
+		}
 	}
 }
 
+void Game_Map::Caching::MapCache::AddUntrackedRefreshTarget(const lcf::rpg::Event& ev) {
+	untracked_refresh_targets.AddEvent(ev);
+}
+
+void Game_Map::Caching::MapCache::RemoveUntrackedRefreshTarget(const lcf::rpg::Event& ev) {
+	untracked_refresh_targets.RemoveEvent(ev);
+}
+
+const std::vector<int>& Game_Map::Caching::MapCache::GetUntrackedRefreshTargets() const {
+	return untracked_refresh_targets.GetEventIds();
+}
+
 void Game_Map::Caching::MapCache::Clear() {
 	for (int i = 0; i < static_cast<int>(ObservedVarOps_END); i++) {
 		refresh_targets_by_varid[i].clear();
 	}
+	untracked_refresh_targets = {};
 }
 
 bool Game_Map::CloneMapEvent(int src_map_id, int src_event_id, int target_x, int target_y, int target_event_id, std::string_view target_name) {
-	std::unique_ptr<lcf::rpg::Map> source_map_storage;
+	MapFileCache::MapRef source_map_storage;
 	const lcf::rpg::Map* source_map;
 
 	if (src_map_id == GetMapId()) {
 		source_map = &GetMap();
 	} else {
-		source_map_storage = Game_Map::LoadMapFile(src_map_id);
+		source_map_storage = LoadCachedMapFile(src_map_id);
 		source_map = source_map_storage.get();
 
 		if (source_map_storage == nullptr) {
 			Output::Warning("CloneMapEvent: Invalid source map ID {}", src_map_id);
 			return false;
 		}
-
-		if (!Tr::GetCurrentTranslationId().empty()) {
-			TranslateMapMessages(src_map_id, *source_map_storage);
-		}
 	}
 
 	const lcf::rpg::Event* source_event = FindEventById(source_map->events, src_event_id);
@@ -524,6 +748,7 @@ bool Game_Map::DestroyMapEvent(const int event_id, bool from_clone) {
 			break;
 		}
 	}
+	InvalidateEventIndex();
 
 	// Remove event from map
 	for (auto it = map->events.begin(); it != map->events.end(); ++it) {
@@ -557,6 +782,8 @@ void Game_Map::TranslateMapMessages(int mapId, lcf::rpg::Map& map) {
 
 
 void Game_Map::UpdateUnderlyingEventReferences() {
+	InvalidateEventIndex();
+
 	// Update references because modifying the vector can reallocate
 	size_t idx = 0;
 	for (auto& ev : events) {
@@ -639,12 +866,26 @@ std::vector<uint8_t> Game_Map::GetTilesLayer(int layer) {
 
 void Game_Map::Refresh() {
 	if (GetMapId() > 0) {
-		for (Game_Event& ev : events) {
-			ev.RefreshPage();
+		if (need_refresh || refresh_event_ids.empty()) {
+			for (Game_Event& ev : events) {
+				ev.RefreshPage();
+			}
+		} else {
+			// Only the events depending on changed switches or variables and
+			// events with untracked conditions, in the same order as a full refresh
+			const auto& untracked = map_cache->GetUntrackedRefreshTargets();
+			refresh_event_ids.insert(refresh_event_ids.end(), untracked.begin(), untracked.end());
+			std::sort(refresh_event_ids.begin(), refresh_event_ids.end());
+			for (Game_Event& ev : events) {
+				if (std::binary_search(refresh_event_ids.begin(), refresh_event_ids.end(), ev.GetId())) {
+					ev.RefreshPage();
+				}
+			}
 		}
 	}
 
 	need_refresh = false;
+	refresh_event_ids.clear();
 }
 
 Game_Interpreter_Map& Game_Map::GetInterpreter() {
@@ -883,19 +1124,13 @@ bool Game_Map::CheckOrMakeWayEx(const Game_Character& self,
 	}
 	if (vehicle_type != Game_Vehicle::Airship && check_events_and_vehicles) {
 		// Check for collision with events on the target tile.
-		if (ignore_some_events_by_id.empty()) {
-			for (auto& other: GetEvents()) {
-				if (CheckOrMakeCollideEvent(other)) {
-					return false;
-				}
-			}
-		} else {
-			for (auto& other: GetEvents()) {
-				if (std::find(ignore_some_events_by_id.begin(), ignore_some_events_by_id.end(), other.GetId()) != ignore_some_events_by_id.end())
-					continue;
-				if (CheckOrMakeCollideEvent(other)) {
-					return false;
-				}
+		for (int i = GetNextEventIndexAt(to_x, to_y, -1); i >= 0; i = GetNextEventIndexAt(to_x, to_y, i)) {
+			auto& other = events[i];
+			if (!ignore_some_events_by_id.empty()
+					&& std::find(ignore_some_events_by_id.begin(), ignore_some_events_by_id.end(), other.GetId()) != ignore_some_events_by_id.end())
+				continue;
+			if (CheckOrMakeCollideEvent(other)) {
+				return false;
 			}
 		}
 
@@ -953,11 +1188,12 @@ bool Game_Map::CanLandAirship(int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: events) {
-		if (ev.IsInPosition(x, y)
-				&& ev.IsActive()
-				&& ev.GetActivePage() != nullptr) {
-			return false;
+	if (const auto* indices = GetEventIndicesAt(x, y)) {
+		for (int i: *indices) {
+			auto& ev = events[i];
+			if (ev.IsActive() && ev.GetActivePage() != nullptr) {
+				return false;
+			}
 		}
 	}
 	for (auto vid: { Game_Vehicle::Boat, Game_Vehicle::Ship }) {
@@ -991,12 +1227,14 @@ bool Game_Map::CanDisembarkShip(Game_Player& player, int x, int y) {
 		return false;
 	}
 
-	for (auto& ev: GetEvents()) {
-		if (ev.IsInPosition(x, y)
-			&& ev.GetLayer() == lcf::rpg::EventPage::Layers_same
-			&& ev.IsActive()
-			&& ev.GetActivePage() != nullptr) {
-			return false;
+	if (const auto* indices = GetEventIndicesAt(x, y)) {
+		for (int i: *indices) {
+			auto& ev = events[i];
+			if (ev.GetLayer() == lcf::rpg::EventPage::Layers_same
+				&& ev.IsActive()
+				&& ev.GetActivePage() != nullptr) {
+				return false;
+			}
 		}
 	}
 
@@ -1069,16 +1307,19 @@ bool Game_Map::IsPassableTile(
 
 		// Highest ID event with layer=below, not through, and a tile graphic wins.
 		int event_tile_id = 0;
-		for (auto& ev: events) {
-			if (self == &ev) {
-				continue;
-			}
-			if (!ev.IsActive() || ev.GetActivePage() == nullptr || ev.GetThrough()) {
-				continue;
-			}
-			if (ev.IsInPosition(x, y) && ev.GetLayer() == lcf::rpg::EventPage::Layers_below) {
-				if (ev.HasTileSprite()) {
-					event_tile_id = ev.GetTileId();
+		if (const auto* indices = GetEventIndicesAt(x, y)) {
+			for (int i: *indices) {
+				auto& ev = events[i];
+				if (self == &ev) {
+					continue;
+				}
+				if (!ev.IsActive() || ev.GetActivePage() == nullptr || ev.GetThrough()) {
+					continue;
+				}
+				if (ev.GetLayer() == lcf::rpg::EventPage::Layers_below) {
+					if (ev.HasTileSprite()) {
+						event_tile_id = ev.GetTileId();
+					}
 				}
 			}
 		}
@@ -1183,16 +1424,49 @@ int Game_Map::GetTerrainTag(int x, int y) {
 }
 
 Game_Event* Game_Map::GetEventAt(int x, int y, bool require_active) {
-	auto& events = GetEvents();
-	for (auto iter = events.rbegin(); iter != events.rend(); ++iter) {
-		auto& ev = *iter;
-		if (ev.IsInPosition(x, y) && (!require_active || ev.IsActive())) {
+	const auto* indices = GetEventIndicesAt(x, y);
+	if (!indices) {
+		return nullptr;
+	}
+	for (auto iter = indices->rbegin(); iter != indices->rend(); ++iter) {
+		auto& ev = events[*iter];
+		if (!require_active || ev.IsActive()) {
 			return &ev;
 		}
 	}
 	return nullptr;
 }
 
+void Game_Map::OnEventPositionChanged(const Game_Event& ev, int old_x, int old_y) {
+	if (!events_by_tile_valid) {
+		return;
+	}
+
+	// Events which are not (yet) part of the map, e.g. during construction, are not indexed
+	const auto* first = events.data();
+	const auto* last = first + events.size();
+	if (std::less<const Game_Event*>()(&ev, first) || !std::less<const Game_Event*>()(&ev, last)) {
+		return;
+	}
+	const int idx = static_cast<int>(&ev - first);
+
+	auto& old_tile = events_by_tile[EventTileKey(old_x, old_y)];
+	auto it = std::lower_bound(old_tile.begin(), old_tile.end(), idx);
+	if (it == old_tile.end() || *it != idx) {
+		// Out of sync, rebuild on next lookup
+		InvalidateEventIndex();
+		return;
+	}
+	old_tile.erase(it);
+
+	auto& new_tile = events_by_tile[EventTileKey(ev.GetX(), ev.GetY())];
+	new_tile.insert(std::upper_bound(new_tile.begin(), new_tile.end(), idx), idx);
+}
+
+void Game_Map::InvalidateEventIndex() {
+	events_by_tile_valid = false;
+}
+
 bool Game_Map::LoopHorizontal() {
 	return map->scroll_type == lcf::rpg::Map::ScrollType_horizontal || map->scroll_type == lcf::rpg::Map::ScrollType_both;
 }
@@ -1242,16 +1516,16 @@ int Game_Map::YwithDirection(int y, int direction) {
 }
 
 int Game_Map::CheckEvent(int x, int y) {
-	for (const Game_Event& ev : events) {
-		if (ev.IsInPosition(x, y)) {
-			return ev.GetId();
-		}
+	if (const auto* indices = GetEventIndicesAt(x, y)) {
+		return events[indices->front()].GetId();
 	}
 
 	return 0;
 }
 
 void Game_Map::Update(MapUpdateAsyncContext& actx, bool is_preupdate) {
+	Instrumentation::Scope iscope("Game_Map::Update");
+
 	if (GetNeedRefresh()) {
 		Refresh();
 	}
@@ -1762,25 +2036,21 @@ bool Game_Map::GetNeedRefresh() {
 		return false;
 	}
 
-	return need_refresh;
+	return need_refresh || !refresh_event_ids.empty();
 }
 
 void Game_Map::SetNeedRefresh(bool refresh) {
 	need_refresh = refresh;
+	// A full refresh includes all events
+	refresh_event_ids.clear();
 }
 
 void Game_Map::SetNeedRefreshForSwitchChange(int switch_id) {
-	if (need_refresh)
-		return;
-	if (map_cache->GetNeedRefresh<Caching::ObservedVarOps::SwitchSet>(switch_id))
-		SetNeedRefresh(true);
+	SetNeedRefreshForSwitchRangeChange(switch_id, switch_id);
 }
 
 void Game_Map::SetNeedRefreshForVarChange(int var_id) {
-	if (need_refresh)
-		return;
-	if (map_cache->GetNeedRefresh<Caching::ObservedVarOps::VarSet>(var_id))
-		SetNeedRefresh(true);
+	SetNeedRefreshForVarRangeChange(var_id, var_id);
 }
 
 void Game_Map::SetNeedRefreshForSwitchChange(std::initializer_list<int> switch_ids) {
@@ -1795,6 +2065,31 @@ void Game_Map::SetNeedRefreshForVarChange(std::initializer_list<int> var_ids) {
 	}
 }
 
+void Game_Map::SetNeedRefreshForSwitchRangeChange(int first_switch_id, int last_switch_id) {
+	if (need_refresh)
+		return;
+	if (first_switch_id > last_switch_id)
+		std::swap(first_switch_id, last_switch_id);
+	map_cache->CollectRefreshTargets<Caching::ObservedVarOps::SwitchSet>(first_switch_id, last_switch_id, refresh_event_ids);
+}
+
+void Game_Map::SetNeedRefreshForVarRangeChange(int first_var_id, int last_var_id) {
+	if (need_refresh)
+		return;
+	if (first_var_id > last_var_id)
+		std::swap(first_var_id, last_var_id);
+	map_cache->CollectRefreshTargets<Caching::ObservedVarOps::VarSet>(first_var_id, last_var_id, refresh_event_ids);
+}
+
+void Game_Map::SetNeedRefreshForSwitchChanges(Game_Switches& switches) {
+	if (!need_refresh) {
+		for (const auto& [first_switch_id, last_switch_id]: switches.GetChangedRanges()) {
+			map_cache->CollectRefreshTargets<Caching::ObservedVarOps::SwitchSet>(first_switch_id, last_switch_id, refresh_event_ids);
+		}
+	}
+	switches.ClearChanges();
+}
+
 std::vector<unsigned char>& Game_Map::GetPassagesDown() {
 	return passages_down;
 }
@@ -1875,6 +2170,8 @@ bool Game_Map::ReloadChipset() {
 
 void Game_Map::OnTranslationChanged() {
 	ReloadChipset();
+	// The cached maps contain the old translation
+	MapFileCache::Clear();
 	// Marks common events for reload on map change
 	// This is not save to do while they are executing
 	translation_changed = true;
@@ -2026,6 +2323,10 @@ void Game_Map::Caching::MapEventCache::RemoveEvent(const lcf::rpg::Event& ev) {
 	}
 }
 
+const std::vector<int>& Game_Map::Caching::MapEventCache::GetEventIds() const {
+	return event_ids;
+}
+
 // Parallax
 /////////////
 
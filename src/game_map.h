@@ -19,6 +19,7 @@
 #define EP_GAME_MAP_H
 
 // Headers
+#include <algorithm>
 #include <cstdint>
 #include <initializer_list>
 #include <vector>
@@ -42,6 +43,7 @@
 #include <lcf/rpg/savecommonevent.h>
 
 class FileRequestAsync;
+class Game_Switches;
 struct BattleArgs;
 
 // These are in sixteenths of a pixel.
@@ -127,10 +129,11 @@ namespace Game_Map {
 	int GetNextAvailableEventId();
 
 	/**
-	 * Loads the map from disk
+	 * Loads the map from disk or from the map file cache.
+	 * The messages of the map are translated when a translation is active.
 	 *
 	 * @param map_id the id of the map to load
-	 * @return the map, or nullptr if it couldn't be loaded
+	 * @return copy of the map, or nullptr if it couldn't be loaded
 	 */
 	std::unique_ptr<lcf::rpg::Map> LoadMapFile(int map_id);
 
@@ -177,6 +180,9 @@ namespace Game_Map {
 
 	/**
 	 * Refreshes the map.
+	 * When only switches and variables changed since the last refresh
+	 * (SetNeedRefreshForSwitchChange, SetNeedRefreshForVarChange) only
+	 * the events observing them are refreshed, otherwise all events.
 	 */
 	void Refresh();
 
@@ -528,7 +534,7 @@ namespace Game_Map {
 	void SetPositionY(int new_position_y, bool reset_panorama = true);
 
 	/**
-	 * @return need refresh flag.
+	 * @return Whether a full refresh or a refresh of some events is pending.
 	 */
 	bool GetNeedRefresh();
 
@@ -541,6 +547,8 @@ namespace Game_Map {
 
 	/**
 	 * Sets the need refresh flag.
+	 * Use this for changes that are not tracked per event, e.g. items,
+	 * actors or timers. All events are refreshed.
 	 *
 	 * @param refresh need refresh flag.
 	 */
@@ -607,6 +615,23 @@ namespace Game_Map {
 	 */
 	Game_Event* GetEventAt(int x, int y, bool require_active);
 
+	/**
+	 * Updates the tile index of the map events after an event changed position.
+	 * Called by Game_Character when the position of an event changes.
+	 *
+	 * @param ev the event which moved
+	 * @param old_x previous x position
+	 * @param old_y previous y position
+	 */
+	void OnEventPositionChanged(const Game_Event& ev, int old_x, int old_y);
+
+	/**
+	 * Marks the tile index of the map events as outdated.
+	 * Must be called when events are added, removed or their save data is replaced.
+	 * The index is rebuilt on the next lookup.
+	 */
+	void InvalidateEventIndex();
+
 	bool LoopHorizontal();
 	bool LoopVertical();
 
@@ -718,6 +743,9 @@ namespace Game_Map {
 			void AddEvent(const lcf::rpg::Event& ev);
 			void RemoveEvent(const lcf::rpg::Event& ev);
 
+			/** @return IDs of the events observing the switch or variable */
+			const std::vector<int>& GetEventIds() const;
+
 		private:
 			std::vector<int> event_ids;
 		};
@@ -742,9 +770,31 @@ namespace Game_Map {
 			template <ObservedVarOps Op>
 			bool GetNeedRefresh(int var_id);
 
+			/**
+			 * Appends the IDs of all events observing a range of switches or
+			 * variables. IDs already in event_ids are not added again.
+			 *
+			 * @param first_id first switch or variable
+			 * @param last_id last switch or variable
+			 * @param event_ids receives the event IDs
+			 */
+			template <ObservedVarOps Op>
+			void CollectRefreshTargets(int first_id, int last_id, std::vector<int>& event_ids) const;
+
+			/**
+			 * Registers an event with page conditions that are not tracked per id
+			 * (items, actors, timers). These events are part of every refresh.
+			 */
+			void AddUntrackedRefreshTarget(const lcf::rpg::Event& ev);
+			void RemoveUntrackedRefreshTarget(const lcf::rpg::Event& ev);
+
+			/** @return Events registered with AddUntrackedRefreshTarget */
+			const std::vector<int>& GetUntrackedRefreshTargets() const;
+
 			void Clear();
 		private:
 			MapEventCacheData_t refresh_targets_by_varid[ObservedVarOps_END];
+			MapEventCache untracked_refresh_targets;
 		};
 	}
 
@@ -752,6 +802,16 @@ namespace Game_Map {
 	void SetNeedRefreshForVarChange(int var_id);
 	void SetNeedRefreshForSwitchChange(std::initializer_list<int> switch_ids);
 	void SetNeedRefreshForVarChange(std::initializer_list<int> var_ids);
+	void SetNeedRefreshForSwitchRangeChange(int first_switch_id, int last_switch_id);
+	void SetNeedRefreshForVarRangeChange(int first_var_id, int last_var_id);
+
+	/**
+	 * Schedules a refresh of the events observing switches which changed their
+	 * value and clears the changes recorded by the switches.
+	 *
+	 * @param switches switches with recorded changes
+	 */
+	void SetNeedRefreshForSwitchChanges(Game_Switches& switches);
 
 	namespace Parallax {
 		struct Params {
@@ -927,4 +987,35 @@ inline bool Game_Map::Caching::MapCache::GetNeedRefresh(int var_id) {
 	return events_cache.find(var_id) != events_cache.end();
 }
 
+template <Game_Map::Caching::ObservedVarOps Op>
+inline void Game_Map::Caching::MapCache::CollectRefreshTargets(int first_id, int last_id, std::vector<int>& event_ids) const {
+	static_assert(static_cast<int>(Op) >= 0 && Op < ObservedVarOps_END);
+
+	const auto& events_cache = refresh_targets_by_varid[static_cast<int>(Op)];
+
+	auto add_events = [&event_ids](const MapEventCache& cache) {
+		for (int event_id: cache.GetEventIds()) {
+			if (std::find(event_ids.begin(), event_ids.end(), event_id) == event_ids.end()) {
+				event_ids.push_back(event_id);
+			}
+		}
+	};
+
+	if (static_cast<size_t>(last_id - first_id) >= events_cache.size()) {
+		// Large range, cheaper to check every observed id
+		for (const auto& [var_id, cache]: events_cache) {
+			if (var_id >= first_id && var_id <= last_id) {
+				add_events(cache);
+			}
+		}
+	} else {
+		for (int var_id = first_id; var_id <= last_id; ++var_id) {
+			auto it = events_cache.find(var_id);
+			if (it != events_cache.end()) {
+				add_events(it->second);
+			}
+		}
+	}
+}
+
 #endif
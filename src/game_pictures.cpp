@@ -15,6 +15,7 @@
  * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <cmath>
 #include "bitmap.h"
 #include "options.h"
@@ -90,8 +91,15 @@ void Game_Pictures::SetSaveData(std::vector<lcf::rpg::SavePicture> save)
 	}
 
 	pictures.reserve(num_pictures);
+	active_ids.clear();
 	for (int i = 0; i < num_pictures; ++i) {
 		pictures.emplace_back(std::move(save[i]));
+		auto& pic = pictures.back();
+		Deactivate(pic);
+		if (pic.needs_update) {
+			pic.active = true;
+			active_ids.push_back(pic.data.ID);
+		}
 	}
 }
 
@@ -103,6 +111,9 @@ std::vector<lcf::rpg::SavePicture> Game_Pictures::GetSaveData() const {
 
 	for (auto& pic: pictures) {
 		save.push_back(pic.data);
+		if (!pic.active) {
+			save.back().frames += GetPendingFrames(pic);
+		}
 	}
 
 	// RPG_RT Save game data always has a constant number of pictures
@@ -150,6 +161,7 @@ Game_Pictures::Picture& Game_Pictures::GetPicture(int id) {
 		pictures.reserve(id);
 		while (static_cast<int>(pictures.size()) < id) {
 			pictures.emplace_back(static_cast<int>(pictures.size()) + 1);
+			Deactivate(pictures.back());
 		}
 	}
 	return pictures[id - 1];
@@ -252,6 +264,7 @@ bool Game_Pictures::Picture::Show(const ShowParams& params) {
 
 bool Game_Pictures::Show(int id, const ShowParams& params) {
 	auto& pic = GetPicture(id);
+	Activate(pic);
 	if (pic.Show(params)) {
 		if (pic.sprite && !pic.data.name.empty()) {
 			// When the name is empty the current image buffer is reused by ShowPicture command (Used by Yume2kki)
@@ -321,6 +334,7 @@ void Game_Pictures::Picture::Move(const MoveParams& params) {
 
 void Game_Pictures::Move(int id, const MoveParams& params) {
 	auto& pic = GetPicture(id);
+	Activate(pic);
 	pic.Move(params);
 }
 
@@ -600,11 +614,105 @@ void Game_Pictures::Picture::Update(bool is_battle) {
 	}
 }
 
+bool Game_Pictures::Picture::IsSettled(bool is_battle) const {
+	if (!needs_update) {
+		return true;
+	}
+
+	if ((is_battle && !IsOnBattle()) || (!is_battle && !IsOnMap())) {
+		// Not updated, may still have a pending movement
+		return false;
+	}
+
+	if (data.time_left > 0) {
+		return false;
+	}
+
+	if (data.effect_mode == lcf::rpg::SavePicture::Effect_none && data.current_effect_power > 0 && data.current_rotation > 0.0) {
+		// Finishing the last revolution
+		return false;
+	}
+
+	if (data.effect_mode != lcf::rpg::SavePicture::Effect_none) {
+		// Same expression as the interpolation on the last frame of a move
+		if ((data.finish_effect_power - data.current_effect_power) + data.current_effect_power != data.current_effect_power) {
+			return false;
+		}
+	}
+
+	if (data.effect_mode == lcf::rpg::SavePicture::Effect_rotation && data.current_effect_power != 0.0) {
+		return false;
+	}
+
+	if (data.effect_mode == lcf::rpg::SavePicture::Effect_wave) {
+		return false;
+	}
+
+	if (data.effect_mode == lcf::rpg::SavePicture::Effect_maniac_fixed_angle && data.current_rotation != data.current_effect_power) {
+		return false;
+	}
+
+	if (Player::IsRPG2k3ECommands() && data.spritesheet_speed > 0) {
+		return false;
+	}
+
+	return true;
+}
+
+void Game_Pictures::Activate(Picture& pic) {
+	if (pic.active) {
+		return;
+	}
+
+	pic.data.frames += GetPendingFrames(pic);
+	pic.active = true;
+
+	const int id = pic.data.ID;
+	active_ids.insert(std::lower_bound(active_ids.begin(), active_ids.end(), id), id);
+}
+
+void Game_Pictures::Deactivate(Picture& pic) {
+	pic.active = false;
+	pic.map_updates_mark = map_updates;
+	pic.battle_updates_mark = battle_updates;
+}
+
+int Game_Pictures::GetPendingFrames(const Picture& pic) const {
+	if (!Player::IsRPG2k3ECommands()) {
+		return 0;
+	}
+
+	int frames = 0;
+	if (pic.IsOnMap()) {
+		frames += map_updates - pic.map_updates_mark;
+	}
+	if (pic.IsOnBattle()) {
+		frames += battle_updates - pic.battle_updates_mark;
+	}
+	return frames;
+}
+
 void Game_Pictures::Update(bool is_battle) {
 	++frame_counter;
-	for (auto& pic: pictures) {
+	if (is_battle) {
+		++battle_updates;
+	} else {
+		++map_updates;
+	}
+
+	// Settled pictures only count frames, this is caught up in Activate and GetSaveData
+	size_t num_active = 0;
+	for (size_t i = 0; i < active_ids.size(); ++i) {
+		const int id = active_ids[i];
+		auto& pic = pictures[id - 1];
 		pic.Update(is_battle);
+		if (pic.IsSettled(is_battle)) {
+			Deactivate(pic);
+		} else {
+			active_ids[num_active++] = id;
+		}
 	}
+	active_ids.resize(num_active);
 }
 
 Game_Pictures::ShowParams Game_Pictures::Picture::GetShowParams() const {
@@ -102,9 +102,23 @@ public:
 		FileRequestBinding request_id;
 		bool needs_update = false;
 		int origin = 0;
+		/** Whether the picture is in the active list and updated every frame */
+		bool active = false;
+		/** Map and battle update counts when the picture was deactivated */
+		int map_updates_mark = 0;
+		int battle_updates_mark = 0;
 
 		void Update(bool is_battle);
 
+		/**
+		 * Checks whether further updates only advance the frame counter.
+		 * Only valid right after an Update call.
+		 *
+		 * @param is_battle whether the last update was in a battle
+		 * @return true when the picture can be removed from the active list
+		 */
+		bool IsSettled(bool is_battle) const;
+
 		bool IsOnMap() const;
 		bool IsOnBattle() const;
 		int NumSpriteSheetFrames() const;
@@ -137,8 +151,33 @@ private:
 	void RequestPictureSprite(Picture& pic);
 	void OnPictureSpriteReady(FileRequestResult*, int id);
 
+	/**
+	 * Adds a picture to the active list and catches up on the
+	 * frames it was not updated.
+	 *
+	 * @param pic picture that starts changing
+	 */
+	void Activate(Picture& pic);
+
+	/**
+	 * Removes a picture from the updates until it is shown or moved again.
+	 *
+	 * @param pic settled picture
+	 */
+	void Deactivate(Picture& pic);
+
+	/**
+	 * @param pic inactive picture
+	 * @return number of frames the picture would have counted since it was deactivated
+	 */
+	int GetPendingFrames(const Picture& pic) const;
+
 	std::vector<Picture> pictures;
+	/** IDs of the pictures which change every frame, in ascending order */
+	std::vector<int> active_ids;
 	int frame_counter = 0;
+	int map_updates = 0;
+	int battle_updates = 0;
 };
 
 inline bool Game_Pictures::Picture::IsOnMap() const {
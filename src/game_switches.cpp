@@ -20,12 +20,80 @@
 #include "output.h"
 #include <lcf/reader_util.h>
 #include <lcf/data.h>
+#include <algorithm>
+#include <bitset>
 
 void Game_Switches::WarnGet(int variable_id) const {
 	Output::Debug("Invalid read sw[{}]!", variable_id);
 	--_warnings;
 }
 
+void Game_Switches::SetData(const Switches_t& s) {
+	_size = static_cast<int>(s.size());
+	_switches.assign((_size + word_bits - 1) / word_bits, 0);
+	_changed.assign(_switches.size(), 0);
+	_has_changes = false;
+
+	for (int i = 0; i < _size; ++i) {
+		if (s[i]) {
+			_switches[i / word_bits] |= Word(1) << (i % word_bits);
+		}
+	}
+}
+
+Game_Switches::Switches_t Game_Switches::GetData() const {
+	Switches_t s(_size);
+	for (int i = 0; i < _size; ++i) {
+		s[i] = (_switches[i / word_bits] >> (i % word_bits)) & 1;
+	}
+	return s;
+}
+
+void Game_Switches::Reserve(int size) {
+	if (size <= _size) {
+		return;
+	}
+	_size = size;
+	const size_t words = (size + word_bits - 1) / word_bits;
+	if (words > _switches.size()) {
+		_switches.resize(words, 0);
+		_changed.resize(words, 0);
+	}
+}
+
+template <typename F>
+void Game_Switches::ApplyRange(int first_id, int last_id, F&& op) {
+	Reserve(last_id);
+
+	const int first = std::max(0, first_id - 1);
+	const int last = last_id - 1;
+	if (first > last) {
+		return;
+	}
+
+	const int first_word = first / word_bits;
+	const int last_word = last / word_bits;
+	const Word first_mask = ~Word(0) << (first % word_bits);
+	const Word last_mask = ~Word(0) >> (word_bits - 1 - last % word_bits);
+
+	Word changed = 0;
+	for (int w = first_word; w <= last_word; ++w) {
+		Word mask = ~Word(0);
+		if (w == first_word) {
+			mask &= first_mask;
+		}
+		if (w == last_word) {
+			mask &= last_mask;
+		}
+		const Word old = _switches[w];
+		op(_switches[w], mask);
+		const Word diff = old ^ _switches[w];
+		_changed[w] |= diff;
+		changed |= diff;
+	}
+	_has_changes |= (changed != 0);
+}
+
 bool Game_Switches::Set(int switch_id, bool value) {
 	if (EP_UNLIKELY(ShouldWarn(switch_id, switch_id))) {
 		Output::Debug("Invalid write sw[{}] = {}!", switch_id, value);
@@ -34,11 +102,11 @@ bool Game_Switches::Set(int switch_id, bool value) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
+	if (value) {
+		ApplyRange(switch_id, switch_id, [](Word& w, Word mask) { w |= mask; });
+	} else {
+		ApplyRange(switch_id, switch_id, [](Word& w, Word mask) { w &= ~mask; });
 	}
-	ss[switch_id - 1] = value;
 	return value;
 }
 
@@ -47,12 +115,10 @@ void Game_Switches::SetRange(int first_id, int last_id, bool value) {
 		Output::Debug("Invalid write sw[{},{}] = {}!", first_id, last_id, value);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id, false);
-	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i] = value;
+	if (value) {
+		ApplyRange(first_id, last_id, [](Word& w, Word mask) { w |= mask; });
+	} else {
+		ApplyRange(first_id, last_id, [](Word& w, Word mask) { w &= ~mask; });
 	}
 }
 
@@ -64,12 +130,9 @@ bool Game_Switches::Flip(int switch_id) {
 	if (switch_id <= 0) {
 		return false;
 	}
-	auto& ss = _switches;
-	if (switch_id > static_cast<int>(ss.size())) {
-		ss.resize(switch_id);
-	}
-	ss[switch_id - 1].flip();
-	return ss[switch_id - 1];
+	ApplyRange(switch_id, switch_id, [](Word& w, Word mask) { w ^= mask; });
+	const int i = switch_id - 1;
+	return (_switches[i / word_bits] >> (i % word_bits)) & 1;
 }
 
 void Game_Switches::FlipRange(int first_id, int last_id) {
@@ -77,12 +140,72 @@ void Game_Switches::FlipRange(int first_id, int last_id) {
 		Output::Debug("Invalid flip sw[{},{}]!", first_id, last_id);
 		--_warnings;
 	}
-	auto& ss = _switches;
-	if (last_id > static_cast<int>(ss.size())) {
-		ss.resize(last_id);
+	ApplyRange(first_id, last_id, [](Word& w, Word mask) { w ^= mask; });
+}
+
+int Game_Switches::CountRange(int first_id, int last_id) const {
+	const int first = std::max(0, first_id - 1);
+	const int last = std::min(last_id, _size) - 1;
+	if (first > last) {
+		return 0;
+	}
+
+	const int first_word = first / word_bits;
+	const int last_word = last / word_bits;
+
+	int count = 0;
+	for (int w = first_word; w <= last_word; ++w) {
+		Word bits = _switches[w];
+		if (w == first_word) {
+			bits &= ~Word(0) << (first % word_bits);
+		}
+		if (w == last_word) {
+			bits &= ~Word(0) >> (word_bits - 1 - last % word_bits);
+		}
+		count += static_cast<int>(std::bitset<word_bits>(bits).count());
+	}
+	return count;
+}
+
+std::vector<std::pair<int, int>> Game_Switches::GetChangedRanges() const {
+	std::vector<std::pair<int, int>> ranges;
+	if (!_has_changes) {
+		return ranges;
 	}
-	for (int i = std::max(0, first_id - 1); i < last_id; ++i) {
-		ss[i].flip();
+
+	// Switch ids are 1 based, bit i is switch i + 1
+	int run_start = -1;
+	for (size_t w = 0; w < _changed.size(); ++w) {
+		Word bits = _changed[w];
+		const int base = static_cast<int>(w) * word_bits;
+
+		if (run_start < 0 && bits == 0) {
+			continue;
+		}
+		if (run_start >= 0 && bits == ~Word(0)) {
+			continue;
+		}
+
+		for (int b = 0; b < word_bits; ++b) {
+			const bool changed = (bits >> b) & 1;
+			if (changed && run_start < 0) {
+				run_start = base + b;
+			} else if (!changed && run_start >= 0) {
+				ranges.emplace_back(run_start + 1, base + b);
+				run_start = -1;
+			}
+		}
+	}
+	if (run_start >= 0) {
+		ranges.emplace_back(run_start + 1, static_cast<int>(_changed.size()) * word_bits);
+	}
+	return ranges;
+}
+
+void Game_Switches::ClearChanges() {
+	if (_has_changes) {
+		std::fill(_changed.begin(), _changed.end(), 0);
+		_has_changes = false;
 	}
 }
 
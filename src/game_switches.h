@@ -19,6 +19,8 @@
 #define EP_GAME_SWITCHES_H
 
 // Headers
+#include <cstdint>
+#include <utility>
 #include <vector>
 #include <string>
 #include <lcf/data.h>
@@ -27,6 +29,11 @@
 
 /**
  * Game_Switches class
+ *
+ * The switches are stored bit packed in 64 bit words, range operations
+ * work on whole words.
+ * Every write also records which switches changed their value. The map
+ * consumes these changes to refresh only the affected events.
  */
 class Game_Switches {
 public:
@@ -35,8 +42,8 @@ public:
 
 	Game_Switches() = default;
 
-	void SetData(Switches_t s);
-	const Switches_t& GetData() const;
+	void SetData(const Switches_t& s);
+	Switches_t GetData() const;
 
 	void SetLowerLimit(size_t limit);
 
@@ -49,6 +56,13 @@ public:
 	bool Flip(int switch_id);
 	void FlipRange(int first_id, int last_id);
 
+	/**
+	 * @param first_id first switch
+	 * @param last_id last switch (inclusive)
+	 * @return Number of switches in the range which are ON
+	 */
+	int CountRange(int first_id, int last_id) const;
+
 	std::string_view GetName(int switch_id) const;
 
 	bool IsValid(int switch_id) const;
@@ -58,34 +72,62 @@ public:
 
 	void SetWarning(int w);
 
+	/** @return Whether a switch changed its value since the last ClearChanges */
+	bool HasChanges() const;
+
+	/**
+	 * @param switch_id switch to check
+	 * @return Whether the switch changed its value since the last ClearChanges
+	 */
+	bool IsChanged(int switch_id) const;
+
+	/**
+	 * @return Ranges of consecutive switches (first, last) which changed their
+	 * value since the last ClearChanges, in ascending order
+	 */
+	std::vector<std::pair<int, int>> GetChangedRanges() const;
+
+	/** Forgets all recorded changes */
+	void ClearChanges();
+
 private:
+	using Word = uint64_t;
+	static constexpr int word_bits = 64;
+
 	bool ShouldWarn(int first_id, int last_id) const;
 	void WarnGet(int variable_id) const;
 
-	Switches_t _switches;
+	/** Grows the storage to hold at least size switches */
+	void Reserve(int size);
+
+	/**
+	 * Calls op(word, mask) for every word touched by the range and records
+	 * the changed bits.
+	 */
+	template <typename F>
+	void ApplyRange(int first_id, int last_id, F&& op);
+
+	/** Switch i (0 based) is bit i % 64 of word i / 64 */
+	std::vector<Word> _switches;
+	/** Bits of switches which changed, same layout as _switches */
+	std::vector<Word> _changed;
+	int _size = 0;
+	bool _has_changes = false;
 	size_t lower_limit = 0;
 	mutable int _warnings = kMaxWarnings;
 };
 
 
-inline void Game_Switches::SetData(Switches_t s) {
-	_switches = std::move(s);
-}
-
-inline const Game_Switches::Switches_t& Game_Switches::GetData() const {
-	return _switches;
-}
-
 inline void Game_Switches::SetLowerLimit(size_t limit) {
 	lower_limit = limit;
 }
 
 inline int Game_Switches::GetSize() const {
-	return static_cast<int>(_switches.size());
+	return _size;
 }
 
 inline int Game_Switches::GetSizeWithLimit() const {
-	return std::max<int>(lower_limit, _switches.size());
+	return std::max<int>(lower_limit, _size);
 }
 
 inline bool Game_Switches::IsValid(int variable_id) const {
@@ -100,10 +142,11 @@ inline bool Game_Switches::Get(int switch_id) const {
 	if (EP_UNLIKELY(ShouldWarn(switch_id, switch_id))) {
 		WarnGet(switch_id);
 	}
-	if (switch_id <= 0 || switch_id > static_cast<int>(_switches.size())) {
+	if (switch_id <= 0 || switch_id > _size) {
 		return false;
 	}
-	return _switches[switch_id - 1];
+	const int i = switch_id - 1;
+	return (_switches[i / word_bits] >> (i % word_bits)) & 1;
 }
 
 inline int Game_Switches::GetInt(int switch_id) const {
@@ -114,4 +157,16 @@ inline void Game_Switches::SetWarning(int w) {
 	_warnings = w;
 }
 
+inline bool Game_Switches::HasChanges() const {
+	return _has_changes;
+}
+
+inline bool Game_Switches::IsChanged(int switch_id) const {
+	if (switch_id <= 0 || switch_id > _size) {
+		return false;
+	}
+	const int i = switch_id - 1;
+	return (_changed[i / word_bits] >> (i % word_bits)) & 1;
+}
+
 #endif
@@ -217,6 +217,12 @@ void Game_System::SePlay(const lcf::rpg::Animation &animation) {
 	}
 }
 
+void Game_System::PrefetchSystemSounds() {
+	for (int i = 0; i < SFX_Count; ++i) {
+		AsyncHandler::Prefetch("Sound", GetSystemSE(i).name);
+	}
+}
+
 std::string_view Game_System::GetSystemName() {
 	return !data.graphics_name.empty() ?
 		std::string_view(data.graphics_name) : std::string_view(lcf::Data::system.system_name);
@@ -397,6 +403,8 @@ void Game_System::SetSystemSE(int which, lcf::rpg::Sound sfx) {
 			SetAudio(data.item_se, dbsys->item_se, std::move(sfx));
 			break;
 	}
+
+	AsyncHandler::Prefetch("Sound", GetSystemSE(which).name);
 }
 
 lcf::rpg::System::Stretch Game_System::GetMessageStretch() {
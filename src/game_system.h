@@ -135,6 +135,12 @@ public:
 	 */
 	void SePlay(const lcf::rpg::Animation& animation);
 
+	/**
+	 * Decodes the system sound effects in the background, this avoids a
+	 * delay when they are played the first time.
+	 */
+	void PrefetchSystemSounds();
+
 	/** @return system graphic filename.  */
 	std::string_view GetSystemName();
 
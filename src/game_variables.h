@@ -22,6 +22,7 @@
 #include <lcf/data.h>
 #include "compiler.h"
 #include "string_view.h"
+#include "variable_kernels.h"
 #include <cstdint>
 #include <string>
 
@@ -152,8 +153,8 @@ private:
 		void PrepareArray(const int first_id_a, const int last_id_a, const int first_id_b, const char* warn, Args... args);
 	template <typename V, typename F>
 		void WriteRange(const int first_id, const int last_id, V&& value, F&& op);
-	template <typename F>
-		void WriteRangeVariable(const int first_id, const int last_id, int var_id, F&& op);
+	void ApplyRange(const int first_id, const int last_id, VariableKernels::Op op, Var_t value);
+	void ApplyRangeVariable(int first_id, const int last_id, const int var_id, VariableKernels::Op op);
 	template <typename F>
 		void WriteArray(const int first_id_a, const int last_id_a, const int first_id_b, F&& op);
 
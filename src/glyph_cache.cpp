@@ -0,0 +1,175 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "glyph_cache.h"
+#include "bitmap.h"
+#include "opacity.h"
+#include <algorithm>
+
+GlyphCache::GlyphCache(bool alpha_only, size_t memory_limit)
+	: alpha_only(alpha_only), memory_limit(memory_limit)
+{}
+
+uint64_t GlyphCache::MakeKey(char32_t code, int size, bool shaped) {
+	return (static_cast<uint64_t>(code) << 32)
+		| (static_cast<uint64_t>(static_cast<uint32_t>(size) & 0x7FFFFFFF) << 1)
+		| (shaped ? 1 : 0);
+}
+
+const Font::GlyphRet* GlyphCache::Find(char32_t code, int size, bool shaped) {
+	auto it = entries.find(MakeKey(code, size, shaped));
+	if (it == entries.end()) {
+		return nullptr;
+	}
+
+	auto& entry = it->second;
+	if (entry.page >= 0) {
+		pages[entry.page].last_use = ++tick;
+	}
+	return &entry.glyph;
+}
+
+Font::GlyphRet GlyphCache::Insert(char32_t code, int size, bool shaped, const Font::GlyphRet& glyph) {
+	if (!glyph.bitmap) {
+		return glyph;
+	}
+
+	const auto& src_rect = glyph.rect;
+	if (src_rect.width > page_size || src_rect.height > page_size) {
+		// Too large for the atlas, this is only expected for huge fonts
+		return glyph;
+	}
+
+	Entry entry;
+	entry.glyph = glyph;
+
+	if (src_rect.width > 0 && src_rect.height > 0) {
+		Rect rect;
+		int page_id = AllocatePage(src_rect.width, src_rect.height, rect);
+		auto& page = pages[page_id];
+
+		page.bitmap->BlitFast(rect.x, rect.y, *glyph.bitmap, src_rect, Opacity::Opaque());
+		page.last_use = ++tick;
+
+		entry.glyph.bitmap = page.bitmap;
+		entry.glyph.rect = rect;
+		entry.page = page_id;
+	}
+
+	// Glyphs without pixels keep their (empty) bitmap, they are never drawn
+
+	auto& ret = entries[MakeKey(code, size, shaped)];
+	ret = std::move(entry);
+	return ret.glyph;
+}
+
+void GlyphCache::Clear() {
+	entries.clear();
+	pages.clear();
+	active_page = -1;
+}
+
+size_t GlyphCache::GetMemoryUsage() const {
+	size_t usage = 0;
+	for (const auto& page: pages) {
+		usage += static_cast<size_t>(page.bitmap->pitch()) * page.bitmap->height();
+	}
+	return usage;
+}
+
+size_t GlyphCache::GetMemoryLimit() const {
+	return memory_limit;
+}
+
+void GlyphCache::SetMemoryLimit(size_t memory_limit) {
+	this->memory_limit = memory_limit;
+	Clear();
+}
+
+size_t GlyphCache::GetGlyphCount() const {
+	return entries.size();
+}
+
+int GlyphCache::GetMaxPages() const {
+	const size_t page_bytes = static_cast<size_t>(page_size) * page_size * (alpha_only ? 1 : 4);
+	return std::max<int>(1, static_cast<int>(memory_limit / page_bytes));
+}
+
+bool GlyphCache::Allocate(Page& page, int width, int height, Rect& rect) {
+	if (page.shelf_x + width > page_size) {
+		// Start a new shelf
+		page.shelf_y += page.shelf_height;
+		page.shelf_x = 0;
+		page.shelf_height = 0;
+	}
+
+	if (page.shelf_y + height > page_size) {
+		return false;
+	}
+
+	rect = { page.shelf_x, page.shelf_y, width, height };
+	page.shelf_x += width;
+	page.shelf_height = std::max(page.shelf_height, height);
+	return true;
+}
+
+int GlyphCache::AllocatePage(int width, int height, Rect& rect) {
+	if (active_page >= 0 && Allocate(pages[active_page], width, height, rect)) {
+		return active_page;
+	}
+
+	if (static_cast<int>(pages.size()) < GetMaxPages()) {
+		Page page;
+		if (alpha_only) {
+			page.bitmap = Bitmap::Create(nullptr, page_size, page_size, 0, DynamicFormat(8, 8, 0, 8, 0, 8, 0, 8, 0, PF::Alpha));
+		} else {
+			page.bitmap = Bitmap::Create(page_size, page_size, true);
+		}
+		pages.push_back(std::move(page));
+		active_page = static_cast<int>(pages.size()) - 1;
+	} else {
+		auto lru = std::min_element(pages.begin(), pages.end(), [](const Page& a, const Page& b) {
+			return a.last_use < b.last_use;
+		});
+		active_page = static_cast<int>(lru - pages.begin());
+		EvictPage(active_page);
+	}
+
+	bool ok = Allocate(pages[active_page], width, height, rect);
+	assert(ok);
+	(void)ok;
+	return active_page;
+}
+
+void GlyphCache::EvictPage(int page_id) {
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (it->second.page == page_id) {
+			it = entries.erase(it);
+		} else {
+			++it;
+		}
+	}
+
+	auto& page = pages[page_id];
+	page.shelf_x = 0;
+	page.shelf_y = 0;
+	page.shelf_height = 0;
+
+	// The atlas bitmap is shared with glyphs returned earlier. They are only
+	// used until the next Render call, so the pixels can be reused.
+}
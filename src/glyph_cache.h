@@ -0,0 +1,124 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_GLYPH_CACHE_H
+#define EP_GLYPH_CACHE_H
+
+// Headers
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "font.h"
+#include "memory_management.h"
+
+/**
+ * Cache of rendered glyphs of a single font.
+ *
+ * The glyph pixels are copied into atlas pages of a fixed size. Glyphs are
+ * keyed by codepoint (or glyph index for shaped glyphs) and font size.
+ * When the memory limit is reached the least recently used page is evicted
+ * together with all glyphs stored in it.
+ */
+class GlyphCache {
+public:
+	/** Width and height of an atlas page */
+	static constexpr int page_size = 256;
+
+	/** Default memory limit of all atlas pages of a font */
+	static constexpr size_t default_memory_limit = 2 * 1024 * 1024;
+
+	/**
+	 * Constructs a glyph cache.
+	 *
+	 * @param alpha_only Whether the atlas only stores an alpha channel.
+	 *                   Only use this when the font never renders colored glyphs.
+	 * @param memory_limit maximum amount of bytes used by the atlas pages
+	 */
+	explicit GlyphCache(bool alpha_only, size_t memory_limit = default_memory_limit);
+
+	/**
+	 * Looks up a glyph.
+	 *
+	 * @param code codepoint or glyph index
+	 * @param size font size the glyph was rendered at
+	 * @param shaped whether code is a glyph index of a shaped glyph
+	 * @return cached glyph or nullptr when not cached
+	 */
+	const Font::GlyphRet* Find(char32_t code, int size, bool shaped);
+
+	/**
+	 * Copies a rendered glyph into the atlas.
+	 *
+	 * @param code codepoint or glyph index
+	 * @param size font size the glyph was rendered at
+	 * @param shaped whether code is a glyph index of a shaped glyph
+	 * @param glyph rendered glyph
+	 * @return glyph referencing the atlas or glyph when it cannot be cached
+	 */
+	Font::GlyphRet Insert(char32_t code, int size, bool shaped, const Font::GlyphRet& glyph);
+
+	/** Removes all glyphs and releases the atlas pages. */
+	void Clear();
+
+	/** @return amount of bytes used by the atlas pages */
+	size_t GetMemoryUsage() const;
+
+	/** @return maximum amount of bytes used by the atlas pages */
+	size_t GetMemoryLimit() const;
+
+	/**
+	 * Changes the memory limit. Clears the cache.
+	 *
+	 * @param memory_limit maximum amount of bytes used by the atlas pages
+	 */
+	void SetMemoryLimit(size_t memory_limit);
+
+	/** @return Number of glyphs in the cache */
+	size_t GetGlyphCount() const;
+
+private:
+	struct Page {
+		BitmapRef bitmap;
+		/** Shelf packing state */
+		int shelf_x = 0;
+		int shelf_y = 0;
+		int shelf_height = 0;
+		uint64_t last_use = 0;
+	};
+
+	struct Entry {
+		Font::GlyphRet glyph;
+		/** Atlas page or -1 when the glyph has no pixels */
+		int page = -1;
+	};
+
+	static uint64_t MakeKey(char32_t code, int size, bool shaped);
+
+	int GetMaxPages() const;
+	bool Allocate(Page& page, int width, int height, Rect& rect);
+	int AllocatePage(int width, int height, Rect& rect);
+	void EvictPage(int page_id);
+
+	bool alpha_only = false;
+	size_t memory_limit = default_memory_limit;
+	uint64_t tick = 0;
+	int active_page = -1;
+	std::vector<Page> pages;
+	std::unordered_map<uint64_t, Entry> entries;
+};
+
+#endif
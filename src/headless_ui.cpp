@@ -0,0 +1,112 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "headless_ui.h"
+#include "output.h"
+#include "player.h"
+
+HeadlessUi::HeadlessUi(long width, long height, const Game_Config& cfg, int hash_interval)
+	: BaseUi(cfg), hash_interval(hash_interval)
+{
+	current_display_mode.width = width;
+	current_display_mode.height = height;
+	current_display_mode.bpp = 32;
+
+	// Fixed format, the surface hashes must not depend on the host
+	const DynamicFormat format(
+		32,
+		0x00FF0000,
+		0x0000FF00,
+		0x000000FF,
+		0xFF000000,
+		PF::NoAlpha);
+
+	Bitmap::SetFormat(Bitmap::ChooseFormat(format));
+
+	main_surface = Bitmap::Create(current_display_mode.width,
+		current_display_mode.height,
+		false,
+		current_display_mode.bpp
+	);
+
+#ifdef SUPPORT_AUDIO
+	audio_cfg = cfg.audio;
+	audio_ = std::make_unique<EmptyAudio>(audio_cfg);
+#endif
+}
+
+bool HeadlessUi::vChangeDisplaySurfaceResolution(int new_width, int new_height) {
+	BitmapRef new_main_surface = Bitmap::Create(new_width, new_height, false, current_display_mode.bpp);
+
+	if (!new_main_surface) {
+		Output::Warning("ChangeDisplaySurfaceResolution Bitmap::Create failed");
+		return false;
+	}
+
+	main_surface = new_main_surface;
+
+	current_display_mode.width = new_width;
+	current_display_mode.height = new_height;
+
+	return true;
+}
+
+void HeadlessUi::UpdateDisplay() {
+	if (hash_interval <= 0) {
+		return;
+	}
+
+	int frame = Player::GetFrames();
+	if (frame == last_hashed_frame || frame % hash_interval != 0) {
+		return;
+	}
+	last_hashed_frame = frame;
+
+	Output::Debug("Frame {}: Surface hash {:016x}", frame, HashSurface(*main_surface));
+}
+
+bool HeadlessUi::ProcessEvents() {
+	// No window, the Player only exits through the scene stack or the exit flag
+	return true;
+}
+
+void HeadlessUi::vGetConfig(Game_ConfigVideo&) const {
+	// Nothing to configure
+}
+
+#ifdef SUPPORT_AUDIO
+AudioInterface& HeadlessUi::GetAudio() {
+	return *audio_;
+}
+#endif
+
+uint64_t HeadlessUi::HashSurface(const Bitmap& bitmap) {
+	uint64_t hash = 0xcbf29ce484222325ULL;
+
+	const auto* pixels = static_cast<const uint8_t*>(bitmap.pixels());
+
+	for (int y = 0; y < bitmap.height(); ++y) {
+		const auto* row = reinterpret_cast<const uint32_t*>(pixels + y * bitmap.pitch());
+		for (int x = 0; x < bitmap.width(); ++x) {
+			hash ^= row[x];
+			hash *= 0x100000001b3ULL;
+		}
+	}
+
+	return hash;
+}
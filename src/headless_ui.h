@@ -0,0 +1,83 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_HEADLESS_UI_H
+#define EP_HEADLESS_UI_H
+
+// Headers
+#include "baseui.h"
+#include "bitmap.h"
+#include "system.h"
+#include <cstdint>
+#include <memory>
+
+#ifdef SUPPORT_AUDIO
+#  include "audio.h"
+#endif
+
+/**
+ * HeadlessUi class.
+ * Renders into an offscreen surface without opening a window and has no
+ * audio output and no input devices. Used for running input replays.
+ */
+class HeadlessUi final : public BaseUi {
+public:
+	/**
+	 * Constructor.
+	 *
+	 * @param width display client width.
+	 * @param height display client height.
+	 * @param cfg config options
+	 * @param hash_interval log a hash of the display surface every
+	 *                      hash_interval frames, 0 disables hashing
+	 */
+	HeadlessUi(long width, long height, const Game_Config& cfg, int hash_interval = 0);
+
+	/**
+	 * Inherited from BaseUi.
+	 */
+	/** @{ */
+	bool vChangeDisplaySurfaceResolution(int new_width, int new_height) override;
+	void UpdateDisplay() override;
+	bool ProcessEvents() override;
+	void vGetConfig(Game_ConfigVideo& cfg) const override;
+
+#ifdef SUPPORT_AUDIO
+	AudioInterface& GetAudio() override;
+#endif
+	/** @} */
+
+	/**
+	 * Calculates a FNV-1a hash of the pixels of the display surface.
+	 * Padding at the end of a row is ignored.
+	 *
+	 * @param bitmap bitmap in the 32 bit format of the display surface
+	 * @return hash value
+	 */
+	static uint64_t HashSurface(const Bitmap& bitmap);
+
+private:
+	int hash_interval = 0;
+	int last_hashed_frame = -1;
+
+#ifdef SUPPORT_AUDIO
+	Game_ConfigAudio audio_cfg;
+	std::unique_ptr<EmptyAudio> audio_;
+#endif
+};
+
+#endif
@@ -47,23 +47,24 @@ static void on_png_error(png_structp, png_const_charp error_msg) {
 	Output::Warning("libpng: {}", error_msg);
 }
 
-static bool ReadPNGWithReadFunction(png_voidp,png_rw_ptr, bool, ImageOut&);
-static void ReadPalettedData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, uint32_t*);
-static void ReadGrayData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, uint32_t*);
-static void ReadGrayAlphaData(png_struct*, png_info*, png_uint_32, png_uint_32, uint32_t*);
-static void ReadRGBData(png_struct*, png_info*, png_uint_32, png_uint_32, uint32_t*);
-static void ReadRGBAData(png_struct*, png_info*, png_uint_32, png_uint_32, uint32_t*);
-
-bool ImagePNG::Read(const void* buffer, bool transparent, ImageOut& output) {
+static bool ReadPNGWithReadFunction(png_voidp,png_rw_ptr, bool, ImageRowOut&);
+static void ReadPalettedData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, uint8_t*, ImageRowOut&);
+static void ReadGrayData(png_struct*, png_info*, png_uint_32, png_uint_32, bool, uint8_t*, ImageRowOut&);
+static void ReadGrayAlphaData(png_struct*, png_info*, png_uint_32, png_uint_32, uint8_t*, ImageRowOut&);
+static void ReadRGBData(png_struct*, png_info*, png_uint_32, png_uint_32, uint8_t*, ImageRowOut&);
+static void ReadRGBAData(png_struct*, png_info*, png_uint_32, png_uint_32, uint8_t*, ImageRowOut&);
+
+bool ImagePNG::Read(const void* buffer, bool transparent, ImageRowOut& output) {
 	return ReadPNGWithReadFunction((png_voidp)&buffer, read_data, transparent, output);
 }
 
-bool ImagePNG::Read(Filesystem_Stream::InputStream& stream, bool transparent, ImageOut& output) {
+bool ImagePNG::Read(Filesystem_Stream::InputStream& stream, bool transparent, ImageRowOut& output) {
 	return ReadPNGWithReadFunction(&stream, read_data_istream, transparent, output);
 }
 
-static bool ReadPNGWithReadFunction(png_voidp user_data, png_rw_ptr fn, bool transparent, ImageOut& output) {
-	output.pixels = nullptr;
+static bool ReadPNGWithReadFunction(png_voidp user_data, png_rw_ptr fn, bool transparent, ImageRowOut& output) {
+	// Only a single row is kept in memory, the rows are converted by the output
+	std::vector<uint8_t> row;
 
 	png_struct *png_ptr = png_create_read_struct(PNG_LIBPNG_VER_STRING, NULL, on_png_error, on_png_warning);
 	if (png_ptr == NULL) {
@@ -91,40 +92,41 @@ static bool ReadPNGWithReadFunction(png_voidp user_data, png_rw_ptr fn, bool tra
 	png_get_IHDR(png_ptr, info_ptr, &w, &h,
 				 &bit_depth, &color_type, NULL, NULL, NULL);
 
-	output.pixels = malloc(w * h * 4);
-	if (!output.pixels) {
-		Output::Warning("Error allocating PNG pixel buffer.");
+	int bpp = 8;
+	if (color_type == PNG_COLOR_TYPE_RGB) {
+		bpp = 24;
+	} else if (color_type == PNG_COLOR_TYPE_RGB_ALPHA) {
+		bpp = 32;
+	}
+
+	if (!output.Begin(w, h, bpp)) {
+		png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 		return false;
 	}
 
+	row.resize(w * 4);
+
 	switch (color_type) {
 		case PNG_COLOR_TYPE_PALETTE:
-			ReadPalettedData(png_ptr, info_ptr, w, h, transparent, (uint32_t*)output.pixels);
-			output.bpp = 8;
+			ReadPalettedData(png_ptr, info_ptr, w, h, transparent, row.data(), output);
 			break;
 		case PNG_COLOR_TYPE_GRAY:
-			ReadGrayData(png_ptr, info_ptr, w, h, transparent, (uint32_t*)output.pixels);
-			output.bpp = 8;
+			ReadGrayData(png_ptr, info_ptr, w, h, transparent, row.data(), output);
 			break;
 		case PNG_COLOR_TYPE_GRAY_ALPHA:
-			ReadGrayAlphaData(png_ptr, info_ptr, w, h, (uint32_t*)output.pixels);
-			output.bpp = 8;
+			ReadGrayAlphaData(png_ptr, info_ptr, w, h, row.data(), output);
 			break;
 		case PNG_COLOR_TYPE_RGB:
-			ReadRGBData(png_ptr, info_ptr, w, h, (uint32_t*)output.pixels);
-			output.bpp = 24;
+			ReadRGBData(png_ptr, info_ptr, w, h, row.data(), output);
 			break;
 		case PNG_COLOR_TYPE_RGB_ALPHA:
-			ReadRGBAData(png_ptr, info_ptr, w, h, (uint32_t*)output.pixels);
-			output.bpp = 32;
+			ReadRGBAData(png_ptr, info_ptr, w, h, row.data(), output);
 			break;
 	}
 
 	png_read_end(png_ptr, NULL);
 	png_destroy_read_struct(&png_ptr, &info_ptr, NULL);
 
-	output.width = w;
-	output.height = h;
 	return true;
 }
 
@@ -132,7 +134,8 @@ static void ReadPalettedData(
 	png_struct* png_ptr, png_info* info_ptr,
 	png_uint_32 w, png_uint_32 h,
 	bool transparent,
-	uint32_t* pixels
+	uint8_t* row,
+	ImageRowOut& output
 ) {
 	// For transparent images, all the colors are opaque, except the
 	// color with index 0. So we'll need to do index->RGB conversion
@@ -149,26 +152,33 @@ static void ReadPalettedData(
 	int num_palette;
 	png_get_PLTE(png_ptr, info_ptr, &palette, &num_palette);
 
-	for (png_uint_32 y = 0; y < h; y++) {
-		// We read the indices (w bytes) into the end of the pixel
-		// data for this row (4w bytes), then scan over them
-		// converting them into RGBA values. Putting them at the end
-		// gives us enough room that we don't overwrite an index
-		// we'll need later with an RGBA value.
-
-		uint32_t* beginning_of_row = pixels + y * w;
+	// Lookup table from index to RGBA, indices outside of the palette are black
+	uint32_t colors[256];
+	const uint8_t black[4] = { 0, 0, 0, 255 };
+	for (auto& color: colors) {
+		memcpy(&color, black, sizeof(black));
+	}
+	for (int i = 0; i < num_palette && i < 256; i++) {
+		png_color& color = palette[i];
+		uint8_t alpha = (i == 0 && transparent) ? 0 : 255;
+		uint8_t rgba[4] = { color.red, color.green, color.blue, alpha };
+		memcpy(&colors[i], rgba, sizeof(rgba));
+	}
 
-		uint8_t* indices = (uint8_t*)beginning_of_row + w * 3;
+	for (png_uint_32 y = 0; y < h; y++) {
+		// We read the indices (w bytes) into the end of the row
+		// (4w bytes), then scan over them converting them into RGBA
+		// values. Putting them at the end gives us enough room that
+		// we don't overwrite an index we'll need later with an RGBA value.
+		uint8_t* indices = row + w * 3;
 		png_read_row(png_ptr, (png_bytep)indices, NULL);
 
-		uint32_t* dst = beginning_of_row;
-		for (png_uint_32 x = 0; x < w; x++, dst++) {
-			uint8_t idx = indices[x];
-			png_color& color = palette[idx];
-			uint8_t alpha = (idx == 0 && transparent) ? 0 : 255;
-			uint8_t rgba[4] = { color.red, color.green, color.blue, alpha };
-			*dst = *(uint32_t*)rgba;
+		uint8_t* dst = row;
+		for (png_uint_32 x = 0; x < w; x++, dst += 4) {
+			memcpy(dst, &colors[indices[x]], 4);
 		}
+
+		output.WriteRow(y, row);
 	}
 }
 
@@ -176,7 +186,8 @@ static void ReadGrayData(
 	png_struct* png_ptr, png_info* info_ptr,
 	png_uint_32 w, png_uint_32 h,
 	bool transparent,
-	uint32_t* pixels
+	uint8_t* row,
+	ImageRowOut& output
 ) {
 	png_set_strip_16(png_ptr);
 	png_set_expand(png_ptr);
@@ -185,64 +196,66 @@ static void ReadGrayData(
 	png_read_update_info(png_ptr, info_ptr);
 
 	for (png_uint_32 y = 0; y < h; y++) {
-		png_bytep dst = (png_bytep) pixels + y * w * 4;
-		png_read_row(png_ptr, dst, NULL);
-	}
+		png_read_row(png_ptr, row, NULL);
+
+		// Black pixels are transparent
+		if (transparent) {
+			uint8_t* p = row;
+			for (png_uint_32 x = 0; x < w; x++, p += 4) {
+				if (p[0] == 0 && p[1] == 0 && p[2] == 0 && p[3] == 255) {
+					p[3] = 0;
+				}
+			}
+		}
 
-	// Black pixels are transparent
-	if (transparent) {
-		uint8_t ck1[4] = {0, 0, 0, 255};
-		uint8_t ck2[4] = {0, 0, 0,   0};
-		uint32_t srckey = *(uint32_t*)ck1;
-		uint32_t dstkey = *(uint32_t*)ck2;
-		uint32_t* p = (uint32_t*) pixels;
-		for (unsigned i = 0; i < w * h; i++, p++)
-			if (*p == srckey)
-				*p = dstkey;
+		output.WriteRow(y, row);
 	}
 }
 
 static void ReadGrayAlphaData(
 	png_struct* png_ptr, png_info* info_ptr,
-	png_uint_32 w, png_uint_32 h,
-	uint32_t* pixels
+	png_uint_32, png_uint_32 h,
+	uint8_t* row,
+	ImageRowOut& output
 ) {
 	png_set_strip_16(png_ptr);
 	png_set_gray_to_rgb(png_ptr);
 	png_read_update_info(png_ptr, info_ptr);
 
 	for (png_uint_32 y = 0; y < h; y++) {
-		png_bytep dst = (png_bytep) pixels + y * w * 4;
-		png_read_row(png_ptr, dst, NULL);
+		png_read_row(png_ptr, row, NULL);
+		output.WriteRow(y, row);
 	}
 }
 
 static void ReadRGBData(
 	png_struct* png_ptr, png_info* info_ptr,
-	png_uint_32 w, png_uint_32 h,
-	uint32_t* pixels
+	png_uint_32, png_uint_32 h,
+	uint8_t* row,
+	ImageRowOut& output
 ) {
 	png_set_strip_16(png_ptr);
 	png_set_filler(png_ptr, 0xFF, PNG_FILLER_AFTER);
 	png_read_update_info(png_ptr, info_ptr);
 
 	for (png_uint_32 y = 0; y < h; y++) {
-		png_bytep dst = (png_bytep) pixels + y * w * 4;
-		png_read_row(png_ptr, dst, NULL);
+		png_read_row(png_ptr, row, NULL);
+		output.WriteRow(y, row);
 	}
 }
 
 static void ReadRGBAData(
 	png_struct* png_ptr, png_info* info_ptr,
-	png_uint_32 w, png_uint_32 h,
-	uint32_t* pixels
+	png_uint_32, png_uint_32 h,
+	uint8_t* row,
+	ImageRowOut& output
 ) {
 	png_set_strip_16(png_ptr);
 	png_read_update_info(png_ptr, info_ptr);
 
 	for (png_uint_32 y = 0; y < h; y++) {
-		png_bytep dst = (png_bytep) pixels + y * w * 4;
-		png_read_row(png_ptr, dst, NULL);
+		png_read_row(png_ptr, row, NULL);
+		output.WriteRow(y, row);
 	}
 }
 
@@ -23,8 +23,8 @@
 #include "filesystem_stream.h"
 
 namespace ImagePNG {
-	bool Read(const void* buffer, bool transparent, ImageOut& output);
-	bool Read(Filesystem_Stream::InputStream& is, bool transparent, ImageOut& output);
+	bool Read(const void* buffer, bool transparent, ImageRowOut& output);
+	bool Read(Filesystem_Stream::InputStream& is, bool transparent, ImageRowOut& output);
 	bool Write(std::ostream& os, uint32_t width, uint32_t height, uint32_t* data);
 }
 
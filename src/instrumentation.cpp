@@ -17,11 +17,69 @@
 
 #include "instrumentation.h"
 #include "utils.h"
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <ostream>
 
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 __itt_domain* Instrumentation::domain = nullptr;
 #endif
 
+bool Instrumentation::trace_enabled = false;
+Instrumentation::clock::time_point Instrumentation::frame_start;
+
+namespace {
+	/** Amount of events kept, must be a power of two */
+	constexpr uint64_t trace_capacity = 1 << 18;
+
+	/**
+	 * Slot of the ring buffer.
+	 * seq is odd while the slot is written and 2 * (index + 1) when the event
+	 * with that index is complete. Readers discard slots that changed while
+	 * they were copied.
+	 */
+	struct TraceSlot {
+		std::atomic<uint64_t> seq { 0 };
+		std::atomic<const char*> name { nullptr };
+		std::atomic<int64_t> start { 0 };
+		/** Duration of a scope or value of a counter */
+		std::atomic<int64_t> duration { 0 };
+		std::atomic<uint32_t> tid { 0 };
+		std::atomic<bool> counter { false };
+	};
+
+	std::unique_ptr<TraceSlot[]> trace_slots;
+	std::atomic<uint64_t> trace_index { 0 };
+	std::atomic<uint32_t> trace_next_tid { 1 };
+	Instrumentation::clock::time_point trace_epoch;
+
+	uint32_t GetTraceThreadId() {
+		thread_local uint32_t tid = trace_next_tid.fetch_add(1, std::memory_order_relaxed);
+		return tid;
+	}
+
+	int64_t ToMicroseconds(Instrumentation::clock::duration d) {
+		return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+	}
+
+	void WriteSlot(const char* name, int64_t start, int64_t duration, bool counter) {
+		const uint64_t index = trace_index.fetch_add(1, std::memory_order_relaxed);
+		auto& slot = trace_slots[index & (trace_capacity - 1)];
+
+		slot.seq.store(2 * index + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.start.store(start, std::memory_order_relaxed);
+		slot.duration.store(duration, std::memory_order_relaxed);
+		slot.tid.store(GetTraceThreadId(), std::memory_order_relaxed);
+		slot.counter.store(counter, std::memory_order_relaxed);
+
+		slot.seq.store(2 * (index + 1), std::memory_order_release);
+	}
+}
+
 void Instrumentation::Init(const char* name) {
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	assert(!domain);
@@ -34,3 +92,73 @@ void Instrumentation::Init(const char* name) {
 	(void)name;
 #endif
 }
+
+void Instrumentation::EnableTrace() {
+	if (trace_enabled) {
+		return;
+	}
+
+	trace_slots.reset(new TraceSlot[trace_capacity]);
+	trace_epoch = clock::now();
+	trace_enabled = true;
+}
+
+void Instrumentation::Record(const char* name, clock::time_point start, clock::time_point end) {
+	if (!trace_enabled) {
+		return;
+	}
+
+	WriteSlot(name, ToMicroseconds(start - trace_epoch), ToMicroseconds(end - start), false);
+}
+
+void Instrumentation::RecordCounter(const char* name, int64_t value) {
+	if (!trace_enabled) {
+		return;
+	}
+
+	WriteSlot(name, ToMicroseconds(clock::now() - trace_epoch), value, true);
+}
+
+int Instrumentation::WriteTrace(std::ostream& os) {
+	os << "{\"traceEvents\":[";
+
+	int written = 0;
+
+	if (trace_enabled) {
+		const uint64_t end = trace_index.load(std::memory_order_acquire);
+		const uint64_t begin = end > trace_capacity ? end - trace_capacity : 0;
+
+		for (uint64_t index = begin; index < end; ++index) {
+			auto& slot = trace_slots[index & (trace_capacity - 1)];
+
+			const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+			const char* name = slot.name.load(std::memory_order_relaxed);
+			const int64_t start = slot.start.load(std::memory_order_relaxed);
+			const int64_t duration = slot.duration.load(std::memory_order_relaxed);
+			const uint32_t tid = slot.tid.load(std::memory_order_relaxed);
+			const bool counter = slot.counter.load(std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (seq != 2 * (index + 1) || slot.seq.load(std::memory_order_relaxed) != seq) {
+				// Still being written or already overwritten by a newer event
+				continue;
+			}
+
+			if (written > 0) {
+				os << ",";
+			}
+			if (counter) {
+				os << "\n{\"name\":\"" << name << "\",\"cat\":\"player\",\"ph\":\"C\",\"pid\":1,\"tid\":" << tid
+					<< ",\"ts\":" << start << ",\"args\":{\"value\":" << duration << "}}";
+			} else {
+				os << "\n{\"name\":\"" << name << "\",\"cat\":\"player\",\"ph\":\"X\",\"pid\":1,\"tid\":" << tid
+					<< ",\"ts\":" << start << ",\"dur\":" << std::max<int64_t>(duration, 0) << "}";
+			}
+			++written;
+		}
+	}
+
+	os << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+	return written;
+}
@@ -26,9 +26,14 @@
 #include <ittnotify.h>
 #endif
 #include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
 
 class Instrumentation {
 public:
+	using clock = std::chrono::steady_clock;
+
 	/**
 	 * Must be called once on startup to initialize the instrumentation framework.
 	 *
@@ -36,6 +41,44 @@ public:
 	 */
 	static void Init(const char* name);
 
+	/**
+	 * Enables the built-in profiler.
+	 * Frames and named scopes are recorded into a ring buffer which keeps
+	 * the most recent events.
+	 * Must be called before any thread that records events is started.
+	 */
+	static void EnableTrace();
+
+	/** @return Whether the built-in profiler records events */
+	static bool IsTraceEnabled();
+
+	/**
+	 * Writes the recorded events in Chrome trace event format (JSON).
+	 * The output can be opened in chrome://tracing or Perfetto.
+	 *
+	 * @param os stream to write to
+	 * @return amount of events written
+	 */
+	static int WriteTrace(std::ostream& os);
+
+	/**
+	 * Records a finished event. Can be called from any thread.
+	 *
+	 * @param name name of the event, must be a string with static storage duration
+	 * @param start start time
+	 * @param end end time
+	 */
+	static void Record(const char* name, clock::time_point start, clock::time_point end);
+
+	/**
+	 * Records the current value of a counter. Can be called from any thread.
+	 * Counters are shown as graphs in the trace viewer.
+	 *
+	 * @param name name of the counter, must be a string with static storage duration
+	 * @param value value of the counter
+	 */
+	static void RecordCounter(const char* name, int64_t value);
+
 	/** Call at the beginning of a frame */
 	static void FrameBegin();
 
@@ -73,23 +116,71 @@ public:
 		bool begun = false;
 	};
 
+	/**
+	 * RAII wrapper recording a named scope in the built-in profiler.
+	 * Does nothing when the profiler is not enabled.
+	 */
+	class Scope {
+	public:
+		/** Creates a Scope that is not recording */
+		Scope() = default;
+
+		/**
+		 * Create a Scope and start recording.
+		 *
+		 * @param name name of the scope, must be a string with static storage duration
+		 */
+		explicit Scope(const char* name) noexcept;
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+		/** Calls End() */
+		~Scope();
+
+		/**
+		 * Ends the current scope and starts recording a new one.
+		 *
+		 * @param name name of the scope, must be a string with static storage duration
+		 */
+		void Begin(const char* name) noexcept;
+		/** Records the scope when Begin() was called */
+		void End() noexcept;
+	private:
+		const char* name = nullptr;
+		clock::time_point start;
+	};
+
 private:
+	static bool trace_enabled;
+	static clock::time_point frame_start;
+
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	static __itt_domain* domain;
 #endif
 };
 
+inline bool Instrumentation::IsTraceEnabled() {
+	return trace_enabled;
+}
+
 inline void Instrumentation::FrameBegin() {
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	assert(domain);
 	__itt_frame_begin_v3(domain, nullptr);
 #endif
+	if (trace_enabled) {
+		frame_start = clock::now();
+	}
 }
 inline void Instrumentation::FrameEnd() {
 #ifdef PLAYER_INSTRUMENTATION_VTUNE
 	assert(domain);
 	__itt_frame_end_v3(domain, nullptr);
 #endif
+	if (trace_enabled) {
+		Record("Frame", frame_start, clock::now());
+	}
 }
 
 inline Instrumentation::FrameScope::FrameScope(bool frame_begin)
@@ -137,4 +228,27 @@ inline void Instrumentation::FrameScope::Dismiss() noexcept {
 	begun = false;
 }
 
+inline Instrumentation::Scope::Scope(const char* name) noexcept {
+	Begin(name);
+}
+
+inline Instrumentation::Scope::~Scope() {
+	End();
+}
+
+inline void Instrumentation::Scope::Begin(const char* name) noexcept {
+	if (trace_enabled) {
+		End();
+		this->name = name;
+		start = clock::now();
+	}
+}
+
+inline void Instrumentation::Scope::End() noexcept {
+	if (name) {
+		Record(name, start, clock::now());
+		name = nullptr;
+	}
+}
+
 #endif
@@ -33,6 +33,10 @@
 #include <lcf/reader_lcf.h>
 #include <lcf/reader_util.h>
 #include <lcf/writer_lcf.h>
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <unordered_map>
 #include <vector>
 
 /*
@@ -177,434 +181,643 @@ struct ProcessAssignmentRet {
 	}
 };
 
-ProcessAssignmentRet ProcessAssignment(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip);
-
-int Process(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip) {
-	int value = 0;
-	int imm = 0;
-	int imm2 = 0;
-	int imm3 = 0;
+namespace {
+	using Instruction = ManiacPatch::Expression::Instruction;
 
-	if (it == end) {
-		return 0;
+	int32_t ClampToInt32(int64_t value) {
+		return static_cast<int32_t>(Utils::Clamp<int64_t>(value, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
 	}
 
-	auto op = static_cast<Op>(*it);
-	++it;
+	int32_t EvaluateUnary(Op op, int32_t imm) {
+		switch (op) {
+			case Op::Negate:
+				return -imm;
+			case Op::Not:
+				return !imm ? 0 : 1;
+			case Op::Flip:
+				return ~imm;
+			default:
+				return 0;
+		}
+	}
 
-	// When entering the switch it is on the first argument
-	switch (op) {
-		case Op::Null:
-			it++;
-			return 0;
-		case Op::U8:
-		case Op::UX8:
-			value = *it++;
-			return value;
-		case Op::U16:
-		case Op::UX16:
-			imm = *it++;
-			if (it == end) {
+	int32_t EvaluateBinary(Op op, int32_t imm, int32_t imm2) {
+		switch (op) {
+			case Op::Add:
+				return ClampToInt32(static_cast<int64_t>(imm) + imm2);
+			case Op::Sub:
+				return ClampToInt32(static_cast<int64_t>(imm) - imm2);
+			case Op::Mul:
+				return ClampToInt32(static_cast<int64_t>(imm) * imm2);
+			case Op::Div:
+				if (imm2 == 0) {
+					return imm;
+				}
+				return imm / imm2;
+			case Op::Mod:
+				if (imm2 == 0) {
+					return imm;
+				}
+				return imm % imm2;
+			case Op::BitOr:
+				return imm | imm2;
+			case Op::BitAnd:
+				return imm & imm2;
+			case Op::BitXor:
+				return imm ^ imm2;
+			case Op::BitShiftLeft:
+				return imm << imm2;
+			case Op::BitShiftRight:
+				return imm >> imm2;
+			case Op::Equal:
+				return imm == imm2 ? 1 : 0;
+			case Op::GreaterEqual:
+				return imm >= imm2 ? 1 : 0;
+			case Op::LessEqual:
+				return imm <= imm2 ? 1 : 0;
+			case Op::Greater:
+				return imm > imm2 ? 1 : 0;
+			case Op::Less:
+				return imm < imm2 ? 1 : 0;
+			case Op::NotEqual:
+				return imm != imm2 ? 1 : 0;
+			case Op::Or:
+				return !!imm || !!imm2 ? 1 : 0;
+			case Op::And:
+				return !!imm && !!imm2 ? 1 : 0;
+			default:
 				return 0;
-			}
-			imm2 = *it++;
-			value = (imm2 << 8) + imm;
-			return value;
-		case Op::S32:
-		case Op::SX32:
-			imm = *it++;
-			if (it == end) {
+		}
+	}
+
+	int32_t EvaluateAssignment(Op op, const ProcessAssignmentRet& ret, int32_t imm2) {
+		switch (op) {
+			case Op::AssignInplace:
+				return ret.assign(imm2);
+			case Op::AddInplace:
+				return ret.assign(ClampToInt32(static_cast<int64_t>(ret.fetch()) + imm2));
+			case Op::SubInplace:
+				return ret.assign(ClampToInt32(static_cast<int64_t>(ret.fetch()) - imm2));
+			case Op::MulInplace:
+				return ret.assign(ClampToInt32(static_cast<int64_t>(ret.fetch()) * imm2));
+			case Op::DivInplace:
+				if (imm2 == 0) {
+					return ret.fetch();
+				}
+				return ret.assign(ret.fetch() / imm2);
+			case Op::ModInplace:
+				if (imm2 == 0) {
+					return ret.fetch();
+				}
+				return ret.assign(ret.fetch() % imm2);
+			case Op::BitOrInplace:
+				return ret.assign(ret.fetch() | imm2);
+			case Op::BitAndInplace:
+				return ret.assign(ret.fetch() & imm2);
+			case Op::BitXorInplace:
+				return ret.assign(ret.fetch() ^ imm2);
+			case Op::BitShiftLeftInplace:
+				return ret.assign(ret.fetch() << imm2);
+			case Op::BitShiftRightInplace:
+				return ret.assign(ret.fetch() >> imm2);
+			default:
 				return 0;
-			}
-			imm2 = *it++;
-			if (it == end) {
+		}
+	}
+
+	struct FunctionInfo {
+		const char* name;
+		int args;
+		/** Result only depends on the arguments */
+		bool pure;
+	};
+
+	const FunctionInfo* GetFunctionInfo(Fn fn) {
+		static constexpr FunctionInfo functions[] = {
+			{ "rnd", 2, false },
+			{ "item", 2, false },
+			{ "event", 2, false },
+			{ "actor", 2, false },
+			{ "member", 2, false },
+			{ "enemy", 2, false },
+			{ "misc", 1, false },
+			{ "pow", 2, true },
+			{ "sqrt", 2, true },
+			{ "sin", 3, true },
+			{ "cos", 3, true },
+			{ "atan2", 3, true },
+			{ "min", 2, true },
+			{ "max", 2, true },
+			{ "abs", 1, true },
+			{ "clamp", 3, true },
+			{ "muldiv", 3, true },
+			{ "divmul", 3, true },
+			{ "between", 3, true }
+		};
+
+		auto idx = static_cast<size_t>(fn);
+		if (idx >= sizeof(functions) / sizeof(functions[0])) {
+			return nullptr;
+		}
+		return &functions[idx];
+	}
+
+	/**
+	 * Calls an expression function. Arguments are in the order they appear
+	 * in the expression.
+	 */
+	int32_t EvaluateFunction(Fn fn, const int32_t* args, const Game_BaseInterpreterContext* ip) {
+		switch (fn) {
+			case Fn::Rand:
+				return ControlVariables::Random(args[1], args[0]);
+			case Fn::Item:
+				return ControlVariables::Item(args[1], args[0]);
+			case Fn::Event:
+				return ControlVariables::Event(args[1], args[0], *ip);
+			case Fn::Actor:
+				return ControlVariables::Actor(args[1], args[0]);
+			case Fn::Party:
+				return ControlVariables::Party(args[1], args[0]);
+			case Fn::Enemy:
+				return ControlVariables::Enemy(args[1], args[0]);
+			case Fn::Misc:
+				return ControlVariables::Other(args[0]);
+			case Fn::Pow:
+				return ControlVariables::Pow(args[0], args[1]);
+			case Fn::Sqrt:
+				return ControlVariables::Sqrt(args[0], args[1]);
+			case Fn::Sin:
+				return ControlVariables::Sin(args[0], args[1], args[2]);
+			case Fn::Cos:
+				return ControlVariables::Cos(args[0], args[1], args[2]);
+			case Fn::Atan2:
+				return ControlVariables::Atan2(args[0], args[1], args[2]);
+			case Fn::Min:
+				return ControlVariables::Min(args[0], args[1]);
+			case Fn::Max:
+				return ControlVariables::Max(args[0], args[1]);
+			case Fn::Abs:
+				return ControlVariables::Abs(args[0]);
+			case Fn::Clamp:
+				return ControlVariables::Clamp(args[0], args[1], args[2]);
+			case Fn::Muldiv:
+				return ControlVariables::Muldiv(args[0], args[1], args[2]);
+			case Fn::Divmul:
+				return ControlVariables::Divmul(args[0], args[1], args[2]);
+			case Fn::Between:
+				return ControlVariables::Between(args[0], args[1], args[2]);
+			default:
 				return 0;
-			}
-			imm3 = *it++;
-			if (it == end) {
+		}
+	}
+
+	/** Reads the expression bytes, every op-code stores 4 of them */
+	class ExpressionReader {
+	public:
+		explicit ExpressionReader(Span<const int32_t> op_codes) : op_codes(op_codes), size(op_codes.size() * 4) {}
+
+		bool AtEnd() const {
+			return pos >= size;
+		}
+
+		int Peek() const {
+			if (AtEnd()) {
 				return 0;
 			}
-			value = *it++;
-			value = (value << 24) + (imm3 << 16) + (imm2 << 8) + imm;
+			return static_cast<int>((static_cast<uint32_t>(op_codes[pos / 4]) >> (8 * (pos % 4))) & 0xFF);
+		}
+
+		int Next() {
+			int value = Peek();
+			++pos;
 			return value;
-		case Op::Var:
-			imm = Process(it, end, ip);
-			return Main_Data::game_variables->Get(imm);
-		case Op::Switch:
-			imm = Process(it, end, ip);
-			return Main_Data::game_switches->GetInt(imm);
-		case Op::VarIndirect:
-			imm = Process(it, end, ip);
-			return Main_Data::game_variables->GetIndirect(imm);
-		case Op::SwitchIndirect:
-			imm = Process(it, end, ip);
-			return Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(imm));
-		case Op::Negate:
-			imm = Process(it, end, ip);
-			return -imm;
-		case Op::Not:
-			imm = Process(it, end, ip);
-			return !imm ? 0 : 1;
-		case Op::Flip:
-			imm = Process(it, end, ip);
-			return ~imm;
-		case Op::AssignInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(imm2);
-		}
-		case Op::AddInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) + imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::SubInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) - imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::MulInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(ret.fetch()) * imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max())));
-		}
-		case Op::DivInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return ret.fetch();
-			}
-			return ret.assign(ret.fetch() / imm2);
 		}
-		case Op::ModInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return ret.fetch();
+
+		void Back() {
+			--pos;
+		}
+
+	private:
+		Span<const int32_t> op_codes;
+		size_t size = 0;
+		size_t pos = 0;
+	};
+
+	/**
+	 * Translates the op-code stream into bytecode for a stack machine.
+	 * The stream is consumed exactly like the former recursive evaluator
+	 * did, operations only depending on constants are folded.
+	 */
+	class ExpressionCompiler {
+	public:
+		explicit ExpressionCompiler(Span<const int32_t> op_codes) : reader(op_codes) {}
+
+		struct Result {
+			bool constant = false;
+			int32_t value = 0;
+		};
+
+		/** Compiles the next expression in the stream */
+		Result Compile();
+
+		ExpressionReader& GetReader() {
+			return reader;
+		}
+
+		/** @return compiled expression producing num_results values */
+		ManiacPatch::Expression Finish(int num_results);
+
+	private:
+		/** Compiles the target of an inplace assignment, leaves the id on the stack */
+		Op CompileAssignmentTarget();
+
+		void Emit(Op op, int32_t value = 0, int arg = 0) {
+			code.push_back({ static_cast<uint8_t>(op), static_cast<uint8_t>(arg), value });
+		}
+
+		/** Replaces the code emitted since start with a constant */
+		Result Constant(size_t start, int32_t value) {
+			code.resize(start);
+			Emit(Op::S32, value);
+			return { true, value };
+		}
+
+		ExpressionReader reader;
+		std::vector<Instruction> code;
+	};
+
+	ExpressionCompiler::Result ExpressionCompiler::Compile() {
+		const size_t start = code.size();
+
+		if (reader.AtEnd()) {
+			return Constant(start, 0);
+		}
+
+		auto op = static_cast<Op>(reader.Next());
+
+		switch (op) {
+			case Op::Null:
+				reader.Next();
+				return Constant(start, 0);
+			case Op::U8:
+			case Op::UX8:
+				return Constant(start, reader.Next());
+			case Op::U16:
+			case Op::UX16: {
+				int imm = reader.Next();
+				if (reader.AtEnd()) {
+					return Constant(start, 0);
+				}
+				int imm2 = reader.Next();
+				return Constant(start, (imm2 << 8) + imm);
 			}
-			return ret.assign(ret.fetch() % imm2);
-		}
-		case Op::BitOrInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() | imm2);
-		}
-		case Op::BitAndInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() & imm2);
-		}
-		case Op::BitXorInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() ^ imm2);
-		}
-		case Op::BitShiftLeftInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() << imm2);
-		}
-		case Op::BitShiftRightInplace: {
-			auto ret = ProcessAssignment(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return ret.assign(ret.fetch() >> imm2);
-		}
-		case Op::Add:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) + imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Sub:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) - imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Mul:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return static_cast<int32_t>(Utils::Clamp<int64_t>(static_cast<int64_t>(imm) * imm2, std::numeric_limits<int32_t>::min(), std::numeric_limits<int32_t>::max()));
-		case Op::Div:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return imm;
+			case Op::S32:
+			case Op::SX32: {
+				uint32_t value = 0;
+				for (int i = 0; i < 4; ++i) {
+					if (i > 0 && reader.AtEnd()) {
+						return Constant(start, 0);
+					}
+					value |= static_cast<uint32_t>(reader.Next()) << (8 * i);
+				}
+				return Constant(start, static_cast<int32_t>(value));
 			}
-			return imm / imm2;
-		case Op::Mod:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			if (imm2 == 0) {
-				return imm;
+			case Op::Var:
+			case Op::Switch:
+			case Op::VarIndirect:
+			case Op::SwitchIndirect:
+				Compile();
+				Emit(op);
+				return {};
+			case Op::Negate:
+			case Op::Not:
+			case Op::Flip: {
+				auto arg = Compile();
+				if (arg.constant) {
+					return Constant(start, EvaluateUnary(op, arg.value));
+				}
+				Emit(op);
+				return {};
 			}
-			return imm % imm2;
-		case Op::BitOr:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm | imm2;
-		case Op::BitAnd:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm & imm2;
-		case Op::BitXor:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm ^ imm2;
-		case Op::BitShiftLeft:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm << imm2;
-		case Op::BitShiftRight:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm >> imm2;
-		case Op::Equal:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm == imm2 ? 1 : 0;
-		case Op::GreaterEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm >= imm2 ? 1 : 0;
-		case Op::LessEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm <= imm2 ? 1 : 0;
-		case Op::Greater:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm > imm2 ? 1 : 0;
-		case Op::Less:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm < imm2 ? 1 : 0;
-		case Op::NotEqual:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return imm != imm2 ? 1 : 0;
-		case Op::Or:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return !!imm || !!imm2 ? 1 : 0;
-		case Op::And:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			return !!imm && !!imm2 ? 1 : 0;
-		case Op::Ternary:
-			imm = Process(it, end, ip);
-			imm2 = Process(it, end, ip);
-			imm3 = Process(it, end, ip);
-			return imm != 0 ? imm2 : imm3;
-		case Op::Function:
-			imm = *it++; // function
-			imm2 = *it++; // arguments
-
-			if ((imm2 & 0x80) != 0) {
-				// Argument count is 4 bytes, that mode is not supported
-				Output::Warning("Maniac: Expression func long args unsupported");
-				return 0;
+			case Op::AssignInplace:
+			case Op::AddInplace:
+			case Op::SubInplace:
+			case Op::MulInplace:
+			case Op::DivInplace:
+			case Op::ModInplace:
+			case Op::BitOrInplace:
+			case Op::BitAndInplace:
+			case Op::BitXorInplace:
+			case Op::BitShiftLeftInplace:
+			case Op::BitShiftRightInplace: {
+				auto target = CompileAssignmentTarget();
+				Compile();
+				Emit(op, 0, static_cast<int>(target));
+				return {};
 			}
-
-			switch (static_cast<Fn>(imm)) {
-				case Fn::Rand:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression rnd args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Random(Process(it, end, ip), imm3);
-				case Fn::Item:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression item args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Item(Process(it, end, ip), imm3);
-				case Fn::Event:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression event args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Event(Process(it, end, ip), imm3, ip);
-				case Fn::Actor:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression actor args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Actor(Process(it, end, ip), imm3);
-				case Fn::Party:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression member args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Party(Process(it, end, ip), imm3);
-				case Fn::Enemy:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression enemy args {} != 2", imm2);
-						return 0;
-					}
-					imm3 = Process(it, end, ip);
-					return ControlVariables::Enemy(Process(it, end, ip), imm3);
-					break;
-				case Fn::Misc:
-					if (imm2 != 1) {
-						Output::Warning("Maniac: Expression misc args {} != 1", imm2);
-						return 0;
-					}
-					return ControlVariables::Other(Process(it, end, ip));
-				case Fn::Pow:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression pow args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Pow(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Sqrt:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression sqrt args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Sqrt(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Sin:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression sin args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Sin(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Cos:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression cos args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Cos(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Atan2:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression atan2 args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Atan2(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Min:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression min args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Min(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Max:
-					if (imm2 != 2) {
-						Output::Warning("Maniac: Expression max args {} != 2", imm2);
-						return 0;
-					}
-					return ControlVariables::Max(Process(it, end, ip), Process(it, end, ip));
-				case Fn::Abs:
-					if (imm2 != 1) {
-						Output::Warning("Maniac: Expression abs args {} != 1", imm2);
-						return 0;
-					}
-					return ControlVariables::Abs(Process(it, end, ip));
-				case Fn::Clamp:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression clamp args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Clamp(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Muldiv:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression muldiv args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Muldiv(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Divmul:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression divmul args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Divmul(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				case Fn::Between:
-					if (imm2 != 3) {
-						Output::Warning("Maniac: Expression between args {} != 3", imm2);
-						return 0;
-					}
-					return ControlVariables::Between(Process(it, end, ip), Process(it, end, ip), Process(it, end, ip));
-				default:
+			case Op::Add:
+			case Op::Sub:
+			case Op::Mul:
+			case Op::Div:
+			case Op::Mod:
+			case Op::BitOr:
+			case Op::BitAnd:
+			case Op::BitXor:
+			case Op::BitShiftLeft:
+			case Op::BitShiftRight:
+			case Op::Equal:
+			case Op::GreaterEqual:
+			case Op::LessEqual:
+			case Op::Greater:
+			case Op::Less:
+			case Op::NotEqual:
+			case Op::Or:
+			case Op::And: {
+				auto lhs = Compile();
+				auto rhs = Compile();
+				if (lhs.constant && rhs.constant) {
+					return Constant(start, EvaluateBinary(op, lhs.value, rhs.value));
+				}
+				Emit(op);
+				return {};
+			}
+			case Op::Ternary: {
+				// All operands are evaluated
+				auto cond = Compile();
+				auto lhs = Compile();
+				auto rhs = Compile();
+				if (cond.constant && lhs.constant && rhs.constant) {
+					return Constant(start, cond.value != 0 ? lhs.value : rhs.value);
+				}
+				Emit(op);
+				return {};
+			}
+			case Op::Function: {
+				int imm = reader.Next(); // function
+				int imm2 = reader.Next(); // arguments
+
+				if ((imm2 & 0x80) != 0) {
+					// Argument count is 4 bytes, that mode is not supported
+					Output::Warning("Maniac: Expression func long args unsupported");
+					return Constant(start, 0);
+				}
+
+				auto fn = static_cast<Fn>(imm);
+				auto* info = GetFunctionInfo(fn);
+				if (info && imm2 != info->args) {
+					Output::Warning("Maniac: Expression {} args {} != {}", info->name, imm2, info->args);
+					return Constant(start, 0);
+				}
+				if (!info) {
 					Output::Warning("Maniac: Expression Unknown Func {}", imm);
-					for (int i = 0; i < imm2; ++i) {
-						Process(it, end, ip);
+				}
+
+				bool constant = true;
+				int32_t args[3] = {};
+				for (int i = 0; i < imm2; ++i) {
+					auto arg = Compile();
+					constant = constant && arg.constant;
+					if (i < 3) {
+						args[i] = arg.value;
 					}
-					return 0;
+				}
+
+				if (constant && (!info || info->pure)) {
+					return Constant(start, info ? EvaluateFunction(fn, args, nullptr) : 0);
+				}
+				Emit(op, imm2, imm);
+				return {};
 			}
-		default:
-			Output::Warning("Maniac: Expression contains unsupported operation {}", static_cast<int>(op));
-			return 0;
+			default:
+				Output::Warning("Maniac: Expression contains unsupported operation {}", static_cast<int>(op));
+				return Constant(start, 0);
+		}
 	}
-}
 
-ProcessAssignmentRet ProcessAssignment(std::vector<int32_t>::iterator& it, std::vector<int32_t>::iterator end, const Game_BaseInterpreterContext& ip) {
-	// Like process but it remembers the type (Variable or Switch) without evaluating it to allow assignments
-	int imm = 0;
+	Op ExpressionCompiler::CompileAssignmentTarget() {
+		if (reader.AtEnd()) {
+			Emit(Op::S32, 0);
+			return Op::Null;
+		}
+
+		auto op = static_cast<Op>(reader.Next());
 
-	if (it == end) {
-		return {Op::Null, 0};
+		switch (op) {
+			case Op::Var:
+			case Op::Switch:
+			case Op::VarIndirect:
+			case Op::SwitchIndirect:
+				Compile();
+				return op;
+			default:
+				// Not a lvalue: The assignment only warns, evaluate it anyway
+				reader.Back();
+				Compile();
+				return op;
+		}
 	}
 
-	auto op = static_cast<Op>(*it);
-	++it;
+	ManiacPatch::Expression ExpressionCompiler::Finish(int num_results) {
+		ManiacPatch::Expression expr;
+		expr.num_results = num_results;
 
-	// When entering the switch it is on the first argument
-	switch (op) {
-		case Op::Var:
-		case Op::Switch:
-		case Op::VarIndirect:
-		case Op::SwitchIndirect:
-			imm = Process(it, end, ip);
-			return {op, imm};
-		default:
-			--it; // back on the op as op is fetched again by Process
-			imm = Process(it, end, ip);
-			return {op, imm};
+		int depth = 0;
+		for (const auto& instr: code) {
+			switch (static_cast<Op>(instr.op)) {
+				case Op::S32:
+					++depth;
+					break;
+				case Op::Var:
+				case Op::Switch:
+				case Op::VarIndirect:
+				case Op::SwitchIndirect:
+				case Op::Negate:
+				case Op::Not:
+				case Op::Flip:
+					break;
+				case Op::Ternary:
+					depth -= 2;
+					break;
+				case Op::Function:
+					depth -= instr.value - 1;
+					break;
+				default:
+					// Binary operations and assignments
+					--depth;
+					break;
+			}
+			expr.max_depth = std::max(expr.max_depth, depth);
+		}
+
+		expr.code = std::move(code);
+		return expr;
 	}
-}
 
-int32_t ManiacPatch::ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
-	std::vector<int32_t> ops;
-	for (auto &o: op_codes) {
-		auto uo = static_cast<uint32_t>(o);
-		ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
-		ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
-		ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
-		ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
-	}
-	auto beg = ops.begin();
-	return Process(beg, ops.end(), interpreter);
-}
+	/** Runs the bytecode, the results are left on the stack */
+	int32_t* Run(const ManiacPatch::Expression& expr, int32_t* stack, const Game_BaseInterpreterContext& ip) {
+		int32_t* sp = stack;
 
-std::vector<int32_t> ManiacPatch::ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
-	std::vector<int32_t> ops;
-	for (auto& o : op_codes) {
-		auto uo = static_cast<uint32_t>(o);
-		ops.push_back(static_cast<int32_t>(uo & 0x000000FF));
-		ops.push_back(static_cast<int32_t>((uo & 0x0000FF00) >> 8));
-		ops.push_back(static_cast<int32_t>((uo & 0x00FF0000) >> 16));
-		ops.push_back(static_cast<int32_t>((uo & 0xFF000000) >> 24));
+		for (const auto& instr: expr.code) {
+			auto op = static_cast<Op>(instr.op);
+			switch (op) {
+				case Op::S32:
+					*sp++ = instr.value;
+					break;
+				case Op::Var:
+					sp[-1] = Main_Data::game_variables->Get(sp[-1]);
+					break;
+				case Op::Switch:
+					sp[-1] = Main_Data::game_switches->GetInt(sp[-1]);
+					break;
+				case Op::VarIndirect:
+					sp[-1] = Main_Data::game_variables->GetIndirect(sp[-1]);
+					break;
+				case Op::SwitchIndirect:
+					sp[-1] = Main_Data::game_switches->GetInt(Main_Data::game_variables->Get(sp[-1]));
+					break;
+				case Op::Negate:
+				case Op::Not:
+				case Op::Flip:
+					sp[-1] = EvaluateUnary(op, sp[-1]);
+					break;
+				case Op::AssignInplace:
+				case Op::AddInplace:
+				case Op::SubInplace:
+				case Op::MulInplace:
+				case Op::DivInplace:
+				case Op::ModInplace:
+				case Op::BitOrInplace:
+				case Op::BitAndInplace:
+				case Op::BitXorInplace:
+				case Op::BitShiftLeftInplace:
+				case Op::BitShiftRightInplace: {
+					--sp;
+					ProcessAssignmentRet ret = { static_cast<Op>(instr.arg), sp[-1] };
+					sp[-1] = EvaluateAssignment(op, ret, sp[0]);
+					break;
+				}
+				case Op::Ternary:
+					sp -= 2;
+					sp[-1] = sp[-1] != 0 ? sp[0] : sp[1];
+					break;
+				case Op::Function: {
+					sp -= instr.value;
+					int32_t result = EvaluateFunction(static_cast<Fn>(instr.arg), sp, &ip);
+					*sp++ = result;
+					break;
+				}
+				default:
+					--sp;
+					sp[-1] = EvaluateBinary(op, sp[-1], sp[0]);
+					break;
+			}
+		}
+
+		return sp;
 	}
 
-	if (ops.empty()) {
-		return {};
+	template <typename F>
+	void WithStack(const ManiacPatch::Expression& expr, F&& f) {
+		std::array<int32_t, 32> stack;
+		if (expr.max_depth <= static_cast<int>(stack.size())) {
+			f(stack.data());
+		} else {
+			std::vector<int32_t> large_stack(expr.max_depth);
+			f(large_stack.data());
+		}
 	}
 
-	auto it = ops.begin();
+	struct CachedExpression {
+		std::vector<int32_t> op_codes;
+		bool multiple = false;
+		ManiacPatch::Expression expr;
+	};
 
-	std::vector<int32_t> results;
+	// Keyed by the address of the op-codes, which are the parameters of an EventCommand
+	constexpr size_t expression_cache_limit = 4096;
+	std::unordered_map<const int32_t*, CachedExpression> expression_cache;
+
+	const ManiacPatch::Expression& GetCachedExpression(Span<const int32_t> op_codes, bool multiple) {
+		auto it = expression_cache.find(op_codes.data());
+		if (it != expression_cache.end()) {
+			auto& entry = it->second;
+			// The event command can be gone and the memory reused
+			if (entry.multiple == multiple && std::equal(op_codes.begin(), op_codes.end(), entry.op_codes.begin(), entry.op_codes.end())) {
+				return entry.expr;
+			}
+		} else {
+			if (expression_cache.size() >= expression_cache_limit) {
+				expression_cache.clear();
+			}
+			it = expression_cache.emplace(op_codes.data(), CachedExpression()).first;
+		}
+
+		auto& entry = it->second;
+		entry.op_codes.assign(op_codes.begin(), op_codes.end());
+		entry.multiple = multiple;
+		entry.expr = multiple ? ManiacPatch::CompileExpressions(op_codes) : ManiacPatch::CompileExpression(op_codes);
+		return entry.expr;
+	}
+}
 
+ManiacPatch::Expression ManiacPatch::CompileExpression(Span<const int32_t> op_codes) {
+	ExpressionCompiler compiler(op_codes);
+	compiler.Compile();
+	return compiler.Finish(1);
+}
+
+ManiacPatch::Expression ManiacPatch::CompileExpressions(Span<const int32_t> op_codes) {
+	ExpressionCompiler compiler(op_codes);
+	auto& reader = compiler.GetReader();
+
+	if (reader.AtEnd()) {
+		return compiler.Finish(0);
+	}
+
+	int num_results = 0;
 	while (true) {
-		results.push_back(Process(it, ops.end(), interpreter));
+		compiler.Compile();
+		++num_results;
 
-		if (it == ops.end() || static_cast<Op>(*it) == Op::Null) {
+		if (reader.AtEnd() || static_cast<Op>(reader.Peek()) == Op::Null) {
 			break;
 		}
 	}
 
+	return compiler.Finish(num_results);
+}
+
+int32_t ManiacPatch::EvaluateExpression(const Expression& expr, const Game_BaseInterpreterContext& interpreter) {
+	int32_t result = 0;
+	WithStack(expr, [&](int32_t* stack) {
+		if (Run(expr, stack, interpreter) != stack) {
+			result = stack[0];
+		}
+	});
+	return result;
+}
+
+std::vector<int32_t> ManiacPatch::EvaluateExpressions(const Expression& expr, const Game_BaseInterpreterContext& interpreter) {
+	std::vector<int32_t> results;
+	WithStack(expr, [&](int32_t* stack) {
+		auto* sp = Run(expr, stack, interpreter);
+		results.assign(stack, sp);
+	});
 	return results;
 }
 
+int32_t ManiacPatch::ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	return EvaluateExpression(GetCachedExpression(op_codes, false), interpreter);
+}
+
+std::vector<int32_t> ManiacPatch::ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter) {
+	return EvaluateExpressions(GetCachedExpression(op_codes, true), interpreter);
+}
+
+void ManiacPatch::ClearExpressionCache() {
+	expression_cache.clear();
+}
+
 std::array<bool, 50> ManiacPatch::GetKeyRange() {
 	std::array<Input::Keys::InputKey, 50> keys = {
 		Input::Keys::A,
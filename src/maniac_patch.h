@@ -28,9 +28,83 @@
 class Game_BaseInterpreterContext;
 
 namespace ManiacPatch {
+	/**
+	 * Expression compiled to bytecode of a stack machine.
+	 * Parts of the expression that only depend on constants are folded.
+	 */
+	struct Expression {
+		struct Instruction {
+			/** Operation, uses the op-code numbers of the expression */
+			uint8_t op = 0;
+			/** Function id or target of an inplace assignment */
+			uint8_t arg = 0;
+			/** Constant or number of function arguments */
+			int32_t value = 0;
+		};
+
+		std::vector<Instruction> code;
+		/** Maximum stack size needed for evaluation */
+		int max_depth = 0;
+		/** Number of values the expression produces */
+		int num_results = 0;
+	};
+
+	/**
+	 * Compiles the first expression of an op-code stream.
+	 *
+	 * @param op_codes expression op-codes of an event command
+	 * @return compiled expression
+	 */
+	Expression CompileExpression(Span<const int32_t> op_codes);
+
+	/**
+	 * Compiles a list of expressions.
+	 *
+	 * @param op_codes expression op-codes of an event command
+	 * @return compiled expression producing one value per expression
+	 */
+	Expression CompileExpressions(Span<const int32_t> op_codes);
+
+	/**
+	 * Evaluates an expression compiled by CompileExpression.
+	 *
+	 * @param expr compiled expression
+	 * @param interpreter interpreter the expression belongs to
+	 * @return result
+	 */
+	int32_t EvaluateExpression(const Expression& expr, const Game_BaseInterpreterContext& interpreter);
+
+	/**
+	 * Evaluates expressions compiled by CompileExpressions.
+	 *
+	 * @param expr compiled expressions
+	 * @param interpreter interpreter the expressions belong to
+	 * @return results
+	 */
+	std::vector<int32_t> EvaluateExpressions(const Expression& expr, const Game_BaseInterpreterContext& interpreter);
+
+	/**
+	 * Evaluates an expression. The compiled expression is cached, the cache
+	 * is keyed by the address of the op-codes inside the event command.
+	 *
+	 * @param op_codes expression op-codes of an event command
+	 * @param interpreter interpreter the expression belongs to
+	 * @return result
+	 */
 	int32_t ParseExpression(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
+
+	/**
+	 * Evaluates a list of expressions, the compiled expressions are cached.
+	 *
+	 * @param op_codes expression op-codes of an event command
+	 * @param interpreter interpreter the expressions belong to
+	 * @return results
+	 */
 	std::vector<int32_t> ParseExpressions(Span<const int32_t> op_codes, const Game_BaseInterpreterContext& interpreter);
 
+	/** Removes all compiled expressions from the cache */
+	void ClearExpressionCache();
+
 	std::array<bool, 50> GetKeyRange();
 
 	bool CheckString(std::string_view str_l, std::string_view str_r, int op, bool ignore_case);
@@ -0,0 +1,182 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include <cassert>
+#include <chrono>
+#include <list>
+#include <map>
+#include <lcf/lmu/reader.h>
+#include "map_file_cache.h"
+#include "output.h"
+#include "thread_pool.h"
+
+namespace {
+	struct CacheItem {
+		MapFileCache::MapRef map;
+		size_t size;
+		std::list<int>::iterator lru;
+	};
+
+	std::map<int, CacheItem> cache;
+
+	// IDs of the cached maps, most recently used first
+	std::list<int> lru;
+
+	size_t cache_limit = 8 * 1024 * 1024;
+	size_t cache_size = 0;
+
+	struct PrefetchItem {
+		std::shared_future<void> done;
+		std::shared_ptr<std::unique_ptr<lcf::rpg::Map>> map;
+	};
+
+	std::map<int, PrefetchItem> prefetch_items;
+
+	// IDs of the prefetched maps in the order they were requested
+	std::list<int> prefetch_order;
+
+	// Maps that are prefetched but never taken are dropped after this amount
+	constexpr size_t prefetch_limit = 16;
+
+	void FreeCacheMemory() {
+		while (cache_size > cache_limit && !lru.empty()) {
+			auto it = cache.find(lru.back());
+			assert(it != cache.end());
+
+#ifdef CACHE_DEBUG
+			Output::Debug("Map: Freeing memory of {}", it->first);
+#endif
+
+			cache_size -= it->second.size;
+			cache.erase(it);
+			lru.pop_back();
+		}
+
+#ifdef CACHE_DEBUG
+		Output::Debug("Map cache size: {}", cache_size / 1024.0 / 1024);
+#endif
+	}
+}
+
+MapFileCache::MapRef MapFileCache::Get(int map_id) {
+	auto it = cache.find(map_id);
+	if (it == cache.end()) {
+		return {};
+	}
+
+	lru.splice(lru.begin(), lru, it->second.lru);
+	return it->second.map;
+}
+
+void MapFileCache::Add(int map_id, MapRef map) {
+	if (!map || cache.find(map_id) != cache.end()) {
+		return;
+	}
+
+	const size_t size = EstimateMemory(*map);
+
+	lru.push_front(map_id);
+	cache.emplace(map_id, CacheItem{ std::move(map), size, lru.begin() });
+	cache_size += size;
+
+	FreeCacheMemory();
+}
+
+std::shared_future<void> MapFileCache::Prefetch(int map_id, Filesystem_Stream::InputStream stream, bool xml, std::string encoding) {
+	if (!stream || IsCachedOrPending(map_id)) {
+		return {};
+	}
+
+	auto is = std::make_shared<Filesystem_Stream::InputStream>(std::move(stream));
+	auto map = std::make_shared<std::unique_ptr<lcf::rpg::Map>>();
+
+	auto done = ThreadPool::Global().Submit([is, map, xml, encoding = std::move(encoding)]() {
+		if (xml) {
+			*map = lcf::LMU_Reader::LoadXml(*is);
+		} else {
+			*map = lcf::LMU_Reader::Load(*is, encoding);
+		}
+	});
+
+	prefetch_items.emplace(map_id, PrefetchItem{ done, map });
+	prefetch_order.push_back(map_id);
+
+	if (prefetch_order.size() > prefetch_limit) {
+		prefetch_items.erase(prefetch_order.front());
+		prefetch_order.pop_front();
+	}
+
+	return done;
+}
+
+std::unique_ptr<lcf::rpg::Map> MapFileCache::TakePrefetched(int map_id) {
+	auto it = prefetch_items.find(map_id);
+	if (it == prefetch_items.end()) {
+		return {};
+	}
+
+	auto item = std::move(it->second);
+	prefetch_items.erase(it);
+	prefetch_order.remove(map_id);
+
+	item.done.wait();
+	return std::move(*item.map);
+}
+
+bool MapFileCache::IsCachedOrPending(int map_id) {
+	return cache.find(map_id) != cache.end() || prefetch_items.find(map_id) != prefetch_items.end();
+}
+
+size_t MapFileCache::EstimateMemory(const lcf::rpg::Map& map) {
+	size_t size = sizeof(map);
+	size += (map.lower_layer.size() + map.upper_layer.size()) * sizeof(int16_t);
+
+	for (const auto& ev: map.events) {
+		size += sizeof(ev) + ev.name.size();
+		for (const auto& page: ev.pages) {
+			size += sizeof(page) + page.character_name.size();
+			size += page.move_route.move_commands.size() * sizeof(lcf::rpg::MoveCommand);
+			for (const auto& com: page.event_commands) {
+				size += sizeof(com) + com.string.size() + com.parameters.size() * sizeof(int32_t);
+			}
+		}
+	}
+
+	return size;
+}
+
+void MapFileCache::SetMemoryLimit(size_t limit) {
+	cache_limit = limit;
+	FreeCacheMemory();
+}
+
+size_t MapFileCache::GetMemoryLimit() {
+	return cache_limit;
+}
+
+size_t MapFileCache::GetMemoryUsage() {
+	return cache_size;
+}
+
+void MapFileCache::Clear() {
+	cache_size = 0;
+	cache.clear();
+	lru.clear();
+	prefetch_items.clear();
+	prefetch_order.clear();
+}
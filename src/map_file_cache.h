@@ -0,0 +1,110 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_MAP_FILE_CACHE_H
+#define EP_MAP_FILE_CACHE_H
+
+// Headers
+#include <cstddef>
+#include <future>
+#include <memory>
+#include <string>
+#include <lcf/rpg/map.h>
+
+#include "filesystem_stream.h"
+
+/**
+ * Keeps parsed map files in memory to avoid parsing them again when the
+ * map is entered again or when events are cloned from another map.
+ * When the maps exceed the memory limit (8 MB by default) the least
+ * recently used maps are freed.
+ * Cached maps are shared and must not be modified, Game_Map works on a copy
+ * of the current map.
+ */
+namespace MapFileCache {
+	using MapRef = std::shared_ptr<const lcf::rpg::Map>;
+
+	/**
+	 * Returns a cached map and marks it as recently used.
+	 *
+	 * @param map_id ID of the map
+	 * @return cached map or nullptr when not cached
+	 */
+	MapRef Get(int map_id);
+
+	/**
+	 * Adds a map to the cache and frees the least recently used maps when
+	 * the memory limit is exceeded.
+	 *
+	 * @param map_id ID of the map
+	 * @param map parsed map
+	 */
+	void Add(int map_id, MapRef map);
+
+	/**
+	 * Parses a map file in a worker thread.
+	 * The result is not added to the cache, it must be taken by TakePrefetched
+	 * to apply the translation on the game thread first.
+	 *
+	 * @param map_id ID of the map
+	 * @param stream Stream to the map file
+	 * @param xml Whether the map file is an EasyRPG XML map
+	 * @param encoding Encoding of the map file
+	 * @return future that becomes ready when parsing finished, invalid when nothing is parsed
+	 */
+	std::shared_future<void> Prefetch(int map_id, Filesystem_Stream::InputStream stream, bool xml, std::string encoding);
+
+	/**
+	 * Takes a map parsed by Prefetch. Waits when the map is still parsed.
+	 *
+	 * @param map_id ID of the map
+	 * @return parsed map or nullptr when the map was not prefetched or parsing failed
+	 */
+	std::unique_ptr<lcf::rpg::Map> TakePrefetched(int map_id);
+
+	/**
+	 * @param map_id ID of the map
+	 * @return Whether the map is cached or parsed by a worker thread
+	 */
+	bool IsCachedOrPending(int map_id);
+
+	/**
+	 * Estimates the memory used by a parsed map.
+	 *
+	 * @param map parsed map
+	 * @return memory in bytes
+	 */
+	size_t EstimateMemory(const lcf::rpg::Map& map);
+
+	/**
+	 * Sets the maximum amount of memory used by parsed maps.
+	 *
+	 * @param limit memory limit in bytes
+	 */
+	void SetMemoryLimit(size_t limit);
+
+	/** @return memory limit in bytes */
+	size_t GetMemoryLimit();
+
+	/** @return memory used by parsed maps in bytes */
+	size_t GetMemoryUsage();
+
+	/** Frees all maps, e.g. when the translation changed */
+	void Clear();
+}
+
+#endif
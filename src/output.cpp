@@ -23,6 +23,7 @@
 #include <iostream>
 #include <fstream>
 #include <thread>
+#include <mutex>
 #include <chrono>
 #include <fmt/color.h>
 #include <fmt/ostream.h>
@@ -40,6 +41,7 @@
 #include "message_overlay.h"
 #include "font.h"
 #include "baseui.h"
+#include "thread_pool.h"
 
 // fmt 7 has renamed the namespace
 #if FMT_VERSION < 70000
@@ -103,6 +105,11 @@ namespace {
 
 	LogCallbackFn log_cb = LogCallback;
 	LogCallbackUserData log_cb_udata = nullptr;
+
+#ifdef HAVE_ASYNC_WORKER
+	// Image decoders running in worker threads can log
+	std::mutex log_mutex;
+#endif
 }
 
 std::string Output::LogLevelToString(LogLevel lvl) {
@@ -136,6 +143,10 @@ void Output::SetLogCallback(LogCallbackFn fn, LogCallbackUserData userdata) {
 }
 
 static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Color()) {
+#ifdef HAVE_ASYNC_WORKER
+	std::unique_lock<std::mutex> lock(log_mutex);
+#endif
+
 // skip writing log file
 #ifndef EMSCRIPTEN
 	std::string prefix = Output::LogLevelToString(lvl) + ": ";
@@ -160,6 +171,15 @@ static void WriteLog(LogLevel lvl, std::string const& msg, Color const& c = Colo
 	// output to custom logger or terminal
 	log_cb(lvl, msg, log_cb_udata);
 
+#ifdef HAVE_ASYNC_WORKER
+	lock.unlock();
+
+	if (ThreadPool::IsWorkerThread()) {
+		// The overlay is only accessible from the main thread
+		return;
+	}
+#endif
+
 	// output to overlay
 	if (lvl != LogLevel::Debug && lvl != LogLevel::Error) {
 		Graphics::GetMessageOverlay().AddMessage(msg, c);
@@ -0,0 +1,165 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "path_finder.h"
+#include <algorithm>
+#include <cstdlib>
+
+namespace {
+	struct Neighbour {
+		int dx;
+		int dy;
+		int direction;
+	};
+
+	// The order of the neighbours defines which of several equally long routes is chosen
+	constexpr Neighbour neighbours[] = {
+		{ 1, 0, 1 }, // Right
+		{ 0, -1, 0 }, // Up
+		{ -1, 0, 3 }, // Left
+		{ 0, 1, 2 }, // Down
+		{ -1, 1, 6 }, // Down Left
+		{ 1, -1, 4 }, // Up Right
+		{ -1, -1, 7 }, // Up Left
+		{ 1, 1, 5 } // Down Right
+	};
+}
+
+bool PathFinder::Search(const Args& args, const CheckWayFn& check_way, std::vector<int>& route) {
+	route.clear();
+	expanded_nodes = 0;
+
+	const int width = args.width;
+	const int height = args.height;
+
+	auto in_bounds = [&](int x, int y) {
+		return x >= 0 && x < width && y >= 0 && y < height;
+	};
+
+	if (!in_bounds(args.start_x, args.start_y) || args.search_max <= 0) {
+		return false;
+	}
+
+	const size_t num_cells = static_cast<size_t>(width) * static_cast<size_t>(height);
+	if (cells.size() < num_cells) {
+		cells.resize(num_cells, Cell{ 0, -1, -1 });
+	}
+
+	// Cells of previous searches are invalidated by bumping the generation
+	if (++generation == 0) {
+		std::fill(cells.begin(), cells.end(), Cell{ 0, -1, -1 });
+		generation = 1;
+	}
+
+	const int start = args.start_y * width + args.start_x;
+	cells[start] = { generation, -1, -1 };
+
+	queue.clear();
+	queue.push_back(start);
+	size_t head = 0;
+
+	const int num_neighbours = args.allow_diagonal ? 8 : 4;
+
+	int closest = -1;
+	int closest_distance = std::numeric_limits<int>::max();
+
+	while (head < queue.size() && expanded_nodes < args.search_max) {
+		const int n = queue[head++];
+		const int n_x = n % width;
+		const int n_y = n / width;
+		++expanded_nodes;
+
+		if (n_x == args.dest_x && n_y == args.dest_y) {
+			// Reached the destination
+			closest = n;
+			closest_distance = 0;
+			break;
+		}
+
+		for (int i = 0; i < num_neighbours; ++i) {
+			const auto& nb = neighbours[i];
+			int a_x = n_x + nb.dx;
+			int a_y = n_y + nb.dy;
+
+			// Adjust neighbour coordinates for map looping
+			if (args.loop_horizontal) {
+				if (a_x >= width) {
+					a_x -= width;
+				} else if (a_x < 0) {
+					a_x += width;
+				}
+			}
+			if (args.loop_vertical) {
+				if (a_y >= height) {
+					a_y -= height;
+				} else if (a_y < 0) {
+					a_y += height;
+				}
+			}
+
+			if (!in_bounds(a_x, a_y)) {
+				continue;
+			}
+
+			const int a = a_y * width + a_x;
+			if (cells[a].generation == generation) {
+				// Already discovered with a route that is at most as long
+				continue;
+			}
+
+			const bool is_destination = (a_x == args.dest_x && a_y == args.dest_y);
+			if (!check_way(n_x, n_y, a_x, a_y, false) && !(is_destination && check_way(n_x, n_y, a_x, a_y, true))) {
+				continue;
+			}
+
+			if (nb.dx != 0 && nb.dy != 0) {
+				// Diagonal steps require one free orthogonal neighbour
+				if (!check_way(n_x, n_y, n_x + nb.dx, n_y, false) && !check_way(n_x, n_y, n_x, n_y + nb.dy, false)) {
+					continue;
+				}
+			}
+
+			cells[a] = { generation, n, nb.direction };
+			queue.push_back(a);
+		}
+
+		const int manhattan_dist = std::abs(args.dest_x - n_x) + std::abs(args.dest_y - n_y);
+		if (manhattan_dist < closest_distance) {
+			closest = n;
+			closest_distance = manhattan_dist;
+		}
+	}
+
+	if (closest < 0) {
+		return false;
+	}
+
+	// Walk back from the closest node, keeping at most steps_max nodes
+	int node = closest;
+	while (static_cast<int>(route.size()) < args.steps_max) {
+		route.push_back(cells[node].direction);
+		node = cells[node].parent;
+		if (node < 0) {
+			break;
+		}
+	}
+
+	std::reverse(route.begin(), route.end());
+
+	return true;
+}
@@ -0,0 +1,95 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_PATH_FINDER_H
+#define EP_PATH_FINDER_H
+
+// Headers
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+/**
+ * Grid based route search used by the "Search Path" event command.
+ *
+ * Nodes are expanded in breadth-first order, which for the uniform step
+ * cost of the map grid is the order of a cost-keyed priority queue with
+ * ties broken by discovery order. The visited state and the parent links
+ * are kept in a flat grid of the map size, which is reused between
+ * searches, so a search is linear in the number of expanded nodes.
+ */
+class PathFinder {
+public:
+	/** Argument struct for a search */
+	struct Args {
+		int start_x = 0;
+		int start_y = 0;
+		int dest_x = 0;
+		int dest_y = 0;
+		int width = 0;
+		int height = 0;
+		bool loop_horizontal = false;
+		bool loop_vertical = false;
+		bool allow_diagonal = false;
+		/** Maximum amount of expanded nodes */
+		int search_max = std::numeric_limits<int>::max();
+		/** Maximum amount of nodes in the returned route */
+		int steps_max = std::numeric_limits<int>::max();
+	};
+
+	/**
+	 * Passability callback.
+	 * When to_destination is true the target tile is the destination and
+	 * the relaxed destination check is requested.
+	 */
+	using CheckWayFn = std::function<bool(int from_x, int from_y, int to_x, int to_y, bool to_destination)>;
+
+	/**
+	 * Searches a route from the start to the destination.
+	 * When the destination is unreachable the route leads to the expanded
+	 * node with the lowest manhattan distance to the destination.
+	 *
+	 * @param args search arguments
+	 * @param check_way passability callback
+	 * @param route receives the direction of each node of the route,
+	 *        the start node (when part of the route) has direction -1
+	 * @return false when no node was expanded
+	 */
+	bool Search(const Args& args, const CheckWayFn& check_way, std::vector<int>& route);
+
+	/** @return amount of nodes expanded by the last search */
+	int GetExpandedNodes() const;
+
+private:
+	struct Cell {
+		uint32_t generation;
+		int32_t parent;
+		int32_t direction;
+	};
+
+	std::vector<Cell> cells;
+	std::vector<int32_t> queue;
+	uint32_t generation = 0;
+	int expanded_nodes = 0;
+};
+
+inline int PathFinder::GetExpandedNodes() const {
+	return expanded_nodes;
+}
+
+#endif
@@ -0,0 +1,805 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "pixel_kernels.h"
+#include "cpu_features.h"
+#include "bitmap_hslrgb.h"
+
+#ifdef EP_SIMD_SSE41
+#  include <smmintrin.h>
+#endif
+#ifdef EP_SIMD_AVX2
+#  include <immintrin.h>
+#endif
+#ifdef EP_SIMD_NEON
+#  include <arm_neon.h>
+#  if defined(__aarch64__) || defined(_M_ARM64)
+// ARMv7 NEON has no exact float division, the hue change stays scalar there
+#    define EP_NEON_HUE
+#  endif
+#endif
+
+using PixelKernels::Variant;
+using PixelKernels::PixelLayout;
+using PixelKernels::ToneParams;
+
+namespace {
+
+// Hard light lookup table mapping source color to destination color
+// FIXME: Replace this with std::array<std::array<uint8_t,256>,256> when we have C++17
+struct HardLightTable {
+	uint8_t table[256][256] = {};
+};
+
+constexpr HardLightTable make_hard_light_lookup() {
+	HardLightTable hl;
+	for (int i = 0; i < 256; ++i) {
+		for (int j = 0; j < 256; ++j) {
+			int res = 0;
+			if (i <= 128)
+				res = (2 * i * j) / 255;
+			else
+				res = 255 - 2 * (255 - i) * (255 - j) / 255;
+			hl.table[i][j] = res > 255 ? 255 : res < 0 ? 0 : res;
+		}
+	}
+	return hl;
+}
+
+constexpr auto hard_light = make_hard_light_lookup();
+
+/*
+ * The SIMD variants evaluate the hard light table as
+ * min(k * (j ^ flip) / 255, 255) ^ flip
+ * which is the same formula with the upper half mirrored.
+ */
+constexpr int HardLightFactor(int i) {
+	return i <= 128 ? 2 * i : 2 * (255 - i);
+}
+
+constexpr int HardLightFlip(int i) {
+	return i <= 128 ? 0 : 0xFF;
+}
+
+// Saturation Tone Inline: Changes a pixel saturation
+inline void saturation_tone(uint32_t &src_pixel, const int saturation, const int rs, const int gs, const int bs, const int as) {
+	// Algorithm from OpenPDN (MIT license)
+	// Transformation in Y'CbCr color space
+	uint8_t r = (src_pixel >> rs) & 0xFF;
+	uint8_t g = (src_pixel >> gs) & 0xFF;
+	uint8_t b = (src_pixel >> bs) & 0xFF;
+	uint8_t a = (src_pixel >> as) & 0xFF;
+
+	// Y' = 0.299 R' + 0.587 G' + 0.114 B'
+	uint8_t lum = (7471 * b + 38470 * g + 19595 * r) >> 16;
+
+	// Scale Cb/Cr by scale factor "sat"
+	int red = ((lum * 1024 + (r - lum) * saturation) >> 10);
+	red = red > 255 ? 255 : red < 0 ? 0 : red;
+	int green = ((lum * 1024 + (g - lum) * saturation) >> 10);
+	green = green > 255 ? 255 : green < 0 ? 0 : green;
+	int blue = ((lum * 1024 + (b - lum) * saturation) >> 10);
+	blue = blue > 255 ? 255 : blue < 0 ? 0 : blue;
+
+	src_pixel = ((uint32_t)red << rs) | ((uint32_t)green << gs) | ((uint32_t)blue << bs) | ((uint32_t)a << as);
+}
+
+// Color Tone Inline: Changes color of a pixel by hard light table
+inline void color_tone(uint32_t &src_pixel, const Tone& tone, const int rs, const int gs, const int bs, const int as) {
+	src_pixel = ((uint32_t)hard_light.table[tone.red][(src_pixel >> rs) & 0xFF] << rs)
+		| ((uint32_t)hard_light.table[tone.green][(src_pixel >> gs) & 0xFF] << gs)
+		| ((uint32_t)hard_light.table[tone.blue][(src_pixel >> bs) & 0xFF] << bs)
+		| ((uint32_t)((src_pixel >> as) & 0xFF) << as);
+}
+
+inline void color_tone_alpha(uint32_t &src_pixel, const Tone& tone, const int rs, const int gs, const int bs, const int as) {
+	uint8_t a = (src_pixel >> as) & 0xFF;
+	uint8_t r = ((uint32_t)hard_light.table[tone.red][(src_pixel >> rs) & 0xFF]) * a / 255;
+	uint8_t g = ((uint32_t)hard_light.table[tone.green][(src_pixel >> gs) & 0xFF]) * a / 255;
+	uint8_t b = ((uint32_t)hard_light.table[tone.blue][(src_pixel >> bs) & 0xFF]) * a / 255;
+	src_pixel = ((uint32_t)r << rs) | ((uint32_t)g << gs) | ((uint32_t)b << bs) | ((uint32_t)a << as);
+}
+
+namespace Scalar {
+	int ApplyTone(uint32_t* pixels, int count, const ToneParams& p) {
+		const int rs = p.layout.r_shift;
+		const int gs = p.layout.g_shift;
+		const int bs = p.layout.b_shift;
+		const int as = p.layout.a_shift;
+
+		for (int i = 0; i < count; ++i) {
+			uint32_t& pixel = pixels[i];
+			const uint8_t a = (pixel >> as) & 0xFF;
+
+			if (p.skip_transparent && a == 0) {
+				continue;
+			}
+
+			if (p.saturation) {
+				saturation_tone(pixel, p.sat, rs, gs, bs, as);
+			}
+
+			if (p.color) {
+				if (p.premultiply && a != 255) {
+					color_tone_alpha(pixel, p.tone, rs, gs, bs, as);
+				} else {
+					color_tone(pixel, p.tone, rs, gs, bs, as);
+				}
+			}
+		}
+
+		return count;
+	}
+
+	int ApplyHueChange(uint32_t* pixels, int count, int hue, const PixelLayout& layout) {
+		for (int i = 0; i < count; ++i) {
+			uint32_t pixel = pixels[i];
+			uint8_t r = (pixel >> layout.r_shift) & 0xFF;
+			uint8_t g = (pixel >> layout.g_shift) & 0xFF;
+			uint8_t b = (pixel >> layout.b_shift) & 0xFF;
+			uint8_t a = (pixel >> layout.a_shift) & 0xFF;
+			if (a > 0)
+				RGB_adjust_HSL(r, g, b, hue);
+			pixels[i] = ((uint32_t) r << layout.r_shift) | ((uint32_t) g << layout.g_shift)
+				| ((uint32_t) b << layout.b_shift) | ((uint32_t) a << layout.a_shift);
+		}
+
+		return count;
+	}
+}
+
+/*
+ * The SIMD variants process one 32 bit lane per pixel and every channel in
+ * a separate vector. All intermediate values fit into 32 bit integers and
+ * divisions use the same rounding as the scalar code:
+ * - x / 255 is computed as (x + 1 + (x >> 8)) >> 8, exact for x <= 65280
+ * - divisions in the HSL conversion use float, exact for the value range
+ */
+
+#ifdef EP_SIMD_SSE41
+namespace Sse41 {
+	EP_TARGET_SSE41 inline __m128i Div255(__m128i x) {
+		__m128i t = _mm_add_epi32(_mm_add_epi32(x, _mm_set1_epi32(1)), _mm_srli_epi32(x, 8));
+		return _mm_srli_epi32(t, 8);
+	}
+
+	EP_TARGET_SSE41 inline __m128i HardLight(__m128i v, __m128i k, __m128i flip) {
+		v = Div255(_mm_mullo_epi32(_mm_xor_si128(v, flip), k));
+		return _mm_xor_si128(_mm_min_epi32(v, _mm_set1_epi32(255)), flip);
+	}
+
+	EP_TARGET_SSE41 inline __m128i Saturate(__m128i v, __m128i lum, __m128i lum1024, __m128i sat) {
+		v = _mm_srai_epi32(_mm_add_epi32(lum1024, _mm_mullo_epi32(_mm_sub_epi32(v, lum), sat)), 10);
+		return _mm_min_epi32(_mm_max_epi32(v, _mm_setzero_si128()), _mm_set1_epi32(255));
+	}
+
+	/** @return mask ? a : b */
+	EP_TARGET_SSE41 inline __m128i Select(__m128i mask, __m128i a, __m128i b) {
+		return _mm_blendv_epi8(b, a, mask);
+	}
+
+	/** @return num / den rounded towards zero */
+	EP_TARGET_SSE41 inline __m128i Divide(__m128i num, __m128i den) {
+		return _mm_cvttps_epi32(_mm_div_ps(_mm_cvtepi32_ps(num), _mm_cvtepi32_ps(den)));
+	}
+
+	EP_TARGET_SSE41 int ApplyTone(uint32_t* pixels, int count, const ToneParams& p) {
+		const __m128i rs = _mm_cvtsi32_si128(p.layout.r_shift);
+		const __m128i gs = _mm_cvtsi32_si128(p.layout.g_shift);
+		const __m128i bs = _mm_cvtsi32_si128(p.layout.b_shift);
+		const __m128i as = _mm_cvtsi32_si128(p.layout.a_shift);
+		const __m128i mask = _mm_set1_epi32(0xFF);
+		const __m128i sat = _mm_set1_epi32(p.sat);
+		const __m128i kr = _mm_set1_epi32(HardLightFactor(p.tone.red));
+		const __m128i kg = _mm_set1_epi32(HardLightFactor(p.tone.green));
+		const __m128i kb = _mm_set1_epi32(HardLightFactor(p.tone.blue));
+		const __m128i fr = _mm_set1_epi32(HardLightFlip(p.tone.red));
+		const __m128i fg = _mm_set1_epi32(HardLightFlip(p.tone.green));
+		const __m128i fb = _mm_set1_epi32(HardLightFlip(p.tone.blue));
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+			__m128i r = _mm_and_si128(_mm_srl_epi32(px, rs), mask);
+			__m128i g = _mm_and_si128(_mm_srl_epi32(px, gs), mask);
+			__m128i b = _mm_and_si128(_mm_srl_epi32(px, bs), mask);
+			const __m128i a = _mm_and_si128(_mm_srl_epi32(px, as), mask);
+
+			if (p.saturation) {
+				__m128i lum = _mm_add_epi32(_mm_mullo_epi32(b, _mm_set1_epi32(7471)), _mm_mullo_epi32(g, _mm_set1_epi32(38470)));
+				lum = _mm_srli_epi32(_mm_add_epi32(lum, _mm_mullo_epi32(r, _mm_set1_epi32(19595))), 16);
+				const __m128i lum1024 = _mm_slli_epi32(lum, 10);
+				r = Saturate(r, lum, lum1024, sat);
+				g = Saturate(g, lum, lum1024, sat);
+				b = Saturate(b, lum, lum1024, sat);
+			}
+
+			if (p.color) {
+				r = HardLight(r, kr, fr);
+				g = HardLight(g, kg, fg);
+				b = HardLight(b, kb, fb);
+				if (p.premultiply) {
+					r = Div255(_mm_mullo_epi32(r, a));
+					g = Div255(_mm_mullo_epi32(g, a));
+					b = Div255(_mm_mullo_epi32(b, a));
+				}
+			}
+
+			__m128i out = _mm_or_si128(
+				_mm_or_si128(_mm_sll_epi32(r, rs), _mm_sll_epi32(g, gs)),
+				_mm_or_si128(_mm_sll_epi32(b, bs), _mm_sll_epi32(a, as)));
+			if (p.skip_transparent) {
+				out = Select(_mm_cmpeq_epi32(a, _mm_setzero_si128()), px, out);
+			}
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), out);
+		}
+
+		return i + Scalar::ApplyTone(pixels + i, count - i, p);
+	}
+
+	EP_TARGET_SSE41 int ApplyHueChange(uint32_t* pixels, int count, int hue, const PixelLayout& layout) {
+		const __m128i rs = _mm_cvtsi32_si128(layout.r_shift);
+		const __m128i gs = _mm_cvtsi32_si128(layout.g_shift);
+		const __m128i bs = _mm_cvtsi32_si128(layout.b_shift);
+		const __m128i as = _mm_cvtsi32_si128(layout.a_shift);
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i mask = _mm_set1_epi32(0xFF);
+		const __m128i c1ff = _mm_set1_epi32(0x1FF);
+		const __m128i vhue = _mm_set1_epi32(hue);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const __m128i px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pixels + i));
+			const __m128i r = _mm_and_si128(_mm_srl_epi32(px, rs), mask);
+			const __m128i g = _mm_and_si128(_mm_srl_epi32(px, gs), mask);
+			const __m128i b = _mm_and_si128(_mm_srl_epi32(px, bs), mask);
+			const __m128i a = _mm_and_si128(_mm_srl_epi32(px, as), mask);
+
+			// RGB_to_HSL: Same channel order decision as the scalar code
+			const __m128i r_gt_g = _mm_cmpgt_epi32(r, g);
+			const __m128i r_gt_b = _mm_cmpgt_epi32(r, b);
+			const __m128i g_gt_b = _mm_cmpgt_epi32(g, b);
+			const __m128i b_gt_r = _mm_cmpgt_epi32(b, r);
+			const __m128i b_gt_g = _mm_cmpgt_epi32(b, g);
+			const __m128i r_max = _mm_and_si128(r_gt_g, r_gt_b);
+			const __m128i b_max = _mm_or_si128(_mm_andnot_si128(r_gt_b, r_gt_g),
+				_mm_andnot_si128(r_gt_g, _mm_andnot_si128(g_gt_b, b_gt_r)));
+
+			const __m128i vmax = _mm_max_epi32(_mm_max_epi32(r, g), b);
+			const __m128i vmin = _mm_min_epi32(_mm_min_epi32(r, g), b);
+			const __m128i c = _mm_sub_epi32(vmax, vmin);
+			const __m128i l2 = _mm_add_epi32(vmax, vmin);
+
+			const __m128i num = Select(r_max, _mm_sub_epi32(g, b),
+				Select(b_max, _mm_sub_epi32(r, g), _mm_sub_epi32(b, r)));
+			const __m128i base = Select(r_max, _mm_and_si128(b_gt_g, _mm_set1_epi32(0x600)),
+				Select(b_max, _mm_set1_epi32(0x400), _mm_set1_epi32(0x200)));
+			__m128i h = _mm_add_epi32(Divide(_mm_slli_epi32(num, 8), c), base);
+			h = _mm_andnot_si128(_mm_cmpeq_epi32(c, zero), h);
+
+			__m128i d = Select(_mm_cmpgt_epi32(l2, mask), _mm_sub_epi32(c1ff, l2), l2);
+			__m128i s = _mm_andnot_si128(_mm_cmpeq_epi32(l2, zero), Divide(_mm_slli_epi32(c, 8), d));
+			const __m128i l = _mm_srli_epi32(l2, 1);
+
+			// HSL_adjust
+			h = _mm_add_epi32(h, vhue);
+			h = _mm_sub_epi32(h, _mm_and_si128(_mm_cmpgt_epi32(h, _mm_set1_epi32(0x5FF)), _mm_set1_epi32(0x600)));
+			s = _mm_min_epi32(s, mask);
+
+			// HSL_to_RGB
+			const __m128i ll2 = _mm_slli_epi32(l, 1);
+			d = Select(_mm_cmpgt_epi32(ll2, mask), _mm_sub_epi32(c1ff, ll2), ll2);
+			const __m128i cc = _mm_srli_epi32(_mm_mullo_epi32(s, d), 8);
+			const __m128i m = _mm_srli_epi32(_mm_sub_epi32(ll2, cc), 1);
+			const __m128i h0 = _mm_and_si128(h, mask);
+			const __m128i x0 = _mm_srli_epi32(_mm_mullo_epi32(h0, cc), 8);
+			const __m128i x1 = _mm_srli_epi32(_mm_mullo_epi32(_mm_sub_epi32(mask, h0), cc), 8);
+			const __m128i seg = _mm_srli_epi32(h, 8);
+			const __m128i seg0 = _mm_cmpeq_epi32(seg, zero);
+			const __m128i seg1 = _mm_cmpeq_epi32(seg, _mm_set1_epi32(1));
+			const __m128i seg2 = _mm_cmpeq_epi32(seg, _mm_set1_epi32(2));
+			const __m128i seg3 = _mm_cmpeq_epi32(seg, _mm_set1_epi32(3));
+			const __m128i seg4 = _mm_cmpeq_epi32(seg, _mm_set1_epi32(4));
+			const __m128i seg5 = _mm_cmpeq_epi32(seg, _mm_set1_epi32(5));
+
+			__m128i nr = _mm_or_si128(_mm_and_si128(_mm_or_si128(seg0, seg5), cc),
+				_mm_or_si128(_mm_and_si128(seg1, x1), _mm_and_si128(seg4, x0)));
+			__m128i ng = _mm_or_si128(_mm_and_si128(_mm_or_si128(seg1, seg2), cc),
+				_mm_or_si128(_mm_and_si128(seg0, x0), _mm_and_si128(seg3, x1)));
+			__m128i nb = _mm_or_si128(_mm_and_si128(_mm_or_si128(seg3, seg4), cc),
+				_mm_or_si128(_mm_and_si128(seg2, x0), _mm_and_si128(seg5, x1)));
+
+			// Transparent pixels keep their color
+			const __m128i transparent = _mm_cmpeq_epi32(a, zero);
+			nr = Select(transparent, r, _mm_and_si128(_mm_add_epi32(m, nr), mask));
+			ng = Select(transparent, g, _mm_and_si128(_mm_add_epi32(m, ng), mask));
+			nb = Select(transparent, b, _mm_and_si128(_mm_add_epi32(m, nb), mask));
+
+			const __m128i out = _mm_or_si128(
+				_mm_or_si128(_mm_sll_epi32(nr, rs), _mm_sll_epi32(ng, gs)),
+				_mm_or_si128(_mm_sll_epi32(nb, bs), _mm_sll_epi32(a, as)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(pixels + i), out);
+		}
+
+		return i + Scalar::ApplyHueChange(pixels + i, count - i, hue, layout);
+	}
+}
+#endif
+
+#ifdef EP_SIMD_AVX2
+namespace Avx2 {
+	EP_TARGET_AVX2 inline __m256i Div255(__m256i x) {
+		__m256i t = _mm256_add_epi32(_mm256_add_epi32(x, _mm256_set1_epi32(1)), _mm256_srli_epi32(x, 8));
+		return _mm256_srli_epi32(t, 8);
+	}
+
+	EP_TARGET_AVX2 inline __m256i HardLight(__m256i v, __m256i k, __m256i flip) {
+		v = Div255(_mm256_mullo_epi32(_mm256_xor_si256(v, flip), k));
+		return _mm256_xor_si256(_mm256_min_epi32(v, _mm256_set1_epi32(255)), flip);
+	}
+
+	EP_TARGET_AVX2 inline __m256i Saturate(__m256i v, __m256i lum, __m256i lum1024, __m256i sat) {
+		v = _mm256_srai_epi32(_mm256_add_epi32(lum1024, _mm256_mullo_epi32(_mm256_sub_epi32(v, lum), sat)), 10);
+		return _mm256_min_epi32(_mm256_max_epi32(v, _mm256_setzero_si256()), _mm256_set1_epi32(255));
+	}
+
+	/** @return mask ? a : b */
+	EP_TARGET_AVX2 inline __m256i Select(__m256i mask, __m256i a, __m256i b) {
+		return _mm256_blendv_epi8(b, a, mask);
+	}
+
+	/** @return num / den rounded towards zero */
+	EP_TARGET_AVX2 inline __m256i Divide(__m256i num, __m256i den) {
+		return _mm256_cvttps_epi32(_mm256_div_ps(_mm256_cvtepi32_ps(num), _mm256_cvtepi32_ps(den)));
+	}
+
+	EP_TARGET_AVX2 int ApplyTone(uint32_t* pixels, int count, const ToneParams& p) {
+		const __m128i rs = _mm_cvtsi32_si128(p.layout.r_shift);
+		const __m128i gs = _mm_cvtsi32_si128(p.layout.g_shift);
+		const __m128i bs = _mm_cvtsi32_si128(p.layout.b_shift);
+		const __m128i as = _mm_cvtsi32_si128(p.layout.a_shift);
+		const __m256i mask = _mm256_set1_epi32(0xFF);
+		const __m256i sat = _mm256_set1_epi32(p.sat);
+		const __m256i kr = _mm256_set1_epi32(HardLightFactor(p.tone.red));
+		const __m256i kg = _mm256_set1_epi32(HardLightFactor(p.tone.green));
+		const __m256i kb = _mm256_set1_epi32(HardLightFactor(p.tone.blue));
+		const __m256i fr = _mm256_set1_epi32(HardLightFlip(p.tone.red));
+		const __m256i fg = _mm256_set1_epi32(HardLightFlip(p.tone.green));
+		const __m256i fb = _mm256_set1_epi32(HardLightFlip(p.tone.blue));
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+			__m256i r = _mm256_and_si256(_mm256_srl_epi32(px, rs), mask);
+			__m256i g = _mm256_and_si256(_mm256_srl_epi32(px, gs), mask);
+			__m256i b = _mm256_and_si256(_mm256_srl_epi32(px, bs), mask);
+			const __m256i a = _mm256_and_si256(_mm256_srl_epi32(px, as), mask);
+
+			if (p.saturation) {
+				__m256i lum = _mm256_add_epi32(_mm256_mullo_epi32(b, _mm256_set1_epi32(7471)), _mm256_mullo_epi32(g, _mm256_set1_epi32(38470)));
+				lum = _mm256_srli_epi32(_mm256_add_epi32(lum, _mm256_mullo_epi32(r, _mm256_set1_epi32(19595))), 16);
+				const __m256i lum1024 = _mm256_slli_epi32(lum, 10);
+				r = Saturate(r, lum, lum1024, sat);
+				g = Saturate(g, lum, lum1024, sat);
+				b = Saturate(b, lum, lum1024, sat);
+			}
+
+			if (p.color) {
+				r = HardLight(r, kr, fr);
+				g = HardLight(g, kg, fg);
+				b = HardLight(b, kb, fb);
+				if (p.premultiply) {
+					r = Div255(_mm256_mullo_epi32(r, a));
+					g = Div255(_mm256_mullo_epi32(g, a));
+					b = Div255(_mm256_mullo_epi32(b, a));
+				}
+			}
+
+			__m256i out = _mm256_or_si256(
+				_mm256_or_si256(_mm256_sll_epi32(r, rs), _mm256_sll_epi32(g, gs)),
+				_mm256_or_si256(_mm256_sll_epi32(b, bs), _mm256_sll_epi32(a, as)));
+			if (p.skip_transparent) {
+				out = Select(_mm256_cmpeq_epi32(a, _mm256_setzero_si256()), px, out);
+			}
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), out);
+		}
+
+		return i + Scalar::ApplyTone(pixels + i, count - i, p);
+	}
+
+	EP_TARGET_AVX2 int ApplyHueChange(uint32_t* pixels, int count, int hue, const PixelLayout& layout) {
+		const __m128i rs = _mm_cvtsi32_si128(layout.r_shift);
+		const __m128i gs = _mm_cvtsi32_si128(layout.g_shift);
+		const __m128i bs = _mm_cvtsi32_si128(layout.b_shift);
+		const __m128i as = _mm_cvtsi32_si128(layout.a_shift);
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i mask = _mm256_set1_epi32(0xFF);
+		const __m256i c1ff = _mm256_set1_epi32(0x1FF);
+		const __m256i vhue = _mm256_set1_epi32(hue);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			const __m256i px = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(pixels + i));
+			const __m256i r = _mm256_and_si256(_mm256_srl_epi32(px, rs), mask);
+			const __m256i g = _mm256_and_si256(_mm256_srl_epi32(px, gs), mask);
+			const __m256i b = _mm256_and_si256(_mm256_srl_epi32(px, bs), mask);
+			const __m256i a = _mm256_and_si256(_mm256_srl_epi32(px, as), mask);
+
+			// RGB_to_HSL: Same channel order decision as the scalar code
+			const __m256i r_gt_g = _mm256_cmpgt_epi32(r, g);
+			const __m256i r_gt_b = _mm256_cmpgt_epi32(r, b);
+			const __m256i g_gt_b = _mm256_cmpgt_epi32(g, b);
+			const __m256i b_gt_r = _mm256_cmpgt_epi32(b, r);
+			const __m256i b_gt_g = _mm256_cmpgt_epi32(b, g);
+			const __m256i r_max = _mm256_and_si256(r_gt_g, r_gt_b);
+			const __m256i b_max = _mm256_or_si256(_mm256_andnot_si256(r_gt_b, r_gt_g),
+				_mm256_andnot_si256(r_gt_g, _mm256_andnot_si256(g_gt_b, b_gt_r)));
+
+			const __m256i vmax = _mm256_max_epi32(_mm256_max_epi32(r, g), b);
+			const __m256i vmin = _mm256_min_epi32(_mm256_min_epi32(r, g), b);
+			const __m256i c = _mm256_sub_epi32(vmax, vmin);
+			const __m256i l2 = _mm256_add_epi32(vmax, vmin);
+
+			const __m256i num = Select(r_max, _mm256_sub_epi32(g, b),
+				Select(b_max, _mm256_sub_epi32(r, g), _mm256_sub_epi32(b, r)));
+			const __m256i base = Select(r_max, _mm256_and_si256(b_gt_g, _mm256_set1_epi32(0x600)),
+				Select(b_max, _mm256_set1_epi32(0x400), _mm256_set1_epi32(0x200)));
+			__m256i h = _mm256_add_epi32(Divide(_mm256_slli_epi32(num, 8), c), base);
+			h = _mm256_andnot_si256(_mm256_cmpeq_epi32(c, zero), h);
+
+			__m256i d = Select(_mm256_cmpgt_epi32(l2, mask), _mm256_sub_epi32(c1ff, l2), l2);
+			__m256i s = _mm256_andnot_si256(_mm256_cmpeq_epi32(l2, zero), Divide(_mm256_slli_epi32(c, 8), d));
+			const __m256i l = _mm256_srli_epi32(l2, 1);
+
+			// HSL_adjust
+			h = _mm256_add_epi32(h, vhue);
+			h = _mm256_sub_epi32(h, _mm256_and_si256(_mm256_cmpgt_epi32(h, _mm256_set1_epi32(0x5FF)), _mm256_set1_epi32(0x600)));
+			s = _mm256_min_epi32(s, mask);
+
+			// HSL_to_RGB
+			const __m256i ll2 = _mm256_slli_epi32(l, 1);
+			d = Select(_mm256_cmpgt_epi32(ll2, mask), _mm256_sub_epi32(c1ff, ll2), ll2);
+			const __m256i cc = _mm256_srli_epi32(_mm256_mullo_epi32(s, d), 8);
+			const __m256i m = _mm256_srli_epi32(_mm256_sub_epi32(ll2, cc), 1);
+			const __m256i h0 = _mm256_and_si256(h, mask);
+			const __m256i x0 = _mm256_srli_epi32(_mm256_mullo_epi32(h0, cc), 8);
+			const __m256i x1 = _mm256_srli_epi32(_mm256_mullo_epi32(_mm256_sub_epi32(mask, h0), cc), 8);
+			const __m256i seg = _mm256_srli_epi32(h, 8);
+			const __m256i seg0 = _mm256_cmpeq_epi32(seg, zero);
+			const __m256i seg1 = _mm256_cmpeq_epi32(seg, _mm256_set1_epi32(1));
+			const __m256i seg2 = _mm256_cmpeq_epi32(seg, _mm256_set1_epi32(2));
+			const __m256i seg3 = _mm256_cmpeq_epi32(seg, _mm256_set1_epi32(3));
+			const __m256i seg4 = _mm256_cmpeq_epi32(seg, _mm256_set1_epi32(4));
+			const __m256i seg5 = _mm256_cmpeq_epi32(seg, _mm256_set1_epi32(5));
+
+			__m256i nr = _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(seg0, seg5), cc),
+				_mm256_or_si256(_mm256_and_si256(seg1, x1), _mm256_and_si256(seg4, x0)));
+			__m256i ng = _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(seg1, seg2), cc),
+				_mm256_or_si256(_mm256_and_si256(seg0, x0), _mm256_and_si256(seg3, x1)));
+			__m256i nb = _mm256_or_si256(_mm256_and_si256(_mm256_or_si256(seg3, seg4), cc),
+				_mm256_or_si256(_mm256_and_si256(seg2, x0), _mm256_and_si256(seg5, x1)));
+
+			// Transparent pixels keep their color
+			const __m256i transparent = _mm256_cmpeq_epi32(a, zero);
+			nr = Select(transparent, r, _mm256_and_si256(_mm256_add_epi32(m, nr), mask));
+			ng = Select(transparent, g, _mm256_and_si256(_mm256_add_epi32(m, ng), mask));
+			nb = Select(transparent, b, _mm256_and_si256(_mm256_add_epi32(m, nb), mask));
+
+			const __m256i out = _mm256_or_si256(
+				_mm256_or_si256(_mm256_sll_epi32(nr, rs), _mm256_sll_epi32(ng, gs)),
+				_mm256_or_si256(_mm256_sll_epi32(nb, bs), _mm256_sll_epi32(a, as)));
+			_mm256_storeu_si256(reinterpret_cast<__m256i*>(pixels + i), out);
+		}
+
+		return i + Scalar::ApplyHueChange(pixels + i, count - i, hue, layout);
+	}
+}
+#endif
+
+#ifdef EP_SIMD_NEON
+namespace Neon {
+	inline int32x4_t Div255(int32x4_t x) {
+		int32x4_t t = vaddq_s32(vaddq_s32(x, vdupq_n_s32(1)), vshrq_n_s32(x, 8));
+		return vshrq_n_s32(t, 8);
+	}
+
+	inline int32x4_t HardLight(int32x4_t v, int32x4_t k, int32x4_t flip) {
+		v = Div255(vmulq_s32(veorq_s32(v, flip), k));
+		return veorq_s32(vminq_s32(v, vdupq_n_s32(255)), flip);
+	}
+
+	inline int32x4_t Saturate(int32x4_t v, int32x4_t lum, int32x4_t lum1024, int32x4_t sat) {
+		v = vshrq_n_s32(vaddq_s32(lum1024, vmulq_s32(vsubq_s32(v, lum), sat)), 10);
+		return vminq_s32(vmaxq_s32(v, vdupq_n_s32(0)), vdupq_n_s32(255));
+	}
+
+	/** @param shift negative shift amount */
+	inline int32x4_t Channel(uint32x4_t px, int32x4_t shift) {
+		return vreinterpretq_s32_u32(vandq_u32(vshlq_u32(px, shift), vdupq_n_u32(0xFF)));
+	}
+
+	inline uint32x4_t Shift(int32x4_t v, int32x4_t shift) {
+		return vshlq_u32(vreinterpretq_u32_s32(v), shift);
+	}
+
+	int ApplyTone(uint32_t* pixels, int count, const ToneParams& p) {
+		const int32x4_t rs = vdupq_n_s32(p.layout.r_shift);
+		const int32x4_t gs = vdupq_n_s32(p.layout.g_shift);
+		const int32x4_t bs = vdupq_n_s32(p.layout.b_shift);
+		const int32x4_t as = vdupq_n_s32(p.layout.a_shift);
+		const int32x4_t sat = vdupq_n_s32(p.sat);
+		const int32x4_t kr = vdupq_n_s32(HardLightFactor(p.tone.red));
+		const int32x4_t kg = vdupq_n_s32(HardLightFactor(p.tone.green));
+		const int32x4_t kb = vdupq_n_s32(HardLightFactor(p.tone.blue));
+		const int32x4_t fr = vdupq_n_s32(HardLightFlip(p.tone.red));
+		const int32x4_t fg = vdupq_n_s32(HardLightFlip(p.tone.green));
+		const int32x4_t fb = vdupq_n_s32(HardLightFlip(p.tone.blue));
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const uint32x4_t px = vld1q_u32(pixels + i);
+			int32x4_t r = Channel(px, vnegq_s32(rs));
+			int32x4_t g = Channel(px, vnegq_s32(gs));
+			int32x4_t b = Channel(px, vnegq_s32(bs));
+			const int32x4_t a = Channel(px, vnegq_s32(as));
+
+			if (p.saturation) {
+				int32x4_t lum = vaddq_s32(vmulq_n_s32(b, 7471), vmulq_n_s32(g, 38470));
+				lum = vshrq_n_s32(vaddq_s32(lum, vmulq_n_s32(r, 19595)), 16);
+				const int32x4_t lum1024 = vshlq_n_s32(lum, 10);
+				r = Saturate(r, lum, lum1024, sat);
+				g = Saturate(g, lum, lum1024, sat);
+				b = Saturate(b, lum, lum1024, sat);
+			}
+
+			if (p.color) {
+				r = HardLight(r, kr, fr);
+				g = HardLight(g, kg, fg);
+				b = HardLight(b, kb, fb);
+				if (p.premultiply) {
+					r = Div255(vmulq_s32(r, a));
+					g = Div255(vmulq_s32(g, a));
+					b = Div255(vmulq_s32(b, a));
+				}
+			}
+
+			uint32x4_t out = vorrq_u32(vorrq_u32(Shift(r, rs), Shift(g, gs)), vorrq_u32(Shift(b, bs), Shift(a, as)));
+			if (p.skip_transparent) {
+				out = vbslq_u32(vceqq_s32(a, vdupq_n_s32(0)), px, out);
+			}
+			vst1q_u32(pixels + i, out);
+		}
+
+		return i + Scalar::ApplyTone(pixels + i, count - i, p);
+	}
+
+#ifdef EP_NEON_HUE
+	/** @return num / den rounded towards zero */
+	inline int32x4_t Divide(int32x4_t num, int32x4_t den) {
+		return vcvtq_s32_f32(vdivq_f32(vcvtq_f32_s32(num), vcvtq_f32_s32(den)));
+	}
+
+	inline int32x4_t And(uint32x4_t mask, int32x4_t v) {
+		return vandq_s32(vreinterpretq_s32_u32(mask), v);
+	}
+
+	int ApplyHueChange(uint32_t* pixels, int count, int hue, const PixelLayout& layout) {
+		const int32x4_t rs = vdupq_n_s32(layout.r_shift);
+		const int32x4_t gs = vdupq_n_s32(layout.g_shift);
+		const int32x4_t bs = vdupq_n_s32(layout.b_shift);
+		const int32x4_t as = vdupq_n_s32(layout.a_shift);
+		const int32x4_t zero = vdupq_n_s32(0);
+		const int32x4_t mask = vdupq_n_s32(0xFF);
+		const int32x4_t c1ff = vdupq_n_s32(0x1FF);
+		const int32x4_t vhue = vdupq_n_s32(hue);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			const uint32x4_t px = vld1q_u32(pixels + i);
+			const int32x4_t r = Channel(px, vnegq_s32(rs));
+			const int32x4_t g = Channel(px, vnegq_s32(gs));
+			const int32x4_t b = Channel(px, vnegq_s32(bs));
+			const int32x4_t a = Channel(px, vnegq_s32(as));
+
+			// RGB_to_HSL: Same channel order decision as the scalar code
+			const uint32x4_t r_gt_g = vcgtq_s32(r, g);
+			const uint32x4_t r_gt_b = vcgtq_s32(r, b);
+			const uint32x4_t g_gt_b = vcgtq_s32(g, b);
+			const uint32x4_t b_gt_r = vcgtq_s32(b, r);
+			const uint32x4_t b_gt_g = vcgtq_s32(b, g);
+			const uint32x4_t r_max = vandq_u32(r_gt_g, r_gt_b);
+			const uint32x4_t b_max = vorrq_u32(vbicq_u32(r_gt_g, r_gt_b),
+				vbicq_u32(vbicq_u32(b_gt_r, g_gt_b), r_gt_g));
+
+			const int32x4_t vmax = vmaxq_s32(vmaxq_s32(r, g), b);
+			const int32x4_t vmin = vminq_s32(vminq_s32(r, g), b);
+			const int32x4_t c = vsubq_s32(vmax, vmin);
+			const int32x4_t l2 = vaddq_s32(vmax, vmin);
+
+			const int32x4_t num = vbslq_s32(r_max, vsubq_s32(g, b),
+				vbslq_s32(b_max, vsubq_s32(r, g), vsubq_s32(b, r)));
+			const int32x4_t base = vbslq_s32(r_max, And(b_gt_g, vdupq_n_s32(0x600)),
+				vbslq_s32(b_max, vdupq_n_s32(0x400), vdupq_n_s32(0x200)));
+			int32x4_t h = vaddq_s32(Divide(vshlq_n_s32(num, 8), c), base);
+			h = vbslq_s32(vceqq_s32(c, zero), zero, h);
+
+			int32x4_t d = vbslq_s32(vcgtq_s32(l2, mask), vsubq_s32(c1ff, l2), l2);
+			int32x4_t s = vbslq_s32(vceqq_s32(l2, zero), zero, Divide(vshlq_n_s32(c, 8), d));
+			const int32x4_t l = vshrq_n_s32(l2, 1);
+
+			// HSL_adjust
+			h = vaddq_s32(h, vhue);
+			h = vsubq_s32(h, And(vcgtq_s32(h, vdupq_n_s32(0x5FF)), vdupq_n_s32(0x600)));
+			s = vminq_s32(s, mask);
+
+			// HSL_to_RGB
+			const int32x4_t ll2 = vshlq_n_s32(l, 1);
+			d = vbslq_s32(vcgtq_s32(ll2, mask), vsubq_s32(c1ff, ll2), ll2);
+			const int32x4_t cc = vshrq_n_s32(vmulq_s32(s, d), 8);
+			const int32x4_t m = vshrq_n_s32(vsubq_s32(ll2, cc), 1);
+			const int32x4_t h0 = vandq_s32(h, mask);
+			const int32x4_t x0 = vshrq_n_s32(vmulq_s32(h0, cc), 8);
+			const int32x4_t x1 = vshrq_n_s32(vmulq_s32(vsubq_s32(mask, h0), cc), 8);
+			const int32x4_t seg = vshrq_n_s32(h, 8);
+			const uint32x4_t seg0 = vceqq_s32(seg, zero);
+			const uint32x4_t seg1 = vceqq_s32(seg, vdupq_n_s32(1));
+			const uint32x4_t seg2 = vceqq_s32(seg, vdupq_n_s32(2));
+			const uint32x4_t seg3 = vceqq_s32(seg, vdupq_n_s32(3));
+			const uint32x4_t seg4 = vceqq_s32(seg, vdupq_n_s32(4));
+			const uint32x4_t seg5 = vceqq_s32(seg, vdupq_n_s32(5));
+
+			int32x4_t nr = vorrq_s32(And(vorrq_u32(seg0, seg5), cc), vorrq_s32(And(seg1, x1), And(seg4, x0)));
+			int32x4_t ng = vorrq_s32(And(vorrq_u32(seg1, seg2), cc), vorrq_s32(And(seg0, x0), And(seg3, x1)));
+			int32x4_t nb = vorrq_s32(And(vorrq_u32(seg3, seg4), cc), vorrq_s32(And(seg2, x0), And(seg5, x1)));
+
+			// Transparent pixels keep their color
+			const uint32x4_t transparent = vceqq_s32(a, zero);
+			nr = vbslq_s32(transparent, r, vandq_s32(vaddq_s32(m, nr), mask));
+			ng = vbslq_s32(transparent, g, vandq_s32(vaddq_s32(m, ng), mask));
+			nb = vbslq_s32(transparent, b, vandq_s32(vaddq_s32(m, nb), mask));
+
+			const uint32x4_t out = vorrq_u32(vorrq_u32(Shift(nr, rs), Shift(ng, gs)), vorrq_u32(Shift(nb, bs), Shift(a, as)));
+			vst1q_u32(pixels + i, out);
+		}
+
+		return i + Scalar::ApplyHueChange(pixels + i, count - i, hue, layout);
+	}
+#endif
+}
+#endif
+
+using ToneFunc = int (*)(uint32_t* pixels, int count, const ToneParams& params);
+using HueChangeFunc = int (*)(uint32_t* pixels, int count, int hue, const PixelLayout& layout);
+
+struct Kernels {
+	Variant variant = Variant::Scalar;
+	ToneFunc tone = Scalar::ApplyTone;
+	HueChangeFunc hue_change = Scalar::ApplyHueChange;
+};
+
+Kernels MakeKernels(Variant variant) {
+	Kernels kernels;
+	kernels.variant = variant;
+
+	switch (variant) {
+		case Variant::Scalar:
+			break;
+		case Variant::Sse41:
+#ifdef EP_SIMD_SSE41
+			kernels.tone = Sse41::ApplyTone;
+			kernels.hue_change = Sse41::ApplyHueChange;
+#endif
+			break;
+		case Variant::Avx2:
+#ifdef EP_SIMD_AVX2
+			kernels.tone = Avx2::ApplyTone;
+			kernels.hue_change = Avx2::ApplyHueChange;
+#endif
+			break;
+		case Variant::Neon:
+#ifdef EP_SIMD_NEON
+			kernels.tone = Neon::ApplyTone;
+#  ifdef EP_NEON_HUE
+			kernels.hue_change = Neon::ApplyHueChange;
+#  endif
+#endif
+			break;
+	}
+
+	return kernels;
+}
+
+Kernels& ActiveKernels() {
+	// Initialised on first use, bitmaps can be toned during static initialisation
+	static Kernels kernels = MakeKernels(PixelKernels::GetDefaultVariant());
+	return kernels;
+}
+
+} // anonymous namespace
+
+void PixelKernels::ApplyTone(uint32_t* pixels, int count, const ToneParams& params) {
+	ActiveKernels().tone(pixels, count, params);
+}
+
+void PixelKernels::ApplyHueChange(uint32_t* pixels, int count, int hue, const PixelLayout& layout) {
+	ActiveKernels().hue_change(pixels, count, hue, layout);
+}
+
+bool PixelKernels::IsSupported(Variant variant) {
+	switch (variant) {
+		case Variant::Scalar:
+			return true;
+		case Variant::Sse41:
+#ifdef EP_SIMD_SSE41
+			return CpuFeatures::HasSse41();
+#else
+			return false;
+#endif
+		case Variant::Avx2:
+#ifdef EP_SIMD_AVX2
+			return CpuFeatures::HasAvx2();
+#else
+			return false;
+#endif
+		case Variant::Neon:
+#ifdef EP_SIMD_NEON
+			return true;
+#else
+			return false;
+#endif
+	}
+
+	return false;
+}
+
+bool PixelKernels::SetVariant(Variant variant) {
+	if (!IsSupported(variant)) {
+		return false;
+	}
+
+	ActiveKernels() = MakeKernels(variant);
+	return true;
+}
+
+Variant PixelKernels::GetVariant() {
+	return ActiveKernels().variant;
+}
+
+Variant PixelKernels::GetDefaultVariant() {
+	for (auto variant: { Variant::Avx2, Variant::Sse41, Variant::Neon }) {
+		if (IsSupported(variant)) {
+			return variant;
+		}
+	}
+	return Variant::Scalar;
+}
+
+const char* PixelKernels::GetVariantName(Variant variant) {
+	switch (variant) {
+		case Variant::Scalar:
+			return "Scalar";
+		case Variant::Sse41:
+			return "SSE4.1";
+		case Variant::Avx2:
+			return "AVX2";
+		case Variant::Neon:
+			return "NEON";
+	}
+
+	return "Unknown";
+}
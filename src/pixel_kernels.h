@@ -0,0 +1,115 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_PIXEL_KERNELS_H
+#define EP_PIXEL_KERNELS_H
+
+// Headers
+#include <cstdint>
+#include "tone.h"
+
+/**
+ * Per pixel color transformations used by Bitmap::ToneBlit and
+ * Bitmap::HueChangeBlit.
+ *
+ * Every kernel exists as a scalar reference and in SIMD variants that
+ * produce bit identical results. The fastest variant supported by the CPU
+ * is selected on startup.
+ */
+namespace PixelKernels {
+	/** Implementations of the kernels */
+	enum class Variant {
+		Scalar,
+		Sse41,
+		Avx2,
+		Neon
+	};
+
+	/** Position of the 8 bit channels in a 32 bit pixel */
+	struct PixelLayout {
+		int r_shift = 0;
+		int g_shift = 0;
+		int b_shift = 0;
+		int a_shift = 0;
+	};
+
+	/** Parameters of a tone change */
+	struct ToneParams {
+		PixelLayout layout;
+		/** Change the saturation (gray component of the tone) */
+		bool saturation = false;
+		/** Saturation factor, 1024 keeps the saturation */
+		int sat = 1024;
+		/** Apply the color components of the tone by hard light */
+		bool color = false;
+		/** Tone, only the red, green and blue components are used */
+		Tone tone;
+		/** Multiply the toned color with the alpha channel */
+		bool premultiply = false;
+		/** Keep pixels with an alpha of 0 unchanged */
+		bool skip_transparent = false;
+	};
+
+	/**
+	 * Applies a tone to a row of pixels.
+	 *
+	 * @param pixels pixels to modify
+	 * @param count number of pixels
+	 * @param params tone parameters
+	 */
+	void ApplyTone(uint32_t* pixels, int count, const ToneParams& params);
+
+	/**
+	 * Rotates the hue of a row of pixels. Pixels with an alpha of 0 are
+	 * not modified.
+	 *
+	 * @param pixels pixels to modify
+	 * @param count number of pixels
+	 * @param hue hue rotation in 1/256 of 60 degree, range [0, 0x600]
+	 * @param layout channel layout of the pixels
+	 */
+	void ApplyHueChange(uint32_t* pixels, int count, int hue, const PixelLayout& layout);
+
+	/**
+	 * @param variant kernel variant
+	 * @return Whether the variant is compiled in and supported by the CPU
+	 */
+	bool IsSupported(Variant variant);
+
+	/**
+	 * Selects the kernels used by ApplyTone and ApplyHueChange.
+	 * Intended for tests and benchmarks.
+	 *
+	 * @param variant kernel variant
+	 * @return false when the variant is not supported, the selection is unchanged
+	 */
+	bool SetVariant(Variant variant);
+
+	/** @return Currently selected variant */
+	Variant GetVariant();
+
+	/** @return Best variant supported by the CPU */
+	Variant GetDefaultVariant();
+
+	/**
+	 * @param variant kernel variant
+	 * @return Human readable name of the variant
+	 */
+	const char* GetVariantName(Variant variant);
+}
+
+#endif
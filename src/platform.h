@@ -89,6 +89,14 @@ namespace Platform {
 		/** @return Filesize or -1 on error */
 		int64_t GetSize() const;
 
+		/**
+		 * The unit of the value is platform dependent, it is only meaningful
+		 * for comparing it with other modification times.
+		 *
+		 * @return Time of the last modification or -1 on error
+		 */
+		int64_t GetModificationTime() const;
+
 		/**
 		 * Creates a directory recursively at the filename path.
 		 * @param follow_symlinks Whether to follow symlinks (if supported on this platform)
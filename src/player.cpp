@@ -129,6 +129,9 @@ namespace Player {
 	int frames;
 	std::string replay_input_path;
 	std::string record_input_path;
+	std::string profile_trace_path;
+	bool headless_flag;
+	int hash_surface_interval;
 	std::string command_line;
 	int rng_seed = -1;
 	Game_ConfigPlayer player_config;
@@ -281,7 +284,7 @@ void Player::MainLoop() {
 	}
 
 	auto frame_limit = DisplayUi->GetFrameLimit();
-	if (frame_limit == Game_Clock::duration()) {
+	if (frame_limit == Game_Clock::duration() || Game_Clock::IsMaxSpeed()) {
 		return;
 	}
 
@@ -388,8 +391,17 @@ void Player::Update(bool update_scene) {
 }
 
 void Player::Draw() {
+	Instrumentation::Scope iscope("Graphics::Draw");
 	Graphics::Update();
 	Graphics::Draw(*DisplayUi->GetDisplaySurface());
+
+	if (Instrumentation::IsTraceEnabled()) {
+		Instrumentation::RecordCounter("Cache::SpriteEffect hits", Cache::GetSpriteEffectHits());
+		Instrumentation::RecordCounter("Cache::SpriteEffect misses", Cache::GetSpriteEffectMisses());
+		Instrumentation::RecordCounter("Cache::SpriteEffect size", Cache::GetSpriteEffectCacheSize());
+	}
+
+	iscope.Begin("BaseUi::UpdateDisplay");
 	DisplayUi->UpdateDisplay();
 }
 
@@ -409,6 +421,16 @@ void Player::Exit() {
 		Scene_Settings::SaveConfig(true);
 	}
 
+	if (!profile_trace_path.empty()) {
+		auto os = FileFinder::Root().OpenOutputStream(profile_trace_path, std::ios::out | std::ios::trunc);
+		if (os) {
+			int num_events = Instrumentation::WriteTrace(os);
+			Output::Debug("Wrote {} profiler events to {}", num_events, profile_trace_path);
+		} else {
+			Output::Warning("Failed to write profiler trace {}", profile_trace_path);
+		}
+	}
+
 	Graphics::UpdateSceneCallback();
 #ifdef EMSCRIPTEN
 	BitmapRef surface = DisplayUi->GetDisplaySurface();
@@ -439,6 +461,8 @@ Game_Config Player::ParseCommandLine() {
 	start_map_id = -1;
 	no_rtp_flag = false;
 	no_audio_flag = false;
+	headless_flag = false;
+	hash_surface_interval = 0;
 	is_easyrpg_project = false;
 	Game_Battle::battle_test.enabled = false;
 
@@ -623,6 +647,27 @@ Game_Config Player::ParseCommandLine() {
 			}
 			continue;
 		}
+		if (cp.ParseNext(arg, 1, "--profile-trace")) {
+			if (arg.NumValues() > 0) {
+				profile_trace_path = arg.Value(0);
+				Instrumentation::EnableTrace();
+			}
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--headless")) {
+			headless_flag = true;
+			continue;
+		}
+		if (cp.ParseNext(arg, 0, "--max-speed")) {
+			Game_Clock::SetMaxSpeed(true);
+			continue;
+		}
+		if (cp.ParseNext(arg, 1, "--hash-surface")) {
+			if (arg.ParseValue(0, li_value) && li_value > 0) {
+				hash_surface_interval = li_value;
+			}
+			continue;
+		}
 		if (cp.ParseNext(arg, 1, "--encoding")) {
 			if (arg.NumValues() > 0) {
 				forced_encoding = arg.Value(0);
@@ -1205,6 +1250,7 @@ void Player::LoadSavegame(const std::string& save_name, int save_id) {
 	Main_Data::game_variables->SetData(std::move(save->system.variables));
 	Main_Data::game_strings->SetData(std::move(save->system.maniac_strings));
 	Main_Data::game_system->SetupFromSave(std::move(save->system));
+	Main_Data::game_system->PrefetchSystemSounds();
 	Main_Data::game_actors->SetSaveData(std::move(save->actors));
 	Main_Data::game_party->SetupFromSave(std::move(save->inventory));
 	Main_Data::game_screen->SetSaveData(std::move(save->screen));
@@ -1448,11 +1494,17 @@ Engine options:
  --font2-size PX      Size of font 2 in pixel. The default is 12.
  --font-path PATH     The path in which the settings scene looks for fonts.
                       The default is config-path/Font.
+ --hash-surface N     With --headless log a hash of the screen every N frames.
+ --headless           Run without window, audio output and input devices. Use
+                      with --replay-input and --max-speed to run recorded
+                      sessions as tests.
  --language LANG      Load the game translation in language/LANG folder.
  --load-game-id N     Skip the title scene and load SaveN.lsd (N is padded to
                       two digits).
  --log-file FILE      Path to the logfile. The Player will write diagnostic
                       messages to this file.
+ --max-speed          Run one game frame per rendered frame as fast as possible
+                      instead of in real time.
  --new-game           Skip the title scene and start a new game directly.
  --no-log-color       Disable colors in terminal log.
  --no-rtp             Disable support for the Runtime Package (RTP).
@@ -1479,6 +1531,12 @@ Engine options:
                       of the engine.
  --no-patch           Disable all engine patches. To disable a single patch,
                       prefix any of the patch options with --no-
+ --preload-maps       Parse the maps reachable from the current map by teleport
+                      or event cloning in the background.
+                      Disable with --no-preload-maps.
+ --profile-trace FILE Record the duration of frames and of the main engine
+                      phases and write them as Chrome trace (JSON) to FILE on
+                      exit. Open it with chrome://tracing or Perfetto.
  --project-path PATH  Instead of using the working directory, the game in PATH
                       is used.
  --record-input FILE  Record all button inputs to FILE.
@@ -1530,6 +1588,8 @@ Audio options:
  --no-audio           Disable audio (in case you prefer your own music).
  --music-volume V     Set volume of background music to V (0-100).
  --sound-volume V     Set volume of sound effects to V (0-100).
+ --sound-cache-size N Use up to N MB of memory for decoded sound effects (1-256).
+                      The default is 3.
  --soundfont FILE     Soundfont in sf2 format to use when playing MIDI files.
  --soundfont-path P   The path in which the settings scene looks for soundfonts.
                       The default is config-path/Soundfont.
@@ -400,6 +400,15 @@ namespace Player {
 	/** Path to record input log to */
 	extern std::string record_input_path;
 
+	/** Path to write the profiler trace to */
+	extern std::string profile_trace_path;
+
+	/** Run without window, audio output and input devices */
+	extern bool headless_flag;
+
+	/** Log a hash of the headless display every N frames, 0 to disable */
+	extern int hash_surface_interval;
+
 	/** The concatenated command line */
 	extern std::string command_line;
 
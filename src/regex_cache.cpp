@@ -0,0 +1,66 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "regex_cache.h"
+#include <algorithm>
+
+RegexCache::RegexCache(size_t capacity) : capacity(std::max<size_t>(capacity, 1)) {
+}
+
+std::shared_ptr<const std::wregex> RegexCache::Get(const std::wstring& pattern, Flags flags) {
+	Key key = { pattern, flags };
+
+	auto it = entries.find(key);
+	if (it != entries.end()) {
+		++hits;
+		lru.splice(lru.begin(), lru, it->second);
+		return it->second->second;
+	}
+
+	++misses;
+	// Throws for invalid patterns before anything is inserted
+	auto regex = std::make_shared<const std::wregex>(pattern, flags);
+
+	lru.emplace_front(key, regex);
+	entries.emplace(std::move(key), lru.begin());
+	Evict();
+
+	return regex;
+}
+
+void RegexCache::Clear() {
+	entries.clear();
+	lru.clear();
+}
+
+void RegexCache::SetCapacity(size_t capacity) {
+	this->capacity = std::max<size_t>(capacity, 1);
+	Evict();
+}
+
+void RegexCache::Evict() {
+	while (entries.size() > capacity) {
+		entries.erase(lru.back().first);
+		lru.pop_back();
+	}
+}
+
+RegexCache& RegexCache::Global() {
+	static RegexCache cache;
+	return cache;
+}
@@ -0,0 +1,127 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_REGEX_CACHE_H
+#define EP_REGEX_CACHE_H
+
+// Headers
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <regex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * Bounded cache of compiled regular expressions.
+ *
+ * Compiling a std::regex is far more expensive than matching short strings,
+ * event scripts usually apply the same few patterns in loops.
+ * When the cache is full the least recently used expression is evicted.
+ */
+class RegexCache {
+public:
+	using Flags = std::regex_constants::syntax_option_type;
+
+	static constexpr size_t default_capacity = 64;
+
+	/**
+	 * @param capacity maximum amount of cached expressions
+	 */
+	explicit RegexCache(size_t capacity = default_capacity);
+
+	/**
+	 * Returns the compiled expression of a pattern, compiling it on a miss.
+	 * Invalid patterns are not cached.
+	 *
+	 * @param pattern regular expression
+	 * @param flags syntax options
+	 * @return compiled expression, stays valid when evicted
+	 * @throws std::regex_error when the pattern is invalid
+	 */
+	std::shared_ptr<const std::wregex> Get(const std::wstring& pattern, Flags flags = std::regex_constants::ECMAScript);
+
+	/** Removes all expressions */
+	void Clear();
+
+	/** @return amount of cached expressions */
+	size_t GetSize() const;
+
+	/** @return maximum amount of cached expressions */
+	size_t GetCapacity() const;
+
+	/**
+	 * Changes the capacity, evicting expressions when necessary.
+	 *
+	 * @param capacity maximum amount of cached expressions, at least 1
+	 */
+	void SetCapacity(size_t capacity);
+
+	/** @return amount of lookups which found a compiled expression */
+	size_t GetHits() const;
+
+	/** @return amount of lookups which compiled the expression */
+	size_t GetMisses() const;
+
+	/** @return Cache used by Game_Strings */
+	static RegexCache& Global();
+
+private:
+	struct Key {
+		std::wstring pattern;
+		Flags flags;
+
+		bool operator==(const Key& o) const {
+			return flags == o.flags && pattern == o.pattern;
+		}
+	};
+
+	struct KeyHash {
+		size_t operator()(const Key& k) const {
+			return std::hash<std::wstring>()(k.pattern) ^ static_cast<size_t>(k.flags);
+		}
+	};
+
+	using Entry = std::pair<Key, std::shared_ptr<const std::wregex>>;
+
+	void Evict();
+
+	/** Most recently used first */
+	std::list<Entry> lru;
+	std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entries;
+	size_t capacity;
+	size_t hits = 0;
+	size_t misses = 0;
+};
+
+inline size_t RegexCache::GetSize() const {
+	return entries.size();
+}
+
+inline size_t RegexCache::GetCapacity() const {
+	return capacity;
+}
+
+inline size_t RegexCache::GetHits() const {
+	return hits;
+}
+
+inline size_t RegexCache::GetMisses() const {
+	return misses;
+}
+
+#endif
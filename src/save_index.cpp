@@ -0,0 +1,226 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "save_index.h"
+#include <istream>
+#include <locale>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <fmt/format.h>
+#include "output.h"
+#include "utils.h"
+
+namespace {
+	constexpr const char* header = "EasyRPG SaveIndex 1";
+
+	// slot, size, mtime, timestamp, hero name, level, hp, 4 * (face name, face id)
+	constexpr int num_fields = 15;
+
+	std::string Escape(std::string_view s) {
+		std::string out;
+		out.reserve(s.size());
+		for (char c: s) {
+			switch (c) {
+				case '\\': out += "\\\\"; break;
+				case '\t': out += "\\t"; break;
+				case '\n': out += "\\n"; break;
+				case '\r': out += "\\r"; break;
+				default: out += c;
+			}
+		}
+		return out;
+	}
+
+	std::string Unescape(std::string_view s) {
+		std::string out;
+		out.reserve(s.size());
+		for (size_t i = 0; i < s.size(); ++i) {
+			if (s[i] != '\\' || i + 1 == s.size()) {
+				out += s[i];
+				continue;
+			}
+			switch (s[++i]) {
+				case 't': out += '\t'; break;
+				case 'n': out += '\n'; break;
+				case 'r': out += '\r'; break;
+				default: out += s[i];
+			}
+		}
+		return out;
+	}
+
+	std::vector<std::string_view> SplitFields(std::string_view line) {
+		std::vector<std::string_view> fields;
+		size_t start = 0;
+		for (;;) {
+			size_t end = line.find('\t', start);
+			if (end == std::string_view::npos) {
+				fields.push_back(line.substr(start));
+				return fields;
+			}
+			fields.push_back(line.substr(start, end - start));
+			start = end + 1;
+		}
+	}
+
+	template <typename T>
+	bool ParseNumber(std::string_view s, T& out) {
+		std::istringstream iss{std::string(s)};
+		iss.imbue(std::locale::classic());
+		iss >> out;
+		return !iss.fail() && iss.peek() == std::char_traits<char>::eof();
+	}
+}
+
+SaveIndex SaveIndex::Load(const FilesystemView& fs) {
+	SaveIndex index;
+
+	auto file = fs.FindFile(filename);
+	if (file.empty()) {
+		return index;
+	}
+
+	auto is = fs.OpenInputStream(file);
+	if (!is || !index.Read(is)) {
+		Output::Debug("SaveIndex: {} is invalid, ignoring it", file);
+	}
+	return index;
+}
+
+bool SaveIndex::Save(const FilesystemView& fs) {
+	auto file = fs.FindFile(filename);
+	if (file.empty()) {
+		file = filename;
+	}
+
+	auto os = fs.OpenOutputStream(file);
+	if (!os) {
+		Output::Debug("SaveIndex: Cannot write {}", file);
+		return false;
+	}
+
+	Write(os);
+	modified = false;
+	return true;
+}
+
+bool SaveIndex::Read(std::istream& is) {
+	entries.clear();
+	modified = false;
+
+	std::string line;
+	if (!Utils::ReadLine(is, line) || line != header) {
+		return false;
+	}
+
+	while (Utils::ReadLine(is, line)) {
+		if (line.empty()) {
+			continue;
+		}
+
+		auto fields = SplitFields(line);
+		if (fields.size() != num_fields) {
+			entries.clear();
+			return false;
+		}
+
+		int slot_id = 0;
+		Entry entry;
+		auto& title = entry.title;
+		bool ok = ParseNumber(fields[0], slot_id)
+			&& ParseNumber(fields[1], entry.size)
+			&& ParseNumber(fields[2], entry.mtime)
+			&& ParseNumber(fields[3], title.timestamp);
+		title.hero_name = Unescape(fields[4]);
+		ok = ok && ParseNumber(fields[5], title.hero_level);
+		ok = ok && ParseNumber(fields[6], title.hero_hp);
+		title.face1_name = Unescape(fields[7]);
+		ok = ok && ParseNumber(fields[8], title.face1_id);
+		title.face2_name = Unescape(fields[9]);
+		ok = ok && ParseNumber(fields[10], title.face2_id);
+		title.face3_name = Unescape(fields[11]);
+		ok = ok && ParseNumber(fields[12], title.face3_id);
+		title.face4_name = Unescape(fields[13]);
+		ok = ok && ParseNumber(fields[14], title.face4_id);
+
+		if (!ok || slot_id <= 0) {
+			entries.clear();
+			return false;
+		}
+		entries[slot_id] = std::move(entry);
+	}
+
+	return true;
+}
+
+void SaveIndex::Write(std::ostream& os) const {
+	os << header << "\n";
+
+	for (const auto& it: entries) {
+		const auto& e = it.second;
+		const auto& title = e.title;
+		os << fmt::format("{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\t{}\n",
+			it.first, e.size, e.mtime, title.timestamp,
+			Escape(title.hero_name), title.hero_level, title.hero_hp,
+			Escape(title.face1_name), title.face1_id,
+			Escape(title.face2_name), title.face2_id,
+			Escape(title.face3_name), title.face3_id,
+			Escape(title.face4_name), title.face4_id);
+	}
+}
+
+const lcf::rpg::SaveTitle* SaveIndex::Find(int slot_id, int64_t size, int64_t mtime) const {
+	if (size < 0 || mtime < 0) {
+		return nullptr;
+	}
+
+	auto it = entries.find(slot_id);
+	if (it == entries.end() || it->second.size != size || it->second.mtime != mtime) {
+		return nullptr;
+	}
+	return &it->second.title;
+}
+
+void SaveIndex::Update(int slot_id, int64_t size, int64_t mtime, const lcf::rpg::SaveTitle& title) {
+	if (size < 0 || mtime < 0) {
+		Remove(slot_id);
+		return;
+	}
+
+	auto& e = entries[slot_id];
+	e.size = size;
+	e.mtime = mtime;
+	e.title = title;
+	modified = true;
+}
+
+void SaveIndex::Remove(int slot_id) {
+	if (entries.erase(slot_id) > 0) {
+		modified = true;
+	}
+}
+
+void SaveIndex::UpdateFile(const FilesystemView& fs, int slot_id, std::string_view save_file, const lcf::rpg::SaveTitle& title) {
+	auto index = Load(fs);
+	index.Update(slot_id, fs.GetFilesize(save_file), fs.GetModificationTime(save_file), title);
+	if (index.IsModified()) {
+		index.Save(fs);
+	}
+}
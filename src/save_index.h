@@ -0,0 +1,130 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_SAVE_INDEX_H
+#define EP_SAVE_INDEX_H
+
+// Headers
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <lcf/rpg/savetitle.h>
+#include "filesystem.h"
+
+/**
+ * Side-car file storing the title data of every savegame.
+ *
+ * The file menus only need the title of a savegame. Reading it from the
+ * index avoids parsing every SaveXX.lsd file. An entry is only used when
+ * size and modification time of the savegame still match, otherwise the
+ * savegame must be parsed again.
+ */
+class SaveIndex {
+public:
+	/** Name of the index file in the save directory */
+	static constexpr const char* filename = "easyrpg_saveindex.txt";
+
+	/**
+	 * Reads the index of a save directory.
+	 * A missing or broken index file results in an empty index.
+	 *
+	 * @param fs save directory
+	 * @return index
+	 */
+	static SaveIndex Load(const FilesystemView& fs);
+
+	/**
+	 * Writes the index to a save directory.
+	 *
+	 * @param fs save directory
+	 * @return Whether writing was successful
+	 */
+	bool Save(const FilesystemView& fs);
+
+	/**
+	 * Reads the index from a stream, replacing all entries.
+	 *
+	 * @param is stream to read
+	 * @return false when the stream does not contain a valid index
+	 */
+	bool Read(std::istream& is);
+
+	/**
+	 * Writes the index to a stream.
+	 *
+	 * @param os stream to write
+	 */
+	void Write(std::ostream& os) const;
+
+	/**
+	 * Looks up the title of a savegame.
+	 *
+	 * @param slot_id save slot, starting at 1
+	 * @param size current size of the savegame
+	 * @param mtime current modification time of the savegame
+	 * @return title or nullptr when the slot is not indexed or the entry is stale
+	 */
+	const lcf::rpg::SaveTitle* Find(int slot_id, int64_t size, int64_t mtime) const;
+
+	/**
+	 * Stores the title of a savegame.
+	 * Nothing is stored when size or modification time are unknown.
+	 *
+	 * @param slot_id save slot, starting at 1
+	 * @param size size of the savegame
+	 * @param mtime modification time of the savegame
+	 * @param title title data of the savegame
+	 */
+	void Update(int slot_id, int64_t size, int64_t mtime, const lcf::rpg::SaveTitle& title);
+
+	/**
+	 * Removes the entry of a save slot.
+	 *
+	 * @param slot_id save slot, starting at 1
+	 */
+	void Remove(int slot_id);
+
+	/** @return Whether entries changed since the last Load, Read or Save */
+	bool IsModified() const;
+
+	/**
+	 * Refreshes the entry of a savegame that was just written and updates
+	 * the index file.
+	 *
+	 * @param fs save directory
+	 * @param slot_id save slot, starting at 1
+	 * @param save_file path to the savegame
+	 * @param title title data of the savegame
+	 */
+	static void UpdateFile(const FilesystemView& fs, int slot_id, std::string_view save_file, const lcf::rpg::SaveTitle& title);
+
+private:
+	struct Entry {
+		int64_t size = -1;
+		int64_t mtime = -1;
+		lcf::rpg::SaveTitle title;
+	};
+
+	std::map<int, Entry> entries;
+	bool modified = false;
+};
+
+inline bool SaveIndex::IsModified() const {
+	return modified;
+}
+
+#endif
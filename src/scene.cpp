@@ -25,6 +25,7 @@
 #include "output.h"
 #include "audio.h"
 #include "filefinder.h"
+#include "instrumentation.h"
 #include "transition.h"
 #include "game_actors.h"
 #include "game_interpreter.h"
@@ -143,6 +144,8 @@ void Scene::ScheduleTransitionIn(Scene::SceneType prev_scene_type) {
 }
 
 void Scene::MainFunction() {
+	Instrumentation::Scope iscope("Scene::MainFunction");
+
 	static bool init = false;
 
 	if (IsAsyncPending()) {
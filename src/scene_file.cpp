@@ -89,6 +89,8 @@ void Scene_File::UpdateLatestTimestamp(int id, lcf::rpg::Save& savegame) {
 }
 
 void Scene_File::PopulateSaveWindow(Window_SaveFile& win, int id) {
+	pending_saves.erase(id);
+
 	// Try to access file
 	std::stringstream ss;
 	ss << "Save" << (id <= 8 ? "0" : "") << (id + 1) << ".lsd";
@@ -97,22 +99,56 @@ void Scene_File::PopulateSaveWindow(Window_SaveFile& win, int id) {
 
 	if (!file.empty()) {
 		// File found
-		auto save_stream = FileFinder::Save().OpenInputStream(file);
-		if (!save_stream) {
-			Output::Debug("Save {} read error", file);
-			win.SetCorrupted(true);
+		auto size = fs.GetFilesize(file);
+		auto mtime = fs.GetModificationTime(file);
+
+		if (auto* title = save_index.Find(id + 1, size, mtime)) {
+			lcf::rpg::Save savegame;
+			savegame.title = *title;
+			PopulatePartyFaces(win, id, savegame);
+			UpdateLatestTimestamp(id, savegame);
 			return;
 		}
 
-		std::unique_ptr<lcf::rpg::Save> savegame = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+		pending_saves[id] = { std::move(file), size, mtime };
+	}
+}
 
-		if (savegame) {
-			PopulatePartyFaces(win, id, *savegame);
-			UpdateLatestTimestamp(id, *savegame);
-		} else {
-			Output::Debug("Save {} corrupted", file);
-			win.SetCorrupted(true);
-		}
+void Scene_File::LoadSaveWindow(Window_SaveFile& win, int id, std::string_view file, int64_t size, int64_t mtime) {
+	auto save_stream = FileFinder::Save().OpenInputStream(file);
+	if (!save_stream) {
+		Output::Debug("Save {} read error", file);
+		win.SetCorrupted(true);
+		return;
+	}
+
+	std::unique_ptr<lcf::rpg::Save> savegame = lcf::LSD_Reader::Load(save_stream, Player::encoding);
+
+	if (savegame) {
+		PopulatePartyFaces(win, id, *savegame);
+		UpdateLatestTimestamp(id, *savegame);
+		save_index.Update(id + 1, size, mtime, savegame->title);
+	} else {
+		Output::Debug("Save {} corrupted", file);
+		win.SetCorrupted(true);
+		save_index.Remove(id + 1);
+	}
+}
+
+void Scene_File::LoadPendingSaveWindows(int first, int last) {
+	first = std::max(first, 0);
+	last = std::min(last, static_cast<int>(file_windows.size()) - 1);
+
+	auto it = pending_saves.lower_bound(first);
+	while (it != pending_saves.end() && it->first <= last) {
+		auto& w = *file_windows[it->first];
+		LoadSaveWindow(w, it->first, it->second.file, it->second.size, it->second.mtime);
+		w.Refresh();
+		it = pending_saves.erase(it);
+	}
+
+	if (save_index.IsModified()) {
+		save_index.Save(fs);
 	}
 }
 
@@ -122,6 +158,7 @@ void Scene_File::Start() {
 
 	// Refresh File Finder Save Folder
 	fs = FileFinder::Save();
+	save_index = SaveIndex::Load(fs);
 
 	for (int i = 0; i < Utils::Clamp<int32_t>(lcf::Data::system.easyrpg_max_savefiles, 3, 99); i++) {
 		std::shared_ptr<Window_SaveFile>
@@ -139,6 +176,18 @@ void Scene_File::Start() {
 	up_arrow = Scene_File::MakeArrowSprite(false);
 	down_arrow = Scene_File::MakeArrowSprite(true);
 
+	// The cursor starts at the newest savegame. Of the savegames missing in
+	// the index the most recently modified one is most likely the newest.
+	auto newest = pending_saves.end();
+	for (auto it = pending_saves.begin(); it != pending_saves.end(); ++it) {
+		if (newest == pending_saves.end() || it->second.mtime > newest->second.mtime) {
+			newest = it;
+		}
+	}
+	if (newest != pending_saves.end()) {
+		LoadPendingSaveWindows(newest->first, newest->first);
+	}
+
 	index = latest_slot;
 	top_index = std::max(0, index - 2);
 
@@ -159,6 +208,9 @@ void Scene_File::Start() {
 }
 
 void Scene_File::RefreshWindows() {
+	// Parse the visible savegames and one more above and below
+	LoadPendingSaveWindows(top_index - 1, top_index + 3);
+
 	for (int i = 0; i < (int)file_windows.size(); i++) {
 		Window_SaveFile *w = file_windows[i].get();
 		w->SetY(40 + (i - top_index) * 64);
@@ -173,6 +225,8 @@ void Scene_File::Refresh() {
 		PopulateSaveWindow(*w, i);
 		w->Refresh();
 	}
+
+	LoadPendingSaveWindows(top_index - 1, top_index + 3);
 }
 
 void Scene_File::vUpdate() {
@@ -19,9 +19,11 @@
 #define EP_SCENE_FILE_H
 
 // Headers
+#include <map>
 #include <vector>
 #include "filefinder.h"
 #include <lcf/rpg/save.h>
+#include "save_index.h"
 #include "scene.h"
 #include "window_help.h"
 #include "window_savefile.h"
@@ -60,6 +62,26 @@ protected:
 	static std::unique_ptr<Sprite> MakeBorderSprite(int y);
 	static std::unique_ptr<Sprite> MakeArrowSprite(bool down);
 
+	/**
+	 * Parses a savegame and populates the window with it.
+	 *
+	 * @param win window to populate
+	 * @param id window index
+	 * @param file path to the savegame
+	 * @param size size of the savegame, used for the save index
+	 * @param mtime modification time of the savegame, used for the save index
+	 */
+	void LoadSaveWindow(Window_SaveFile& win, int id, std::string_view file, int64_t size, int64_t mtime);
+
+	/**
+	 * Parses the savegames of all windows in the given range that were not
+	 * found in the save index and updates the index.
+	 *
+	 * @param first first window index
+	 * @param last last window index (inclusive)
+	 */
+	void LoadPendingSaveWindows(int first, int last);
+
 	void RefreshWindows();
 	void MoveFileWindows(int dy, int dt);
 	void UpdateArrows();
@@ -78,6 +100,17 @@ protected:
 
 	FilesystemView fs;
 
+	/** Title data of unchanged savegames */
+	SaveIndex save_index;
+
+	struct PendingSave {
+		std::string file;
+		int64_t size = -1;
+		int64_t mtime = -1;
+	};
+	/** Savegames not in the index, parsed when their window becomes visible */
+	std::map<int, PendingSave> pending_saves;
+
 	double latest_time = 0;
 	int latest_slot = 0;
 
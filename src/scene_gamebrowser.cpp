@@ -26,6 +26,7 @@
 #include "cache.h"
 #include "game_system.h"
 #include "input.h"
+#include "map_file_cache.h"
 #include "player.h"
 #include "scene_logo.h"
 #include "bitmap.h"
@@ -50,6 +51,7 @@ void Scene_GameBrowser::Continue(SceneType /* prev_scene */) {
 
 	Cache::ClearAll();
 	AudioSeCache::Clear();
+	MapFileCache::Clear();
 	MidiDecoder::Reset();
 	lcf::Data::Clear();
 	Player::ResetGameObjects();
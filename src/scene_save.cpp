@@ -41,6 +41,7 @@
 #include <lcf/lsd/reader.h>
 #include "output.h"
 #include "player.h"
+#include "save_index.h"
 #include "scene_save.h"
 #include "translation.h"
 #include "version.h"
@@ -80,17 +81,38 @@ bool Scene_Save::Save(const FilesystemView& fs, int slot_id, bool prepare_save)
 	const auto filename = GetSaveFilename(fs, slot_id);
 	Output::Debug("Saving to {}", filename);
 
-	auto save_stream = FileFinder::Save().OpenOutputStream(filename);
+	lcf::rpg::SaveTitle title;
+	bool res;
+	{
+		auto save_stream = FileFinder::Save().OpenOutputStream(filename);
 
-	if (!save_stream) {
-		Output::Warning("Failed saving to {}", filename);
-		return false;
+		if (!save_stream) {
+			Output::Warning("Failed saving to {}", filename);
+			return false;
+		}
+
+		res = WriteSave(save_stream, slot_id, prepare_save, &title);
+	}
+
+	// The stream must be closed to obtain the final size and modification time
+	if (res) {
+		SaveIndex::UpdateFile(FileFinder::Save(), slot_id, filename, title);
 	}
 
-	return Save(save_stream, slot_id, prepare_save);
+	AsyncHandler::SaveFilesystem();
+
+	return res;
 }
 
 bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
+	bool res = WriteSave(os, slot_id, prepare_save, nullptr);
+
+	AsyncHandler::SaveFilesystem();
+
+	return res;
+}
+
+bool Scene_Save::WriteSave(std::ostream& os, int slot_id, bool prepare_save, lcf::rpg::SaveTitle* title_out) {
 	lcf::rpg::Save save;
 	auto& title = save.title;
 	// TODO: Maybe find a better place to setup the save file?
@@ -158,7 +180,9 @@ bool Scene_Save::Save(std::ostream& os, int slot_id, bool prepare_save) {
 
 	Main_Data::game_dynrpg->Save(slot_id);
 
-	AsyncHandler::SaveFilesystem();
+	if (title_out) {
+		*title_out = save.title;
+	}
 
 	return res;
 }
@@ -42,6 +42,9 @@ public:
 	static std::string GetSaveFilename(const FilesystemView& tree, int slot_id);
 	static bool Save(const FilesystemView& tree, int slot_id, bool prepare_save = true);
 	static bool Save(std::ostream& os, int slot_id, bool prepare_save = true);
+
+private:
+	static bool WriteSave(std::ostream& os, int slot_id, bool prepare_save, lcf::rpg::SaveTitle* title_out);
 };
 
 #endif
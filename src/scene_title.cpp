@@ -31,6 +31,7 @@
 #include "game_ineluki.h"
 #include "game_screen.h"
 #include "game_system.h"
+#include "map_file_cache.h"
 #include "transition.h"
 #include "input.h"
 #include "main_data.h"
@@ -51,6 +52,7 @@ Scene_Title::Scene_Title() {
 
 void Scene_Title::Start() {
 	Main_Data::game_system->ResetSystemGraphic();
+	Main_Data::game_system->PrefetchSystemSounds();
 
 	// Change the resolution of the window
 	if (Player::has_custom_resolution) {
@@ -89,6 +91,7 @@ void Scene_Title::Continue(SceneType prev_scene) {
 		// e.g. by pressing F12, except the Title Load menu
 		Cache::ClearAll();
 		AudioSeCache::Clear();
+		MapFileCache::Clear();
 
 		Player::ResetGameObjects();
 		if (Player::IsPatchKeyPatch()) {
@@ -41,7 +41,8 @@ void Sprite::BlitScreen(Bitmap& dst) {
 	if (!bitmap || (opacity_top_effect <= 0 && opacity_bottom_effect <= 0))
 		return;
 
-	BitmapRef draw_bitmap = Refresh(src_rect_effect);
+	bool apply_effects = false;
+	BitmapRef draw_bitmap = Refresh(src_rect_effect, apply_effects);
 	if (!draw_bitmap) {
 		return;
 	}
@@ -49,6 +50,18 @@ void Sprite::BlitScreen(Bitmap& dst) {
 	bitmap_changed = false;
 
 	Rect rect = src_rect_effect.GetSubRect(src_rect);
+	if (apply_effects) {
+		// Same pixels as drawn from bitmap_effects below
+		rect.x = src_rect_effect.x + rect.x % src_rect_effect.width;
+		rect.y = src_rect_effect.y + rect.y % src_rect_effect.height;
+
+		dst.EffectsBlit(x, y, ox - GetRenderOx(), oy - GetRenderOy(), *bitmap, rect,
+			Opacity(opacity_top_effect, opacity_bottom_effect, bush_effect),
+			current_tone, current_flash, current_flip_x, current_flip_y,
+			static_cast<Bitmap::BlendMode>(blend_type_effect));
+		return;
+	}
+
 	if (draw_bitmap == bitmap_effects) {
 		// When a "sprite rect" (src_rect_effect) is used bitmap_effects
 		// only has the size of this subrect instead of the whole bitmap
@@ -78,8 +91,9 @@ void Sprite::BlitScreenIntern(Bitmap& dst, Bitmap const& draw_bitmap, Rect const
 		waver_effect_depth, waver_effect_phase, static_cast<Bitmap::BlendMode>(blend_type_effect));
 }
 
-BitmapRef Sprite::Refresh(Rect& rect) {
-	if (zoom_x_effect == 1.0 && zoom_y_effect == 1.0 && angle_effect == 0.0 && waver_effect_depth == 0) {
+BitmapRef Sprite::Refresh(Rect& rect, bool& apply_effects) {
+	const bool plain = zoom_x_effect == 1.0 && zoom_y_effect == 1.0 && angle_effect == 0.0 && waver_effect_depth == 0;
+	if (plain) {
 		// Prevent effect sprite creation when not in the viewport
 		// TODO: Out of bounds math adjustments for zoom, angle and waver
 		// but even without this will catch most of the cases
@@ -108,6 +122,17 @@ BitmapRef Sprite::Refresh(Rect& rect) {
 		return bitmap;
 	} else if (bitmap_effects) {
 		return bitmap_effects;
+	} else if (plain && effects_changed && !rect.IsEmpty()) {
+		// Effects that change every frame (tint fades, flashes) are applied
+		// while drawing. A bitmap is only created once they are stable.
+		current_tone = tone_effect;
+		current_flash = flash_effect;
+		current_flip_x = flipx_effect;
+		current_flip_y = flipy_effect;
+		bitmap_effects_src_rect = rect;
+		apply_effects = true;
+
+		return bitmap;
 	} else {
 		current_tone = tone_effect;
 		current_flash = flash_effect;
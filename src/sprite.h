@@ -141,7 +141,7 @@ private:
 	void BlitScreen(Bitmap& dst);
 	void BlitScreenIntern(Bitmap& dst, Bitmap const& draw_bitmap,
 							Rect const& src_rect) const;
-	BitmapRef Refresh(Rect& rect);
+	BitmapRef Refresh(Rect& rect, bool& apply_effects);
 };
 
 inline int Sprite::GetWidth() const {
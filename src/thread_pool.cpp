@@ -0,0 +1,131 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "thread_pool.h"
+#include <algorithm>
+
+#ifdef HAVE_ASYNC_WORKER
+
+namespace {
+	thread_local bool is_worker_thread = false;
+}
+
+ThreadPool::ThreadPool(int num_threads) {
+	if (num_threads <= 0) {
+		// Keep one core for the main thread, the jobs are mostly IO bound anyway
+		int cores = static_cast<int>(std::thread::hardware_concurrency());
+		num_threads = std::min(std::max(cores - 1, 1), 4);
+	}
+
+	threads.reserve(num_threads);
+	for (int i = 0; i < num_threads; ++i) {
+		threads.emplace_back(&ThreadPool::WorkerMain, this);
+	}
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		quit = true;
+		queue.clear();
+	}
+	cv.notify_all();
+
+	for (auto& thread: threads) {
+		thread.join();
+	}
+}
+
+std::shared_future<void> ThreadPool::Submit(Job job) {
+	Task task(std::move(job));
+	std::shared_future<void> result = task.get_future().share();
+
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		queue.push_back(std::move(task));
+	}
+	cv.notify_one();
+
+	return result;
+}
+
+int ThreadPool::GetThreadCount() const {
+	return static_cast<int>(threads.size());
+}
+
+size_t ThreadPool::GetQueueSize() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return queue.size();
+}
+
+bool ThreadPool::IsWorkerThread() {
+	return is_worker_thread;
+}
+
+void ThreadPool::WorkerMain() {
+	is_worker_thread = true;
+
+	for (;;) {
+		Task task;
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			cv.wait(lock, [this]() { return quit || !queue.empty(); });
+			if (quit) {
+				return;
+			}
+			task = std::move(queue.front());
+			queue.pop_front();
+		}
+
+		task();
+	}
+}
+
+#else
+
+ThreadPool::ThreadPool(int) {
+}
+
+ThreadPool::~ThreadPool() {
+}
+
+std::shared_future<void> ThreadPool::Submit(Job job) {
+	Task task(std::move(job));
+	std::shared_future<void> result = task.get_future().share();
+	task();
+	return result;
+}
+
+int ThreadPool::GetThreadCount() const {
+	return 0;
+}
+
+size_t ThreadPool::GetQueueSize() const {
+	return 0;
+}
+
+bool ThreadPool::IsWorkerThread() {
+	return false;
+}
+
+#endif
+
+ThreadPool& ThreadPool::Global() {
+	static ThreadPool pool;
+	return pool;
+}
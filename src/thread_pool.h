@@ -0,0 +1,97 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_THREAD_POOL_H
+#define EP_THREAD_POOL_H
+
+// Headers
+#include "system.h"
+#include <functional>
+#include <future>
+
+#ifdef HAVE_ASYNC_WORKER
+#  include <condition_variable>
+#  include <deque>
+#  include <vector>
+#  include <mutex>
+#  include <thread>
+#endif
+
+/**
+ * Fixed size pool of worker threads executing jobs in FIFO order.
+ *
+ * Jobs must not touch the game state, they are only intended for
+ * self-contained work like file IO or image decoding.
+ * When the Player is built without HAVE_ASYNC_WORKER the pool has no
+ * threads and every job is executed immediately by Submit.
+ */
+class ThreadPool {
+public:
+	using Job = std::function<void()>;
+
+	/**
+	 * Creates the pool and starts the worker threads.
+	 *
+	 * @param num_threads Amount of worker threads, 0 uses a default
+	 *                    depending on the amount of CPU cores.
+	 */
+	explicit ThreadPool(int num_threads = 0);
+
+	/**
+	 * Discards all queued jobs and waits until the running jobs finished.
+	 */
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	/**
+	 * Queues a job for execution by a worker thread.
+	 *
+	 * @param job job to execute
+	 * @return future that becomes ready when the job finished.
+	 *         When the job is discarded the future holds a broken_promise.
+	 */
+	std::shared_future<void> Submit(Job job);
+
+	/** @return Amount of worker threads, 0 when jobs run synchronously */
+	int GetThreadCount() const;
+
+	/** @return Amount of jobs waiting for execution */
+	size_t GetQueueSize() const;
+
+	/** @return the pool shared by the whole Player */
+	static ThreadPool& Global();
+
+	/** @return Whether the calling thread is a worker thread of any pool */
+	static bool IsWorkerThread();
+
+private:
+	using Task = std::packaged_task<void()>;
+
+#ifdef HAVE_ASYNC_WORKER
+	void WorkerMain();
+
+	std::vector<std::thread> threads;
+	std::deque<Task> queue;
+	mutable std::mutex mutex;
+	std::condition_variable cv;
+	bool quit = false;
+#endif
+};
+
+#endif
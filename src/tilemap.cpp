@@ -105,6 +105,11 @@ void Tilemap::SetFastBlitDown(bool fast) {
 	layer_down.SetFastBlit(fast);
 }
 
+void Tilemap::SetLayerCache(bool enable) {
+	layer_down.SetLayerCache(enable);
+	layer_up.SetLayerCache(enable);
+}
+
 void Tilemap::SetTone(Tone tone) {
 	layer_down.SetTone(tone);
 	layer_up.SetTone(tone);
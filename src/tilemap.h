@@ -69,6 +69,7 @@ public:
 	void OnSubstituteDown();
 	void OnSubstituteUp();
 	void SetFastBlitDown(bool fast);
+	void SetLayerCache(bool enable);
 	void SetTone(Tone tone);
 
 private:
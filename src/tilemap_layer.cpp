@@ -258,31 +258,153 @@ static uint32_t MakeAbTileHash(int id, int anim_step) {
 	return static_cast<uint32_t>((id + (anim_step << 12)) | (4 << 24));
 }
 
-void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_oy) {
-	// Get the number of tiles that can be displayed on window
-	int tiles_x = (int)ceil(Player::screen_width / (float)TILE_SIZE);
-	int tiles_y = (int)ceil(Player::screen_height / (float)TILE_SIZE);
+bool TilemapLayer::IsAnimatedTile(const TileData& tile) const {
+	// Blocks A, B and C of the lower layer change with the animation step
+	return layer == 0 && tile.ID < BLOCK_D;
+}
 
-	// If ox or oy are not equal to the tile size draw the next tile too
-	// to prevent black (empty) tiles at the borders
-	if ((ox - render_ox) % TILE_SIZE != 0) {
-		++tiles_x;
+void TilemapLayer::DrawTileData(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_c, int animation_step_ab) {
+	if (layer == 0) {
+		// If lower layer
+		bool allow_fast_blit = (tile.z == TileBelow);
+
+		if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
+			int id = substitutions[tile.ID - BLOCK_E];
+			// If Block E
+
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 96) {
+				// If from first column of the block
+				col = 12 + id % 6;
+				row = id / 6;
+			} else {
+				// If from second column of the block
+				col = 18 + (id - 96) % 6;
+				row = (id - 96) / 6;
+			}
+
+			auto tone_hash = MakeETileHash(id);
+			DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
+			// If Block C
+
+			// Get the tile coordinates from chipset
+			int col = 3 + (tile.ID - BLOCK_C) / 50;
+			int row = 4 + animation_step_c;
+
+			auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
+			DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else if (tile.ID < BLOCK_C) {
+			// If Blocks A1, A2, B
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
+
+			int col = pos.x;
+			int row = pos.y;
+
+			// Create tone changed tile
+			auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
+			DrawTile(dst, *autotiles_ab_screen, *autotiles_ab_screen_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		} else {
+			// If blocks D1-D12
+
+			// Draw the tile from autotile cache
+			TileXY pos = GetCachedAutotileD(tile.ID);
+
+			int col = pos.x;
+			int row = pos.y;
+
+			auto tone_hash = MakeDTileHash(tile.ID);
+			DrawTile(dst, *autotiles_d_screen, *autotiles_d_screen_effect, x, y, row, col, tone_hash, allow_fast_blit);
+		}
+	} else {
+		// If upper layer
+
+		// Check that block F is being drawn
+		if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
+			int id = substitutions[tile.ID - BLOCK_F];
+			int row, col;
+
+			// Get the tile coordinates from chipset
+			if (id < 48) {
+				// If from first column of the block
+				col = 18 + id % 6;
+				row = 8 + id / 6;
+			} else {
+				// If from second column of the block
+				col = 24 + (id - 48) % 6;
+				row = (id - 48) / 6;
+			}
+
+			auto tone_hash = MakeFTileHash(id);
+			DrawTile(dst, *chipset, *chipset_effect, x, y, row, col, tone_hash);
+		}
 	}
-	if ((oy - render_oy) % TILE_SIZE != 0) {
-		++tiles_y;
+}
+
+static int div_rounding_down(int n, int m) {
+	if (n >= 0) return n / m;
+	return (n - m + 1) / m;
+}
+
+static int mod(int n, int m) {
+	int rem = n % m;
+	return rem >= 0 ? rem : m + rem;
+}
+
+void TilemapLayer::RefreshLayerCache(LayerCache& cache, uint8_t z_order, int tile_x, int tile_y, int tiles_x, int tiles_y) {
+	const int cache_w = tiles_x * TILE_SIZE;
+	const int cache_h = tiles_y * TILE_SIZE;
+
+	if (!cache.bitmap || cache.bitmap->width() != cache_w || cache.bitmap->height() != cache_h) {
+		cache.bitmap = Bitmap::Create(cache_w, cache_h, true);
 	}
+	cache.bitmap->Clear();
+	cache.animated_tiles.clear();
 
 	const bool loop_h = Game_Map::LoopHorizontal();
 	const bool loop_v = Game_Map::LoopVertical();
 
-	auto div_rounding_down = [](int n, int m) {
-		if (n >= 0) return n / m;
-		return (n - m + 1) / m;
-	};
-	auto mod = [](int n, int m) {
-		int rem = n % m;
-		return rem >= 0 ? rem : m + rem;
-	};
+	for (int y = 0; y < tiles_y; y++) {
+		for (int x = 0; x < tiles_x; x++) {
+			int map_x = tile_x + x;
+			int map_y = tile_y + y;
+			if (loop_h) map_x = mod(map_x, width);
+			if (loop_v) map_y = mod(map_y, height);
+
+			if (!IsInMapBounds(map_x, map_y)) {
+				continue;
+			}
+
+			const TileData& tile = GetDataCache(map_x, map_y);
+			if (tile.z != z_order) {
+				continue;
+			}
+
+			if (IsAnimatedTile(tile)) {
+				cache.animated_tiles.push_back({ tile, x * TILE_SIZE, y * TILE_SIZE });
+				continue;
+			}
+
+			// Static tiles do not depend on the animation step
+			DrawTileData(*cache.bitmap, tile, x * TILE_SIZE, y * TILE_SIZE, 0, 0);
+		}
+	}
+
+	cache.tile_x = tile_x;
+	cache.tile_y = tile_y;
+	cache.tiles_x = tiles_x;
+	cache.tiles_y = tiles_y;
+	cache.valid = true;
+}
+
+void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_oy) {
+	// Get the number of tiles that can be displayed on window
+	int tiles_x = (int)ceil(Player::screen_width / (float)TILE_SIZE);
+	int tiles_y = (int)ceil(Player::screen_height / (float)TILE_SIZE);
 
 	// FIXME: When Game_Map singleton is made an object we can remove this null check
 	const auto frames = Main_Data::game_system ? static_cast<uint32_t>(Main_Data::game_system->GetFrameCounter()) : 0u;
@@ -303,6 +425,38 @@ void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_
 	const int mod_ox = mod(ox - render_ox, TILE_SIZE);
 	const int mod_oy = mod(oy - render_oy, TILE_SIZE);
 
+	if (use_layer_cache) {
+		// The cache always contains the next tile too, so it is independent
+		// of the sub-tile scroll offset and only rebuilt on full tile steps
+		++tiles_x;
+		++tiles_y;
+
+		auto& cache = GetLayerCache(z_order);
+		if (!cache.valid || cache.tile_x != div_ox || cache.tile_y != div_oy
+				|| cache.tiles_x != tiles_x || cache.tiles_y != tiles_y) {
+			RefreshLayerCache(cache, z_order, div_ox, div_oy, tiles_x, tiles_y);
+		}
+
+		dst.Blit(-mod_ox, -mod_oy, *cache.bitmap, cache.bitmap->GetRect(), 255);
+
+		for (auto& anim: cache.animated_tiles) {
+			DrawTileData(dst, anim.tile, anim.x - mod_ox, anim.y - mod_oy, animation_step_c, animation_step_ab);
+		}
+		return;
+	}
+
+	// If ox or oy are not equal to the tile size draw the next tile too
+	// to prevent black (empty) tiles at the borders
+	if ((ox - render_ox) % TILE_SIZE != 0) {
+		++tiles_x;
+	}
+	if ((oy - render_oy) % TILE_SIZE != 0) {
+		++tiles_y;
+	}
+
+	const bool loop_h = Game_Map::LoopHorizontal();
+	const bool loop_v = Game_Map::LoopVertical();
+
 	for (int y = 0; y < tiles_y; y++) {
 		for (int x = 0; x < tiles_x; x++) {
 
@@ -328,85 +482,7 @@ void TilemapLayer::Draw(Bitmap& dst, uint8_t z_order, int render_ox, int render_
 
 			// Draw the sublayer if its z is being draw now
 			if (z_order == tile.z) {
-				if (layer == 0) {
-					// If lower layer
-					bool allow_fast_blit = (tile.z == TileBelow);
-
-					if (tile.ID >= BLOCK_E && tile.ID < BLOCK_E + BLOCK_E_TILES) {
-						int id = substitutions[tile.ID - BLOCK_E];
-						// If Block E
-
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 96) {
-							// If from first column of the block
-							col = 12 + id % 6;
-							row = id / 6;
-						} else {
-							// If from second column of the block
-							col = 18 + (id - 96) % 6;
-							row = (id - 96) / 6;
-						}
-
-						auto tone_hash = MakeETileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID >= BLOCK_C && tile.ID < BLOCK_D) {
-						// If Block C
-
-						// Get the tile coordinates from chipset
-						int col = 3 + (tile.ID - BLOCK_C) / 50;
-						int row = 4 + animation_step_c;
-
-						auto tone_hash = MakeCTileHash(tile.ID, animation_step_c);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else if (tile.ID < BLOCK_C) {
-						// If Blocks A1, A2, B
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileAB(tile.ID, animation_step_ab);
-
-						int col = pos.x;
-						int row = pos.y;
-
-						// Create tone changed tile
-						auto tone_hash = MakeAbTileHash(tile.ID,  animation_step_ab);
-						DrawTile(dst, *autotiles_ab_screen, *autotiles_ab_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					} else {
-						// If blocks D1-D12
-
-						// Draw the tile from autotile cache
-						TileXY pos = GetCachedAutotileD(tile.ID);
-
-						int col = pos.x;
-						int row = pos.y;
-
-						auto tone_hash = MakeDTileHash(tile.ID);
-						DrawTile(dst, *autotiles_d_screen, *autotiles_d_screen_effect, map_draw_x, map_draw_y, row, col, tone_hash, allow_fast_blit);
-					}
-				} else {
-					// If upper layer
-
-					// Check that block F is being drawn
-					if (tile.ID >= BLOCK_F && tile.ID < BLOCK_F + BLOCK_F_TILES) {
-						int id = substitutions[tile.ID - BLOCK_F];
-						int row, col;
-
-						// Get the tile coordinates from chipset
-						if (id < 48) {
-							// If from first column of the block
-							col = 18 + id % 6;
-							row = 8 + id / 6;
-						} else {
-							// If from second column of the block
-							col = 24 + (id - 48) % 6;
-							row = (id - 48) / 6;
-						}
-
-						auto tone_hash = MakeFTileHash(id);
-						DrawTile(dst, *chipset, *chipset_effect, map_draw_x, map_draw_y, row, col, tone_hash);
-					}
-				}
+				DrawTileData(dst, tile, map_draw_x, map_draw_y, animation_step_c, animation_step_ab);
 			}
 		}
 	}
@@ -673,6 +749,7 @@ void TilemapLayer::SetChipset(BitmapRef const& nchipset) {
 	chipset = nchipset;
 	chipset_effect = Bitmap::Create(chipset->width(), chipset->height());
 	chipset_tone_tiles.clear();
+	InvalidateLayerCache();
 
 	if (autotiles_ab_next != 0 && autotiles_d_screen != nullptr && layer == 0) {
 		autotiles_ab_screen = GenerateAutotiles(autotiles_ab_next, autotiles_ab_map);
@@ -720,6 +797,7 @@ void TilemapLayer::SetMapData(std::vector<short> nmap_data) {
 	}
 
 	map_data = std::move(nmap_data);
+	InvalidateLayerCache();
 }
 
 static inline bool IsTileFromBlock(int tile_id, int block) {
@@ -862,6 +940,7 @@ void TilemapLayer::SetPassable(std::vector<unsigned char> npassable) {
 
 	// Recalculate z values of all tiles
 	CreateTileCache(map_data);
+	InvalidateLayerCache();
 }
 
 void TilemapLayer::OnSubstitute() {
@@ -869,6 +948,7 @@ void TilemapLayer::OnSubstitute() {
 
 	// Recalculate z values of all tiles
 	CreateTileCache(map_data);
+	InvalidateLayerCache();
 }
 
 TilemapSubLayer::TilemapSubLayer(TilemapLayer* tilemap, Drawable::Z_t z) :
@@ -904,4 +984,5 @@ void TilemapLayer::SetTone(Tone tone) {
 		chipset_effect->Clear();
 	}
 	chipset_tone_tiles.clear();
+	InvalidateLayerCache();
 }
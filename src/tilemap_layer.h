@@ -97,6 +97,16 @@ public:
 	 */
 	void SetFastBlit(bool fast);
 
+	/**
+	 * Influences how the static tiles of the tilemap are drawn.
+	 * When enabled the non-animated tiles of each sublayer are composed into
+	 * an offscreen bitmap that is only redrawn when the visible tile range or
+	 * the tile data changes. Only the animated autotiles are drawn per frame.
+	 *
+	 * @param enable true: enable the layer cache
+	 */
+	void SetLayerCache(bool enable);
+
 	void SetTone(Tone tone);
 
 private:
@@ -114,6 +124,7 @@ private:
 	int animation_type = 0;
 	int layer = 0;
 	bool fast_blit = false;
+	bool use_layer_cache = true;
 
 	void CreateTileCache(const std::vector<short>& nmap_data);
 	void CreateTileCacheAt(int x, int y, int tile_id);
@@ -123,6 +134,7 @@ private:
 	void DrawTile(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, bool allow_fast_blit = true);
 	void DrawTileImpl(Bitmap& dst, Bitmap& tile, Bitmap& tone_tile, int x, int y, int row, int col, uint32_t tone_hash, ImageOpacity op, bool allow_fast_blit);
 	void RecalculateAutotile(int x, int y, int tile_id);
+	void InvalidateLayerCache();
 
 	static const int TILES_PER_ROW = 64;
 
@@ -161,6 +173,32 @@ private:
 
 	std::vector<TileData> data_cache_vec;
 
+	bool IsAnimatedTile(const TileData& tile) const;
+	void DrawTileData(Bitmap& dst, const TileData& tile, int x, int y, int animation_step_c, int animation_step_ab);
+
+	struct AnimatedTile {
+		TileData tile;
+		int x;
+		int y;
+	};
+
+	/** Pre-composed static tiles of one sublayer */
+	struct LayerCache {
+		BitmapRef bitmap;
+		std::vector<AnimatedTile> animated_tiles;
+		int tile_x = 0;
+		int tile_y = 0;
+		int tiles_x = 0;
+		int tiles_y = 0;
+		bool valid = false;
+	};
+
+	LayerCache& GetLayerCache(uint8_t z_order);
+	void RefreshLayerCache(LayerCache& cache, uint8_t z_order, int tile_x, int tile_y, int tiles_x, int tiles_y);
+
+	// Index 0: TileBelow sublayer, Index 1: TileAbove sublayer
+	LayerCache layer_cache[2];
+
 	TilemapSubLayer lower_layer;
 	TilemapSubLayer upper_layer;
 
@@ -231,6 +269,7 @@ inline int TilemapLayer::GetWidth() const {
 
 inline void TilemapLayer::SetWidth(int nwidth) {
 	width = nwidth;
+	InvalidateLayerCache();
 }
 
 inline int TilemapLayer::GetHeight() const {
@@ -239,6 +278,7 @@ inline int TilemapLayer::GetHeight() const {
 
 inline void TilemapLayer::SetHeight(int nheight) {
 	height = nheight;
+	InvalidateLayerCache();
 }
 
 inline int TilemapLayer::GetAnimationSpeed() const {
@@ -261,10 +301,25 @@ inline void TilemapLayer::SetFastBlit(bool fast) {
 	fast_blit = fast;
 }
 
+inline void TilemapLayer::SetLayerCache(bool enable) {
+	use_layer_cache = enable;
+	InvalidateLayerCache();
+}
+
 inline TilemapLayer::TileData& TilemapLayer::GetDataCache(int x, int y) {
 	return data_cache_vec[x + y * width];
 }
 
+inline TilemapLayer::LayerCache& TilemapLayer::GetLayerCache(uint8_t z_order) {
+	return layer_cache[z_order >= TileAbove ? 1 : 0];
+}
+
+inline void TilemapLayer::InvalidateLayerCache() {
+	for (auto& cache: layer_cache) {
+		cache.valid = false;
+	}
+}
+
 inline bool TilemapLayer::IsInMapBounds(int x, int y) const {
 	return x >= 0 && x < width && y >= 0 && y < height;
 }
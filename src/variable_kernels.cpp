@@ -0,0 +1,659 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// Headers
+#include "variable_kernels.h"
+#include "cpu_features.h"
+#include <algorithm>
+#include <limits>
+
+#ifdef EP_SIMD_SSE41
+#  include <smmintrin.h>
+#endif
+#ifdef EP_SIMD_AVX2
+#  include <immintrin.h>
+#endif
+
+using VariableKernels::Variant;
+using VariableKernels::Op;
+
+namespace {
+
+constexpr int64_t int32_min = std::numeric_limits<int32_t>::min();
+constexpr int64_t int32_max = std::numeric_limits<int32_t>::max();
+
+/**
+ * Operands of a kernel. The operations are rewritten so that they need
+ * neither overflow checks nor 64 bit arithmetic:
+ *
+ * Offset: v = clamp(v, lo, hi) + value, the addition never overflows.
+ * Mult: v < lo -> below, v > hi -> above, otherwise v * value.
+ * Others: v = clamp(v op value, minval, maxval)
+ */
+struct Params {
+	int32_t value = 0;
+	int32_t minval = 0;
+	int32_t maxval = 0;
+	int32_t lo = 0;
+	int32_t hi = 0;
+	int32_t below = 0;
+	int32_t above = 0;
+};
+
+constexpr int32_t Clamp(int64_t v, int32_t minval, int32_t maxval) {
+	return static_cast<int32_t>(std::min<int64_t>(std::max<int64_t>(v, minval), maxval));
+}
+
+constexpr int64_t FloorDiv(int64_t n, int64_t d) {
+	return n / d - ((n % d != 0) && ((n < 0) != (d < 0)));
+}
+
+constexpr int64_t CeilDiv(int64_t n, int64_t d) {
+	return n / d + ((n % d != 0) && ((n < 0) == (d < 0)));
+}
+
+namespace Scalar {
+	int Offset(int32_t* vars, int count, const Params& p) {
+		const auto add = static_cast<uint32_t>(p.value);
+		for (int i = 0; i < count; ++i) {
+			const auto v = std::min(std::max(vars[i], p.lo), p.hi);
+			vars[i] = static_cast<int32_t>(static_cast<uint32_t>(v) + add);
+		}
+		return count;
+	}
+
+	int Mult(int32_t* vars, int count, const Params& p) {
+		for (int i = 0; i < count; ++i) {
+			const auto v = vars[i];
+			vars[i] = v < p.lo ? p.below : (v > p.hi ? p.above : v * p.value);
+		}
+		return count;
+	}
+
+	int Div(int32_t* vars, int count, const Params& p) {
+		// INT32_MIN / -1 overflows
+		if (p.value == -1) {
+			for (int i = 0; i < count; ++i) {
+				vars[i] = Clamp(-int64_t(vars[i]), p.minval, p.maxval);
+			}
+			return count;
+		}
+		for (int i = 0; i < count; ++i) {
+			vars[i] = Clamp(vars[i] / p.value, p.minval, p.maxval);
+		}
+		return count;
+	}
+
+	int Mod(int32_t* vars, int count, const Params& p) {
+		if (p.value == -1) {
+			std::fill(vars, vars + count, Clamp(0, p.minval, p.maxval));
+			return count;
+		}
+		for (int i = 0; i < count; ++i) {
+			vars[i] = Clamp(vars[i] % p.value, p.minval, p.maxval);
+		}
+		return count;
+	}
+
+	int BitOr(int32_t* vars, int count, const Params& p) {
+		for (int i = 0; i < count; ++i) {
+			vars[i] = std::min(std::max(vars[i] | p.value, p.minval), p.maxval);
+		}
+		return count;
+	}
+
+	int BitAnd(int32_t* vars, int count, const Params& p) {
+		for (int i = 0; i < count; ++i) {
+			vars[i] = std::min(std::max(vars[i] & p.value, p.minval), p.maxval);
+		}
+		return count;
+	}
+
+	int BitXor(int32_t* vars, int count, const Params& p) {
+		for (int i = 0; i < count; ++i) {
+			vars[i] = std::min(std::max(vars[i] ^ p.value, p.minval), p.maxval);
+		}
+		return count;
+	}
+
+	int BitShiftLeft(int32_t* vars, int count, const Params& p) {
+		for (int i = 0; i < count; ++i) {
+			const auto v = static_cast<int32_t>(static_cast<uint32_t>(vars[i]) << p.value);
+			vars[i] = std::min(std::max(v, p.minval), p.maxval);
+		}
+		return count;
+	}
+
+	int BitShiftRight(int32_t* vars, int count, const Params& p) {
+		for (int i = 0; i < count; ++i) {
+			vars[i] = std::min(std::max(vars[i] >> p.value, p.minval), p.maxval);
+		}
+		return count;
+	}
+}
+
+#ifdef EP_SIMD_SSE41
+namespace Sse41 {
+	EP_TARGET_SSE41 inline __m128i Clamp(__m128i v, __m128i minval, __m128i maxval) {
+		return _mm_min_epi32(_mm_max_epi32(v, minval), maxval);
+	}
+
+	EP_TARGET_SSE41 int Offset(int32_t* vars, int count, const Params& p) {
+		const __m128i lo = _mm_set1_epi32(p.lo);
+		const __m128i hi = _mm_set1_epi32(p.hi);
+		const __m128i add = _mm_set1_epi32(p.value);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			auto* ptr = reinterpret_cast<__m128i*>(vars + i);
+			_mm_storeu_si128(ptr, _mm_add_epi32(Clamp(_mm_loadu_si128(ptr), lo, hi), add));
+		}
+		return i + Scalar::Offset(vars + i, count - i, p);
+	}
+
+	EP_TARGET_SSE41 int Mult(int32_t* vars, int count, const Params& p) {
+		const __m128i lo = _mm_set1_epi32(p.lo);
+		const __m128i hi = _mm_set1_epi32(p.hi);
+		const __m128i below = _mm_set1_epi32(p.below);
+		const __m128i above = _mm_set1_epi32(p.above);
+		const __m128i factor = _mm_set1_epi32(p.value);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			auto* ptr = reinterpret_cast<__m128i*>(vars + i);
+			const __m128i v = _mm_loadu_si128(ptr);
+			__m128i r = _mm_mullo_epi32(v, factor);
+			r = _mm_blendv_epi8(r, below, _mm_cmplt_epi32(v, lo));
+			r = _mm_blendv_epi8(r, above, _mm_cmpgt_epi32(v, hi));
+			_mm_storeu_si128(ptr, r);
+		}
+		return i + Scalar::Mult(vars + i, count - i, p);
+	}
+
+	// The quotient of two 32 bit integers computed in double precision
+	// truncates to the exact integer quotient.
+	template <bool mod>
+	EP_TARGET_SSE41 inline __m128i DivMod(__m128i v, __m128d d, __m128d minval, __m128d maxval) {
+		__m128d lo = _mm_cvtepi32_pd(v);
+		__m128d hi = _mm_cvtepi32_pd(_mm_unpackhi_epi64(v, v));
+		__m128d q_lo = _mm_div_pd(lo, d);
+		__m128d q_hi = _mm_div_pd(hi, d);
+		if (mod) {
+			q_lo = _mm_round_pd(q_lo, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+			q_hi = _mm_round_pd(q_hi, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+			q_lo = _mm_sub_pd(lo, _mm_mul_pd(q_lo, d));
+			q_hi = _mm_sub_pd(hi, _mm_mul_pd(q_hi, d));
+		}
+		q_lo = _mm_min_pd(_mm_max_pd(q_lo, minval), maxval);
+		q_hi = _mm_min_pd(_mm_max_pd(q_hi, minval), maxval);
+		return _mm_unpacklo_epi64(_mm_cvttpd_epi32(q_lo), _mm_cvttpd_epi32(q_hi));
+	}
+
+	template <bool mod>
+	EP_TARGET_SSE41 int DivModLoop(int32_t* vars, int count, const Params& p) {
+		const __m128d d = _mm_set1_pd(p.value);
+		const __m128d minval = _mm_set1_pd(p.minval);
+		const __m128d maxval = _mm_set1_pd(p.maxval);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			auto* ptr = reinterpret_cast<__m128i*>(vars + i);
+			_mm_storeu_si128(ptr, DivMod<mod>(_mm_loadu_si128(ptr), d, minval, maxval));
+		}
+		return i;
+	}
+
+	int Div(int32_t* vars, int count, const Params& p) {
+		int i = DivModLoop<false>(vars, count, p);
+		return i + Scalar::Div(vars + i, count - i, p);
+	}
+
+	int Mod(int32_t* vars, int count, const Params& p) {
+		int i = DivModLoop<true>(vars, count, p);
+		return i + Scalar::Mod(vars + i, count - i, p);
+	}
+
+	EP_TARGET_SSE41 int BitOr(int32_t* vars, int count, const Params& p) {
+		const __m128i value = _mm_set1_epi32(p.value);
+		const __m128i minval = _mm_set1_epi32(p.minval);
+		const __m128i maxval = _mm_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			auto* ptr = reinterpret_cast<__m128i*>(vars + i);
+			_mm_storeu_si128(ptr, Clamp(_mm_or_si128(_mm_loadu_si128(ptr), value), minval, maxval));
+		}
+		return i + Scalar::BitOr(vars + i, count - i, p);
+	}
+
+	EP_TARGET_SSE41 int BitAnd(int32_t* vars, int count, const Params& p) {
+		const __m128i value = _mm_set1_epi32(p.value);
+		const __m128i minval = _mm_set1_epi32(p.minval);
+		const __m128i maxval = _mm_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			auto* ptr = reinterpret_cast<__m128i*>(vars + i);
+			_mm_storeu_si128(ptr, Clamp(_mm_and_si128(_mm_loadu_si128(ptr), value), minval, maxval));
+		}
+		return i + Scalar::BitAnd(vars + i, count - i, p);
+	}
+
+	EP_TARGET_SSE41 int BitXor(int32_t* vars, int count, const Params& p) {
+		const __m128i value = _mm_set1_epi32(p.value);
+		const __m128i minval = _mm_set1_epi32(p.minval);
+		const __m128i maxval = _mm_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			auto* ptr = reinterpret_cast<__m128i*>(vars + i);
+			_mm_storeu_si128(ptr, Clamp(_mm_xor_si128(_mm_loadu_si128(ptr), value), minval, maxval));
+		}
+		return i + Scalar::BitXor(vars + i, count - i, p);
+	}
+
+	EP_TARGET_SSE41 int BitShiftLeft(int32_t* vars, int count, const Params& p) {
+		const __m128i shift = _mm_cvtsi32_si128(p.value);
+		const __m128i minval = _mm_set1_epi32(p.minval);
+		const __m128i maxval = _mm_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			auto* ptr = reinterpret_cast<__m128i*>(vars + i);
+			_mm_storeu_si128(ptr, Clamp(_mm_sll_epi32(_mm_loadu_si128(ptr), shift), minval, maxval));
+		}
+		return i + Scalar::BitShiftLeft(vars + i, count - i, p);
+	}
+
+	EP_TARGET_SSE41 int BitShiftRight(int32_t* vars, int count, const Params& p) {
+		const __m128i shift = _mm_cvtsi32_si128(p.value);
+		const __m128i minval = _mm_set1_epi32(p.minval);
+		const __m128i maxval = _mm_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 4 <= count; i += 4) {
+			auto* ptr = reinterpret_cast<__m128i*>(vars + i);
+			_mm_storeu_si128(ptr, Clamp(_mm_sra_epi32(_mm_loadu_si128(ptr), shift), minval, maxval));
+		}
+		return i + Scalar::BitShiftRight(vars + i, count - i, p);
+	}
+}
+#endif
+
+#ifdef EP_SIMD_AVX2
+namespace Avx2 {
+	EP_TARGET_AVX2 inline __m256i Clamp(__m256i v, __m256i minval, __m256i maxval) {
+		return _mm256_min_epi32(_mm256_max_epi32(v, minval), maxval);
+	}
+
+	EP_TARGET_AVX2 int Offset(int32_t* vars, int count, const Params& p) {
+		const __m256i lo = _mm256_set1_epi32(p.lo);
+		const __m256i hi = _mm256_set1_epi32(p.hi);
+		const __m256i add = _mm256_set1_epi32(p.value);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			auto* ptr = reinterpret_cast<__m256i*>(vars + i);
+			_mm256_storeu_si256(ptr, _mm256_add_epi32(Clamp(_mm256_loadu_si256(ptr), lo, hi), add));
+		}
+		return i + Scalar::Offset(vars + i, count - i, p);
+	}
+
+	EP_TARGET_AVX2 int Mult(int32_t* vars, int count, const Params& p) {
+		const __m256i lo = _mm256_set1_epi32(p.lo);
+		const __m256i hi = _mm256_set1_epi32(p.hi);
+		const __m256i below = _mm256_set1_epi32(p.below);
+		const __m256i above = _mm256_set1_epi32(p.above);
+		const __m256i factor = _mm256_set1_epi32(p.value);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			auto* ptr = reinterpret_cast<__m256i*>(vars + i);
+			const __m256i v = _mm256_loadu_si256(ptr);
+			__m256i r = _mm256_mullo_epi32(v, factor);
+			r = _mm256_blendv_epi8(r, below, _mm256_cmpgt_epi32(lo, v));
+			r = _mm256_blendv_epi8(r, above, _mm256_cmpgt_epi32(v, hi));
+			_mm256_storeu_si256(ptr, r);
+		}
+		return i + Scalar::Mult(vars + i, count - i, p);
+	}
+
+	template <bool mod>
+	EP_TARGET_AVX2 inline __m128i DivMod(__m128i v, __m256d d, __m256d minval, __m256d maxval) {
+		const __m256d n = _mm256_cvtepi32_pd(v);
+		__m256d q = _mm256_div_pd(n, d);
+		if (mod) {
+			q = _mm256_round_pd(q, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+			q = _mm256_sub_pd(n, _mm256_mul_pd(q, d));
+		}
+		q = _mm256_min_pd(_mm256_max_pd(q, minval), maxval);
+		return _mm256_cvttpd_epi32(q);
+	}
+
+	template <bool mod>
+	EP_TARGET_AVX2 int DivModLoop(int32_t* vars, int count, const Params& p) {
+		const __m256d d = _mm256_set1_pd(p.value);
+		const __m256d minval = _mm256_set1_pd(p.minval);
+		const __m256d maxval = _mm256_set1_pd(p.maxval);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			auto* ptr = reinterpret_cast<__m256i*>(vars + i);
+			const __m256i v = _mm256_loadu_si256(ptr);
+			const __m128i lo = DivMod<mod>(_mm256_castsi256_si128(v), d, minval, maxval);
+			const __m128i hi = DivMod<mod>(_mm256_extracti128_si256(v, 1), d, minval, maxval);
+			_mm256_storeu_si256(ptr, _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1));
+		}
+		return i;
+	}
+
+	int Div(int32_t* vars, int count, const Params& p) {
+		int i = DivModLoop<false>(vars, count, p);
+		return i + Scalar::Div(vars + i, count - i, p);
+	}
+
+	int Mod(int32_t* vars, int count, const Params& p) {
+		int i = DivModLoop<true>(vars, count, p);
+		return i + Scalar::Mod(vars + i, count - i, p);
+	}
+
+	EP_TARGET_AVX2 int BitOr(int32_t* vars, int count, const Params& p) {
+		const __m256i value = _mm256_set1_epi32(p.value);
+		const __m256i minval = _mm256_set1_epi32(p.minval);
+		const __m256i maxval = _mm256_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			auto* ptr = reinterpret_cast<__m256i*>(vars + i);
+			_mm256_storeu_si256(ptr, Clamp(_mm256_or_si256(_mm256_loadu_si256(ptr), value), minval, maxval));
+		}
+		return i + Scalar::BitOr(vars + i, count - i, p);
+	}
+
+	EP_TARGET_AVX2 int BitAnd(int32_t* vars, int count, const Params& p) {
+		const __m256i value = _mm256_set1_epi32(p.value);
+		const __m256i minval = _mm256_set1_epi32(p.minval);
+		const __m256i maxval = _mm256_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			auto* ptr = reinterpret_cast<__m256i*>(vars + i);
+			_mm256_storeu_si256(ptr, Clamp(_mm256_and_si256(_mm256_loadu_si256(ptr), value), minval, maxval));
+		}
+		return i + Scalar::BitAnd(vars + i, count - i, p);
+	}
+
+	EP_TARGET_AVX2 int BitXor(int32_t* vars, int count, const Params& p) {
+		const __m256i value = _mm256_set1_epi32(p.value);
+		const __m256i minval = _mm256_set1_epi32(p.minval);
+		const __m256i maxval = _mm256_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			auto* ptr = reinterpret_cast<__m256i*>(vars + i);
+			_mm256_storeu_si256(ptr, Clamp(_mm256_xor_si256(_mm256_loadu_si256(ptr), value), minval, maxval));
+		}
+		return i + Scalar::BitXor(vars + i, count - i, p);
+	}
+
+	EP_TARGET_AVX2 int BitShiftLeft(int32_t* vars, int count, const Params& p) {
+		const __m128i shift = _mm_cvtsi32_si128(p.value);
+		const __m256i minval = _mm256_set1_epi32(p.minval);
+		const __m256i maxval = _mm256_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			auto* ptr = reinterpret_cast<__m256i*>(vars + i);
+			_mm256_storeu_si256(ptr, Clamp(_mm256_sll_epi32(_mm256_loadu_si256(ptr), shift), minval, maxval));
+		}
+		return i + Scalar::BitShiftLeft(vars + i, count - i, p);
+	}
+
+	EP_TARGET_AVX2 int BitShiftRight(int32_t* vars, int count, const Params& p) {
+		const __m128i shift = _mm_cvtsi32_si128(p.value);
+		const __m256i minval = _mm256_set1_epi32(p.minval);
+		const __m256i maxval = _mm256_set1_epi32(p.maxval);
+
+		int i = 0;
+		for (; i + 8 <= count; i += 8) {
+			auto* ptr = reinterpret_cast<__m256i*>(vars + i);
+			_mm256_storeu_si256(ptr, Clamp(_mm256_sra_epi32(_mm256_loadu_si256(ptr), shift), minval, maxval));
+		}
+		return i + Scalar::BitShiftRight(vars + i, count - i, p);
+	}
+}
+#endif
+
+using KernelFunc = int (*)(int32_t* vars, int count, const Params& p);
+
+struct Kernels {
+	Variant variant = Variant::Scalar;
+	KernelFunc offset = Scalar::Offset;
+	KernelFunc mult = Scalar::Mult;
+	KernelFunc div = Scalar::Div;
+	KernelFunc mod = Scalar::Mod;
+	KernelFunc bit_or = Scalar::BitOr;
+	KernelFunc bit_and = Scalar::BitAnd;
+	KernelFunc bit_xor = Scalar::BitXor;
+	KernelFunc bit_shift_left = Scalar::BitShiftLeft;
+	KernelFunc bit_shift_right = Scalar::BitShiftRight;
+};
+
+Kernels MakeKernels(Variant variant) {
+	Kernels kernels;
+	kernels.variant = variant;
+
+	switch (variant) {
+		case Variant::Scalar:
+			break;
+		case Variant::Sse41:
+#ifdef EP_SIMD_SSE41
+			kernels.offset = Sse41::Offset;
+			kernels.mult = Sse41::Mult;
+			kernels.div = Sse41::Div;
+			kernels.mod = Sse41::Mod;
+			kernels.bit_or = Sse41::BitOr;
+			kernels.bit_and = Sse41::BitAnd;
+			kernels.bit_xor = Sse41::BitXor;
+			kernels.bit_shift_left = Sse41::BitShiftLeft;
+			kernels.bit_shift_right = Sse41::BitShiftRight;
+#endif
+			break;
+		case Variant::Avx2:
+#ifdef EP_SIMD_AVX2
+			kernels.offset = Avx2::Offset;
+			kernels.mult = Avx2::Mult;
+			kernels.div = Avx2::Div;
+			kernels.mod = Avx2::Mod;
+			kernels.bit_or = Avx2::BitOr;
+			kernels.bit_and = Avx2::BitAnd;
+			kernels.bit_xor = Avx2::BitXor;
+			kernels.bit_shift_left = Avx2::BitShiftLeft;
+			kernels.bit_shift_right = Avx2::BitShiftRight;
+#endif
+			break;
+	}
+
+	return kernels;
+}
+
+Kernels& ActiveKernels() {
+	static Kernels kernels = MakeKernels(VariableKernels::GetDefaultVariant());
+	return kernels;
+}
+
+/** Adds offset to every variable, offset is the operand of Add or the negated operand of Sub */
+void ApplyOffset(const Kernels& kernels, int32_t* vars, int count, int64_t offset, Params p) {
+	const int64_t lo = p.minval - offset;
+	const int64_t hi = p.maxval - offset;
+	if (hi < int32_min) {
+		std::fill(vars, vars + count, p.maxval);
+		return;
+	}
+	if (lo > int32_max) {
+		std::fill(vars, vars + count, p.minval);
+		return;
+	}
+
+	p.lo = static_cast<int32_t>(std::max(lo, int32_min));
+	p.hi = static_cast<int32_t>(std::min(hi, int32_max));
+	// The result is in [minval, maxval], a wrapping addition is exact
+	p.value = static_cast<int32_t>(static_cast<uint32_t>(offset));
+	kernels.offset(vars, count, p);
+}
+
+void ApplyMult(const Kernels& kernels, int32_t* vars, int count, Params p) {
+	const int64_t factor = p.value;
+	if (factor == 0) {
+		std::fill(vars, vars + count, Clamp(0, p.minval, p.maxval));
+		return;
+	}
+
+	int64_t lo, hi;
+	if (factor > 0) {
+		lo = CeilDiv(p.minval, factor);
+		hi = FloorDiv(p.maxval, factor);
+		p.below = p.minval;
+		p.above = p.maxval;
+	} else {
+		lo = CeilDiv(p.maxval, factor);
+		hi = FloorDiv(p.minval, factor);
+		p.below = p.maxval;
+		p.above = p.minval;
+	}
+	// Only hi can leave the 32 bit range (INT32_MIN / -1)
+	p.lo = static_cast<int32_t>(lo);
+	p.hi = static_cast<int32_t>(std::min(hi, int32_max));
+	kernels.mult(vars, count, p);
+}
+
+} // anonymous namespace
+
+void VariableKernels::Apply(int32_t* vars, int count, Op op, int32_t value, int32_t minval, int32_t maxval) {
+	if (count <= 0) {
+		return;
+	}
+
+	const auto& kernels = ActiveKernels();
+
+	Params p;
+	p.value = value;
+	p.minval = minval;
+	p.maxval = maxval;
+
+	switch (op) {
+		case Op::Set:
+			std::fill(vars, vars + count, Clamp(value, minval, maxval));
+			break;
+		case Op::Add:
+			ApplyOffset(kernels, vars, count, value, p);
+			break;
+		case Op::Sub:
+			ApplyOffset(kernels, vars, count, -int64_t(value), p);
+			break;
+		case Op::Mult:
+			ApplyMult(kernels, vars, count, p);
+			break;
+		case Op::Div:
+			if (value == 0) {
+				ApplyOffset(kernels, vars, count, 0, p);
+			} else {
+				kernels.div(vars, count, p);
+			}
+			break;
+		case Op::Mod:
+			if (value == 0) {
+				std::fill(vars, vars + count, Clamp(0, minval, maxval));
+			} else {
+				kernels.mod(vars, count, p);
+			}
+			break;
+		case Op::BitOr:
+			kernels.bit_or(vars, count, p);
+			break;
+		case Op::BitAnd:
+			kernels.bit_and(vars, count, p);
+			break;
+		case Op::BitXor:
+			kernels.bit_xor(vars, count, p);
+			break;
+		case Op::BitShiftLeft:
+			p.value = value & 31;
+			kernels.bit_shift_left(vars, count, p);
+			break;
+		case Op::BitShiftRight:
+			p.value = value & 31;
+			kernels.bit_shift_right(vars, count, p);
+			break;
+	}
+}
+
+bool VariableKernels::IsSupported(Variant variant) {
+	switch (variant) {
+		case Variant::Scalar:
+			return true;
+		case Variant::Sse41:
+#ifdef EP_SIMD_SSE41
+			return CpuFeatures::HasSse41();
+#else
+			return false;
+#endif
+		case Variant::Avx2:
+#ifdef EP_SIMD_AVX2
+			return CpuFeatures::HasAvx2();
+#else
+			return false;
+#endif
+	}
+
+	return false;
+}
+
+bool VariableKernels::SetVariant(Variant variant) {
+	if (!IsSupported(variant)) {
+		return false;
+	}
+
+	ActiveKernels() = MakeKernels(variant);
+	return true;
+}
+
+Variant VariableKernels::GetVariant() {
+	return ActiveKernels().variant;
+}
+
+Variant VariableKernels::GetDefaultVariant() {
+	for (auto variant: { Variant::Avx2, Variant::Sse41 }) {
+		if (IsSupported(variant)) {
+			return variant;
+		}
+	}
+	return Variant::Scalar;
+}
+
+const char* VariableKernels::GetVariantName(Variant variant) {
+	switch (variant) {
+		case Variant::Scalar:
+			return "Scalar";
+		case Variant::Sse41:
+			return "SSE4.1";
+		case Variant::Avx2:
+			return "AVX2";
+	}
+
+	return "Unknown";
+}
@@ -0,0 +1,99 @@
+/*
+ * This file is part of EasyRPG Player.
+ *
+ * EasyRPG Player is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * EasyRPG Player is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with EasyRPG Player. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef EP_VARIABLE_KERNELS_H
+#define EP_VARIABLE_KERNELS_H
+
+// Headers
+#include <cstdint>
+
+/**
+ * Range operations of Game_Variables with a constant operand.
+ *
+ * Every kernel exists as a scalar reference and in SIMD variants that
+ * produce identical results. The fastest variant supported by the CPU is
+ * selected on startup.
+ */
+namespace VariableKernels {
+	/** Implementations of the kernels */
+	enum class Variant {
+		Scalar,
+		Sse41,
+		Avx2
+	};
+
+	/** Operation applied to every variable */
+	enum class Op {
+		Set,
+		Add,
+		Sub,
+		Mult,
+		Div,
+		Mod,
+		BitOr,
+		BitAnd,
+		BitXor,
+		BitShiftLeft,
+		BitShiftRight
+	};
+
+	/**
+	 * Applies an operation with a constant operand to a span of variables
+	 * and clamps the results to [minval, maxval].
+	 *
+	 * Add, Sub and Mult saturate instead of overflowing. Division by 0 keeps
+	 * the variable, modulo by 0 results in 0. The shift amount is taken
+	 * modulo 32.
+	 *
+	 * @param vars variables to modify
+	 * @param count number of variables
+	 * @param op operation
+	 * @param value operand
+	 * @param minval lower limit of the variables
+	 * @param maxval upper limit of the variables
+	 */
+	void Apply(int32_t* vars, int count, Op op, int32_t value, int32_t minval, int32_t maxval);
+
+	/**
+	 * @param variant kernel variant
+	 * @return Whether the variant is compiled in and supported by the CPU
+	 */
+	bool IsSupported(Variant variant);
+
+	/**
+	 * Selects the kernels used by Apply.
+	 * Intended for tests and benchmarks.
+	 *
+	 * @param variant kernel variant
+	 * @return false when the variant is not supported, the selection is unchanged
+	 */
+	bool SetVariant(Variant variant);
+
+	/** @return Currently selected variant */
+	Variant GetVariant();
+
+	/** @return Best variant supported by the CPU */
+	Variant GetDefaultVariant();
+
+	/**
+	 * @param variant kernel variant
+	 * @return Human readable name of the variant
+	 */
+	const char* GetVariantName(Variant variant);
+}
+
+#endif
@@ -17,10 +17,118 @@
 
 // Headers
 #include "window_gamelist.h"
+#include <memory>
+#include <future>
+#include <lcf/inireader.h>
+#include <lcf/reader_util.h>
 #include "filefinder.h"
+#include "filesystem_native.h"
 #include "bitmap.h"
 #include "font.h"
+#include "game_config.h"
+#include "game_index.h"
+#include "options.h"
+#include "output.h"
 #include "system.h"
+#include "thread_pool.h"
+
+#ifndef USE_CUSTOM_FILEBUF
+namespace {
+	/** @return GameTitle of the RPG_RT.ini converted to UTF-8, empty when not available */
+	std::string ReadGameTitle(const FilesystemView& fs) {
+		auto is = fs.OpenInputStream(fs.FindFile(INI_NAME), std::ios_base::in);
+		if (!is) {
+			return {};
+		}
+
+		lcf::INIReader ini(is);
+		if (ini.ParseError() == -1) {
+			return {};
+		}
+
+		auto title = ini.Get("RPG_RT", "GameTitle", "");
+		auto encodings = lcf::ReaderUtil::DetectEncodings(title);
+		if (title.empty() || encodings.empty()) {
+			return title;
+		}
+		return lcf::ReaderUtil::Recode(title, encodings.front());
+	}
+
+	/** Determines project type and title of a game directory or archive */
+	void ProbeGame(const FilesystemView& base_fs, FileFinder::GameEntry& ge) {
+		auto fs = base_fs.Create(ge.dir_name);
+		ge.type = FileFinder::GetProjectType(fs);
+		if (ge.type == FileFinder::ProjectType::Supported) {
+			ge.title = ReadGameTitle(fs);
+		}
+	}
+
+	/**
+	 * Probes all games of a directory.
+	 * For native directories the results are cached in the game index and
+	 * the changed games are probed by the worker threads.
+	 */
+	void ProbeGames(const FilesystemView& base_fs, std::vector<FileFinder::GameEntry>& game_entries) {
+		if (dynamic_cast<const NativeFilesystem*>(&base_fs.GetOwner()) == nullptr) {
+			for (auto& ge: game_entries) {
+				ProbeGame(base_fs, ge);
+			}
+			return;
+		}
+
+		auto config_fs = Game_Config::GetGlobalConfigFilesystem();
+		auto index = config_fs ? GameIndex::Load(config_fs) : GameIndex();
+		const auto dir = base_fs.GetFullPath();
+
+		std::vector<GameIndex::Entry> stats(game_entries.size());
+		std::vector<char> probed(game_entries.size(), 0);
+		std::vector<std::shared_future<void>> jobs;
+
+		for (size_t i = 0; i < game_entries.size(); ++i) {
+			auto& ge = game_entries[i];
+			stats[i].size = base_fs.GetFilesize(ge.dir_name);
+			stats[i].mtime = base_fs.GetModificationTime(ge.dir_name);
+
+			if (const auto* entry = index.Find(dir, ge.dir_name, stats[i].size, stats[i].mtime)) {
+				ge.type = entry->type;
+				ge.title = entry->title;
+				continue;
+			}
+
+			// The directory cache of a filesystem is not thread-safe:
+			// Every job opens the directory again
+			jobs.push_back(ThreadPool::Global().Submit([&dir, &ge, done = &probed[i]]() {
+				auto fs = std::make_shared<NativeFilesystem>("", FilesystemView());
+				ProbeGame(fs->Subtree(dir), ge);
+				*done = 1;
+			}));
+		}
+
+		for (auto& job: jobs) {
+			job.wait();
+		}
+
+		std::vector<std::string> names;
+		names.reserve(game_entries.size());
+		for (size_t i = 0; i < game_entries.size(); ++i) {
+			const auto& ge = game_entries[i];
+			names.push_back(ge.dir_name);
+			if (probed[i]) {
+				stats[i].type = ge.type;
+				stats[i].title = ge.title;
+				index.Update(dir, ge.dir_name, std::move(stats[i]));
+			}
+		}
+		index.Retain(dir, names);
+
+		Output::Debug("GameBrowser: Probed {} of {} games in {}", jobs.size(), game_entries.size(), dir);
+
+		if (config_fs && index.IsModified()) {
+			index.Save(config_fs);
+		}
+	}
+}
+#endif
 
 Window_GameList::Window_GameList(int ix, int iy, int iwidth, int iheight) :
 	Window_Selectable(ix, iy, iwidth, iheight) {
@@ -65,25 +173,19 @@ bool Window_GameList::Refresh(FilesystemView filesystem_base, bool show_dotdot)
 		}
 		if (dir.second.type == DirectoryTree::FileType::Regular) {
 			if (FileFinder::IsSupportedArchiveExtension(dir.second.name)) {
-				// The type is only determined on platforms with fast file IO (Windows and UNIX systems)
-				// A platform is considered "fast" when it does not require our custom IO buffer
-#ifndef USE_CUSTOM_FILEBUF
-				auto fs = base_fs.Create(dir.second.name);
-				game_entries.push_back({ dir.second.name, FileFinder::GetProjectType(fs) });
-#else
 				game_entries.push_back({ dir.second.name, FileFinder::ProjectType::Unknown });
-#endif
 			}
 		} else if (dir.second.type == DirectoryTree::FileType::Directory) {
-#ifndef USE_CUSTOM_FILEBUF
-			auto fs = base_fs.Create(dir.second.name);
-			game_entries.push_back({ dir.second.name, FileFinder::GetProjectType(fs) });
-#else
 			game_entries.push_back({ dir.second.name, FileFinder::ProjectType::Unknown });
-#endif
 		}
 	}
 
+	// The type is only determined on platforms with fast file IO (Windows and UNIX systems)
+	// A platform is considered "fast" when it does not require our custom IO buffer
+#ifndef USE_CUSTOM_FILEBUF
+	ProbeGames(base_fs, game_entries);
+#endif
+
 	// Sort game list in place
 	std::sort(game_entries.begin(), game_entries.end(),
 			  [](const FileFinder::GameEntry &ge1, const FileFinder::GameEntry &ge2) {
@@ -452,6 +452,7 @@ void Window_Settings::RefreshEngine() {
 		GetFrame().options.back().help2 = fmt::format("Sample name: {}", fmt_sample_name(true));
 	}
 	AddOption(cfg.automatic_screenshots_interval, [this, &cfg]() { cfg.automatic_screenshots_interval.Set(GetCurrentOption().current_value); });
+	AddOption(cfg.preload_maps, [&cfg]() { cfg.preload_maps.Toggle(); });
 }
 
 void Window_Settings::RefreshEngineFont(bool mincho) {
@@ -0,0 +1,130 @@
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include "audio_mixer.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("AudioMixer");
+
+namespace {
+
+using Format = AudioMixer::Format;
+
+template <typename T>
+std::vector<T> MakeSamples(int count, uint32_t seed) {
+	std::vector<T> samples(count);
+	for (auto& s: samples) {
+		seed = seed * 1103515245u + 12345u;
+		s = static_cast<T>(seed >> 7);
+	}
+	return samples;
+}
+
+std::vector<float> MakeFloatSamples(int count, uint32_t seed) {
+	std::vector<float> samples(count);
+	for (auto& s: samples) {
+		seed = seed * 1103515245u + 12345u;
+		s = static_cast<float>(seed >> 8) / static_cast<float>(1 << 23) - 1.0f;
+	}
+	return samples;
+}
+
+void CheckMix(const void* src, Format format, int channels, int frames) {
+	std::vector<float> expected(frames * 2, 0.25f);
+	std::vector<float> actual = expected;
+
+	AudioMixer::Scalar::Mix(expected.data(), src, format, channels, frames, 0.7f, 0.3f);
+	AudioMixer::Mix(actual.data(), src, format, channels, frames, 0.7f, 0.3f);
+
+	for (std::size_t i = 0; i < expected.size(); ++i) {
+		REQUIRE_EQ(actual[i], doctest::Approx(expected[i]).epsilon(1e-6));
+	}
+}
+
+template <typename T>
+void CheckMixFormat(Format format) {
+	// Odd frame counts test the scalar tail
+	for (int channels: { 1, 2, 3 }) {
+		for (int frames: { 0, 1, 7, 64, 1021 }) {
+			auto samples = MakeSamples<T>(frames * channels, frames + channels);
+			CheckMix(samples.data(), format, channels, frames);
+		}
+	}
+}
+
+}
+
+TEST_CASE("MixIntegerFormats") {
+	CheckMixFormat<int8_t>(Format::S8);
+	CheckMixFormat<uint8_t>(Format::U8);
+	CheckMixFormat<int16_t>(Format::S16);
+	CheckMixFormat<uint16_t>(Format::U16);
+	CheckMixFormat<int32_t>(Format::S32);
+	CheckMixFormat<uint32_t>(Format::U32);
+}
+
+TEST_CASE("MixFloat") {
+	for (int channels: { 1, 2 }) {
+		auto samples = MakeFloatSamples(333 * channels, channels);
+		CheckMix(samples.data(), Format::F32, channels, 333);
+	}
+}
+
+TEST_CASE("MixConversion") {
+	std::vector<float> out(4, 0.0f);
+
+	const int16_t s16[] = { -32768, 16384 };
+	AudioMixer::Mix(out.data(), s16, Format::S16, 2, 1, 1.0f, 0.5f);
+	REQUIRE_EQ(out[0], -1.0f);
+	REQUIRE_EQ(out[1], 0.25f);
+
+	const uint16_t u16[] = { 0, 49152 };
+	AudioMixer::Mix(out.data(), u16, Format::U16, 1, 2, 1.0f, 1.0f);
+	REQUIRE_EQ(out[0], -2.0f);
+	REQUIRE_EQ(out[1], -0.75f);
+	REQUIRE_EQ(out[2], 0.5f);
+	REQUIRE_EQ(out[3], 0.5f);
+}
+
+TEST_CASE("ClipAndPack") {
+	for (float total_volume: { 0.5f, 1.0f, 3.0f, 32.0f }) {
+		auto samples = MakeFloatSamples(1003, 42);
+		for (auto& s: samples) {
+			s *= total_volume;
+		}
+
+		std::vector<int16_t> expected(samples.size());
+		std::vector<int16_t> actual(samples.size());
+		AudioMixer::Scalar::ClipAndPack(expected.data(), samples.data(), samples.size(), total_volume);
+		AudioMixer::ClipAndPack(actual.data(), samples.data(), samples.size(), total_volume);
+
+		for (std::size_t i = 0; i < expected.size(); ++i) {
+			REQUIRE(std::abs(actual[i] - expected[i]) <= 1);
+		}
+	}
+}
+
+TEST_CASE("ClipAndPackSaturates") {
+	const float samples[] = { 2.0f, -2.0f, 1.0f, -1.0f, 0.5f, -0.5f, 0.0f, -0.0f, 4.0f };
+	int16_t out[9];
+
+	AudioMixer::ClipAndPack(out, samples, 9, 1.0f);
+	REQUIRE_EQ(out[0], 32767);
+	REQUIRE_EQ(out[1], -32767);
+	REQUIRE_EQ(out[2], 32767);
+	REQUIRE_EQ(out[3], -32767);
+	REQUIRE_EQ(out[4], 16384);
+	REQUIRE_EQ(out[5], -16384);
+	REQUIRE_EQ(out[6], 0);
+	REQUIRE_EQ(out[7], 0);
+	REQUIRE_EQ(out[8], 32767);
+
+	// Compressed samples never exceed the range
+	AudioMixer::ClipAndPack(out, samples, 9, 4.0f);
+	REQUIRE_EQ(out[8], 32767);
+	REQUIRE(out[0] < 32767);
+	REQUIRE(out[0] > 16384);
+	REQUIRE_EQ(out[0], -out[1]);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,133 @@
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "audio_secache.h"
+#include "filesystem_stream.h"
+#include "doctest.h"
+
+#ifdef WANT_DRWAV
+
+TEST_SUITE_BEGIN("AudioSeCache");
+
+namespace {
+
+/** Creates a stream to a 16 bit mono WAV file */
+Filesystem_Stream::InputStream MakeWav(std::string name, int frames) {
+	std::vector<uint8_t> wav;
+	auto put_str = [&](const char* s) { wav.insert(wav.end(), s, s + 4); };
+	auto put_u32 = [&](uint32_t v) { for (int i = 0; i < 4; ++i) wav.push_back((v >> (8 * i)) & 0xFF); };
+	auto put_u16 = [&](uint16_t v) { wav.push_back(v & 0xFF); wav.push_back(v >> 8); };
+
+	const uint32_t data_size = frames * 2;
+	put_str("RIFF");
+	put_u32(36 + data_size);
+	put_str("WAVE");
+	put_str("fmt ");
+	put_u32(16);
+	put_u16(1); // PCM
+	put_u16(1); // channels
+	put_u32(11025);
+	put_u32(11025 * 2);
+	put_u16(2);
+	put_u16(16);
+	put_str("data");
+	put_u32(data_size);
+	for (int i = 0; i < frames; ++i) {
+		put_u16(static_cast<uint16_t>(i * 37));
+	}
+
+	return Filesystem_Stream::InputStream(new Filesystem_Stream::InputMemoryStreamBuf(std::move(wav)), std::move(name));
+}
+
+/** Decodes a SE into the cache like playing it does */
+void Play(const std::string& name, int frames) {
+	auto se = AudioSeCache::GetCachedSe(name);
+	if (!se) {
+		se = AudioSeCache::Create(MakeWav(name, frames), name);
+	}
+	REQUIRE(se);
+	REQUIRE(se->CreateSeDecoder());
+}
+
+/** Restores the memory limit and empties the cache */
+struct CacheGuard {
+	CacheGuard() : limit(AudioSeCache::GetMemoryLimit()) { AudioSeCache::Clear(); }
+	~CacheGuard() { AudioSeCache::SetMemoryLimit(limit); AudioSeCache::Clear(); }
+	size_t limit;
+};
+
+}
+
+TEST_CASE("Cache") {
+	CacheGuard guard;
+
+	REQUIRE_FALSE(AudioSeCache::GetCachedSe("a"));
+	Play("a", 1000);
+	REQUIRE(AudioSeCache::GetCachedSe("a"));
+	REQUIRE_EQ(AudioSeCache::GetMemoryUsage(), 2000);
+
+	int frequency = 0;
+	int channels = 0;
+	AudioDecoder::Format format;
+	REQUIRE(AudioSeCache::GetCachedSe("a")->GetCachedFormat(frequency, format, channels));
+	REQUIRE_EQ(frequency, 11025);
+	REQUIRE_EQ(channels, 1);
+
+	AudioSeCache::Clear();
+	REQUIRE_FALSE(AudioSeCache::GetCachedSe("a"));
+	REQUIRE_EQ(AudioSeCache::GetMemoryUsage(), 0);
+}
+
+TEST_CASE("EvictLeastRecentlyUsed") {
+	CacheGuard guard;
+	AudioSeCache::SetMemoryLimit(5000);
+
+	Play("a", 1000);
+	Play("b", 1000);
+	Play("a", 1000);
+	Play("c", 1000);
+
+	// b was used least recently
+	REQUIRE(AudioSeCache::GetCachedSe("a"));
+	REQUIRE_FALSE(AudioSeCache::GetCachedSe("b"));
+	REQUIRE(AudioSeCache::GetCachedSe("c"));
+	REQUIRE_EQ(AudioSeCache::GetMemoryUsage(), 4000);
+
+	AudioSeCache::SetMemoryLimit(2000);
+	REQUIRE_FALSE(AudioSeCache::GetCachedSe("a"));
+	REQUIRE(AudioSeCache::GetCachedSe("c"));
+}
+
+TEST_CASE("KeepPlaying") {
+	CacheGuard guard;
+
+	Play("a", 1000);
+	auto decoder = AudioSeCache::GetCachedSe("a")->CreateSeDecoder();
+
+	AudioSeCache::SetMemoryLimit(0);
+	REQUIRE(AudioSeCache::GetCachedSe("a"));
+
+	decoder.reset();
+	Play("b", 1000);
+	REQUIRE_FALSE(AudioSeCache::GetCachedSe("a"));
+}
+
+TEST_CASE("Prefetch") {
+	CacheGuard guard;
+
+	auto done = AudioSeCache::Prefetch(MakeWav("a", 1000), "a");
+	REQUIRE(done.valid());
+	done.wait();
+
+	auto se = AudioSeCache::GetCachedSe("a");
+	REQUIRE(se);
+	REQUIRE_EQ(se->GetSeData()->buffer.size(), 2000);
+
+	// Already cached
+	REQUIRE_FALSE(AudioSeCache::Prefetch(MakeWav("a", 1000), "a").valid());
+	REQUIRE_FALSE(AudioSeCache::Prefetch(Filesystem_Stream::InputStream(), "b").valid());
+}
+
+TEST_SUITE_END();
+
+#endif
@@ -0,0 +1,62 @@
+#include "bitmap.h"
+#include "cache.h"
+#include "color.h"
+#include "rect.h"
+#include "tone.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Cache");
+
+TEST_CASE("SpriteEffect") {
+	Cache::Clear();
+
+	auto src = Bitmap::Create(16, 16, true);
+	src->SetId("Test/SpriteEffect");
+	const Rect rect(0, 0, 8, 8);
+	const Tone tone(100, 128, 128, 128);
+
+	const auto hits = Cache::GetSpriteEffectHits();
+	const auto misses = Cache::GetSpriteEffectMisses();
+
+	auto effect = Cache::SpriteEffect(src, rect, true, false, tone, Color());
+	REQUIRE(effect);
+	REQUIRE_EQ(effect->GetWidth(), 8);
+	REQUIRE_EQ(Cache::GetSpriteEffectMisses(), misses + 1);
+
+	REQUIRE_EQ(Cache::SpriteEffect(src, rect, true, false, tone, Color()), effect);
+	REQUIRE_EQ(Cache::GetSpriteEffectHits(), hits + 1);
+
+	// Bitmaps with the same ID share their effects
+	auto same_id = Bitmap::Create(16, 16, true);
+	same_id->SetId("Test/SpriteEffect");
+	REQUIRE_EQ(Cache::SpriteEffect(same_id, rect, true, false, tone, Color()), effect);
+
+	REQUIRE_NE(Cache::SpriteEffect(src, rect, false, true, tone, Color()), effect);
+	REQUIRE_NE(Cache::SpriteEffect(src, rect, true, false, Tone(), Color(255, 0, 0, 128)), effect);
+	REQUIRE_EQ(Cache::GetSpriteEffectMisses(), misses + 3);
+
+	// Expired effects are created again
+	effect.reset();
+	REQUIRE(Cache::SpriteEffect(src, rect, true, false, tone, Color()));
+	REQUIRE_EQ(Cache::GetSpriteEffectMisses(), misses + 4);
+
+	Cache::Clear();
+	REQUIRE_EQ(Cache::GetSpriteEffectCacheSize(), 0);
+}
+
+TEST_CASE("SpriteEffectPrune") {
+	Cache::Clear();
+
+	auto src = Bitmap::Create(16, 16, true);
+	src->SetId("Test/SpriteEffectPrune");
+
+	// A fade creates a new effect every frame, the old ones expire
+	for (int i = 0; i < 5000; ++i) {
+		Cache::SpriteEffect(src, Rect(0, 0, 4, 4), false, false, Tone(i % 256, i / 256, 128, 128), Color());
+	}
+	REQUIRE_LE(Cache::GetSpriteEffectCacheSize(), 2048);
+
+	Cache::Clear();
+}
+
+TEST_SUITE_END();
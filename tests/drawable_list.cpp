@@ -1,5 +1,8 @@
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <memory>
+#include <vector>
 #include "utils.h"
 #include "drawable_list.h"
 #include "drawable_mgr.h"
@@ -260,6 +263,76 @@ TEST_CASE("TakeNotSorted") {
 	REQUIRE(list.IsSorted());
 }
 
+TEST_CASE("TakeKeepsOrder") {
+	DrawableList default_list;
+	DrawableMgr::SetLocalList(&default_list);
+
+	DrawableList list;
+
+	std::vector<std::unique_ptr<TestSprite>> sprites;
+	for (int i = 0; i < 10; ++i) {
+		sprites.push_back(std::make_unique<TestSprite>(i / 3));
+		list.Append(sprites.back().get());
+	}
+
+	REQUIRE_EQ(list.Take(sprites[4].get()), sprites[4].get());
+	REQUIRE_EQ(list.Take(sprites[4].get()), nullptr);
+	REQUIRE_EQ(list.Take(sprites[0].get()), sprites[0].get());
+	REQUIRE_EQ(list.Take(sprites[9].get()), sprites[9].get());
+	REQUIRE_EQ(list.Take(sprites[8].get()), sprites[8].get());
+
+	REQUIRE_EQ(list.size(), 6L);
+	REQUIRE_FALSE(list.IsDirty());
+	REQUIRE(list.IsSorted());
+
+	std::vector<Drawable*> expected = { sprites[1].get(), sprites[2].get(), sprites[3].get(),
+		sprites[5].get(), sprites[6].get(), sprites[7].get() };
+	REQUIRE(std::vector<Drawable*>(list.begin(), list.end()) == expected);
+
+	// Positions are still valid after compacting
+	REQUIRE_EQ(list.Take(sprites[6].get()), sprites[6].get());
+	REQUIRE_EQ(list.size(), 5L);
+	REQUIRE_EQ(list[4], sprites[7].get());
+}
+
+TEST_CASE("UpdateZ") {
+	DrawableList list;
+	DrawableMgr::SetLocalList(&list);
+
+	std::vector<std::unique_ptr<TestSprite>> sprites;
+	for (int i = 0; i < 64; ++i) {
+		sprites.push_back(std::make_unique<TestSprite>(i % 8));
+		list.Append(sprites.back().get());
+	}
+	list.Sort();
+
+	// Each move must give the same order as a full stable sort
+	uint32_t seed = 1;
+	for (int i = 0; i < 500; ++i) {
+		std::vector<Drawable*> expected(list.begin(), list.end());
+
+		if (i % 50 == 0) {
+			// Leave a hole in the list, the replacement is not in the list
+			auto& removed = sprites[(i * 7) % sprites.size()];
+			auto iter = std::find(expected.begin(), expected.end(), removed.get());
+			if (iter != expected.end()) {
+				expected.erase(iter);
+			}
+			removed = std::make_unique<TestSprite>(0);
+		}
+
+		seed = seed * 1103515245u + 12345u;
+		sprites[(seed >> 8) % sprites.size()]->SetZ((seed >> 16) % 10);
+		std::stable_sort(expected.begin(), expected.end(), [](auto* l, auto* r) { return l->GetZ() < r->GetZ(); });
+
+		REQUIRE_FALSE(list.IsDirty());
+		REQUIRE(std::vector<Drawable*>(list.begin(), list.end()) == expected);
+	}
+
+	sprites.clear();
+	DrawableMgr::SetLocalList(nullptr);
+}
+
 TEST_CASE("TakeFromAll") {
 	DrawableList default_list;
 	DrawableMgr::SetLocalList(&default_list);
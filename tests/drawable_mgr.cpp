@@ -45,8 +45,10 @@ TEST_CASE("Drawables") {
 
 	REQUIRE_FALSE(list.IsDirty());
 
+	// The drawable is moved, the list stays sorted
 	local->SetZ(10);
-	REQUIRE(list.IsDirty());
+	REQUIRE_FALSE(list.IsDirty());
+	REQUIRE(list.IsSorted());
 
 	REQUIRE_EQ(list.size(), 1L);
 	REQUIRE_EQ(*list.begin(), local.get());
@@ -3,6 +3,7 @@
 #include "main_data.h"
 #include "doctest.h"
 #include "player.h"
+#include <vector>
 
 #define ZIP_PATH EP_TEST_PATH "/filesystem/test.zip"
 #define ZIP_FOLDER_PATH EP_TEST_PATH "/filesystem/folder.zip"
@@ -60,6 +61,50 @@ TEST_CASE("File reading") {
 	CHECK(line_out == "lo");
 }
 
+TEST_CASE("Streamed file reading") {
+	auto fs = FileFinder::Root().Create(ZIP_PATH);
+	auto is = fs.OpenInputStream("200kb");
+	REQUIRE(is);
+	CHECK(is.GetSize() == 200 * 1024);
+
+	auto expected = [](int pos) {
+		return static_cast<uint8_t>(pos % 251);
+	};
+
+	std::vector<uint8_t> data(200 * 1024);
+	is.read(reinterpret_cast<char*>(data.data()), data.size());
+	CHECK(is.gcount() == static_cast<std::streamsize>(data.size()));
+	bool equal = true;
+	for (int i = 0; i < static_cast<int>(data.size()); ++i) {
+		equal &= data[i] == expected(i);
+	}
+	CHECK(equal);
+
+	// Seeking backwards out of the inflate window
+	for (int pos: {150000, 10, 199999, 70000, 0}) {
+		is.clear();
+		is.seekg(pos);
+		CHECK(is.tellg() == pos);
+		CHECK(is.get() == expected(pos));
+	}
+}
+
+TEST_CASE("Concurrent file reading") {
+	auto fs = FileFinder::Root().Create(ZIP_PATH);
+	auto is1 = fs.OpenInputStream("200kb");
+	auto is2 = fs.OpenInputStream("text");
+	REQUIRE(is1);
+	REQUIRE(is2);
+
+	std::string line_out;
+	is1.seekg(1000);
+	CHECK(Utils::ReadLine(is2, line_out));
+	CHECK(line_out == "hello");
+	CHECK(is1.get() == 1000 % 251);
+	CHECK(Utils::ReadLine(is2, line_out));
+	CHECK(line_out == "World");
+}
+
 TEST_CASE("File IO error") {
 	auto fs = FileFinder::Root().Create(ZIP_PATH);
 	CHECK(!fs.OpenInputStream("game"));
@@ -3,6 +3,8 @@
 #include "cache.h"
 #include "bitmap.h"
 #include "font.h"
+#include "glyph_cache.h"
+#include <algorithm>
 #include <iostream>
 #include "doctest.h"
 
@@ -104,4 +106,61 @@ TEST_CASE("FontGlyphCharEx") {
 	}
 }
 
+TEST_CASE("FontGlyphCache") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto font = Font::Default();
+	auto system = Cache::SysBlack();
+	const std::string text = "Xyz ぽ下";
+
+	font->ClearGlyphCache();
+
+	// Cold cache
+	auto surface_cold = Bitmap::Create(width, height);
+	Text::Draw(*surface_cold, 0, 0, *font, *system, 0, text);
+
+	// Warm cache, pixels must be identical
+	auto surface_warm = Bitmap::Create(width, height);
+	Text::Draw(*surface_warm, 0, 0, *font, *system, 0, text);
+
+	auto* cold = reinterpret_cast<uint32_t*>(surface_cold->pixels());
+	auto* warm = reinterpret_cast<uint32_t*>(surface_warm->pixels());
+	REQUIRE(std::equal(cold, cold + width * height, warm));
+}
+
+TEST_CASE("GlyphCacheEviction") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+	auto glyph_bm = Bitmap::Create(GlyphCache::page_size, GlyphCache::page_size / 2);
+
+	// Room for exactly 2 glyphs
+	GlyphCache cache(false, GlyphCache::page_size * GlyphCache::page_size * 4);
+
+	auto insert = [&](char32_t code) {
+		Font::GlyphRet gret;
+		gret.bitmap = glyph_bm;
+		gret.rect = glyph_bm->GetRect();
+		return cache.Insert(code, 12, false, gret);
+	};
+
+	auto a = insert('a');
+	REQUIRE(a.bitmap != glyph_bm);
+	REQUIRE_EQ(a.rect, Rect(0, 0, GlyphCache::page_size, GlyphCache::page_size / 2));
+
+	insert('b');
+	REQUIRE_EQ(cache.GetGlyphCount(), 2);
+	REQUIRE(cache.Find('a', 12, false) != nullptr);
+	REQUIRE(cache.Find('a', 12, true) == nullptr);
+	REQUIRE(cache.Find('a', 16, false) == nullptr);
+
+	// Page is full, the least recently used page is evicted
+	insert('c');
+	REQUIRE_EQ(cache.GetGlyphCount(), 1);
+	REQUIRE(cache.Find('a', 12, false) == nullptr);
+	REQUIRE(cache.Find('c', 12, false) != nullptr);
+	REQUIRE_EQ(cache.GetMemoryUsage(), GlyphCache::page_size * GlyphCache::page_size * 4);
+
+	cache.Clear();
+	REQUIRE_EQ(cache.GetGlyphCount(), 0);
+	REQUIRE_EQ(cache.GetMemoryUsage(), 0);
+}
+
 TEST_SUITE_END();
@@ -0,0 +1,107 @@
+#include <sstream>
+#include "game_index.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("GameIndex");
+
+namespace {
+	GameIndex::Entry MakeEntry(int64_t size, int64_t mtime, FileFinder::ProjectType type, std::string title) {
+		GameIndex::Entry entry;
+		entry.size = size;
+		entry.mtime = mtime;
+		entry.type = type;
+		entry.title = std::move(title);
+		return entry;
+	}
+}
+
+TEST_CASE("Find") {
+	GameIndex index;
+	CHECK(!index.IsModified());
+	CHECK(index.Find("/games", "a.zip", 100, 200) == nullptr);
+
+	index.Update("/games", "a.zip", MakeEntry(100, 200, FileFinder::ProjectType::Supported, "A"));
+	CHECK(index.IsModified());
+
+	auto* entry = index.Find("/games", "a.zip", 100, 200);
+	REQUIRE(entry != nullptr);
+	CHECK_EQ(entry->type, FileFinder::ProjectType::Supported);
+	CHECK_EQ(entry->title, "A");
+
+	// Stale entries
+	CHECK(index.Find("/games", "a.zip", 101, 200) == nullptr);
+	CHECK(index.Find("/games", "a.zip", 100, 201) == nullptr);
+	CHECK(index.Find("/games", "b.zip", 100, 200) == nullptr);
+	CHECK(index.Find("/other", "a.zip", 100, 200) == nullptr);
+
+	// Unknown modification time
+	CHECK(index.Find("/games", "a.zip", 100, -1) == nullptr);
+	index.Update("/games", "a.zip", MakeEntry(100, -1, FileFinder::ProjectType::Supported, "A"));
+	CHECK(index.Find("/games", "a.zip", 100, 200) == nullptr);
+	CHECK_EQ(index.GetSize(), 0);
+}
+
+TEST_CASE("Retain") {
+	GameIndex index;
+	index.Update("/games", "a.zip", MakeEntry(1, 1, FileFinder::ProjectType::Supported, ""));
+	index.Update("/games", "b", MakeEntry(2, 2, FileFinder::ProjectType::RpgMakerXp, ""));
+	index.Update("/other", "c", MakeEntry(3, 3, FileFinder::ProjectType::Unknown, ""));
+
+	std::stringstream ss;
+	index.Write(ss);
+	REQUIRE(index.Read(ss));
+	CHECK(!index.IsModified());
+	CHECK_EQ(index.GetSize(), 3);
+
+	index.Retain("/games", { "a.zip", "b", "d" });
+	CHECK(!index.IsModified());
+
+	index.Retain("/games", { "b" });
+	CHECK(index.IsModified());
+	CHECK(index.Find("/games", "a.zip", 1, 1) == nullptr);
+	CHECK(index.Find("/games", "b", 2, 2) != nullptr);
+	CHECK(index.Find("/other", "c", 3, 3) != nullptr);
+}
+
+TEST_CASE("ReadWrite") {
+	GameIndex index;
+	index.Update("C:\\Games", "Tab\tGame", MakeEntry(12345678901, 1700000000, FileFinder::ProjectType::SimRpgMaker95, "Line\nBreak"));
+	index.Update("/games", "a.zip", MakeEntry(0, 0, FileFinder::ProjectType::Unknown, ""));
+
+	std::stringstream ss;
+	index.Write(ss);
+
+	GameIndex read;
+	REQUIRE(read.Read(ss));
+	CHECK(!read.IsModified());
+	CHECK_EQ(read.GetSize(), 2);
+
+	auto* entry = read.Find("C:\\Games", "Tab\tGame", 12345678901, 1700000000);
+	REQUIRE(entry != nullptr);
+	CHECK_EQ(entry->type, FileFinder::ProjectType::SimRpgMaker95);
+	CHECK_EQ(entry->title, "Line\nBreak");
+
+	entry = read.Find("/games", "a.zip", 0, 0);
+	REQUIRE(entry != nullptr);
+	CHECK_EQ(entry->type, FileFinder::ProjectType::Unknown);
+	CHECK(entry->title.empty());
+}
+
+TEST_CASE("ReadInvalid") {
+	GameIndex index;
+
+	std::stringstream empty;
+	CHECK(!index.Read(empty));
+
+	std::stringstream bad_header("EasyRPG GameIndex 0\n");
+	CHECK(!index.Read(bad_header));
+
+	std::stringstream bad_fields("EasyRPG GameIndex 1\n/games\ta.zip\t1\t1\t1\n");
+	CHECK(!index.Read(bad_fields));
+
+	std::stringstream bad_type("EasyRPG GameIndex 1\n/games\ta.zip\t1\t1\t99\t\n");
+	CHECK(!index.Read(bad_type));
+	CHECK_EQ(index.GetSize(), 0);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,162 @@
+#include "game_interpreter_jump_table.h"
+#include "doctest.h"
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace {
+
+using Cmd = lcf::rpg::EventCommand::Code;
+
+lcf::rpg::EventCommand MakeCmd(Cmd code, int indent, std::vector<int32_t> params = {}) {
+	lcf::rpg::EventCommand com;
+	com.code = static_cast<int32_t>(code);
+	com.indent = indent;
+	com.parameters = lcf::DBArray<int32_t>(params.begin(), params.end());
+	return com;
+}
+
+// Reference implementations: the linear scans the interpreter used before
+int RefFindNext(const std::vector<lcf::rpg::EventCommand>& list, int index, int indent, std::initializer_list<Cmd> codes) {
+	for (++index; index < static_cast<int>(list.size()); ++index) {
+		const auto& com = list[index];
+		if (com.indent > indent) {
+			continue;
+		}
+		if (std::find(codes.begin(), codes.end(), static_cast<Cmd>(com.code)) != codes.end()) {
+			break;
+		}
+	}
+	return index;
+}
+
+int RefFindPrevious(const std::vector<lcf::rpg::EventCommand>& list, int index, int indent, Cmd code) {
+	for (int idx = index; idx >= 0; idx--) {
+		if (list[idx].indent > indent)
+			continue;
+		if (list[idx].indent < indent)
+			return -1;
+		if (static_cast<Cmd>(list[idx].code) != code)
+			continue;
+		return idx;
+	}
+	return -2;
+}
+
+int RefFindLabel(const std::vector<lcf::rpg::EventCommand>& list, int label_id) {
+	for (int idx = 0; (size_t)idx < list.size(); idx++) {
+		if (static_cast<Cmd>(list[idx].code) != Cmd::Label)
+			continue;
+		if (list[idx].parameters.empty() || list[idx].parameters[0] != label_id)
+			continue;
+		return idx;
+	}
+	return -1;
+}
+
+}
+
+TEST_SUITE_BEGIN("Game_Interpreter_JumpTable");
+
+TEST_CASE("Branch") {
+	std::vector<lcf::rpg::EventCommand> list = {
+		MakeCmd(Cmd::ConditionalBranch, 0),
+		MakeCmd(Cmd::ConditionalBranch, 1),
+		MakeCmd(Cmd::ElseBranch, 1),
+		MakeCmd(Cmd::EndBranch, 1),
+		MakeCmd(Cmd::ElseBranch, 0),
+		MakeCmd(Cmd::ShowMessage, 1),
+		MakeCmd(Cmd::EndBranch, 0),
+		MakeCmd(Cmd::END, 0),
+	};
+
+	InterpreterJumpTable table(list);
+	REQUIRE(table.IsFor(list));
+
+	REQUIRE_EQ(table.FindNext(0, 0, {Cmd::ElseBranch, Cmd::EndBranch}), 4);
+	REQUIRE_EQ(table.FindNext(1, 1, {Cmd::ElseBranch, Cmd::EndBranch}), 2);
+	REQUIRE_EQ(table.FindNext(4, 0, {Cmd::EndBranch}), 6);
+	REQUIRE_EQ(table.FindNext(6, 0, {Cmd::EndBranch}), 8);
+}
+
+TEST_CASE("Loop") {
+	std::vector<lcf::rpg::EventCommand> list = {
+		MakeCmd(Cmd::Loop, 0),
+		MakeCmd(Cmd::Loop, 1),
+		MakeCmd(Cmd::BreakLoop, 2),
+		MakeCmd(Cmd::EndLoop, 1),
+		MakeCmd(Cmd::BreakLoop, 1),
+		MakeCmd(Cmd::EndLoop, 0),
+		MakeCmd(Cmd::END, 0),
+	};
+
+	InterpreterJumpTable table(list);
+
+	REQUIRE_EQ(table.FindNext(2, 1, {Cmd::EndLoop}), 3);
+	REQUIRE_EQ(table.FindNext(4, 0, {Cmd::EndLoop}), 5);
+	REQUIRE_EQ(table.FindNextEndLoop(2), 3);
+	REQUIRE_EQ(table.FindNextEndLoop(4), 5);
+	REQUIRE_EQ(table.FindNextEndLoop(5), 7);
+
+	REQUIRE_EQ(table.FindPrevious(3, 1, Cmd::Loop), 1);
+	REQUIRE_EQ(table.FindPrevious(5, 0, Cmd::Loop), 0);
+	REQUIRE_EQ(table.FindPrevious(3, 2, Cmd::Loop), -1);
+	REQUIRE_EQ(table.FindPrevious(6, 0, Cmd::EndBranch), -2);
+}
+
+TEST_CASE("Label") {
+	std::vector<lcf::rpg::EventCommand> list = {
+		MakeCmd(Cmd::Label, 0),
+		MakeCmd(Cmd::Label, 0, {2}),
+		MakeCmd(Cmd::Label, 1, {1}),
+		MakeCmd(Cmd::Label, 0, {2}),
+		MakeCmd(Cmd::JumpToLabel, 0, {1}),
+	};
+
+	InterpreterJumpTable table(list);
+
+	REQUIRE_EQ(table.FindLabel(1), 2);
+	REQUIRE_EQ(table.FindLabel(2), 1);
+	REQUIRE_EQ(table.FindLabel(3), -1);
+}
+
+TEST_CASE("IsFor") {
+	std::vector<lcf::rpg::EventCommand> list = { MakeCmd(Cmd::END, 0) };
+	auto copy = list;
+
+	InterpreterJumpTable table(list);
+	REQUIRE(table.IsFor(list));
+	REQUIRE_FALSE(table.IsFor(copy));
+	REQUIRE_FALSE(InterpreterJumpTable().IsFor(list));
+}
+
+TEST_CASE("MatchesLinearScan") {
+	std::mt19937 rng(1234);
+	const Cmd codes[] = { Cmd::Loop, Cmd::EndLoop, Cmd::ElseBranch, Cmd::EndBranch, Cmd::Label, Cmd::ShowMessage };
+
+	for (int iter = 0; iter < 200; ++iter) {
+		std::vector<lcf::rpg::EventCommand> list;
+		const int num = std::uniform_int_distribution<int>(1, 60)(rng);
+		for (int i = 0; i < num; ++i) {
+			auto code = codes[std::uniform_int_distribution<int>(0, 5)(rng)];
+			// Random indentation, also produces broken nesting
+			int indent = std::uniform_int_distribution<int>(0, 4)(rng);
+			list.push_back(MakeCmd(code, indent, {std::uniform_int_distribution<int>(0, 3)(rng)}));
+		}
+
+		InterpreterJumpTable table(list);
+
+		for (int i = 0; i < num; ++i) {
+			for (int indent = -1; indent <= 5; ++indent) {
+				REQUIRE_EQ(table.FindNext(i, indent, {Cmd::ElseBranch, Cmd::EndBranch}), RefFindNext(list, i, indent, {Cmd::ElseBranch, Cmd::EndBranch}));
+				REQUIRE_EQ(table.FindNext(i, indent, {Cmd::EndLoop}), RefFindNext(list, i, indent, {Cmd::EndLoop}));
+				REQUIRE_EQ(table.FindPrevious(i, indent, Cmd::Loop), RefFindPrevious(list, i, indent, Cmd::Loop));
+			}
+		}
+		for (int label = 0; label <= 4; ++label) {
+			REQUIRE_EQ(table.FindLabel(label), RefFindLabel(list, label));
+		}
+	}
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,153 @@
+#include "game_map.h"
+#include "game_event.h"
+#include "game_switches.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "doctest.h"
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("Game_Map_Events");
+
+TEST_CASE("EventLookupOrder") {
+	const MockGame mg(MockMap::ePassEvents20x15);
+
+	for (int id = 1; id <= 4; ++id) {
+		mg.GetEvent(id)->MoveTo(1, id, 0);
+	}
+	mg.GetEvent(2)->MoveTo(1, 5, 5);
+	mg.GetEvent(4)->MoveTo(1, 5, 5);
+
+	// CheckEvent returns the lowest ID, GetEventAt the highest ID
+	REQUIRE_EQ(Game_Map::CheckEvent(5, 5), 2);
+	REQUIRE_EQ(Game_Map::GetEventAt(5, 5, false), mg.GetEvent(4));
+	REQUIRE_EQ(Game_Map::CheckEvent(6, 5), 0);
+	REQUIRE_EQ(Game_Map::GetEventAt(6, 5, false), nullptr);
+
+	mg.GetEvent(4)->SetActive(false);
+	REQUIRE_EQ(Game_Map::GetEventAt(5, 5, false), mg.GetEvent(4));
+	REQUIRE_EQ(Game_Map::GetEventAt(5, 5, true), mg.GetEvent(2));
+}
+
+TEST_CASE("EventLookupAfterMove") {
+	const MockGame mg(MockMap::ePassEvents20x15);
+
+	auto& ev1 = *mg.GetEvent(1);
+	auto& ev3 = *mg.GetEvent(3);
+
+	ev1.MoveTo(1, 2, 2);
+	ev3.MoveTo(1, 2, 2);
+	REQUIRE_EQ(Game_Map::CheckEvent(2, 2), 1);
+
+	ev1.SetX(3);
+	REQUIRE_EQ(Game_Map::CheckEvent(2, 2), 3);
+	REQUIRE_EQ(Game_Map::CheckEvent(3, 2), 1);
+
+	ev1.SetY(4);
+	REQUIRE_EQ(Game_Map::CheckEvent(3, 2), 0);
+	REQUIRE_EQ(Game_Map::CheckEvent(3, 4), 1);
+
+	ev3.SetX(3);
+	ev3.SetY(4);
+	REQUIRE_EQ(Game_Map::CheckEvent(2, 2), 0);
+	REQUIRE_EQ(Game_Map::CheckEvent(3, 4), 1);
+	REQUIRE_EQ(Game_Map::GetEventAt(3, 4, false), &ev3);
+}
+
+TEST_CASE("EventCollision") {
+	const MockGame mg(MockMap::ePassEvents20x15);
+
+	auto& ev1 = *mg.GetEvent(1);
+	auto& ev2 = *mg.GetEvent(2);
+
+	ev1.MoveTo(1, 2, 2);
+	ev2.MoveTo(1, 3, 2);
+	mg.GetEvent(3)->MoveTo(1, 10, 10);
+	mg.GetEvent(4)->MoveTo(1, 11, 10);
+
+	REQUIRE_FALSE(Game_Map::CheckWay(ev1, 2, 2, 3, 2));
+	REQUIRE(Game_Map::CheckWay(ev1, 2, 2, 2, 3));
+
+	int ignore[] = { 2 };
+	REQUIRE(Game_Map::CheckWay(ev1, 2, 2, 3, 2, true, ignore));
+
+	ev2.SetY(3);
+	REQUIRE(Game_Map::CheckWay(ev1, 2, 2, 3, 2));
+	REQUIRE_FALSE(Game_Map::CheckWay(ev1, 2, 2, 3, 3));
+}
+
+static lcf::rpg::EventPage& AddPage(lcf::rpg::Event& ev) {
+	ev.pages.push_back(ev.pages.front());
+	ev.pages.back().ID = static_cast<int>(ev.pages.size());
+	return ev.pages.back();
+}
+
+static int PageOf(int event_id) {
+	const auto* page = Game_Map::GetEvent(event_id)->GetActivePage();
+	return page ? page->ID : 0;
+}
+
+TEST_CASE("RefreshObservingEvents") {
+	const MockGame mg(MockMap::ePassEvents20x15);
+
+	// Event 1 observes switch 1, event 2 variable 1, event 3 an item
+	auto map = MakeMockMap(MockMap::ePassEvents20x15);
+	auto& pg1 = AddPage(map->events[0]);
+	pg1.condition.flags.switch_a = true;
+	pg1.condition.switch_a_id = 1;
+	auto& pg2 = AddPage(map->events[1]);
+	pg2.condition.flags.variable = true;
+	pg2.condition.variable_id = 1;
+	pg2.condition.variable_value = 5;
+	auto& pg3 = AddPage(map->events[2]);
+	pg3.condition.flags.switch_a = true;
+	pg3.condition.switch_a_id = 2;
+	AddPage(map->events[2]).condition.flags.item = true;
+	Game_Map::Setup(std::move(map));
+
+	REQUIRE(Game_Map::GetNeedRefresh());
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+	REQUIRE_EQ(PageOf(1), 1);
+	REQUIRE_EQ(PageOf(2), 1);
+
+	// Changes without an observer need no refresh
+	Game_Map::SetNeedRefreshForSwitchChange(3);
+	Game_Map::SetNeedRefreshForVarChange(2);
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+
+	// Variable 1 changes without notification, only event 1 is refreshed
+	Main_Data::game_switches->Set(1, true);
+	Main_Data::game_variables->Set(1, 5);
+	Game_Map::SetNeedRefreshForSwitchChange(1);
+	REQUIRE(Game_Map::GetNeedRefresh());
+	Game_Map::Refresh();
+	REQUIRE_FALSE(Game_Map::GetNeedRefresh());
+	REQUIRE_EQ(PageOf(1), 2);
+	REQUIRE_EQ(PageOf(2), 1);
+
+	Game_Map::SetNeedRefreshForVarChange(1);
+	Game_Map::Refresh();
+	REQUIRE_EQ(PageOf(2), 2);
+
+	// Events with untracked conditions are part of every refresh
+	Main_Data::game_switches->Set(2, true);
+	Main_Data::game_switches->Set(1, false);
+	Game_Map::SetNeedRefreshForSwitchChange(1);
+	Game_Map::Refresh();
+	REQUIRE_EQ(PageOf(1), 1);
+	REQUIRE_EQ(PageOf(3), 2);
+
+	Main_Data::game_switches->SetRange(1, 10, true);
+	Game_Map::SetNeedRefreshForSwitchRangeChange(1, 10);
+	Game_Map::Refresh();
+	REQUIRE_EQ(PageOf(1), 2);
+
+	// Full refresh re-evaluates all events
+	Main_Data::game_variables->Set(1, 0);
+	Game_Map::SetNeedRefresh(true);
+	Game_Map::Refresh();
+	REQUIRE_EQ(PageOf(2), 1);
+}
+
+TEST_SUITE_END();
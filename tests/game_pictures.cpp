@@ -0,0 +1,122 @@
+#include "game_pictures.h"
+#include "player.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("Game_Pictures");
+
+namespace {
+
+/** Sets the engine for the lifetime of the guard */
+struct EngineGuard {
+	explicit EngineGuard(int engine) : config(Player::game_config) { Player::game_config.engine = engine; }
+	~EngineGuard() { Player::game_config = config; }
+	Game_ConfigGame config;
+};
+
+Game_Pictures::ShowParams MakeShow(int x) {
+	Game_Pictures::ShowParams params;
+	params.position_x = x;
+	return params;
+}
+
+Game_Pictures::MoveParams MakeMove(int x, int duration) {
+	Game_Pictures::MoveParams params;
+	params.position_x = x;
+	params.duration = duration;
+	return params;
+}
+
+}
+
+TEST_CASE("Settle") {
+	const EngineGuard guard(Player::EngineRpg2k3 | Player::EngineEnglish);
+	Game_Pictures pictures;
+
+	pictures.Show(1, MakeShow(10));
+	pictures.Show(2, MakeShow(20));
+	REQUIRE(pictures.GetPicture(1).active);
+	REQUIRE(pictures.GetPicture(2).active);
+
+	pictures.Update(false);
+	REQUIRE_FALSE(pictures.GetPicture(1).active);
+	REQUIRE_FALSE(pictures.GetPicture(2).active);
+
+	// 1 second
+	pictures.Move(2, MakeMove(80, 10));
+	REQUIRE(pictures.GetPicture(2).active);
+	for (int i = 0; i < 30; ++i) {
+		pictures.Update(false);
+	}
+	REQUIRE(pictures.GetPicture(2).active);
+	REQUIRE_EQ(pictures.GetPicture(2).data.current_x, doctest::Approx(50.0));
+
+	for (int i = 0; i < 30; ++i) {
+		pictures.Update(false);
+	}
+	REQUIRE_FALSE(pictures.GetPicture(2).active);
+	REQUIRE_EQ(pictures.GetPicture(2).data.current_x, 80.0);
+}
+
+TEST_CASE("Effects") {
+	const EngineGuard guard(Player::EngineRpg2k3 | Player::EngineEnglish);
+	Game_Pictures pictures;
+
+	auto params = MakeShow(0);
+	params.effect_mode = lcf::rpg::SavePicture::Effect_wave;
+	params.effect_power = 5;
+	pictures.Show(1, params);
+
+	params.effect_mode = lcf::rpg::SavePicture::Effect_rotation;
+	pictures.Show(2, params);
+
+	params.effect_mode = lcf::rpg::SavePicture::Effect_none;
+	params.spritesheet_cols = 2;
+	params.spritesheet_speed = 4;
+	pictures.Show(3, params);
+
+	for (int i = 0; i < 10; ++i) {
+		pictures.Update(false);
+	}
+	REQUIRE(pictures.GetPicture(1).active);
+	REQUIRE(pictures.GetPicture(2).active);
+	REQUIRE(pictures.GetPicture(3).active);
+	REQUIRE_EQ(pictures.GetPicture(1).data.current_waver, 80);
+	REQUIRE_EQ(pictures.GetPicture(2).data.current_rotation, 50.0);
+}
+
+TEST_CASE("Frames") {
+	const EngineGuard guard(Player::EngineRpg2k3 | Player::EngineEnglish);
+	Game_Pictures pictures;
+
+	auto params = MakeShow(0);
+	params.battle_layer = 1;
+	pictures.Show(1, params);
+	pictures.Show(2, MakeShow(0));
+
+	for (int i = 0; i < 10; ++i) {
+		pictures.Update(false);
+	}
+	for (int i = 0; i < 5; ++i) {
+		pictures.Update(true);
+	}
+	REQUIRE_FALSE(pictures.GetPicture(1).active);
+
+	// Frames of settled pictures are only counted on their layers
+	auto save = pictures.GetSaveData();
+	REQUIRE_EQ(save[0].frames, 15);
+	REQUIRE_EQ(save[1].frames, 10);
+
+	pictures.Move(1, MakeMove(10, 0));
+	REQUIRE_EQ(pictures.GetPicture(1).data.frames, 15);
+	pictures.Update(false);
+	REQUIRE_EQ(pictures.GetSaveData()[0].frames, 16);
+
+	// The active list is rebuilt from the save
+	pictures.SetSaveData(save);
+	pictures.Update(false);
+	save = pictures.GetSaveData();
+	REQUIRE_EQ(save[0].frames, 16);
+	REQUIRE_EQ(save[1].frames, 11);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,47 @@
+#include "headless_ui.h"
+#include "bitmap.h"
+#include "game_clock.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("HeadlessUi");
+
+TEST_CASE("MaxSpeed") {
+	const auto now = Game_Clock::now();
+
+	Game_Clock::SetMaxSpeed(true);
+	Game_Clock::ResetFrame(now);
+
+	// Exactly one step independent of the elapsed time
+	for (auto dt: { std::chrono::seconds(0), std::chrono::seconds(1), std::chrono::seconds(1) }) {
+		Game_Clock::OnNextFrame(now + dt);
+		REQUIRE(Game_Clock::NextGameTimeStep());
+		REQUIRE_FALSE(Game_Clock::NextGameTimeStep());
+	}
+
+	Game_Clock::SetMaxSpeed(false);
+	Game_Clock::ResetFrame(now);
+
+	Game_Clock::OnNextFrame(now);
+	REQUIRE_FALSE(Game_Clock::NextGameTimeStep());
+
+	Game_Clock::ResetFrame(Game_Clock::now());
+}
+
+TEST_CASE("HashSurface") {
+	Bitmap::SetFormat(format_R8G8B8A8_a().format());
+
+	auto a = Bitmap::Create(16, 16, false);
+	auto b = Bitmap::Create(16, 16, false);
+	a->Clear();
+	b->Clear();
+
+	REQUIRE_EQ(HeadlessUi::HashSurface(*a), HeadlessUi::HashSurface(*b));
+
+	b->FillRect(Rect(3, 4, 1, 1), Color(255, 0, 0, 255));
+	REQUIRE_NE(HeadlessUi::HashSurface(*a), HeadlessUi::HashSurface(*b));
+
+	a->FillRect(Rect(3, 4, 1, 1), Color(255, 0, 0, 255));
+	REQUIRE_EQ(HeadlessUi::HashSurface(*a), HeadlessUi::HashSurface(*b));
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,60 @@
+#include "instrumentation.h"
+#include "doctest.h"
+#include <sstream>
+#include <string>
+#include <thread>
+
+TEST_SUITE_BEGIN("Instrumentation");
+
+namespace {
+int CountOccurrences(const std::string& s, const std::string& what) {
+	int count = 0;
+	for (auto pos = s.find(what); pos != std::string::npos; pos = s.find(what, pos + what.size())) {
+		++count;
+	}
+	return count;
+}
+}
+
+TEST_CASE("Trace") {
+	Instrumentation::EnableTrace();
+	REQUIRE(Instrumentation::IsTraceEnabled());
+
+	{
+		Instrumentation::Scope iscope("Test::Outer");
+		Instrumentation::Scope inner;
+		inner.Begin("Test::First");
+		inner.Begin("Test::Second");
+	}
+
+	std::thread thread([]() {
+		Instrumentation::Scope iscope("Test::Thread");
+	});
+	thread.join();
+
+	std::stringstream ss;
+	REQUIRE_GE(Instrumentation::WriteTrace(ss), 4);
+
+	auto json = ss.str();
+	REQUIRE_EQ(json.rfind("{\"traceEvents\":[", 0), 0);
+	REQUIRE_EQ(CountOccurrences(json, "\"name\":\"Test::Outer\""), 1);
+	REQUIRE_EQ(CountOccurrences(json, "\"name\":\"Test::First\""), 1);
+	REQUIRE_EQ(CountOccurrences(json, "\"name\":\"Test::Second\""), 1);
+	REQUIRE_EQ(CountOccurrences(json, "\"name\":\"Test::Thread\""), 1);
+	REQUIRE_EQ(CountOccurrences(json, "\"ph\":\"X\""), CountOccurrences(json, "\"name\":"));
+}
+
+TEST_CASE("Counter") {
+	Instrumentation::EnableTrace();
+
+	Instrumentation::RecordCounter("Test::Counter", 42);
+
+	std::stringstream ss;
+	Instrumentation::WriteTrace(ss);
+
+	auto json = ss.str();
+	REQUIRE_EQ(CountOccurrences(json, "\"name\":\"Test::Counter\",\"cat\":\"player\",\"ph\":\"C\""), 1);
+	REQUIRE_EQ(CountOccurrences(json, "\"args\":{\"value\":42}"), 1);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,134 @@
+#include <algorithm>
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+#include "game_interpreter.h"
+#include "game_variables.h"
+#include "main_data.h"
+#include "maniac_patch.h"
+#include "span.h"
+#include "doctest.h"
+
+#include "mock_game.h"
+
+TEST_SUITE_BEGIN("ManiacPatch");
+
+namespace {
+
+// Op-codes of the expression byte stream
+constexpr int U8 = 1;
+constexpr int Var = 8;
+constexpr int AssignInplace = 34;
+constexpr int AddInplace = 35;
+constexpr int Add = 48;
+constexpr int Mul = 50;
+constexpr int Less = 62;
+constexpr int Ternary = 72;
+constexpr int Function = 78;
+
+// Function ids
+constexpr int Max = 13;
+constexpr int Clamp = 15;
+
+/** Packs the bytes of an expression into event command parameters */
+std::vector<int32_t> Pack(std::initializer_list<int> bytes) {
+	std::vector<int32_t> params((bytes.size() + 3) / 4);
+	int i = 0;
+	for (int b: bytes) {
+		params[i / 4] |= static_cast<int32_t>(static_cast<uint32_t>(b & 0xFF) << (8 * (i % 4)));
+		++i;
+	}
+	return params;
+}
+
+MockGame Setup() {
+	MockGame mg(MockMap::ePassBlock20x15);
+	Main_Data::game_variables->SetLowerLimit(10);
+	Main_Data::game_variables->SetWarning(0);
+	ManiacPatch::ClearExpressionCache();
+	return mg;
+}
+
+}
+
+TEST_CASE("ConstantFolding") {
+	const auto mg = Setup();
+	Game_Interpreter interpreter;
+
+	// (2 + 3) * max(4, 1)
+	auto params = Pack({ Mul, Add, U8, 2, U8, 3, Function, Max, 2, U8, 4, U8, 1 });
+	auto expr = ManiacPatch::CompileExpression(MakeSpan(params));
+
+	REQUIRE_EQ(expr.code.size(), 1);
+	REQUIRE_EQ(expr.num_results, 1);
+	REQUIRE_EQ(ManiacPatch::EvaluateExpression(expr, interpreter), 20);
+}
+
+TEST_CASE("Variables") {
+	const auto mg = Setup();
+	Game_Interpreter interpreter;
+	auto& vars = *Main_Data::game_variables;
+
+	// v[1] < 5 ? v[1] + 10 : clamp(v[1], 0, 7)
+	auto params = Pack({ Ternary, Less, Var, U8, 1, U8, 5, Add, Var, U8, 1, U8, 10, Function, Clamp, 3, Var, U8, 1, U8, 0, U8, 7 });
+	auto expr = ManiacPatch::CompileExpression(MakeSpan(params));
+	REQUIRE_GT(expr.code.size(), 1);
+
+	vars.Set(1, 3);
+	REQUIRE_EQ(ManiacPatch::EvaluateExpression(expr, interpreter), 13);
+	vars.Set(1, 6);
+	REQUIRE_EQ(ManiacPatch::EvaluateExpression(expr, interpreter), 6);
+	vars.Set(1, 100);
+	REQUIRE_EQ(ManiacPatch::EvaluateExpression(expr, interpreter), 7);
+}
+
+TEST_CASE("Inplace") {
+	const auto mg = Setup();
+	Game_Interpreter interpreter;
+	auto& vars = *Main_Data::game_variables;
+
+	// v[2] = 4, then v[2] += v[2]
+	auto assign = Pack({ AssignInplace, Var, U8, 2, U8, 4 });
+	auto add = Pack({ AddInplace, Var, U8, 2, Var, U8, 2 });
+
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(assign), interpreter), 4);
+	REQUIRE_EQ(vars.Get(2), 4);
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(add), interpreter), 8);
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(add), interpreter), 16);
+	REQUIRE_EQ(vars.Get(2), 16);
+}
+
+TEST_CASE("Multiple") {
+	const auto mg = Setup();
+	Game_Interpreter interpreter;
+	Main_Data::game_variables->Set(3, 42);
+
+	auto params = Pack({ U8, 1, Var, U8, 3, Add, U8, 1, U8, 2 });
+	auto expr = ManiacPatch::CompileExpressions(MakeSpan(params));
+
+	REQUIRE_EQ(expr.num_results, 3);
+	REQUIRE_EQ(ManiacPatch::EvaluateExpressions(expr, interpreter), std::vector<int32_t>{ 1, 42, 3 });
+	REQUIRE_EQ(ManiacPatch::ParseExpressions(MakeSpan(params), interpreter), std::vector<int32_t>{ 1, 42, 3 });
+
+	REQUIRE(ManiacPatch::ParseExpressions(Span<const int32_t>(), interpreter).empty());
+}
+
+TEST_CASE("CacheInvalidation") {
+	const auto mg = Setup();
+	Game_Interpreter interpreter;
+
+	auto params = Pack({ Add, U8, 1, U8, 2 });
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(params), interpreter), 3);
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(params), interpreter), 3);
+
+	// Same address, different content
+	auto changed = Pack({ Mul, U8, 5, U8, 2 });
+	REQUIRE_EQ(changed.size(), params.size());
+	std::copy(changed.begin(), changed.end(), params.begin());
+	REQUIRE_EQ(ManiacPatch::ParseExpression(MakeSpan(params), interpreter), 10);
+
+	// Same address, now as a list of expressions
+	REQUIRE_EQ(ManiacPatch::ParseExpressions(MakeSpan(params), interpreter), std::vector<int32_t>{ 10 });
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,91 @@
+#include <memory>
+#include <sstream>
+#include "map_file_cache.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("MapFileCache");
+
+namespace {
+
+/** Creates a map with a w * h tile layer and an event */
+MapFileCache::MapRef MakeMap(int w, int h) {
+	auto map = std::make_shared<lcf::rpg::Map>();
+	map->width = w;
+	map->height = h;
+	map->lower_layer.resize(w * h);
+	map->upper_layer.resize(w * h);
+	map->events.resize(1);
+	map->events[0].ID = 1;
+	map->events[0].pages.resize(1);
+	map->events[0].pages[0].event_commands.resize(10);
+	return map;
+}
+
+/** Restores the memory limit and empties the cache */
+struct CacheGuard {
+	CacheGuard() : limit(MapFileCache::GetMemoryLimit()) { MapFileCache::Clear(); }
+	~CacheGuard() { MapFileCache::SetMemoryLimit(limit); MapFileCache::Clear(); }
+	size_t limit;
+};
+
+}
+
+TEST_CASE("Cache") {
+	CacheGuard guard;
+
+	auto map = MakeMap(20, 15);
+	REQUIRE_GT(MapFileCache::EstimateMemory(*map), 20 * 15 * 2 * sizeof(int16_t));
+
+	REQUIRE_FALSE(MapFileCache::Get(1));
+	MapFileCache::Add(1, map);
+	REQUIRE_EQ(MapFileCache::Get(1), map);
+	REQUIRE(MapFileCache::IsCachedOrPending(1));
+	REQUIRE_EQ(MapFileCache::GetMemoryUsage(), MapFileCache::EstimateMemory(*map));
+
+	MapFileCache::Clear();
+	REQUIRE_FALSE(MapFileCache::Get(1));
+	REQUIRE_EQ(MapFileCache::GetMemoryUsage(), 0);
+}
+
+TEST_CASE("EvictLeastRecentlyUsed") {
+	CacheGuard guard;
+
+	auto map = MakeMap(100, 100);
+	const size_t size = MapFileCache::EstimateMemory(*map);
+	MapFileCache::SetMemoryLimit(size * 2 + size / 2);
+
+	MapFileCache::Add(1, map);
+	MapFileCache::Add(2, MakeMap(100, 100));
+	REQUIRE(MapFileCache::Get(1));
+	MapFileCache::Add(3, MakeMap(100, 100));
+
+	// Map 2 was used least recently
+	REQUIRE(MapFileCache::Get(1));
+	REQUIRE_FALSE(MapFileCache::Get(2));
+	REQUIRE(MapFileCache::Get(3));
+	REQUIRE_EQ(MapFileCache::GetMemoryUsage(), size * 2);
+
+	// Maps that are still in use stay valid
+	MapFileCache::SetMemoryLimit(0);
+	REQUIRE_FALSE(MapFileCache::Get(1));
+	REQUIRE_EQ(map->lower_layer.size(), 100 * 100);
+}
+
+TEST_CASE("Prefetch") {
+	CacheGuard guard;
+
+	REQUIRE_FALSE(MapFileCache::TakePrefetched(5));
+
+	auto done = MapFileCache::Prefetch(5, Filesystem_Stream::InputStream(new std::stringbuf("not a map"), "Map0005.lmu"), false, "1252");
+	REQUIRE(done.valid());
+	REQUIRE(MapFileCache::IsCachedOrPending(5));
+
+	// Already pending
+	REQUIRE_FALSE(MapFileCache::Prefetch(5, Filesystem_Stream::InputStream(new std::stringbuf("not a map"), "Map0005.lmu"), false, "1252").valid());
+
+	// Parsing failed
+	REQUIRE_FALSE(MapFileCache::TakePrefetched(5));
+	REQUIRE_FALSE(MapFileCache::IsCachedOrPending(5));
+}
+
+TEST_SUITE_END();
@@ -111,6 +111,12 @@ std::unique_ptr<lcf::rpg::Map> MakeMockMap(MockMap maptag) {
 		case MockMap::eMapCount:
 		case MockMap::ePass40x30:
 			break;
+		case MockMap::ePassEvents20x15:
+			for (int id = 2; id <= 4; ++id) {
+				map->events.push_back(map->events.front());
+				map->events.back().ID = id;
+			}
+			break;
 		case MockMap::ePassBlock20x15:
 			for (int y = 0; y < h; ++y) {
 				for (int x = 0; x < w; ++x) {
@@ -22,6 +22,7 @@ enum class MockMap {
 	eNone,
 	ePassBlock20x15, // Left half is passable, right half is blocked
 	ePass40x30,
+	ePassEvents20x15, // Passable with 4 events
 	eMapCount
 };
 
@@ -0,0 +1,161 @@
+#include "path_finder.h"
+#include "doctest.h"
+#include <string>
+#include <vector>
+
+namespace {
+
+// '#' is blocked, everything else is passable
+struct Grid {
+	std::vector<std::string> rows;
+
+	int Width() const { return static_cast<int>(rows[0].size()); }
+	int Height() const { return static_cast<int>(rows.size()); }
+
+	bool IsPassable(int x, int y) const {
+		if (x < 0 || x >= Width() || y < 0 || y >= Height()) {
+			return false;
+		}
+		return rows[y][x] != '#';
+	}
+
+	PathFinder::CheckWayFn CheckWay() const {
+		return [this](int, int, int to_x, int to_y, bool) {
+			return IsPassable(to_x, to_y);
+		};
+	}
+
+	PathFinder::Args MakeArgs(int sx, int sy, int dx, int dy) const {
+		PathFinder::Args args;
+		args.start_x = sx;
+		args.start_y = sy;
+		args.dest_x = dx;
+		args.dest_y = dy;
+		args.width = Width();
+		args.height = Height();
+		return args;
+	}
+};
+
+constexpr int Up = 0;
+constexpr int Right = 1;
+constexpr int Down = 2;
+constexpr int Left = 3;
+constexpr int UpRight = 4;
+constexpr int DownRight = 5;
+
+}
+
+TEST_SUITE_BEGIN("PathFinder");
+
+TEST_CASE("Straight") {
+	Grid grid { { "....." } };
+	PathFinder pf;
+	std::vector<int> route;
+
+	REQUIRE(pf.Search(grid.MakeArgs(0, 0, 4, 0), grid.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, Right, Right, Right, Right });
+}
+
+TEST_CASE("AroundWall") {
+	Grid grid { {
+		"...",
+		".#.",
+		"...",
+	} };
+	PathFinder pf;
+	std::vector<int> route;
+
+	// Right is expanded before Down, so the upper route is taken
+	REQUIRE(pf.Search(grid.MakeArgs(0, 1, 2, 1), grid.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, Up, Right, Right, Down });
+}
+
+TEST_CASE("Diagonal") {
+	Grid grid { {
+		"...",
+		"...",
+		"...",
+	} };
+	PathFinder pf;
+	std::vector<int> route;
+
+	auto args = grid.MakeArgs(0, 0, 2, 2);
+	args.allow_diagonal = true;
+	REQUIRE(pf.Search(args, grid.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, DownRight, DownRight });
+
+	args = grid.MakeArgs(0, 2, 2, 0);
+	args.allow_diagonal = true;
+	REQUIRE(pf.Search(args, grid.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, UpRight, UpRight });
+}
+
+TEST_CASE("Unreachable") {
+	Grid grid { {
+		"..#.",
+		"..#.",
+	} };
+	PathFinder pf;
+	std::vector<int> route;
+
+	// Leads to the closest reachable tile
+	REQUIRE(pf.Search(grid.MakeArgs(0, 0, 3, 0), grid.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, Right });
+}
+
+TEST_CASE("Loop") {
+	Grid grid { { "....." } };
+	PathFinder pf;
+	std::vector<int> route;
+
+	auto args = grid.MakeArgs(0, 0, 4, 0);
+	args.loop_horizontal = true;
+	REQUIRE(pf.Search(args, grid.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, Left });
+}
+
+TEST_CASE("StepsMax") {
+	Grid grid { { "....." } };
+	PathFinder pf;
+	std::vector<int> route;
+
+	auto args = grid.MakeArgs(0, 0, 4, 0);
+	args.steps_max = 2;
+	REQUIRE(pf.Search(args, grid.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ Right, Right });
+}
+
+TEST_CASE("SearchMax") {
+	Grid grid { { "....." } };
+	PathFinder pf;
+	std::vector<int> route;
+
+	auto args = grid.MakeArgs(0, 0, 4, 0);
+	args.search_max = 0;
+	REQUIRE_FALSE(pf.Search(args, grid.CheckWay(), route));
+
+	args.search_max = 3;
+	REQUIRE(pf.Search(args, grid.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, Right, Right });
+	REQUIRE_EQ(pf.GetExpandedNodes(), 3);
+}
+
+TEST_CASE("Reuse") {
+	Grid small { { "..." } };
+	Grid big { {
+		".....",
+		".....",
+	} };
+	PathFinder pf;
+	std::vector<int> route;
+
+	REQUIRE(pf.Search(small.MakeArgs(0, 0, 2, 0), small.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, Right, Right });
+	REQUIRE(pf.Search(big.MakeArgs(4, 1, 0, 1), big.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, Left, Left, Left, Left });
+	REQUIRE(pf.Search(small.MakeArgs(2, 0, 0, 0), small.CheckWay(), route));
+	REQUIRE_EQ(route, std::vector<int>{ -1, Left, Left });
+}
+
+TEST_SUITE_END();
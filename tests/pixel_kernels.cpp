@@ -0,0 +1,172 @@
+#include <cstdint>
+#include <vector>
+#include "pixel_kernels.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("PixelKernels");
+
+namespace {
+
+using PixelKernels::Variant;
+using PixelKernels::PixelLayout;
+using PixelKernels::ToneParams;
+
+constexpr Variant simd_variants[] = { Variant::Sse41, Variant::Avx2, Variant::Neon };
+
+constexpr PixelLayout layouts[] = {
+	{ 0, 8, 16, 24 },
+	{ 24, 16, 8, 0 },
+	{ 16, 8, 0, 24 }
+};
+
+std::vector<uint32_t> MakePixels(int count, uint32_t seed) {
+	std::vector<uint32_t> pixels(count);
+	for (auto& px: pixels) {
+		seed = seed * 1103515245u + 12345u;
+		px = seed ^ (seed >> 13);
+	}
+
+	// Include fully transparent and opaque pixels
+	for (int i = 0; i < count; i += 5) {
+		pixels[i] &= 0x00FFFF00;
+	}
+	for (int i = 2; i < count; i += 7) {
+		pixels[i] |= 0xFF0000FF;
+	}
+	return pixels;
+}
+
+/** RAII guard restoring the selected variant */
+struct VariantGuard {
+	VariantGuard() : variant(PixelKernels::GetVariant()) {}
+	~VariantGuard() { PixelKernels::SetVariant(variant); }
+	Variant variant;
+};
+
+void CheckTone(const ToneParams& params, int count) {
+	const auto src = MakePixels(count, count + params.sat);
+
+	auto expected = src;
+	REQUIRE(PixelKernels::SetVariant(Variant::Scalar));
+	PixelKernels::ApplyTone(expected.data(), count, params);
+
+	for (auto variant: simd_variants) {
+		if (!PixelKernels::SetVariant(variant)) {
+			continue;
+		}
+		auto actual = src;
+		PixelKernels::ApplyTone(actual.data(), count, params);
+		INFO(PixelKernels::GetVariantName(variant));
+		REQUIRE(actual == expected);
+	}
+}
+
+void CheckHueChange(int hue, const PixelLayout& layout, int count) {
+	const auto src = MakePixels(count, count + hue);
+
+	auto expected = src;
+	REQUIRE(PixelKernels::SetVariant(Variant::Scalar));
+	PixelKernels::ApplyHueChange(expected.data(), count, hue, layout);
+
+	for (auto variant: simd_variants) {
+		if (!PixelKernels::SetVariant(variant)) {
+			continue;
+		}
+		auto actual = src;
+		PixelKernels::ApplyHueChange(actual.data(), count, hue, layout);
+		INFO(PixelKernels::GetVariantName(variant));
+		REQUIRE(actual == expected);
+	}
+}
+
+}
+
+TEST_CASE("Variants") {
+	CHECK(PixelKernels::IsSupported(Variant::Scalar));
+	CHECK(PixelKernels::IsSupported(PixelKernels::GetDefaultVariant()));
+
+	VariantGuard guard;
+	for (auto variant: simd_variants) {
+		CHECK_EQ(PixelKernels::SetVariant(variant), PixelKernels::IsSupported(variant));
+	}
+}
+
+TEST_CASE("ToneBitExact") {
+	VariantGuard guard;
+
+	// Odd pixel counts test the scalar tail
+	for (const auto& layout: layouts) {
+		for (int flags = 1; flags < 16; ++flags) {
+			for (Tone tone: { Tone(0, 255, 128, 0), Tone(129, 127, 200, 255), Tone(255, 0, 64, 77) }) {
+				ToneParams params;
+				params.layout = layout;
+				params.saturation = flags & 1;
+				params.color = flags & 2;
+				params.premultiply = flags & 4;
+				params.skip_transparent = flags & 8;
+				params.sat = tone.gray > 128 ? 1024 + (tone.gray - 128) * 16 : tone.gray * 8;
+				params.tone = tone;
+
+				for (int count: { 1, 7, 64, 1021 }) {
+					CheckTone(params, count);
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("ToneHardLight") {
+	VariantGuard guard;
+
+	// Every tone value against every color and alpha
+	const auto& layout = layouts[0];
+	std::vector<uint32_t> src(256 * 256);
+	for (uint32_t i = 0; i < src.size(); ++i) {
+		const uint32_t v = i & 0xFF;
+		src[i] = v | (v << 8) | (v << 16) | ((i >> 8) << 24);
+	}
+
+	for (int t = 0; t < 256; ++t) {
+		ToneParams params;
+		params.layout = layout;
+		params.color = true;
+		params.premultiply = (t & 1) != 0;
+		params.tone = Tone(t, 255 - t, t, 128);
+
+		auto expected = src;
+		REQUIRE(PixelKernels::SetVariant(Variant::Scalar));
+		PixelKernels::ApplyTone(expected.data(), static_cast<int>(expected.size()), params);
+
+		for (auto variant: simd_variants) {
+			if (!PixelKernels::SetVariant(variant)) {
+				continue;
+			}
+			auto actual = src;
+			PixelKernels::ApplyTone(actual.data(), static_cast<int>(actual.size()), params);
+			INFO(PixelKernels::GetVariantName(variant));
+			REQUIRE(actual == expected);
+		}
+	}
+}
+
+TEST_CASE("HueChangeBitExact") {
+	VariantGuard guard;
+
+	for (const auto& layout: layouts) {
+		for (int hue: { 0, 1, 0x100, 0x2FF, 0x555, 0x600 }) {
+			for (int count: { 1, 7, 64, 4099 }) {
+				CheckHueChange(hue, layout, count);
+			}
+		}
+	}
+}
+
+TEST_CASE("HueChangeGray") {
+	// Gray and transparent pixels are not changed
+	std::vector<uint32_t> pixels = { 0x000000FF, 0x808080FF, 0xFFFFFFFF, 0x12345600 };
+	const auto expected = pixels;
+	PixelKernels::ApplyHueChange(pixels.data(), static_cast<int>(pixels.size()), 0x300, layouts[1]);
+	CHECK(pixels == expected);
+}
+
+TEST_SUITE_END();
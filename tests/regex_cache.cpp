@@ -0,0 +1,58 @@
+#include <regex>
+#include "regex_cache.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("RegexCache");
+
+TEST_CASE("HitMiss") {
+	RegexCache cache;
+
+	auto r1 = cache.Get(L"a+b");
+	auto r2 = cache.Get(L"a+b");
+	CHECK_EQ(r1, r2);
+	CHECK_EQ(cache.GetHits(), 1);
+	CHECK_EQ(cache.GetMisses(), 1);
+	CHECK(std::regex_search(std::wstring(L"xaab"), *r1));
+
+	// Flags are part of the key
+	auto r3 = cache.Get(L"a+b", std::regex_constants::ECMAScript | std::regex_constants::icase);
+	CHECK_NE(r1, r3);
+	CHECK_EQ(cache.GetSize(), 2);
+	CHECK(std::regex_search(std::wstring(L"AAB"), *r3));
+	CHECK_FALSE(std::regex_search(std::wstring(L"AAB"), *r1));
+}
+
+TEST_CASE("Evict") {
+	RegexCache cache(2);
+
+	auto a = cache.Get(L"a");
+	cache.Get(L"b");
+	// Makes "b" the least recently used one
+	cache.Get(L"a");
+	cache.Get(L"c");
+
+	CHECK_EQ(cache.GetSize(), 2);
+	CHECK_EQ(cache.Get(L"a"), a);
+	CHECK_EQ(cache.GetMisses(), 3);
+	cache.Get(L"b");
+	CHECK_EQ(cache.GetMisses(), 4);
+
+	// Evicted expressions stay usable
+	cache.SetCapacity(1);
+	CHECK_EQ(cache.GetSize(), 1);
+	CHECK(std::regex_match(std::wstring(L"a"), *a));
+
+	cache.Clear();
+	CHECK_EQ(cache.GetSize(), 0);
+}
+
+TEST_CASE("Invalid") {
+	RegexCache cache;
+
+	CHECK_THROWS_AS(cache.Get(L"a("), std::regex_error);
+	CHECK_EQ(cache.GetSize(), 0);
+	CHECK_THROWS_AS(cache.Get(L"a("), std::regex_error);
+	CHECK_EQ(cache.GetMisses(), 2);
+}
+
+TEST_SUITE_END();
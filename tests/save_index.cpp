@@ -0,0 +1,119 @@
+#include <sstream>
+#include "save_index.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("SaveIndex");
+
+namespace {
+	lcf::rpg::SaveTitle MakeTitle() {
+		lcf::rpg::SaveTitle title;
+		title.timestamp = 45123.456789012345;
+		title.hero_name = "Alex\tThe\\Hero\n";
+		title.hero_level = 42;
+		title.hero_hp = 999;
+		title.face1_name = "Actor1";
+		title.face1_id = 3;
+		title.face4_name = "Monster";
+		title.face4_id = 7;
+		return title;
+	}
+
+	void CheckTitle(const lcf::rpg::SaveTitle& a, const lcf::rpg::SaveTitle& b) {
+		CHECK_EQ(a.timestamp, b.timestamp);
+		CHECK_EQ(a.hero_name, b.hero_name);
+		CHECK_EQ(a.hero_level, b.hero_level);
+		CHECK_EQ(a.hero_hp, b.hero_hp);
+		CHECK_EQ(a.face1_name, b.face1_name);
+		CHECK_EQ(a.face1_id, b.face1_id);
+		CHECK_EQ(a.face2_name, b.face2_name);
+		CHECK_EQ(a.face2_id, b.face2_id);
+		CHECK_EQ(a.face3_name, b.face3_name);
+		CHECK_EQ(a.face3_id, b.face3_id);
+		CHECK_EQ(a.face4_name, b.face4_name);
+		CHECK_EQ(a.face4_id, b.face4_id);
+	}
+}
+
+TEST_CASE("Find") {
+	SaveIndex index;
+	CHECK(!index.IsModified());
+	CHECK(index.Find(1, 100, 200) == nullptr);
+
+	index.Update(1, 100, 200, MakeTitle());
+	CHECK(index.IsModified());
+
+	auto* title = index.Find(1, 100, 200);
+	REQUIRE(title != nullptr);
+	CheckTitle(*title, MakeTitle());
+
+	// Stale entries
+	CHECK(index.Find(1, 101, 200) == nullptr);
+	CHECK(index.Find(1, 100, 201) == nullptr);
+	CHECK(index.Find(2, 100, 200) == nullptr);
+
+	// Unknown modification time
+	CHECK(index.Find(1, 100, -1) == nullptr);
+	index.Update(1, 100, -1, MakeTitle());
+	CHECK(index.Find(1, 100, 200) == nullptr);
+}
+
+TEST_CASE("Remove") {
+	SaveIndex index;
+	index.Update(5, 100, 200, MakeTitle());
+
+	std::stringstream ss;
+	index.Write(ss);
+	REQUIRE(index.Read(ss));
+	CHECK(!index.IsModified());
+
+	index.Remove(4);
+	CHECK(!index.IsModified());
+	index.Remove(5);
+	CHECK(index.IsModified());
+	CHECK(index.Find(5, 100, 200) == nullptr);
+}
+
+TEST_CASE("ReadWrite") {
+	SaveIndex index;
+	index.Update(1, 100, 200, MakeTitle());
+	index.Update(99, 12345678901, 1700000000, lcf::rpg::SaveTitle());
+
+	std::stringstream ss;
+	index.Write(ss);
+
+	SaveIndex read;
+	REQUIRE(read.Read(ss));
+	CHECK(!read.IsModified());
+
+	auto* title = read.Find(1, 100, 200);
+	REQUIRE(title != nullptr);
+	CheckTitle(*title, MakeTitle());
+
+	title = read.Find(99, 12345678901, 1700000000);
+	REQUIRE(title != nullptr);
+	CheckTitle(*title, lcf::rpg::SaveTitle());
+}
+
+TEST_CASE("ReadInvalid") {
+	SaveIndex index;
+
+	std::stringstream empty;
+	CHECK(!index.Read(empty));
+
+	std::stringstream bad_header("EasyRPG SaveIndex 0\n");
+	CHECK(!index.Read(bad_header));
+
+	std::stringstream ss;
+	index.Update(1, 100, 200, MakeTitle());
+	index.Write(ss);
+	std::string data = ss.str();
+
+	std::stringstream truncated(data.substr(0, data.size() - 4));
+	CHECK(!index.Read(truncated));
+	CHECK(index.Find(1, 100, 200) == nullptr);
+
+	std::stringstream bad_number(data + "2\tx\t1\t0\t\t1\t1\t\t0\t\t0\t\t0\t\t0\n");
+	CHECK(!index.Read(bad_number));
+}
+
+TEST_SUITE_END();
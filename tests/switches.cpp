@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <utility>
+#include <vector>
 #include "game_switches.h"
 #include "doctest.h"
 
@@ -123,6 +126,91 @@ TEST_CASE("FlipRange") {
 	REQUIRE_FALSE(s.Get(n + 1));
 }
 
+TEST_CASE("RangeWordBoundaries") {
+	// Compare against a plain vector for ranges crossing 64 bit words
+	auto s = make();
+	std::vector<bool> ref(300);
+
+	uint32_t seed = 7;
+	for (int i = 0; i < 200; ++i) {
+		seed = seed * 1103515245u + 12345u;
+		int first = (seed >> 8) % 300 + 1;
+		int last = (seed >> 18) % 300 + 1;
+		if (first > last) {
+			std::swap(first, last);
+		}
+
+		switch (i % 3) {
+			case 0:
+				s.SetRange(first, last, true);
+				break;
+			case 1:
+				s.SetRange(first, last, false);
+				break;
+			case 2:
+				s.FlipRange(first, last);
+				break;
+		}
+		for (int id = first; id <= last; ++id) {
+			ref[id - 1] = (i % 3 == 0) ? true : (i % 3 == 1) ? false : !ref[id - 1];
+		}
+
+		for (int id = 1; id <= 300; ++id) {
+			REQUIRE_EQ(s.Get(id), ref[id - 1]);
+		}
+		REQUIRE_EQ(s.CountRange(first, last), std::count(ref.begin() + first - 1, ref.begin() + last, true));
+	}
+
+	REQUIRE_EQ(s.CountRange(-5, 1000), std::count(ref.begin(), ref.end(), true));
+	REQUIRE_EQ(s.CountRange(10, 9), 0);
+}
+
+TEST_CASE("Data") {
+	auto s = make();
+	std::vector<bool> data(130);
+	data[0] = data[63] = data[64] = data[129] = true;
+
+	s.SetData(data);
+	REQUIRE_EQ(s.GetSize(), 130);
+	REQUIRE(s.Get(1));
+	REQUIRE_FALSE(s.Get(2));
+	REQUIRE(s.Get(64));
+	REQUIRE(s.Get(65));
+	REQUIRE(s.Get(130));
+	REQUIRE_FALSE(s.HasChanges());
+	REQUIRE(s.GetData() == data);
+}
+
+TEST_CASE("Changes") {
+	auto s = make();
+	REQUIRE_FALSE(s.HasChanges());
+
+	// Writing the same value is not a change
+	s.SetRange(1, 10, false);
+	REQUIRE_FALSE(s.HasChanges());
+
+	s.Set(3, true);
+	s.SetRange(60, 70, true);
+	s.Flip(200);
+	REQUIRE(s.HasChanges());
+	REQUIRE(s.IsChanged(3));
+	REQUIRE_FALSE(s.IsChanged(4));
+
+	using Ranges = std::vector<std::pair<int, int>>;
+	REQUIRE(s.GetChangedRanges() == Ranges{ { 3, 3 }, { 60, 70 }, { 200, 200 } });
+
+	// Changing a switch back still counts
+	s.Set(3, false);
+	REQUIRE(s.IsChanged(3));
+
+	s.ClearChanges();
+	REQUIRE_FALSE(s.HasChanges());
+	REQUIRE(s.GetChangedRanges().empty());
+
+	s.SetRange(1, 256, true);
+	REQUIRE(s.GetChangedRanges() == Ranges{ { 1, 59 }, { 71, 199 }, { 201, 256 } });
+}
+
 TEST_CASE("GetSize") {
 	auto s = make();
 	REQUIRE_EQ(s.GetSizeWithLimit(), max_switches);
@@ -0,0 +1,54 @@
+#include "thread_pool.h"
+#include "doctest.h"
+#include <atomic>
+#include <vector>
+
+TEST_SUITE_BEGIN("ThreadPool");
+
+TEST_CASE("Submit") {
+	ThreadPool pool(2);
+
+	std::atomic<int> sum(0);
+	std::vector<std::shared_future<void>> jobs;
+	for (int i = 1; i <= 100; ++i) {
+		jobs.push_back(pool.Submit([&sum, i]() { sum += i; }));
+	}
+
+	for (auto& job: jobs) {
+		REQUIRE(job.valid());
+		job.wait();
+	}
+
+	REQUIRE_EQ(sum, 5050);
+	REQUIRE_EQ(pool.GetQueueSize(), 0);
+}
+
+TEST_CASE("WorkerThread") {
+	ThreadPool pool(1);
+
+	bool in_worker = false;
+	pool.Submit([&in_worker]() { in_worker = ThreadPool::IsWorkerThread(); }).wait();
+
+#ifdef HAVE_ASYNC_WORKER
+	REQUIRE_EQ(pool.GetThreadCount(), 1);
+	REQUIRE(in_worker);
+#else
+	REQUIRE_EQ(pool.GetThreadCount(), 0);
+	REQUIRE_FALSE(in_worker);
+#endif
+	REQUIRE_FALSE(ThreadPool::IsWorkerThread());
+}
+
+TEST_CASE("DiscardOnDestruction") {
+	std::shared_future<void> job;
+	{
+		ThreadPool pool(1);
+		pool.Submit([]() {});
+		job = pool.Submit([]() {});
+	}
+
+	// Either executed or discarded, but never pending forever
+	job.wait();
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,139 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+#include "variable_kernels.h"
+#include "doctest.h"
+
+TEST_SUITE_BEGIN("VariableKernels");
+
+namespace {
+
+using VariableKernels::Variant;
+using VariableKernels::Op;
+
+constexpr int32_t int32_min = std::numeric_limits<int32_t>::min();
+constexpr int32_t int32_max = std::numeric_limits<int32_t>::max();
+
+constexpr Variant variants[] = { Variant::Scalar, Variant::Sse41, Variant::Avx2 };
+
+constexpr Op ops[] = {
+	Op::Set, Op::Add, Op::Sub, Op::Mult, Op::Div, Op::Mod,
+	Op::BitOr, Op::BitAnd, Op::BitXor, Op::BitShiftLeft, Op::BitShiftRight
+};
+
+constexpr int32_t operands[] = {
+	0, 1, -1, 2, -2, 3, 7, -13, 31, 32, 33, 1000, -99999, 1234567,
+	int32_max, int32_min, int32_max - 1, int32_min + 1
+};
+
+/** RAII guard restoring the selected variant */
+struct VariantGuard {
+	VariantGuard() : variant(VariableKernels::GetVariant()) {}
+	~VariantGuard() { VariableKernels::SetVariant(variant); }
+	Variant variant;
+};
+
+std::vector<int32_t> MakeVars(int count, uint32_t seed) {
+	std::vector<int32_t> vars(count);
+	for (int i = 0; i < count; ++i) {
+		seed = seed * 1103515245u + 12345u;
+		switch (i % 4) {
+			case 0:
+				vars[i] = static_cast<int32_t>(seed ^ (seed >> 13));
+				break;
+			case 1:
+				vars[i] = static_cast<int32_t>(seed >> 8) % 20000 - 10000;
+				break;
+			case 2:
+				vars[i] = static_cast<int32_t>(seed >> 4) % 9999999;
+				break;
+			case 3:
+				vars[i] = operands[(seed >> 16) % (sizeof(operands) / sizeof(operands[0]))];
+				break;
+		}
+	}
+	return vars;
+}
+
+/** Reference with 64 bit arithmetic */
+int32_t Reference(int32_t v, Op op, int32_t value, int32_t minval, int32_t maxval) {
+	int64_t r = 0;
+	switch (op) {
+		case Op::Set: r = value; break;
+		case Op::Add: r = int64_t(v) + value; break;
+		case Op::Sub: r = int64_t(v) - value; break;
+		case Op::Mult: r = int64_t(v) * value; break;
+		case Op::Div: r = value != 0 ? int64_t(v) / value : v; break;
+		case Op::Mod: r = value != 0 ? int64_t(v) % value : 0; break;
+		case Op::BitOr: r = v | value; break;
+		case Op::BitAnd: r = v & value; break;
+		case Op::BitXor: r = v ^ value; break;
+		case Op::BitShiftLeft: r = static_cast<int32_t>(static_cast<uint32_t>(v) << (value & 31)); break;
+		case Op::BitShiftRight: r = v >> (value & 31); break;
+	}
+	return static_cast<int32_t>(std::min<int64_t>(std::max<int64_t>(r, minval), maxval));
+}
+
+void Check(int32_t minval, int32_t maxval) {
+	VariantGuard guard;
+
+	// Odd counts test the scalar tail
+	for (int count: { 1, 7, 64, 1021 }) {
+		const auto src = MakeVars(count, count);
+		for (auto op: ops) {
+			for (auto value: operands) {
+				std::vector<int32_t> expected(src.size());
+				for (std::size_t i = 0; i < src.size(); ++i) {
+					expected[i] = Reference(src[i], op, value, minval, maxval);
+				}
+
+				for (auto variant: variants) {
+					if (!VariableKernels::SetVariant(variant)) {
+						continue;
+					}
+					auto actual = src;
+					VariableKernels::Apply(actual.data(), count, op, value, minval, maxval);
+					INFO(VariableKernels::GetVariantName(variant), " op ", static_cast<int>(op), " value ", value);
+					REQUIRE(actual == expected);
+				}
+			}
+		}
+	}
+}
+
+}
+
+TEST_CASE("Variants") {
+	CHECK(VariableKernels::IsSupported(Variant::Scalar));
+	CHECK(VariableKernels::IsSupported(VariableKernels::GetDefaultVariant()));
+
+	VariantGuard guard;
+	for (auto variant: variants) {
+		CHECK_EQ(VariableKernels::SetVariant(variant), VariableKernels::IsSupported(variant));
+	}
+}
+
+TEST_CASE("Limits2k3") {
+	Check(-9999999, 9999999);
+}
+
+TEST_CASE("LimitsManiac") {
+	Check(int32_min, int32_max);
+}
+
+TEST_CASE("LimitsCustom") {
+	Check(5, 100);
+	Check(-100, -5);
+	Check(int32_min, int32_min + 1);
+	Check(int32_max - 1, int32_max);
+}
+
+TEST_CASE("Empty") {
+	int32_t v = 42;
+	VariableKernels::Apply(&v, 0, Op::Set, 1, 0, 100);
+	CHECK_EQ(v, 42);
+}
+
+TEST_SUITE_END();
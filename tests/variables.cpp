@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <limits>
+#include <utility>
 #include "game_variables.h"
 #include "doctest.h"
 
@@ -468,6 +471,66 @@ TEST_CASE("RangeVariable") {
 	REQUIRE_EQ(s.Get(6), 0);
 }
 
+TEST_CASE("RangeMatchesSingle") {
+	// Range operations must give the same results as the single operations,
+	// also when overflowing and with the Maniac Patch limits
+	constexpr int n = 100;
+	using Var_t = Game_Variables::Var_t;
+	constexpr Var_t int_min = std::numeric_limits<Var_t>::min();
+	constexpr Var_t int_max = std::numeric_limits<Var_t>::max();
+
+	using RangeOp = void (Game_Variables::*)(int, int, Var_t);
+	using SingleOp = Var_t (Game_Variables::*)(int, Var_t);
+	const std::pair<RangeOp, SingleOp> ops[] = {
+		{ &Game_Variables::SetRange, &Game_Variables::Set },
+		{ &Game_Variables::AddRange, &Game_Variables::Add },
+		{ &Game_Variables::SubRange, &Game_Variables::Sub },
+		{ &Game_Variables::MultRange, &Game_Variables::Mult },
+		{ &Game_Variables::DivRange, &Game_Variables::Div },
+		{ &Game_Variables::ModRange, &Game_Variables::Mod },
+		{ &Game_Variables::BitOrRange, &Game_Variables::BitOr },
+		{ &Game_Variables::BitAndRange, &Game_Variables::BitAnd },
+		{ &Game_Variables::BitXorRange, &Game_Variables::BitXor },
+		{ &Game_Variables::BitShiftLeftRange, &Game_Variables::BitShiftLeft },
+		{ &Game_Variables::BitShiftRightRange, &Game_Variables::BitShiftRight }
+	};
+
+	for (auto limit: { std::make_pair(minval, maxval), std::make_pair(int_min, int_max) }) {
+		for (Var_t value: { 0, 1, -1, 3, -7, 31, 123456, -9999999, int_max, int_min + 1 }) {
+			for (const auto& op: ops) {
+				Game_Variables range(limit.first, limit.second);
+				Game_Variables single(limit.first, limit.second);
+				range.SetWarning(0);
+				single.SetWarning(0);
+
+				// Shifting negative values, by negative amounts or out of
+				// the 32 bit range is undefined for the single operations
+				const bool shift = (op.second == &Game_Variables::BitShiftLeft || op.second == &Game_Variables::BitShiftRight);
+				if (shift && (value < 0 || value > 15)) {
+					continue;
+				}
+
+				uint32_t seed = 1;
+				for (int i = 1; i <= n; ++i) {
+					seed = seed * 1103515245u + 12345u;
+					// Avoid int_min, int_min / -1 is undefined
+					Var_t v = std::max<Var_t>(static_cast<Var_t>(seed), int_min + 1);
+					if (shift) {
+						v &= 0xFFFF;
+					}
+					range.Set(i, v);
+					single.Set(i, v);
+				}
+
+				(range.*op.first)(1, n, value);
+				for (int i = 1; i <= n; ++i) {
+					(single.*op.second)(i, value);
+				}
+				REQUIRE(range.GetData() == single.GetData());
+			}
+		}
+	}
+}
 
 TEST_CASE("RangeVariableIndirect") {
 	constexpr int n = max_vars * 2;